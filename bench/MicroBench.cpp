@@ -0,0 +1,1382 @@
+// glfw_window_test_microbench: microbenchmarks of the engine primitives that
+// scenes call thousands of times per frame.
+//
+//   glfw_window_test_microbench [--filter substring] [--samples 15] [--warmup 3]
+//                               [--min-sample-ms 2] [--output micro.json]
+//                               [--baseline old.json] [--threshold 0.03]
+//                               [--fail-on-regression]
+//
+// The number after a slash in a benchmark name is its scaling parameter.
+// Times are nanoseconds per iteration.
+
+#include "MicroBench.h"
+#include "core/Camera.h"
+#include "core/Input.h"
+#include "core/Math.h"
+#include "core/WorkerPool.h"
+#include "core/ecs/Systems.h"
+#include "core/memory/FrameAllocator.h"
+#include "core/log/Logger.h"
+#include "core/render/NullRenderDriver.h"
+#include "nodes/Animation2D.h"
+#include "nodes/AnimationStateMachine.h"
+#include "nodes/NodeTypeMap.h"
+#include "nodes/OscillatingRectangle.h"
+#include "nodes/ParticleEmitter2D.h"
+#include "nodes/PulsingTriangle.h"
+#include "nodes/Rectangle.h"
+#include "nodes/RotatingTriangle.h"
+#include "nodes/SkinnedSprite2D.h"
+#include "nodes/TileMap2D.h"
+#include "nodes/TweenSystem.h"
+#include "scene/Scene.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Input::setupAction reports every mapping on stdout
+struct QuietStdout
+{
+  std::ostringstream sink;
+  std::streambuf *previous;
+  QuietStdout() : previous(std::cout.rdbuf(sink.rdbuf())) {}
+  ~QuietStdout() { std::cout.rdbuf(previous); }
+};
+
+static void registerInputBenchmarks(MicroBench &bench)
+{
+  // Lookup cost grows with the number of mapped actions
+  bench.add("Input::isActionPressed", [](MicroState &state)
+            {
+    auto &input = Input::getInstance();
+    int actions = static_cast<int>(state.getArgument());
+    std::string last = "action_" + std::to_string(actions - 1);
+    if (input.getActionKey(last) < 0 || input.getActionKey("action_" + std::to_string(actions)) >= 0)
+    {
+      QuietStdout quiet;
+      input.clearActions();
+      for (int i = 0; i < actions; ++i)
+        input.setupAction("action_" + std::to_string(i), 32 + i);
+    }
+
+    // Callers pass string literals, so the temporary std::string is part of the cost
+    while (state.keepRunning())
+    {
+      doNotOptimize(input.isActionPressed("action_3"));
+    } }, {8, 64});
+}
+
+// Characters and recorded input for the clip selection benchmarks: each
+// character keeps its movement flags for a while and occasionally jumps or punches
+struct AnimationSelectFixture
+{
+  static constexpr size_t Frames = 64;
+  enum : uint8_t
+  {
+    Moving = 1,
+    Running = 2,
+    Crouching = 4,
+    Jump = 8,
+    Punch = 16
+  };
+
+  std::shared_ptr<AnimationClipSet> clips = std::make_shared<AnimationClipSet>();
+  std::vector<Animation2D> animators;
+  std::vector<uint8_t> inputs; // Frames rows of one byte per character
+
+  explicit AnimationSelectFixture(size_t count) : animators(count), inputs(Frames * count)
+  {
+    clips->addClip("IDLE", {AnimationFrame(1, 2)}, 8.0f, true);
+    clips->addClip("WALK", {AnimationFrame(3, 6)}, 12.0f, true);
+    clips->addClip("RUN", {AnimationFrame(9, 6)}, 15.0f, true);
+    clips->addClip("JUMP", {AnimationFrame(15, 6)}, 10.0f, false);
+    clips->addClip("PUNCH", {AnimationFrame(21, 2)}, 8.0f, false);
+    clips->addClip("CROUCH_IDLE", {AnimationFrame(62, 2)}, 8.0f, true);
+    clips->addClip("CROUCH_WALK", {AnimationFrame(63, 6)}, 12.0f, true);
+    for (Animation2D &animator : animators)
+    {
+      animator.setClips(clips);
+      animator.play(AnimationClipHandle(0));
+    }
+
+    uint32_t seed = 7;
+    for (size_t i = 0; i < count; ++i)
+    {
+      uint8_t held = 0;
+      for (size_t frame = 0; frame < Frames; ++frame)
+      {
+        seed = seed * 1664525u + 1013904223u;
+        uint32_t roll = seed >> 24;
+        if (roll < 24) // About one frame in ten changes the held flags
+          held = static_cast<uint8_t>((seed >> 8) & (Moving | Running | Crouching));
+        uint8_t bits = held;
+        if (roll >= 24 && roll < 28)
+          bits |= Jump;
+        else if (roll >= 28 && roll < 32)
+          bits |= Punch;
+        inputs[frame * count + i] = bits;
+      }
+    }
+  }
+};
+
+static void registerAnimationBenchmarks(MicroBench &bench)
+{
+  // Advance many animators sharing one clip set by one frame; cost per
+  // iteration is the whole batch
+  bench.add("Animation2D::update", [](MicroState &state)
+            {
+    auto clips = std::make_shared<AnimationClipSet>();
+    clips->addClip("Idle", {AnimationFrame(0, 8)}, 12.0f, true);
+    AnimationClipHandle run = clips->addClip("Run", {AnimationFrame(8, 8), AnimationFrame(16, 4)}, 16.0f, true);
+
+    std::vector<Animation2D> animators(static_cast<size_t>(state.getArgument()));
+    for (Animation2D &animator : animators)
+    {
+      animator.setClips(clips);
+      animator.play(run);
+    }
+
+    while (state.keepRunning())
+    {
+      for (Animation2D &animator : animators)
+      {
+        animator.update(1.0f / 60.0f);
+        doNotOptimize(animator.getCurrentFrameIndex());
+      }
+    } }, {1, 1024, 10000, 100000});
+
+  // The same batch advanced by an AnimationSystem, writing each sheet frame
+  // to an int the way it writes Sprite2D::frame
+  bench.add("AnimationSystem::update", [](MicroState &state)
+            {
+    auto clips = std::make_shared<AnimationClipSet>();
+    clips->addClip("Idle", {AnimationFrame(0, 8)}, 12.0f, true);
+    AnimationClipHandle run = clips->addClip("Run", {AnimationFrame(8, 8), AnimationFrame(16, 4)}, 16.0f, true);
+
+    size_t count = static_cast<size_t>(state.getArgument());
+    AnimationSystem system;
+    system.reserve(count);
+    std::vector<Animation2D> animators(count);
+    std::vector<int> frames(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      animators[i].setClips(clips);
+      animators[i].play(run);
+      animators[i].attach(system, &frames[i]);
+    }
+
+    while (state.keepRunning())
+    {
+      system.update(1.0f / 60.0f);
+      doNotOptimize(frames.data());
+      clobberMemory();
+    }
+    animators.clear(); }, {1024, 10000, 100000});
+
+  // A level 64 screens wide with 100k animated sprites and a view scrolling
+  // 4 units per update; argument 0 runs every animator, 1 enables level of detail
+  bench.add("AnimationSystem::scrollingLevel", [](MicroState &state)
+            {
+    auto clips = std::make_shared<AnimationClipSet>();
+    clips->addClip("Run", {AnimationFrame(8, 8), AnimationFrame(16, 4)}, 16.0f, true);
+
+    const size_t count = 100000;
+    const float levelWidth = 320.0f * 64.0f;
+    AnimationSystem system;
+    system.reserve(count);
+    std::vector<Transform2D> transforms(count);
+    std::vector<Animation2D> animators(count);
+    std::vector<int> frames(count);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+      seed = seed * 1664525u + 1013904223u;
+      transforms[i].setPosition(Position2D(static_cast<float>(seed >> 8) / 16777216.0f * levelWidth, static_cast<float>(i % 240)));
+      if (i % 10 == 0)
+        transforms[i].setScale(Scale2D(0.125f, 0.125f)); // Distant background detail, 2 pixels on screen
+      animators[i].setClips(clips);
+      animators[i].play(AnimationClipHandle(0));
+      animators[i].attach(system, &frames[i]);
+      animators[i].setLodBounds(&transforms[i], 8.0f, 8.0f);
+    }
+
+    float left = 0.0f;
+    system.setView(left, 0.0f, left + 320.0f, 240.0f, 1.0f);
+    if (state.getArgument() != 0)
+      system.enableLod(AnimationLodPolicy());
+
+    while (state.keepRunning())
+    {
+      left = left + 4.0f < levelWidth - 320.0f ? left + 4.0f : 0.0f;
+      system.setView(left, 0.0f, left + 320.0f, 240.0f, 1.0f);
+      system.update(1.0f / 60.0f);
+      doNotOptimize(frames.data());
+      clobberMemory();
+    }
+    animators.clear(); }, {0, 1});
+
+  // Picking each character's clip from its movement flags, per frame: the
+  // hand-written if/else chain with play() on change, against one batched pass
+  // over a compiled state machine. Both replay the same 64 frames of input.
+  bench.add("AnimationSelect::handWritten", [](MicroState &state)
+            {
+    AnimationSelectFixture fixture(static_cast<size_t>(state.getArgument()));
+    const AnimationClipSet &clips = *fixture.clips;
+    AnimationClipHandle idle = clips.find("IDLE"), walk = clips.find("WALK"), run = clips.find("RUN");
+    AnimationClipHandle crouchIdle = clips.find("CROUCH_IDLE"), crouchWalk = clips.find("CROUCH_WALK");
+    AnimationClipHandle jump = clips.find("JUMP"), punch = clips.find("PUNCH");
+    size_t count = fixture.animators.size();
+    size_t frame = 0;
+
+    while (state.keepRunning())
+    {
+      const uint8_t *input = fixture.inputs.data() + (frame++ % AnimationSelectFixture::Frames) * count;
+      for (size_t i = 0; i < count; ++i)
+      {
+        uint8_t bits = input[i];
+        AnimationClipHandle target;
+        if (bits & AnimationSelectFixture::Jump)
+          target = jump;
+        else if (bits & AnimationSelectFixture::Punch)
+          target = punch;
+        else if (bits & AnimationSelectFixture::Crouching)
+          target = (bits & AnimationSelectFixture::Moving) ? crouchWalk : crouchIdle;
+        else if (bits & AnimationSelectFixture::Moving)
+          target = (bits & AnimationSelectFixture::Running) ? run : walk;
+        else
+          target = idle;
+
+        Animation2D &animator = fixture.animators[i];
+        if (animator.getCurrentClip() != target)
+          animator.play(target);
+      }
+      clobberMemory();
+    } }, {10000});
+
+  bench.add("AnimationStateMachine::update", [](MicroState &state)
+            {
+    AnimationSelectFixture fixture(static_cast<size_t>(state.getArgument()));
+
+    AnimationStateMachineBuilder builder;
+    builder.addBool("moving");
+    builder.addBool("running");
+    builder.addBool("crouching");
+    builder.addTrigger("jump");
+    builder.addTrigger("punch");
+    builder.addState("idle", "IDLE");
+    builder.addState("walk", "WALK");
+    builder.addState("run", "RUN");
+    builder.addState("crouchIdle", "CROUCH_IDLE");
+    builder.addState("crouchWalk", "CROUCH_WALK");
+    builder.addState("jump", "JUMP");
+    builder.addState("punch", "PUNCH");
+    builder.addAnyTransition("jump").when("jump");
+    builder.addAnyTransition("punch").when("punch");
+    for (const char *from : {"idle", "walk", "run", "crouchIdle", "crouchWalk", "jump", "punch"})
+    {
+      std::string source = from;
+      if (source != "crouchWalk")
+        builder.addTransition(from, "crouchWalk").when("crouching").when("moving");
+      if (source != "crouchIdle")
+        builder.addTransition(from, "crouchIdle").when("crouching").whenNot("moving");
+      if (source != "run")
+        builder.addTransition(from, "run").whenNot("crouching").when("moving").when("running");
+      if (source != "walk")
+        builder.addTransition(from, "walk").whenNot("crouching").when("moving").whenNot("running");
+      if (source != "idle")
+        builder.addTransition(from, "idle").whenNot("crouching").whenNot("moving");
+    }
+
+    AnimationStateBatch batch(builder.compile(*fixture.clips));
+    const AnimationStateMachine &machine = *batch.getMachine();
+    uint32_t moving = machine.findParameter("moving"), running = machine.findParameter("running");
+    uint32_t crouching = machine.findParameter("crouching");
+    uint32_t jump = machine.findParameter("jump"), punch = machine.findParameter("punch");
+    size_t count = fixture.animators.size();
+    for (Animation2D &animator : fixture.animators)
+      batch.add(&animator);
+    size_t frame = 0;
+
+    while (state.keepRunning())
+    {
+      const uint8_t *input = fixture.inputs.data() + (frame++ % AnimationSelectFixture::Frames) * count;
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        uint8_t bits = input[i];
+        batch.setBool(i, moving, (bits & AnimationSelectFixture::Moving) != 0);
+        batch.setBool(i, running, (bits & AnimationSelectFixture::Running) != 0);
+        batch.setBool(i, crouching, (bits & AnimationSelectFixture::Crouching) != 0);
+        if (bits & AnimationSelectFixture::Jump)
+          batch.setTrigger(i, jump);
+        if (bits & AnimationSelectFixture::Punch)
+          batch.setTrigger(i, punch);
+      }
+      doNotOptimize(batch.update());
+      clobberMemory();
+    } }, {10000});
+
+  // Clips are flattened into a frame table, so this should not grow with the group count
+  bench.add("Animation2D::getCurrentFrameIndex", [](MicroState &state)
+            {
+    Animation2D animator;
+    std::vector<AnimationFrame> groups;
+    for (int64_t i = 0; i < state.getArgument(); ++i)
+      groups.emplace_back(static_cast<int>(i * 2), 2);
+    animator.addAnimation("Walk", groups, 60.0f, true);
+    animator.play("Walk");
+
+    // One frame per update, so every group position is visited
+    while (state.keepRunning())
+    {
+      animator.update(1.0f / 60.0f);
+      doNotOptimize(animator.getCurrentFrameIndex());
+    } }, {1, 8, 32});
+}
+
+static void registerMathBenchmarks(MicroBench &bench)
+{
+  // position += velocity * dt over arrays; the argument is the element count
+  bench.add("Vector2::integrate", [](MicroState &state)
+            {
+    size_t count = static_cast<size_t>(state.getArgument());
+    std::vector<Vector2> positions(count);
+    std::vector<Vector2> velocities(count);
+    for (size_t i = 0; i < count; ++i)
+      velocities[i] = Vector2(static_cast<float>(i % 7), static_cast<float>(i % 5));
+
+    while (state.keepRunning())
+    {
+      for (size_t j = 0; j < count; ++j)
+        positions[j] += velocities[j] * (1.0f / 60.0f);
+      doNotOptimize(positions.data());
+      clobberMemory();
+    } }, {1024, 65536});
+
+  bench.add("Vector2::lengthNormalize", [](MicroState &state)
+            {
+    size_t count = static_cast<size_t>(state.getArgument());
+    std::vector<Vector2> vectors(count);
+    for (size_t i = 0; i < count; ++i)
+      vectors[i] = Vector2(1.0f + static_cast<float>(i % 7), 2.0f + static_cast<float>(i % 5));
+
+    while (state.keepRunning())
+    {
+      float total = 0.0f;
+      for (const Vector2 &v : vectors)
+      {
+        float length = std::sqrt(v.x * v.x + v.y * v.y);
+        Vector2 unit = v / length;
+        total += unit.x + unit.y;
+      }
+      doNotOptimize(total);
+    } }, {1024, 65536});
+}
+
+// Root children named Node0..Node{count-1}
+static void addNamedChildren(Scene &scene, int64_t count)
+{
+  for (int64_t i = 0; i < count; ++i)
+    scene.addNode(std::make_unique<Rectangle>("Node" + std::to_string(i), 0.0f, 0.0f));
+}
+
+static void registerNodeBenchmarks(MicroBench &bench)
+{
+  // Detach and re-attach the newest child of a parent with N children. The
+  // newest child sits at the end, so removeChild's linear search is worst case.
+  bench.add("Node::addChild+removeChild", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    Node *parent = scene.getRoot();
+    Node *newest = nullptr;
+    for (int64_t i = 0; i < state.getArgument(); ++i)
+    {
+      auto child = std::make_unique<Rectangle>("Child" + std::to_string(i), 0.0f, 0.0f);
+      newest = child.get();
+      parent->addChild(std::move(child));
+    }
+
+    while (state.keepRunning())
+    {
+      std::unique_ptr<Node> removed = parent->removeChild(newest);
+      parent->addChild(std::move(removed));
+    }
+    doNotOptimize(parent->getChildCount()); }, {16, 256, 4096});
+
+  // Remove by name through the root's child index and add back. Names are
+  // cycled in order, so the removed node is always the oldest child and the
+  // erase shifts the whole child vector.
+  bench.add("Scene::removeNode", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    std::vector<std::string> names;
+    for (int64_t i = 0; i < state.getArgument(); ++i)
+    {
+      names.push_back("Node" + std::to_string(i));
+      scene.addNode(std::make_unique<Rectangle>(names.back(), 0.0f, 0.0f));
+    }
+
+    size_t next = 0;
+    while (state.keepRunning())
+    {
+      std::unique_ptr<Node> removed = scene.removeNode(names[next++ % names.size()]);
+      scene.addNode(std::move(removed));
+    }
+    doNotOptimize(scene.getNodeCount()); }, {16, 256, 4096});
+
+  // Create then free 100k rectangles, the node churn of loading and
+  // unloading a level; argument 0 uses the global heap, 1 a NodeArena that is
+  // reset after each batch
+  bench.add("NodeArena::allocate100k", [](MicroState &state)
+            {
+    const size_t count = 100000;
+    bool useArena = state.getArgument() != 0;
+    NodeArena arena;
+    std::vector<std::unique_ptr<Node>> nodes;
+    nodes.reserve(count);
+
+    while (state.keepRunning())
+    {
+      {
+        NodeArena::Scope scope(useArena ? &arena : nullptr);
+        for (size_t i = 0; i < count; ++i)
+          nodes.push_back(std::make_unique<Rectangle>("Node", 0.0f, 0.0f));
+      }
+      doNotOptimize(nodes.back().get());
+      nodes.clear();
+      if (useArena)
+        arena.reset();
+    } }, {0, 1});
+
+  // One frame of churn in a 10k-node scene: spawn N nodes through the
+  // command buffer and flush, then queueFree them and flush again. The Flat
+  // variant also keeps the FlatHierarchy in sync.
+  auto spawnDestroy = [](MicroState &state, bool flat)
+  {
+    Scene scene("MicroBench");
+    auto arenaScope = scene.useNodeArena();
+    addNamedChildren(scene, 10000);
+    scene.setFlatTraversal(flat);
+    Node *root = scene.getRoot();
+    std::vector<Node *> spawned;
+
+    while (state.keepRunning())
+    {
+      spawned.clear();
+      for (int64_t i = 0; i < state.getArgument(); ++i)
+      {
+        auto node = std::make_unique<Rectangle>("Bullet", 0.0f, 0.0f);
+        spawned.push_back(node.get());
+        scene.getCommands().spawn(root, std::move(node));
+      }
+      scene.flushCommands();
+      for (Node *node : spawned)
+        node->queueFree();
+      scene.flushCommands();
+    }
+    doNotOptimize(scene.getNodeCount());
+  };
+  bench.add("SceneCommands::spawnDestroy", [spawnDestroy](MicroState &state)
+            { spawnDestroy(state, false); }, {16, 1024});
+  bench.add("SceneCommands::spawnDestroyFlat", [spawnDestroy](MicroState &state)
+            { spawnDestroy(state, true); }, {16, 1024});
+
+  // Scene files resolve one factory per node; returns a std::function copy
+  bench.add("NodeTypeMap::getNodeFactory", [](MicroState &state)
+            {
+    static const char *types[] = {"Triangle", "Rectangle", "Sprite2D"};
+    NodeTypeMap::getNodeFactory(types[0]);
+
+    size_t next = 0;
+    while (state.keepRunning())
+    {
+      NodeTypeMap::NodeFactory factory = NodeTypeMap::getNodeFactory(types[next++ % 3]);
+      doNotOptimize(factory);
+    } });
+
+  // Animated nodes a third each rotating, oscillating and pulsing: the script
+  // classes' own update() against the same motion as TweenSystem tracks. Nodes
+  // come from a scene's arena, as in a loaded scene.
+  bench.add("ScriptNodes::update", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    auto arenaScope = scene.useNodeArena();
+    std::vector<std::unique_ptr<Node>> nodes;
+    for (int64_t i = 0; i < state.getArgument(); ++i)
+    {
+      Position2D position(static_cast<float>(i % 320), static_cast<float>(i % 240));
+      if (i % 3 == 0)
+        nodes.push_back(std::make_unique<RotatingTriangle>("Node", position, Scale2D(1.0f, 1.0f), Colors::orange, 90.0f));
+      else if (i % 3 == 1)
+        nodes.push_back(std::make_unique<OscillatingRectangle>("Node", position, Scale2D(1.0f, 1.0f), Colors::blue, 0.1f, 2.0f));
+      else
+        nodes.push_back(std::make_unique<PulsingTriangle>("Node", position, Scale2D(1.0f, 1.0f), Colors::green, 1.0f, 0.2f, 3.0f));
+    }
+
+    while (state.keepRunning())
+    {
+      for (auto &node : nodes)
+        node->update(1.0f / 60.0f);
+      clobberMemory();
+    } }, {100000});
+
+  bench.add("TweenSystem::update", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    auto arenaScope = scene.useNodeArena();
+    std::vector<std::unique_ptr<Node2D>> nodes;
+    TweenSystem tweens;
+    tweens.reserve(static_cast<size_t>(state.getArgument()));
+    for (int64_t i = 0; i < state.getArgument(); ++i)
+    {
+      Position2D position(static_cast<float>(i % 320), static_cast<float>(i % 240));
+      if (i % 3 == 1)
+        nodes.push_back(std::make_unique<Rectangle>("Node", position, Scale2D(1.0f, 1.0f), Colors::blue));
+      else
+        nodes.push_back(std::make_unique<Triangle>("Node", position, Scale2D(1.0f, 1.0f), Colors::green));
+
+      Transform2D &transform = nodes.back()->getTransform();
+      if (i % 3 == 0)
+        tweens.spin(&transform.rotation, 90.0f);
+      else if (i % 3 == 1)
+        tweens.oscillate(&transform.position.x, 1, position.x, 0.1f, 2.0f);
+      else
+        tweens.oscillate(&transform.scale.x, 2, 1.0f, 0.2f, 3.0f);
+    }
+
+    while (state.keepRunning())
+    {
+      tweens.update(1.0f / 60.0f);
+      clobberMemory();
+    } }, {100000});
+
+  // Keyframed position, scale and color curves shared by every node
+  bench.add("TweenSystem::keyframes", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    auto arenaScope = scene.useNodeArena();
+    std::vector<std::unique_ptr<Triangle>> nodes;
+    TweenSystem tweens;
+    TweenCurveHandle path = tweens.addCurve({TweenKeyframe(0.0f, Vector3(0.0f, 0.0f)), TweenKeyframe(1.0f, Vector3(40.0f, 0.0f)),
+                                             TweenKeyframe(2.0f, Vector3(40.0f, 30.0f)), TweenKeyframe(3.0f, Vector3(0.0f, 0.0f))},
+                                            TweenChannel::Position, TweenLoop::Loop);
+    TweenCurveHandle pulse = tweens.addCurve({TweenKeyframe(0.0f, Vector3(1.0f, 1.0f), TweenEase::Cubic),
+                                              TweenKeyframe(0.5f, Vector3(1.5f, 1.5f))},
+                                             TweenChannel::Scale, TweenLoop::PingPong);
+    TweenCurveHandle blink = tweens.addCurve({TweenKeyframe(0.0f, Vector3(1.0f, 0.0f, 0.0f), TweenEase::Step),
+                                              TweenKeyframe(0.25f, Vector3(1.0f, 1.0f, 1.0f), TweenEase::Step),
+                                              TweenKeyframe(0.5f, Vector3(1.0f, 0.0f, 0.0f))},
+                                             TweenChannel::Color, TweenLoop::Loop);
+    for (int64_t i = 0; i < state.getArgument(); ++i)
+    {
+      nodes.push_back(std::make_unique<Triangle>("Node"));
+      float speed = 0.5f + static_cast<float>(i % 7) * 0.25f;
+      if (i % 3 == 0)
+        tweens.play(path, nodes.back()->getTransform(), TweenChannel::Position, speed);
+      else if (i % 3 == 1)
+        tweens.play(pulse, nodes.back()->getTransform(), TweenChannel::Scale, speed);
+      else
+        tweens.play(blink, TweenSystem::getTarget(nodes.back()->getColor()), speed);
+    }
+
+    while (state.keepRunning())
+    {
+      tweens.update(1.0f / 60.0f);
+      clobberMemory();
+    } }, {100000});
+}
+
+// Cutout humanoid: 15 bones, rigid hips, torso, head, hands and feet, and
+// limbs as strips blended across the elbows and knees; a one second walk
+struct CutoutCharacter
+{
+  std::shared_ptr<const Skeleton2D> skeleton;
+  std::shared_ptr<const SkinnedMesh2D> mesh;
+  std::shared_ptr<const SkeletonClip2D> walk;
+};
+
+static CutoutCharacter makeCutoutCharacter()
+{
+  auto skeleton = std::make_shared<Skeleton2D>();
+  auto walk = std::make_shared<SkeletonClip2D>("walk");
+  skeleton->addBone("hips", "", Transform2D());
+  skeleton->addBone("torso", "hips", Transform2D(Position2D(0.0f, -30.0f)));
+  skeleton->addBone("head", "torso", Transform2D(Position2D(0.0f, -25.0f)));
+
+  // Limbs hang down (rotated 90 degrees); upper and lower segments swing in opposition
+  struct Limb
+  {
+    const char *name;
+    const char *parent;
+    float x, y, upper, lower;
+    float swing;
+  };
+  const Limb limbs[] = {{"armL", "torso", -10.0f, -20.0f, 18.0f, 16.0f, 35.0f},
+                        {"armR", "torso", 10.0f, -20.0f, 18.0f, 16.0f, -35.0f},
+                        {"legL", "hips", -6.0f, 0.0f, 22.0f, 20.0f, -30.0f},
+                        {"legR", "hips", 6.0f, 0.0f, 22.0f, 20.0f, 30.0f}};
+  for (const Limb &limb : limbs)
+  {
+    std::string name = limb.name;
+    BoneIndex upper = skeleton->addBone(name + "Upper", limb.parent, Transform2D(Position2D(limb.x, limb.y), Scale2D(1.0f, 1.0f), 90.0f));
+    BoneIndex lower = skeleton->addBone(name + "Lower", name + "Upper", Transform2D(Position2D(limb.upper, 0.0f)));
+    skeleton->addBone(name + "End", name + "Lower", Transform2D(Position2D(limb.lower, 0.0f)));
+
+    auto swingKey = [&](float time, float degrees)
+    {
+      return BoneKeyframe2D(time, Transform2D(Position2D(limb.x, limb.y), Scale2D(1.0f, 1.0f), 90.0f + degrees));
+    };
+    walk->addTrack(upper, {swingKey(0.0f, limb.swing), swingKey(0.5f, -limb.swing), swingKey(1.0f, limb.swing)});
+    walk->addTrack(lower, {BoneKeyframe2D(0.0f, Transform2D(Position2D(limb.upper, 0.0f))),
+                           BoneKeyframe2D(0.25f, Transform2D(Position2D(limb.upper, 0.0f), Scale2D(1.0f, 1.0f), 25.0f)),
+                           BoneKeyframe2D(0.5f, Transform2D(Position2D(limb.upper, 0.0f))),
+                           BoneKeyframe2D(0.75f, Transform2D(Position2D(limb.upper, 0.0f), Scale2D(1.0f, 1.0f), 25.0f)),
+                           BoneKeyframe2D(1.0f, Transform2D(Position2D(limb.upper, 0.0f)))});
+  }
+  walk->addTrack(1, {BoneKeyframe2D(0.0f, Transform2D(Position2D(0.0f, -30.0f))),
+                     BoneKeyframe2D(0.25f, Transform2D(Position2D(0.0f, -32.0f), Scale2D(1.0f, 1.0f), 3.0f)),
+                     BoneKeyframe2D(0.5f, Transform2D(Position2D(0.0f, -30.0f))),
+                     BoneKeyframe2D(0.75f, Transform2D(Position2D(0.0f, -32.0f), Scale2D(1.0f, 1.0f), -3.0f)),
+                     BoneKeyframe2D(1.0f, Transform2D(Position2D(0.0f, -30.0f)))});
+
+  SkinnedMeshBuilder2D builder(*skeleton);
+  builder.addPart(skeleton->findBone("hips"), Vector2(-10.0f, -6.0f), Vector2(10.0f, 6.0f), 0.0f, 1.0f, 0.25f, 0.75f);
+  builder.addPart(skeleton->findBone("torso"), Vector2(-12.0f, -24.0f), Vector2(12.0f, 30.0f), 0.25f, 1.0f, 0.5f, 0.5f);
+  builder.addPart(skeleton->findBone("head"), Vector2(-10.0f, -20.0f), Vector2(10.0f, 0.0f), 0.5f, 1.0f, 0.75f, 0.75f);
+  for (const Limb &limb : limbs)
+  {
+    std::string name = limb.name;
+    BoneIndex upper = skeleton->findBone(name + "Upper");
+    BoneIndex lower = skeleton->findBone(name + "Lower");
+    builder.addPart(skeleton->findBone(name + "End"), Vector2(0.0f, -4.0f), Vector2(8.0f, 4.0f), 0.75f, 1.0f, 1.0f, 0.75f);
+
+    // Twelve rows along the limb, blending from the upper to the lower bone around the joint
+    const Affine2D &bind = skeleton->getBindWorld(upper);
+    const int rows = 12;
+    float length = limb.upper + limb.lower;
+    for (int row = 0; row < rows; ++row)
+    {
+      float along = length * row / (rows - 1);
+      float weight = std::min(std::max((limb.upper + 4.0f - along) / 8.0f, 0.0f), 1.0f);
+      float v = 0.5f - 0.5f * row / (rows - 1);
+      uint32_t left = builder.addVertex(bind.apply(Vector2(along, -3.0f)), Vector2(0.0f, v), upper, lower, weight);
+      uint32_t right = builder.addVertex(bind.apply(Vector2(along, 3.0f)), Vector2(0.125f, v), upper, lower, weight);
+      if (row > 0)
+      {
+        builder.addTriangle(left - 2, right - 2, right);
+        builder.addTriangle(left - 2, right, left);
+      }
+    }
+  }
+
+  return {skeleton, builder.build(), walk};
+}
+
+static void registerNameBenchmarks(MicroBench &bench)
+{
+  // Find the newest of N root children: a string compare over the children
+  // (lookup before names were indexed) against the scene's name index, by
+  // interned id and by string
+  bench.add("NodeName::scanChildren", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    addNamedChildren(scene, state.getArgument());
+    std::string target = "Node" + std::to_string(state.getArgument() - 1);
+
+    while (state.keepRunning())
+    {
+      Node *found = nullptr;
+      for (const auto &child : scene.getRoot()->getChildren())
+      {
+        if (child->getName() == target)
+        {
+          found = child.get();
+          break;
+        }
+      }
+      doNotOptimize(found);
+    } }, {16, 1024});
+
+  bench.add("NodeName::findNodeById", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    addNamedChildren(scene, state.getArgument());
+    StringId target = StringTable::getInstance().intern("Node" + std::to_string(state.getArgument() - 1));
+
+    while (state.keepRunning())
+      doNotOptimize(scene.findNode(target)); }, {16, 1024});
+
+  bench.add("NodeName::findNodeByName", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    addNamedChildren(scene, state.getArgument());
+    std::string target = "Node" + std::to_string(state.getArgument() - 1);
+
+    while (state.keepRunning())
+      doNotOptimize(scene.findNode(target)); }, {16, 1024});
+
+  // Interning a name that is already in the table, as setName and scene
+  // loading do for repeated names
+  bench.add("StringTable::intern", [](MicroState &state)
+            {
+    StringTable &strings = StringTable::getInstance();
+    std::vector<std::string> names;
+    for (int i = 0; i < 64; ++i)
+    {
+      names.push_back("Enemy" + std::to_string(i));
+      strings.intern(names.back());
+    }
+
+    size_t next = 0;
+    while (state.keepRunning())
+      doNotOptimize(strings.intern(names[next++ & 63])); });
+
+  // Resolve a four-segment path; each level has 32 children
+  bench.add("Scene::findPath", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    Node *parent = scene.getRoot();
+    const char *levels[] = {"Level", "Layer", "Group", "Target"};
+    for (const char *level : levels)
+    {
+      Node *next = nullptr;
+      for (int i = 0; i < 32; ++i)
+      {
+        bool onPath = i == 31;
+        auto child = std::make_unique<Rectangle>(onPath ? std::string(level) : level + std::to_string(i), 0.0f, 0.0f);
+        if (onPath)
+          next = child.get();
+        parent->addChild(std::move(child));
+      }
+      parent = next;
+    }
+
+    while (state.keepRunning())
+      doNotOptimize(scene.findPath("Level/Layer/Group/Target")); });
+}
+
+// 100 sprites among N unrelated rectangles, all root children
+static void addQueryNodes(Scene &scene, int64_t rectangles)
+{
+  auto arenaScope = scene.useNodeArena();
+  for (int64_t i = 0; i < rectangles; ++i)
+    scene.addNode(std::make_unique<Rectangle>("Rect" + std::to_string(i), 0.0f, 0.0f));
+  for (int i = 0; i < 100; ++i)
+    scene.addNode(std::make_unique<Sprite2D>("Sprite" + std::to_string(i), 0.0f, 0.0f, 1.0f, 1.0f, "", 1, 1));
+}
+
+// Depth-first visit of every node, casting each one the way code looked for
+// a type before the per-type buckets
+static void visitWithDynamicCast(Node *node, size_t &found)
+{
+  if (dynamic_cast<Sprite2D *>(node))
+    found++;
+  for (const auto &child : node->getChildren())
+    visitWithDynamicCast(child.get(), found);
+}
+
+static void registerQueryBenchmarks(MicroBench &bench)
+{
+  // Visit the 100 sprites of a scene that also holds 0 or 100k rectangles:
+  // the tree's type buckets against a dynamic_cast walk of the whole tree
+  bench.add("NodeQuery::each", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    addQueryNodes(scene, state.getArgument());
+
+    while (state.keepRunning())
+    {
+      size_t found = 0;
+      scene.each<Sprite2D>([&](Sprite2D *) { found++; });
+      doNotOptimize(found);
+    } }, {0, 100000});
+
+  bench.add("NodeQuery::dynamicCastWalk", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    addQueryNodes(scene, state.getArgument());
+
+    while (state.keepRunning())
+    {
+      size_t found = 0;
+      visitWithDynamicCast(scene.getRoot(), found);
+      doNotOptimize(found);
+    } }, {0, 100000});
+}
+
+static void registerLoggerBenchmarks(MicroBench &bench)
+{
+  // The logging cost a frame that reports 100 events adds to the calling
+  // thread. Argument 0 formats and writes each line itself and flushes it,
+  // like the std::cout << ... << std::endl prints the Logger replaced; 1
+  // queues them on the Logger, whose thread formats and writes them.
+  bench.add("Logger::frame", [](MicroState &state)
+            {
+    std::FILE *file = std::tmpfile();
+    if (!file)
+    {
+      std::cerr << "Logger::frame: cannot create a temporary file" << std::endl;
+      return;
+    }
+    Logger &logger = Logger::getInstance();
+    logger.setOutput(file);
+    logger.setLevel(LogCategory::Scene, LogLevel::Info);
+    bool async = state.getArgument() != 0;
+
+    int frame = 0;
+    while (state.keepRunning())
+    {
+      for (int i = 0; i < 100; ++i)
+      {
+        if (async)
+        {
+          LOG_INFO(Scene, "Node {} moved to {}, {}", i, frame, i * 2);
+        }
+        else
+        {
+          std::fprintf(file, "[INFO] [Scene] Node %d moved to %d, %d\n", i, frame, i * 2);
+          std::fflush(file);
+        }
+      }
+      frame++;
+    }
+
+    // Finish writing before the file goes away
+    logger.flush();
+    logger.setOutput(stdout);
+    logger.setLevel(LogCategory::Scene, LogLevel::Warning);
+    std::fclose(file); }, {0, 1});
+
+  // The same 100 calls below the runtime level: one relaxed load each
+  bench.add("Logger::frameFiltered", [](MicroState &state)
+            {
+    int frame = 0;
+    while (state.keepRunning())
+    {
+      for (int i = 0; i < 100; ++i)
+        LOG_INFO(Scene, "Node {} moved to {}, {}", i, frame, i * 2);
+      frame++;
+    } });
+}
+
+// Run body with the profiler in the given mode: 0 or 1 idle, 2 recording
+// into per-thread rings (so memory stays bounded however long it runs)
+template <typename Fn>
+static void withProfilerMode(int64_t mode, Fn &&body)
+{
+  Profiler &profiler = Profiler::getInstance();
+  if (mode == 2)
+    profiler.setRingCapacity(65536);
+  body();
+  if (mode == 2)
+    profiler.setRingCapacity(0);
+}
+
+static void registerProfilerBenchmarks(MicroBench &bench)
+{
+  // A trivial body: argument 0 without a zone, 1 inside a PROFILE_SCOPE while
+  // no capture runs (the always-on cost), 2 inside one while recording
+  bench.add("Profiler::scope", [](MicroState &state)
+            {
+    int64_t mode = state.getArgument();
+    withProfilerMode(mode, [&]
+                     {
+      uint32_t value = 1;
+      while (state.keepRunning())
+      {
+        if (mode == 0)
+        {
+          value = value * 1664525u + 1013904223u;
+          doNotOptimize(value);
+        }
+        else
+        {
+          PROFILE_SCOPE("MicroBench::zone");
+          value = value * 1664525u + 1013904223u;
+          doNotOptimize(value);
+        }
+      } }); }, {0, 1, 2});
+
+  // Updating 10k nodes, each in its own zone: idle (1) against recording (2)
+  bench.add("Profiler::sceneUpdate", [](MicroState &state)
+            {
+    Scene scene("MicroBench");
+    addNamedChildren(scene, 10000);
+    withProfilerMode(state.getArgument(), [&]
+                     {
+      while (state.keepRunning())
+      {
+        scene.update(1.0f / 60.0f);
+        clobberMemory();
+      } }); }, {1, 2});
+}
+
+static void registerFrameAllocatorBenchmarks(MicroBench &bench)
+{
+  // A frame's transient query results: 1000 lists of 8 node pointers built
+  // and dropped. Argument 0 uses std::vector on the heap, 1 FrameVector on
+  // the FrameAllocator (one beginFrame per iteration).
+  bench.add("FrameAllocator::frameScratch", [](MicroState &state)
+            {
+    bool useFrame = state.getArgument() != 0;
+    FrameAllocator &frames = FrameAllocator::getInstance();
+    Node *nodes[8] = {};
+
+    while (state.keepRunning())
+    {
+      size_t total = 0;
+      if (useFrame)
+      {
+        frames.beginFrame();
+        for (int list = 0; list < 1000; ++list)
+        {
+          FrameVector<Node *> results;
+          for (Node *node : nodes)
+            results.push_back(node);
+          total += results.size();
+        }
+      }
+      else
+      {
+        for (int list = 0; list < 1000; ++list)
+        {
+          std::vector<Node *> results;
+          for (Node *node : nodes)
+            results.push_back(node);
+          total += results.size();
+        }
+      }
+      doNotOptimize(total);
+    } }, {0, 1});
+
+  // One 64-byte request: malloc/free (0) against a FrameArena bump (1),
+  // reset every 4096 requests so it stays within its buffer
+  bench.add("FrameArena::allocate", [](MicroState &state)
+            {
+    bool useArena = state.getArgument() != 0;
+    FrameArena arena(4096 * 64);
+    size_t count = 0;
+
+    while (state.keepRunning())
+    {
+      if (useArena)
+      {
+        doNotOptimize(arena.allocate(64));
+        if (++count == 4096)
+        {
+          arena.reset();
+          count = 0;
+        }
+      }
+      else
+      {
+        void *memory = std::malloc(64);
+        doNotOptimize(memory);
+        std::free(memory);
+      }
+    } }, {0, 1});
+}
+
+static void registerEcsBenchmarks(MicroBench &bench)
+{
+  // One frame of moving and animating every sprite: the World's column
+  // systems against Sprite2D nodes in a scene doing the same work (position
+  // setter per mover, animators batched by the tree's AnimationSystem)
+  bench.add("EcsVsNodes::world", [](MicroState &state)
+            {
+    const ComponentMask mask = componentBit(ComponentType::Transform) | componentBit(ComponentType::Velocity) |
+                               componentBit(ComponentType::SpriteFrame) | componentBit(ComponentType::Animation);
+    size_t count = static_cast<size_t>(state.getArgument());
+    World world;
+    world.reserve(mask, count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      Entity entity = world.createEntity(mask);
+      world.get<Transform2D>(entity)->position = Position2D(static_cast<float>(i % 1280), static_cast<float>(i % 720));
+      *world.get<Velocity2D>(entity) = Velocity2D(static_cast<float>(i % 7) - 3.0f, static_cast<float>(i % 5) - 2.0f);
+      *world.get<SpriteFrame>(entity) = SpriteFrame(1, 128, 64, 8, 4);
+      *world.get<AnimationState>(entity) = AnimationState(8, 8, 16.0f, true);
+    }
+
+    while (state.keepRunning())
+    {
+      EcsSystems::integrateVelocity(world, 1.0f / 60.0f);
+      EcsSystems::advanceAnimations(world, 1.0f / 60.0f);
+      clobberMemory();
+    } }, {10000, 1000000});
+
+  bench.add("EcsVsNodes::sprites", [](MicroState &state)
+            {
+    auto clips = std::make_shared<AnimationClipSet>();
+    AnimationClipHandle run = clips->addClip("Run", {AnimationFrame(8, 8)}, 16.0f, true);
+
+    size_t count = static_cast<size_t>(state.getArgument());
+    Scene scene("MicroBench");
+    auto arenaScope = scene.useNodeArena();
+    std::vector<Sprite2D *> sprites;
+    std::vector<Velocity2D> velocities;
+    sprites.reserve(count);
+    velocities.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto sprite = std::make_unique<Sprite2D>("Sprite" + std::to_string(i), static_cast<float>(i % 1280),
+                                               static_cast<float>(i % 720), 1.0f, 1.0f, "", 8, 4);
+      sprite->setAnimationClips(clips);
+      sprite->playAnimation(run);
+      sprites.push_back(sprite.get());
+      velocities.emplace_back(static_cast<float>(i % 7) - 3.0f, static_cast<float>(i % 5) - 2.0f);
+      scene.addNode(std::move(sprite));
+    }
+
+    while (state.keepRunning())
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        const Position2D &position = sprites[i]->getPosition();
+        sprites[i]->setPosition(Position2D(position.x + velocities[i].x * (1.0f / 60.0f),
+                                           position.y + velocities[i].y * (1.0f / 60.0f)));
+      }
+      scene.update(1.0f / 60.0f);
+      clobberMemory();
+    } }, {10000, 1000000});
+}
+
+static void registerSkeletonBenchmarks(MicroBench &bench)
+{
+  // A crowd of walking cutout characters sharing one skeleton, mesh, walk and
+  // texture: every pose sampled, composed and skinned, then drawn through the
+  // null driver (one textured-triangle call each)
+  bench.add("SkinnedSprite2D::frame", [](MicroState &state)
+            {
+    auto &renderDevice = RenderDevice::getInstance();
+    if (!renderDevice.getDriver())
+    {
+      renderDevice.setDriver(std::make_unique<NullRenderDriver>());
+      renderDevice.initialize(nullptr);
+    }
+
+    CutoutCharacter character = makeCutoutCharacter();
+    std::shared_ptr<TextureData> texture = createTextureData(1, 1, "\xff\xff\xff\xff");
+    Scene scene("MicroBench");
+    auto arenaScope = scene.useNodeArena();
+    std::vector<std::unique_ptr<SkinnedSprite2D>> crowd;
+    for (int64_t i = 0; i < state.getArgument(); ++i)
+    {
+      crowd.push_back(std::make_unique<SkinnedSprite2D>("Walker", Position2D(static_cast<float>(i % 40) * 32.0f, static_cast<float>(i / 40) * 28.0f)));
+      crowd.back()->setSkeleton(character.skeleton, character.mesh);
+      crowd.back()->setTexture(texture);
+      crowd.back()->getPose().setSpeed(0.8f + static_cast<float>(i % 5) * 0.1f);
+      crowd.back()->play(character.walk, static_cast<float>(i % 97) / 97.0f);
+    }
+
+    while (state.keepRunning())
+    {
+      for (auto &walker : crowd)
+      {
+        walker->update(1.0f / 60.0f);
+        walker->render();
+      }
+      clobberMemory();
+    } }, {1000});
+
+  // The skinning share of the above: the same mesh into each character's buffer
+  bench.add("SkinnedMesh2D::skin", [](MicroState &state)
+            {
+    CutoutCharacter character = makeCutoutCharacter();
+    const SkinnedMesh2D &mesh = *character.mesh;
+    std::vector<Affine2D> matrices(character.skeleton->getBoneCount(), Affine2D(0.9f, 0.1f, -0.1f, 0.9f, 3.0f, 4.0f));
+    std::vector<std::vector<float>> positions(static_cast<size_t>(state.getArgument()), std::vector<float>(2 * mesh.getVertexCount()));
+
+    while (state.keepRunning())
+    {
+      for (auto &buffer : positions)
+        mesh.skin(matrices.data(), buffer.data());
+      clobberMemory();
+    } }, {1000});
+}
+
+// Fountain holding about `particles` live at steady state: lifetimes of 1-2 s
+// emitted at count / 1.5 per second, warmed up past the longest lifetime
+static std::unique_ptr<ParticleEmitter2D> makeFountain(size_t particles)
+{
+  ParticleEmitterSettings settings;
+  settings.maxParticles = particles;
+  settings.rate = static_cast<float>(particles) / 1.5f;
+  settings.minLifetime = 1.0f;
+  settings.maxLifetime = 2.0f;
+  settings.minSpeed = 100.0f;
+  settings.maxSpeed = 300.0f;
+  settings.spread = 25.0f;
+  settings.spawnExtent = Vector2(20.0f, 2.0f);
+  settings.gravity = Vector2(0.0f, 250.0f);
+  settings.damping = 0.1f;
+  settings.colorVariation = 0.3f;
+  auto fountain = std::make_unique<ParticleEmitter2D>("Fountain", Position2D(640.0f, 600.0f), settings);
+  for (int i = 0; i < 25; ++i)
+    fountain->update(0.1f);
+  return fountain;
+}
+
+static void registerParticleBenchmarks(MicroBench &bench)
+{
+  // One 60 fps frame of a steady fountain: integrate, swap-remove the dead
+  // (about 1/90 of them), emit their replacements and submit one draw to the
+  // null driver. The 60 fps budget is 16.6 ms per frame.
+  bench.add("ParticleEmitter2D::frame", [](MicroState &state)
+            {
+    auto &renderDevice = RenderDevice::getInstance();
+    if (!renderDevice.getDriver())
+    {
+      renderDevice.setDriver(std::make_unique<NullRenderDriver>());
+      renderDevice.initialize(nullptr);
+    }
+
+    auto fountain = makeFountain(static_cast<size_t>(state.getArgument()));
+    while (state.keepRunning())
+    {
+      fountain->update(1.0f / 60.0f);
+      fountain->render();
+      clobberMemory();
+    } }, {1000000});
+
+  // The same frame split across a worker per extra hardware thread (serial on one core)
+  bench.add("ParticleEmitter2D::frameThreaded", [](MicroState &state)
+            {
+    WorkerPool &pool = WorkerPool::getInstance();
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    pool.setThreadCount(hardwareThreads > 1 ? hardwareThreads - 1 : 0);
+
+    auto fountain = makeFountain(static_cast<size_t>(state.getArgument()));
+    fountain->setParallel(true);
+    while (state.keepRunning())
+    {
+      fountain->update(1.0f / 60.0f);
+      fountain->render();
+      clobberMemory();
+    }
+    pool.setThreadCount(0); }, {1000000});
+}
+
+// 4096 x 4096 tiles of 16 units from a 16 x 16 atlas: hashed terrain with one
+// cell in eight left empty. Built once and shared by the tile map benchmarks.
+static TileMap2D &levelMap()
+{
+  static std::unique_ptr<TileMap2D> map;
+  if (!map)
+  {
+    map = std::make_unique<TileMap2D>("Level", Position2D(), 4096, 4096, 16.0f);
+    map->setTileSet(nullptr, 16, 16);
+    for (int y = 0; y < 4096; ++y)
+    {
+      for (int x = 0; x < 4096; ++x)
+      {
+        uint32_t hash = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u;
+        hash ^= hash >> 13;
+        map->setTile(x, y, (hash & 7) == 0 ? EmptyTile : static_cast<TileId>(1 + (hash >> 3) % 256));
+      }
+    }
+  }
+  return *map;
+}
+
+// The level written out and streamed back through a memory-mapped file
+static TileMap2D &streamedLevelMap()
+{
+  static std::unique_ptr<TileMap2D> map;
+  if (!map)
+  {
+    std::string path = (std::filesystem::temp_directory_path() / "microbench_level.tmap").string();
+    map = std::make_unique<TileMap2D>("StreamedLevel");
+    if (!levelMap().saveLevel(path) || !map->openLevel(path))
+      std::exit(1);
+    map->setTileSet(nullptr, 16, 16);
+    std::remove(path.c_str()); // The mapping keeps the data alive
+  }
+  return *map;
+}
+
+// One frame of a 1280x720 camera panning diagonally across the map at 240
+// screen pixels per second (argument: zoom in percent): cull, rebuild the
+// chunks scrolling into view and submit one draw per visible chunk
+static void scrollTileMap(MicroState &state, TileMap2D &map)
+{
+  auto &renderDevice = RenderDevice::getInstance();
+  if (!renderDevice.getDriver())
+  {
+    renderDevice.setDriver(std::make_unique<NullRenderDriver>());
+    renderDevice.initialize(nullptr);
+  }
+
+  // Drop the chunks cached by earlier runs, then build the first view untimed
+  float zoom = static_cast<float>(state.getArgument()) / 100.0f;
+  Camera camera(1280, 720, Position2D(4000.0f, 3000.0f), zoom);
+  map.setTileSize(16.0f);
+  map.setView(camera.getLeft(), camera.getTop(), camera.getRight(), camera.getBottom());
+  map.render();
+
+  float extent = 4096.0f * 16.0f;
+  while (state.keepRunning())
+  {
+    camera.move(4.0f / zoom, 2.0f / zoom);
+    if (camera.getRight() > extent || camera.getBottom() > extent)
+      camera.setPosition(4000.0f, 3000.0f);
+    map.setView(camera.getLeft(), camera.getTop(), camera.getRight(), camera.getBottom());
+    map.render();
+    clobberMemory();
+  }
+}
+
+static void registerTileMapBenchmarks(MicroBench &bench)
+{
+  bench.add("TileMap2D::scroll", [](MicroState &state)
+            { scrollTileMap(state, levelMap()); }, {100, 25});
+  bench.add("TileMap2D::scrollStreamed", [](MicroState &state)
+            { scrollTileMap(state, streamedLevelMap()); }, {100, 25});
+}
+
+static void printUsage()
+{
+  std::cout << "Usage: glfw_window_test_microbench [options]\n"
+               "  --filter TEXT         Only run benchmarks whose name contains TEXT\n"
+               "  --samples N           Measured samples per benchmark (default 15)\n"
+               "  --warmup N            Discarded samples before measuring (default 3)\n"
+               "  --min-sample-ms MS    Minimum duration of one sample (default 2)\n"
+               "  --output PATH         Write results as JSON\n"
+               "  --baseline PATH       Compare against a previous --output file\n"
+               "  --threshold R         Relative change treated as noise (default 0.03)\n"
+               "  --fail-on-regression  Exit with 2 if a benchmark got significantly slower\n"
+               "  --list                List the benchmarks\n";
+}
+
+int main(int argc, char **argv)
+{
+  MicroBench bench;
+  MicroBench::Options &options = bench.getOptions();
+  std::string outputPath;
+  std::string baselinePath;
+  bool failOnRegression = false;
+  bool listOnly = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--help" || arg == "-h")
+    {
+      printUsage();
+      return 0;
+    }
+    else if (arg == "--list")
+      listOnly = true;
+    else if (arg == "--fail-on-regression")
+      failOnRegression = true;
+    else if (!hasValue)
+    {
+      std::cerr << "Missing value for " << arg << std::endl;
+      printUsage();
+      return 1;
+    }
+    else if (arg == "--filter")
+      options.filter = argv[++i];
+    else if (arg == "--samples")
+      options.samples = std::atoi(argv[++i]);
+    else if (arg == "--warmup")
+      options.warmupSamples = std::atoi(argv[++i]);
+    else if (arg == "--min-sample-ms")
+      options.minSampleMs = std::atof(argv[++i]);
+    else if (arg == "--output")
+      outputPath = argv[++i];
+    else if (arg == "--baseline")
+      baselinePath = argv[++i];
+    else if (arg == "--threshold")
+      options.threshold = std::atof(argv[++i]);
+    else
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      printUsage();
+      return 1;
+    }
+  }
+
+  if (options.samples < 2)
+  {
+    std::cerr << "--samples must be at least 2" << std::endl;
+    return 1;
+  }
+
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  registerInputBenchmarks(bench);
+  registerAnimationBenchmarks(bench);
+  registerMathBenchmarks(bench);
+  registerNodeBenchmarks(bench);
+  registerNameBenchmarks(bench);
+  registerQueryBenchmarks(bench);
+  registerLoggerBenchmarks(bench);
+  registerProfilerBenchmarks(bench);
+  registerFrameAllocatorBenchmarks(bench);
+  registerEcsBenchmarks(bench);
+  registerSkeletonBenchmarks(bench);
+  registerParticleBenchmarks(bench);
+  registerTileMapBenchmarks(bench);
+
+  if (listOnly)
+  {
+    for (const std::string &name : bench.getNames())
+      std::cout << name << std::endl;
+    return 0;
+  }
+
+  std::vector<MicroStats> baseline;
+  if (!baselinePath.empty() && !MicroBench::readJson(baselinePath, baseline))
+    return 1;
+  std::map<std::string, const MicroStats *> baselineByName;
+  for (const MicroStats &stats : baseline)
+    baselineByName[stats.name] = &stats;
+
+  std::vector<MicroStats> results = bench.runAll();
+
+  int regressions = 0;
+  std::printf("%-44s %12s %12s %8s %12s\n", "benchmark", "median ns", "mean ns", "cv", "iterations");
+  for (const MicroStats &stats : results)
+  {
+    std::printf("%-44s %12.2f %12.2f %7.1f%% %12llu", stats.name.c_str(), stats.median, stats.mean,
+                stats.cv() * 100.0, static_cast<unsigned long long>(stats.iterations));
+
+    auto it = baselineByName.find(stats.name);
+    if (it != baselineByName.end())
+    {
+      MicroComparison comparison = MicroBench::compare(*it->second, stats, options.threshold);
+      const char *verdict = !comparison.significant ? "same" : comparison.change > 0.0 ? "SLOWER" : "faster";
+      std::printf("  %+6.1f%% (t %+.1f) %s", comparison.change * 100.0, comparison.t, verdict);
+      if (comparison.significant && comparison.change > 0.0)
+        regressions++;
+    }
+    std::printf("\n");
+  }
+
+  if (!outputPath.empty())
+  {
+    if (!MicroBench::writeJson(outputPath, results))
+      return 1;
+    std::cout << "Results written to " << outputPath << std::endl;
+  }
+
+  Logger::getInstance().stop();
+
+  if (regressions > 0)
+  {
+    std::cout << regressions << " benchmark(s) significantly slower than the baseline" << std::endl;
+    if (failOnRegression)
+      return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,333 @@
+#pragma once
+
+// Small microbenchmark harness: calibrated iteration counts, warm-up,
+// repeated samples, summary statistics and a Welch t-test against a saved
+// baseline. Benchmarks are plain functions that loop over their MicroState;
+// pass results through doNotOptimize() so the work is not elided.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Keep a value (and everything it depends on) alive as far as the optimizer knows
+template <typename T>
+inline void doNotOptimize(T const &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void *sink;
+  sink = &value;
+#endif
+}
+
+// Force pending writes to memory
+inline void clobberMemory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : : "memory");
+#endif
+}
+
+// Passed to every benchmark run. Loop with `while (state.keepRunning())`:
+// the timer starts at the first call and stops when the loop ends, so setup
+// before the loop and teardown after it are not measured.
+class MicroState
+{
+private:
+  using Clock = std::chrono::steady_clock;
+
+  uint64_t iterations;
+  uint64_t remaining;
+  int64_t argument;
+  bool started;
+  Clock::time_point start;
+  Clock::time_point stop;
+  Clock::duration paused;
+  Clock::time_point pauseStart;
+
+public:
+  MicroState(uint64_t iterationCount, int64_t arg)
+      : iterations(iterationCount), remaining(iterationCount), argument(arg), started(false), paused(0) {}
+
+  bool keepRunning()
+  {
+    if (!started)
+    {
+      started = true;
+      start = Clock::now();
+    }
+    if (remaining > 0)
+    {
+      remaining--;
+      return true;
+    }
+    stop = Clock::now();
+    return false;
+  }
+
+  uint64_t getIterations() const { return iterations; }
+  int64_t getArgument() const { return argument; }
+
+  // Exclude per-iteration setup (costs two clock reads, use sparingly)
+  void pauseTiming() { pauseStart = Clock::now(); }
+  void resumeTiming() { paused += Clock::now() - pauseStart; }
+
+  // False if the benchmark returned without finishing its loop
+  bool isComplete() const { return started && remaining == 0; }
+
+  double elapsedNs() const
+  {
+    return std::chrono::duration<double, std::nano>(stop - start - paused).count();
+  }
+};
+
+struct MicroStats
+{
+  std::string name;
+  int samples = 0;
+  uint64_t iterations = 0; // Per sample
+  double median = 0.0;     // Nanoseconds per iteration
+  double mean = 0.0;
+  double stddev = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+
+  double cv() const { return mean > 0.0 ? stddev / mean : 0.0; }
+};
+
+// Outcome of comparing a result against its baseline
+struct MicroComparison
+{
+  double change = 0.0; // Relative change of the mean, +0.10 = 10% slower
+  double t = 0.0;      // Welch t statistic
+  bool significant = false;
+};
+
+struct MicroBenchOptions
+{
+  int warmupSamples = 3;
+  int samples = 15;
+  double minSampleMs = 2.0; // Iterations grow until one sample takes this long
+  double threshold = 0.03;  // Relative change below this is reported as noise
+  std::string filter;
+};
+
+class MicroBench
+{
+public:
+  using Function = std::function<void(MicroState &)>;
+  using Options = MicroBenchOptions;
+
+private:
+  struct Entry
+  {
+    std::string name;
+    Function function;
+    int64_t argument;
+  };
+
+  std::vector<Entry> entries;
+  Options options;
+
+  static double runOnce(const Function &function, uint64_t iterations, int64_t argument)
+  {
+    MicroState state(iterations, argument);
+    function(state);
+    return state.isComplete() ? state.elapsedNs() : -1.0;
+  }
+
+public:
+  explicit MicroBench(const Options &benchOptions = Options()) : options(benchOptions) {}
+
+  Options &getOptions() { return options; }
+
+  // Register name, or name/argument for every argument
+  void add(const std::string &name, Function function, std::vector<int64_t> arguments = {})
+  {
+    if (arguments.empty())
+    {
+      entries.push_back({name, function, 0});
+      return;
+    }
+    for (int64_t argument : arguments)
+    {
+      entries.push_back({name + "/" + std::to_string(argument), function, argument});
+    }
+  }
+
+  std::vector<std::string> getNames() const
+  {
+    std::vector<std::string> names;
+    for (const Entry &entry : entries)
+      names.push_back(entry.name);
+    return names;
+  }
+
+  std::vector<MicroStats> runAll() const;
+
+  static MicroComparison compare(const MicroStats &baseline, const MicroStats &current, double threshold);
+
+  // JSON in/out (the reader only understands what writeJson produces)
+  static bool writeJson(const std::string &path, const std::vector<MicroStats> &results);
+  static bool readJson(const std::string &path, std::vector<MicroStats> &results);
+};
+
+// Implementation
+inline std::vector<MicroStats> MicroBench::runAll() const
+{
+  std::vector<MicroStats> results;
+  for (const Entry &entry : entries)
+  {
+    if (!options.filter.empty() && entry.name.find(options.filter) == std::string::npos)
+      continue;
+
+    // Calibrate: grow the iteration count until one sample is long enough to time
+    uint64_t iterations = 1;
+    double minNs = options.minSampleMs * 1e6;
+    bool complete = true;
+    while (true)
+    {
+      double ns = runOnce(entry.function, iterations, entry.argument);
+      if (ns < 0.0)
+      {
+        std::cerr << "MicroBench: " << entry.name << " returned before its loop finished" << std::endl;
+        complete = false;
+        break;
+      }
+      if (ns >= minNs || iterations >= (1ull << 40))
+        break;
+      uint64_t scale = ns > 0.0 ? static_cast<uint64_t>(minNs / ns * 1.2) : 2;
+      iterations *= std::clamp<uint64_t>(scale, 2, 16);
+    }
+
+    if (!complete)
+      continue;
+
+    for (int i = 0; i < options.warmupSamples; ++i)
+    {
+      runOnce(entry.function, iterations, entry.argument);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.samples);
+    for (int i = 0; i < options.samples; ++i)
+    {
+      samples.push_back(runOnce(entry.function, iterations, entry.argument) / iterations);
+    }
+
+    MicroStats stats;
+    stats.name = entry.name;
+    stats.samples = static_cast<int>(samples.size());
+    stats.iterations = iterations;
+    std::sort(samples.begin(), samples.end());
+    size_t count = samples.size();
+    stats.median = count % 2 ? samples[count / 2] : 0.5 * (samples[count / 2 - 1] + samples[count / 2]);
+    stats.min = samples.front();
+    stats.max = samples.back();
+    for (double sample : samples)
+      stats.mean += sample;
+    stats.mean /= count;
+    for (double sample : samples)
+      stats.stddev += (sample - stats.mean) * (sample - stats.mean);
+    stats.stddev = count > 1 ? std::sqrt(stats.stddev / (count - 1)) : 0.0;
+
+    results.push_back(stats);
+  }
+  return results;
+}
+
+inline MicroComparison MicroBench::compare(const MicroStats &baseline, const MicroStats &current, double threshold)
+{
+  MicroComparison result;
+  if (baseline.mean <= 0.0 || baseline.samples < 2 || current.samples < 2)
+    return result;
+
+  result.change = (current.mean - baseline.mean) / baseline.mean;
+  double variance = baseline.stddev * baseline.stddev / baseline.samples +
+                    current.stddev * current.stddev / current.samples;
+  result.t = variance > 0.0 ? (current.mean - baseline.mean) / std::sqrt(variance) : 0.0;
+
+  // |t| > 2.1 is roughly p < 0.05 for the sample counts used here
+  result.significant = std::fabs(result.change) >= threshold && (variance == 0.0 || std::fabs(result.t) > 2.1);
+  return result;
+}
+
+inline bool MicroBench::writeJson(const std::string &path, const std::vector<MicroStats> &results)
+{
+  std::ofstream file(path);
+  if (!file)
+  {
+    std::cerr << "MicroBench: cannot open " << path << " for writing" << std::endl;
+    return false;
+  }
+
+  file << "{\n  \"benchmarks\": [\n";
+  char line[512];
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const MicroStats &stats = results[i];
+    std::snprintf(line, sizeof(line),
+                  "    {\"name\": \"%s\", \"samples\": %d, \"iterations\": %llu, \"median\": %.4f, "
+                  "\"mean\": %.4f, \"stddev\": %.4f, \"min\": %.4f, \"max\": %.4f}%s\n",
+                  stats.name.c_str(), stats.samples, static_cast<unsigned long long>(stats.iterations),
+                  stats.median, stats.mean, stats.stddev, stats.min, stats.max,
+                  i + 1 < results.size() ? "," : "");
+    file << line;
+  }
+  file << "  ]\n}\n";
+  return static_cast<bool>(file);
+}
+
+inline bool MicroBench::readJson(const std::string &path, std::vector<MicroStats> &results)
+{
+  std::ifstream file(path);
+  if (!file)
+  {
+    std::cerr << "MicroBench: cannot open " << path << std::endl;
+    return false;
+  }
+
+  auto number = [](const std::string &line, const char *key, double &value)
+  {
+    std::string pattern = std::string("\"") + key + "\": ";
+    size_t pos = line.find(pattern);
+    if (pos == std::string::npos)
+      return false;
+    value = std::atof(line.c_str() + pos + pattern.size());
+    return true;
+  };
+
+  std::string line;
+  while (std::getline(file, line))
+  {
+    size_t namePos = line.find("\"name\": \"");
+    if (namePos == std::string::npos)
+      continue;
+    size_t nameStart = namePos + 9;
+    size_t nameEnd = line.find('"', nameStart);
+
+    MicroStats stats;
+    stats.name = line.substr(nameStart, nameEnd - nameStart);
+    double samples = 0.0, iterations = 0.0;
+    number(line, "samples", samples);
+    number(line, "iterations", iterations);
+    number(line, "median", stats.median);
+    number(line, "mean", stats.mean);
+    number(line, "stddev", stats.stddev);
+    number(line, "min", stats.min);
+    number(line, "max", stats.max);
+    stats.samples = static_cast<int>(samples);
+    stats.iterations = static_cast<uint64_t>(iterations);
+    results.push_back(stats);
+  }
+  return true;
+}
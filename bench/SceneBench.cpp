@@ -0,0 +1,228 @@
+// glfw_window_test_bench: runs procedural stress scenes headless against the
+// null render driver and writes the results as JSON.
+//
+//   glfw_window_test_bench [--output bench.json] [--frames 300] [--warmup 30]
+//                          [--scenario name]... [--perf]
+//   glfw_window_test_bench --sprites 20000 --sheets 4 --depth 10 --moving 0.5
+//                          --animated 1 [--flat-traversal] [--seed 7]
+//                          [--static-sprites 10000 [--cache-static]]
+
+#define ALLOCATION_TRACKER_IMPLEMENTATION
+#include "SceneBenchmark.h"
+#include "core/log/Logger.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void writeChannel(FILE *file, const char *name, const FrameChannelStats &stats)
+{
+  std::fprintf(file, "      \"%s\": {\"min\": %.4f, \"avg\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f},\n",
+               name, stats.min, stats.avg, stats.p50, stats.p95, stats.p99, stats.max);
+}
+
+static void writePerfPhase(FILE *file, const char *name, const PerfPhaseStats &stats, bool last)
+{
+  std::fprintf(file, "        \"%s\": {\"ipc\": %.3f, \"cyclesPerNode\": %.2f, \"l1dMissesPerNode\": %.3f, "
+                     "\"llcMissesPerNode\": %.4f, \"branchMissesPerNode\": %.3f}%s\n",
+               name, stats.ipc(), stats.perNode(PerfEvent::Cycles), stats.perNode(PerfEvent::L1DMisses),
+               stats.perNode(PerfEvent::LLCMisses), stats.perNode(PerfEvent::BranchMisses), last ? "" : ",");
+}
+
+static bool writeJson(const std::string &path, const std::vector<SceneBenchResult> &results)
+{
+  FILE *file = path == "-" ? stdout : std::fopen(path.c_str(), "w");
+  if (!file)
+  {
+    std::cerr << "Cannot open " << path << " for writing" << std::endl;
+    return false;
+  }
+
+  std::fprintf(file, "{\n  \"benchmark\": \"glfw_window_test_bench\",\n  \"driver\": \"Null\",\n  \"scenarios\": [\n");
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const SceneBenchResult &result = results[i];
+    const SceneBenchConfig &config = result.config;
+    std::fprintf(file, "    {\n      \"name\": \"%s\",\n", config.name.c_str());
+    std::fprintf(file, "      \"params\": {\"sprites\": %d, \"sheets\": %d, \"depth\": %d, \"moving\": %.2f, "
+                       "\"animated\": %.2f, \"flatTraversal\": %s, \"staticSprites\": %d, \"cacheStatic\": %s, "
+                       "\"seed\": %u, \"frames\": %d, \"warmupFrames\": %d},\n",
+                 config.sprites, config.sheets, config.depth, config.movingRatio, config.animatedRatio,
+                 config.flatTraversal ? "true" : "false", config.staticSprites, config.cacheStaticLayer ? "true" : "false",
+                 config.seed, config.frames, config.warmupFrames);
+    std::fprintf(file, "      \"nodes\": %zu,\n      \"setupMs\": %.3f,\n", result.nodeCount, result.setupMs);
+    writeChannel(file, "frameMs", result.frameMs);
+    writeChannel(file, "updateMs", result.updateMs);
+    writeChannel(file, "renderMs", result.renderMs);
+    std::fprintf(file, "      \"perFrame\": {\"drawCalls\": %.1f, \"textureSwitches\": %.1f, \"stateChanges\": %.1f, "
+                       "\"allocations\": %.2f, \"allocatedBytes\": %.1f},\n",
+                 result.perFrame(result.render.drawCalls), result.perFrame(result.render.textureSwitches),
+                 result.perFrame(result.render.stateChanges()), result.perFrame(result.allocations.allocations),
+                 result.perFrame(result.allocations.bytes));
+    std::fprintf(file, "      \"maxFrameAllocations\": %llu,\n",
+                 static_cast<unsigned long long>(result.maxFrameAllocations));
+    std::fprintf(file, "      \"perf\": {\n        \"available\": %s%s\n", result.perfAvailable ? "true" : "false",
+                 result.perfAvailable ? "," : "");
+    if (result.perfAvailable)
+    {
+      writePerfPhase(file, "update", result.perfUpdate, false);
+      writePerfPhase(file, "render", result.perfRender, true);
+    }
+    std::fprintf(file, "      }\n    }%s\n", i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(file, "  ]\n}\n");
+
+  bool ok = std::ferror(file) == 0;
+  if (file != stdout)
+    std::fclose(file);
+  return ok;
+}
+
+static void printUsage()
+{
+  std::cout << "Usage: glfw_window_test_bench [options]\n"
+               "  --output PATH        JSON output (default bench_results.json, - for stdout)\n"
+               "  --frames N           Frames per scenario (default 300)\n"
+               "  --warmup N           Frames excluded from the results (default 30)\n"
+               "  --scenario NAME      Run only this built-in scenario (repeatable)\n"
+               "  --list               List the built-in scenarios\n"
+               "  --perf               Sample hardware counters (Linux, if available)\n"
+               "Custom scenario (replaces the built-in ones):\n"
+               "  --sprites N --sheets N --depth N --moving R --animated R --flat-traversal --seed S\n"
+               "  --static-sprites N   Unchanging background under the sprites (--cache-static renders it offscreen)\n";
+}
+
+int main(int argc, char **argv)
+{
+  std::string outputPath = "bench_results.json";
+  int frames = 300;
+  int warmup = 30;
+  bool usePerf = false;
+  bool custom = false;
+  std::vector<std::string> selected;
+  SceneBenchConfig customConfig;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--help" || arg == "-h")
+    {
+      printUsage();
+      return 0;
+    }
+    else if (arg == "--list")
+    {
+      for (const auto &config : SceneBenchmark::defaultScenarios())
+        std::cout << config.name << std::endl;
+      return 0;
+    }
+    else if (arg == "--perf")
+      usePerf = true;
+    else if (arg == "--flat-traversal")
+    {
+      customConfig.flatTraversal = true;
+      custom = true;
+    }
+    else if (arg == "--cache-static")
+    {
+      customConfig.cacheStaticLayer = true;
+      custom = true;
+    }
+    else if (!hasValue)
+    {
+      std::cerr << "Missing value for " << arg << std::endl;
+      printUsage();
+      return 1;
+    }
+    else if (arg == "--output")
+      outputPath = argv[++i];
+    else if (arg == "--frames")
+      frames = std::atoi(argv[++i]);
+    else if (arg == "--warmup")
+      warmup = std::atoi(argv[++i]);
+    else if (arg == "--scenario")
+      selected.push_back(argv[++i]);
+    else if (arg == "--sprites")
+      customConfig.sprites = std::atoi(argv[++i]), custom = true;
+    else if (arg == "--sheets")
+      customConfig.sheets = std::atoi(argv[++i]), custom = true;
+    else if (arg == "--depth")
+      customConfig.depth = std::atoi(argv[++i]), custom = true;
+    else if (arg == "--moving")
+      customConfig.movingRatio = static_cast<float>(std::atof(argv[++i])), custom = true;
+    else if (arg == "--animated")
+      customConfig.animatedRatio = static_cast<float>(std::atof(argv[++i])), custom = true;
+    else if (arg == "--static-sprites")
+      customConfig.staticSprites = std::atoi(argv[++i]), custom = true;
+    else if (arg == "--seed")
+      customConfig.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    else
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      printUsage();
+      return 1;
+    }
+  }
+
+  if (frames <= warmup)
+  {
+    std::cerr << "--frames must be larger than --warmup" << std::endl;
+    return 1;
+  }
+
+  // Scene setup logs every sprite at debug level
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  std::vector<SceneBenchConfig> scenarios;
+  if (custom)
+  {
+    customConfig.frames = frames;
+    customConfig.warmupFrames = warmup;
+    scenarios.push_back(customConfig);
+  }
+  else
+  {
+    for (const auto &config : SceneBenchmark::defaultScenarios(frames, warmup))
+    {
+      bool wanted = selected.empty();
+      for (const auto &name : selected)
+        wanted = wanted || name == config.name;
+      if (wanted)
+        scenarios.push_back(config);
+    }
+    if (scenarios.empty())
+    {
+      std::cerr << "No scenario matched; see --list" << std::endl;
+      return 1;
+    }
+  }
+
+  SceneBenchmark benchmark(usePerf);
+  std::vector<SceneBenchResult> results;
+  for (const auto &config : scenarios)
+  {
+    SceneBenchResult result = benchmark.run(config);
+    std::printf("%-32s %7zu nodes  frame p50 %7.3f ms  p99 %7.3f ms  draws %8.0f  tex switches %8.0f  allocs/frame %6.2f\n",
+                config.name.c_str(), result.nodeCount, result.frameMs.p50, result.frameMs.p99,
+                result.perFrame(result.render.drawCalls), result.perFrame(result.render.textureSwitches),
+                result.perFrame(result.allocations.allocations));
+    if (result.perfAvailable)
+    {
+      std::printf("%-32s update IPC %.2f, L1D misses/node %.2f | render IPC %.2f, L1D misses/node %.2f\n", "",
+                  result.perfUpdate.ipc(), result.perfUpdate.perNode(PerfEvent::L1DMisses),
+                  result.perfRender.ipc(), result.perfRender.perNode(PerfEvent::L1DMisses));
+    }
+    results.push_back(result);
+  }
+
+  if (!writeJson(outputPath, results))
+    return 1;
+  if (outputPath != "-")
+    std::cout << "Results written to " << outputPath << std::endl;
+
+  Logger::getInstance().stop();
+  return 0;
+}
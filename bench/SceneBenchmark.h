@@ -0,0 +1,330 @@
+#pragma once
+
+// Procedural stress scenes and a headless frame loop shared by the bench
+// target and the performance regression tests. Include from exactly one
+// translation unit per executable (it pulls in the engine headers).
+
+#include "core/memory/AllocationTracker.h"
+#include "core/memory/FrameAllocator.h"
+#include "core/profile/FrameStats.h"
+#include "core/profile/PerfCounters.h"
+#include "core/render/NullRenderDriver.h"
+#include "core/render/RenderDevice.h"
+#include "nodes/Sprite2D.h"
+#include "scene/Scene.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Parameters of one stress scene
+struct SceneBenchConfig
+{
+  std::string name = "custom";
+  int sprites = 10000;
+  int sheets = 1;           // Distinct sprite sheets; 0 = one sheet per sprite
+  int depth = 1;            // Sprites per parent chain; 1 = every sprite under the root
+  float movingRatio = 0.5f; // Share of sprites moved every frame
+  float animatedRatio = 0.5f;
+  bool flatTraversal = false;
+  int staticSprites = 0;         // Background sprites that never change, on render layer 0 under the others (on layer 1)
+  bool cacheStaticLayer = false; // Render the background once into an offscreen target
+  uint32_t seed = 1;
+  int frames = 300;
+  int warmupFrames = 30;
+};
+
+// Measurements over the non-warm-up frames
+struct SceneBenchResult
+{
+  SceneBenchConfig config;
+  size_t nodeCount = 0;
+  double setupMs = 0.0;
+
+  FrameChannelStats frameMs = {};
+  FrameChannelStats updateMs = {};
+  FrameChannelStats renderMs = {};
+
+  // Deterministic counters, totals over the measured frames
+  RenderStats render;
+  AllocationCounts allocations;
+  uint64_t maxFrameAllocations = 0;
+
+  bool perfAvailable = false;
+  PerfPhaseStats perfUpdate;
+  PerfPhaseStats perfRender;
+
+  int measuredFrames() const { return config.frames - config.warmupFrames; }
+  double perFrame(uint64_t total) const
+  {
+    return measuredFrames() > 0 ? static_cast<double>(total) / measuredFrames() : 0.0;
+  }
+};
+
+class SceneBenchmark
+{
+private:
+  static constexpr int SheetColumns = 8;
+  static constexpr int SheetRows = 4;
+  static constexpr int FramePixels = 16;
+
+  NullRenderDriver *driver;
+  PerfFrameCounters perfCounters;
+  bool perfRequested;
+
+  struct Mover
+  {
+    Sprite2D *sprite;
+    float baseX;
+    float baseY;
+    float phase;
+  };
+
+  std::shared_ptr<TextureData> createSheet(std::mt19937 &rng) const;
+
+public:
+  // Installs a NullRenderDriver on the RenderDevice (once per process)
+  explicit SceneBenchmark(bool usePerfCounters = false);
+
+  NullRenderDriver &getDriver() { return *driver; }
+  bool hasPerfCounters() const { return perfCounters.isEnabled(); }
+
+  SceneBenchResult run(const SceneBenchConfig &config);
+
+  // Built-in scenarios covering sheet sharing, hierarchy shape, movement and animation
+  static std::vector<SceneBenchConfig> defaultScenarios(int frames = 300, int warmupFrames = 30);
+};
+
+// Implementation
+inline SceneBenchmark::SceneBenchmark(bool usePerfCounters) : driver(nullptr), perfRequested(usePerfCounters)
+{
+  auto &renderDevice = RenderDevice::getInstance();
+  driver = dynamic_cast<NullRenderDriver *>(renderDevice.getDriver());
+  if (!driver)
+  {
+    auto nullDriver = std::make_unique<NullRenderDriver>();
+    driver = nullDriver.get();
+    renderDevice.setDriver(std::move(nullDriver));
+    renderDevice.initialize(nullptr);
+  }
+
+  if (perfRequested)
+  {
+    perfCounters.enable();
+  }
+  AllocationTracker::getInstance().setFrameThread();
+}
+
+inline std::shared_ptr<TextureData> SceneBenchmark::createSheet(std::mt19937 &rng) const
+{
+  const int width = SheetColumns * FramePixels;
+  const int height = SheetRows * FramePixels;
+  std::vector<uint32_t> pixels(static_cast<size_t>(width) * height, 0xFF000000u | (rng() & 0x00FFFFFFu));
+  return createTextureData(width, height, pixels.data());
+}
+
+inline SceneBenchResult SceneBenchmark::run(const SceneBenchConfig &config)
+{
+  using Clock = std::chrono::steady_clock;
+  auto elapsedMs = [](Clock::time_point from, Clock::time_point to)
+  {
+    return std::chrono::duration<float, std::milli>(to - from).count();
+  };
+
+  SceneBenchResult result;
+  result.config = config;
+  std::mt19937 rng(config.seed);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+  // Build the scene
+  Clock::time_point setupStart = Clock::now();
+  Scene scene(config.name);
+  scene.setFlatTraversal(config.flatTraversal);
+
+  std::vector<std::shared_ptr<TextureData>> sheets;
+  int sheetCount = config.sheets > 0 ? config.sheets : config.sprites;
+  sheets.reserve(sheetCount);
+  for (int i = 0; i < sheetCount; ++i)
+  {
+    sheets.push_back(createSheet(rng));
+  }
+
+  // One shared clip set per frame rate (8-15 fps)
+  std::shared_ptr<const AnimationClipSet> loopClips[8];
+  for (int i = 0; i < 8; ++i)
+  {
+    auto clips = std::make_shared<AnimationClipSet>();
+    clips->addClip("Loop", {AnimationFrame(0, SheetColumns * SheetRows)}, 8.0f + i, true);
+    loopClips[i] = clips;
+  }
+
+  std::vector<Mover> movers;
+  {
+    auto arenaScope = scene.useNodeArena();
+    for (int i = 0; i < config.staticSprites; ++i)
+    {
+      auto sprite = std::make_unique<Sprite2D>("Background" + std::to_string(i), unit(rng) * 1280.0f,
+                                               unit(rng) * 720.0f, 1.0f, 1.0f, "", SheetColumns, SheetRows);
+      sprite->setTexture(sheets[config.sheets > 0 ? rng() % sheetCount : i % sheetCount]);
+      sprite->setFrame(static_cast<int>(rng() % (SheetColumns * SheetRows)));
+      scene.addNode(std::move(sprite));
+    }
+    if (config.cacheStaticLayer)
+    {
+      scene.getLayers().setStatic(0, true);
+      scene.getLayers().setView(0.0f, 0.0f, 1280.0f, 720.0f);
+    }
+
+    Node *chainParent = nullptr;
+    int depth = config.depth > 0 ? config.depth : 1;
+
+    for (int i = 0; i < config.sprites; ++i)
+    {
+      float x = unit(rng) * 1280.0f;
+      float y = unit(rng) * 720.0f;
+      auto sprite = std::make_unique<Sprite2D>("Sprite" + std::to_string(i), x, y, 1.0f, 1.0f, "",
+                                               SheetColumns, SheetRows);
+      sprite->setTexture(sheets[config.sheets > 0 ? rng() % sheetCount : i]);
+
+      if (unit(rng) < config.animatedRatio)
+      {
+        sprite->setAnimationClips(loopClips[rng() % 8]);
+        sprite->playAnimation(AnimationClipHandle(0));
+      }
+      if (unit(rng) < config.movingRatio)
+      {
+        movers.push_back({sprite.get(), x, y, unit(rng) * 6.2831853f});
+      }
+
+      Node *node = sprite.get();
+      if (config.staticSprites > 0)
+      {
+        sprite->setRenderLayer(1);
+      }
+      if (i % depth == 0 || !chainParent)
+      {
+        scene.addNode(std::move(sprite));
+      }
+      else
+      {
+        chainParent->addChild(std::move(sprite));
+      }
+      chainParent = node;
+    }
+  }
+  scene.flushCommands();
+  result.nodeCount = scene.getTotalNodeCount();
+  result.setupMs = elapsedMs(setupStart, Clock::now());
+
+  // Run the frames
+  auto &renderDevice = RenderDevice::getInstance();
+  auto &allocationTracker = AllocationTracker::getInstance();
+  auto &frameAllocator = FrameAllocator::getInstance();
+  int measured = config.frames - config.warmupFrames;
+  FrameStats frameStats(measured > 0 ? measured : 1, 1);
+  perfCounters.reset();
+
+  const float deltaTime = 1.0f / 60.0f;
+  for (int frame = 0; frame < config.frames; ++frame)
+  {
+    bool measuring = frame >= config.warmupFrames;
+    if (frame == config.warmupFrames)
+    {
+      driver->resetStats();
+      perfCounters.reset();
+    }
+
+    frameAllocator.beginFrame();
+    FrameTimes times = {};
+    Clock::time_point frameStart = Clock::now();
+
+    perfCounters.begin();
+    {
+      ALLOCATION_TAG_SCOPE(Scene);
+      scene.update(deltaTime);
+
+      float t = frame * deltaTime;
+      for (const Mover &mover : movers)
+      {
+        mover.sprite->setPosition(Position2D(mover.baseX + 20.0f * std::sin(t + mover.phase),
+                                             mover.baseY + 20.0f * std::cos(t + mover.phase)));
+      }
+      scene.flushCommands();
+    }
+    perfCounters.end(PerfFrameCounters::Update, result.nodeCount);
+    Clock::time_point updateEnd = Clock::now();
+
+    perfCounters.begin();
+    {
+      ALLOCATION_TAG_SCOPE(Render);
+      renderDevice.clear(0.0f, 0.0f, 0.0f, 1.0f);
+      scene.render();
+    }
+    perfCounters.end(PerfFrameCounters::Render, result.nodeCount);
+    Clock::time_point renderEnd = Clock::now();
+
+    times.updateMs = elapsedMs(frameStart, updateEnd);
+    times.renderMs = elapsedMs(updateEnd, renderEnd);
+    times.frameMs = elapsedMs(frameStart, renderEnd);
+    allocationTracker.endFrame();
+
+    if (measuring)
+    {
+      frameStats.addFrame(times);
+      const AllocationCounts &frameAllocations = allocationTracker.getLastFrame();
+      result.allocations.allocations += frameAllocations.allocations;
+      result.allocations.bytes += frameAllocations.bytes;
+      if (frameAllocations.allocations > result.maxFrameAllocations)
+        result.maxFrameAllocations = frameAllocations.allocations;
+    }
+  }
+
+  frameStats.refresh();
+  result.frameMs = frameStats.getStats(FrameStats::Frame);
+  result.updateMs = frameStats.getStats(FrameStats::Update);
+  result.renderMs = frameStats.getStats(FrameStats::Render);
+  result.render = driver->getStats();
+
+  result.perfAvailable = perfCounters.isEnabled();
+  result.perfUpdate = perfCounters.getPhase(PerfFrameCounters::Update);
+  result.perfRender = perfCounters.getPhase(PerfFrameCounters::Render);
+  return result;
+}
+
+inline std::vector<SceneBenchConfig> SceneBenchmark::defaultScenarios(int frames, int warmupFrames)
+{
+  std::vector<SceneBenchConfig> scenarios;
+  auto add = [&](const char *name, int sprites, int sheets, int depth, float moving, float animated, bool flat)
+  {
+    SceneBenchConfig config;
+    config.name = name;
+    config.sprites = sprites;
+    config.sheets = sheets;
+    config.depth = depth;
+    config.movingRatio = moving;
+    config.animatedRatio = animated;
+    config.flatTraversal = flat;
+    config.frames = frames;
+    config.warmupFrames = warmupFrames;
+    scenarios.push_back(config);
+  };
+
+  add("static_shared_flat", 10000, 1, 1, 0.0f, 0.0f, false);
+  add("animated_shared_flat", 10000, 1, 1, 0.5f, 1.0f, false);
+  add("animated_4sheets_flat", 10000, 4, 1, 0.5f, 1.0f, false);
+  add("animated_unique_flat", 10000, 0, 1, 0.5f, 1.0f, false);
+  add("animated_shared_deep", 10000, 1, 100, 0.5f, 1.0f, false);
+  add("animated_shared_deep_flatlist", 10000, 1, 100, 0.5f, 1.0f, true);
+  add("moving_shared_flat_50k", 50000, 1, 1, 1.0f, 0.25f, false);
+
+  // A large unchanging background under a few moving, animated sprites
+  add("static_background_direct", 50, 4, 1, 1.0f, 1.0f, false);
+  scenarios.back().staticSprites = 10000;
+  add("static_background_cached", 50, 4, 1, 1.0f, 1.0f, false);
+  scenarios.back().staticSprites = 10000;
+  scenarios.back().cacheStaticLayer = true;
+  return scenarios;
+}
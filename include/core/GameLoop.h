@@ -3,6 +3,12 @@
 #include "GameSetup.h"
 #include "render/RenderDevice.h"
 #include "Input.h"
+#include "profile/Profiler.h"
+#include "profile/FrameStats.h"
+#include "profile/FlightRecorder.h"
+#include "profile/PerfCounters.h"
+#include "memory/AllocationTracker.h"
+#include "memory/FrameAllocator.h"
 #include <chrono>
 #include <iostream>
 
@@ -11,6 +17,8 @@ class GameLoop
 private:
   GameSetup &gameSetup;
   std::chrono::high_resolution_clock::time_point lastTime;
+  FrameStats frameStats;
+  PerfFrameCounters perfCounters;
 
 public:
   GameLoop(GameSetup &setup)
@@ -30,6 +38,10 @@ public:
   // Render the current frame
   void render();
 
+  // Rolling frame/update/render/swap timings
+  const FrameStats &getFrameStats() const { return frameStats; }
+  const PerfFrameCounters &getPerfCounters() const { return perfCounters; }
+
 private:
   // Calculate delta time
   float calculateDeltaTime();
@@ -53,38 +65,166 @@ inline void GameLoop::run()
 
   std::cout << "Starting game loop..." << std::endl;
 
+  // Frames longer than twice the target frame time count as hitches
+  const auto &gameSettings = gameSetup.getSettings().game;
+  if (gameSettings.targetFPS > 0)
+  {
+    frameStats.setHitchThreshold(2000.0f / gameSettings.targetFPS);
+  }
+
+  // With hitch capture on, keep the last 10 seconds and dump them on a hitch;
+  // otherwise in debug mode capture the first frames for chrome://tracing / Perfetto
+  auto &profiler = Profiler::getInstance();
+  auto &flightRecorder = FlightRecorder::getInstance();
+  if (gameSettings.hitchCapture)
+  {
+    flightRecorder.enable(10.0f, frameStats.getHitchThreshold());
+    flightRecorder.recordEvent("Game loop started");
+  }
+  else if (gameSettings.debugMode)
+  {
+    profiler.captureFrames(300, "profile_trace.json");
+  }
+
+  if (gameSettings.perfCounters)
+  {
+    perfCounters.enable();
+  }
+
+  // Per-frame allocation counts cover this thread; optionally flag any
+  // allocation once the first frames (loading, first-use caches) are done
+  auto &allocationTracker = AllocationTracker::getInstance();
+  allocationTracker.setFrameThread();
+  if (gameSettings.allocationWarmupFrames > 0)
+  {
+    allocationTracker.enableSteadyStateCheck(gameSettings.allocationWarmupFrames);
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto elapsedMs = [](Clock::time_point from, Clock::time_point to)
+  {
+    return std::chrono::duration<float, std::milli>(to - from).count();
+  };
+
+  auto &frameAllocator = FrameAllocator::getInstance();
+
   // Main render loop
   while (!window->shouldClose())
   {
-    // Calculate delta time
-    float deltaTime = calculateDeltaTime();
+    // Scratch memory from two frames ago is recycled here
+    frameAllocator.beginFrame();
+
+    FrameTimes frameTimes;
+    Clock::time_point frameStart = Clock::now();
+    {
+      PROFILE_SCOPE("Frame");
 
-    // Update the scene (animations, etc.)
-    gameSetup.getCurrentScene().update(deltaTime);
+      // Calculate delta time
+      float deltaTime = calculateDeltaTime();
 
-    // Update input system (poll GLFW and update Input class)
-    gameSetup.updateInput();
+      // Update the scene (animations, etc.)
+      {
+        PROFILE_SCOPE("Scene::update");
+        ALLOCATION_TAG_SCOPE(Scene);
+        Scene &scene = gameSetup.getCurrentScene();
+        perfCounters.begin();
+        scene.update(deltaTime);
+        perfCounters.end(PerfFrameCounters::Update, scene.getTotalNodeCount());
+      }
+      Clock::time_point updateEnd = Clock::now();
+      frameTimes.updateMs = elapsedMs(frameStart, updateEnd);
 
-    // Handle keyboard input
-    handleInput();
+      // Update input system (poll GLFW and update Input class)
+      {
+        PROFILE_SCOPE("GameSetup::updateInput");
+        ALLOCATION_TAG_SCOPE(Input);
+        gameSetup.updateInput();
+      }
 
-    // Handle scene-specific input
-    gameSetup.getCurrentScene().handleInput();
+      // Handle keyboard input
+      handleInput();
 
-    // Handle input for all nodes in the scene
-    gameSetup.getCurrentScene().getRoot()->handleInputRecursive();
+      // Handle scene-specific input
+      {
+        PROFILE_SCOPE("Scene::handleInput");
+        ALLOCATION_TAG_SCOPE(Input);
+        gameSetup.getCurrentScene().handleInput();
 
-    // Render the current frame
-    render();
+        // Handle input for all nodes in the scene
+        gameSetup.getCurrentScene().getRoot()->handleInputRecursive();
+      }
 
-    // Swap front and back buffers
-    window->swapBuffers();
+      // Apply spawns/destroys/reparents queued during update and input
+      {
+        PROFILE_SCOPE("Scene::flushCommands");
+        ALLOCATION_TAG_SCOPE(Scene);
+        gameSetup.getCurrentScene().flushCommands();
+      }
 
-    // Poll for and process events
-    window->pollEvents();
+      // Render the current frame
+      Clock::time_point renderStart = Clock::now();
+      {
+        PROFILE_SCOPE("GameLoop::render");
+        ALLOCATION_TAG_SCOPE(Render);
+        render();
+      }
+
+      // Swap front and back buffers
+      Clock::time_point swapStart = Clock::now();
+      {
+        PROFILE_SCOPE("Window::swapBuffers");
+        ALLOCATION_TAG_SCOPE(Render);
+        window->swapBuffers();
+      }
+      Clock::time_point swapEnd = Clock::now();
+      frameTimes.renderMs = elapsedMs(renderStart, swapStart);
+      frameTimes.swapMs = elapsedMs(swapStart, swapEnd);
+
+      // Poll for and process events
+      {
+        PROFILE_SCOPE("Window::pollEvents");
+        ALLOCATION_TAG_SCOPE(Input);
+        window->pollEvents();
+      }
+    }
+
+    frameTimes.frameMs = elapsedMs(frameStart, Clock::now());
+    frameStats.addFrame(frameTimes);
+    flightRecorder.endFrame(frameTimes);
+    profiler.endFrame();
+    allocationTracker.endFrame();
   }
 
   std::cout << "Game loop ended." << std::endl;
+
+  if (flightRecorder.isEnabled())
+  {
+    flightRecorder.waitForWriter();
+    std::cout << "Hitch traces written: " << flightRecorder.getSnapshotCount() << std::endl;
+    flightRecorder.disable();
+  }
+
+  if (gameSettings.showFPS)
+  {
+    frameStats.refresh();
+    const auto &frame = frameStats.getStats(FrameStats::Frame);
+    std::cout << "Frames: " << frameStats.getFrameCount()
+              << ", avg " << frame.avg << " ms, p99 " << frame.p99 << " ms"
+              << ", hitches " << frameStats.getHitchCount() << std::endl;
+    frameStats.writeCsv("frame_stats.csv");
+  }
+
+  if (perfCounters.isEnabled())
+  {
+    perfCounters.print(std::cout);
+  }
+
+  if (gameSettings.showFPS || gameSettings.allocationWarmupFrames > 0)
+  {
+    allocationTracker.printReport(std::cout);
+    std::cout << "Frame scratch: high water " << frameAllocator.getHighWaterBytes()
+              << " bytes, " << frameAllocator.getOverflowCount() << " heap fallbacks" << std::endl;
+  }
 }
 
 inline void GameLoop::handleInput()
@@ -105,7 +245,16 @@ inline void GameLoop::render()
       1.0f);
 
   // Render the current scene
-  gameSetup.getCurrentScene().render();
+  Scene &scene = gameSetup.getCurrentScene();
+  perfCounters.begin();
+  scene.render();
+  perfCounters.end(PerfFrameCounters::Render, scene.getTotalNodeCount());
+
+  // Performance overlay on top
+  if (gameSetup.getSettings().game.showFPS)
+  {
+    frameStats.drawOverlay();
+  }
 }
 
 inline float GameLoop::calculateDeltaTime()
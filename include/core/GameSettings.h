@@ -58,6 +58,9 @@ public:
     int targetFPS;
     bool debugMode;
     bool showFPS;
+    bool hitchCapture; // Keep a rolling trace and dump it when a frame hitches
+    bool perfCounters; // Sample hardware counters around scene update/render (Linux)
+    int allocationWarmupFrames; // > 0: report any game loop allocation after this many frames
   } game;
 
 public:
@@ -172,6 +175,9 @@ public:
     std::cout << "Clear Color: (" << graphics.clearColorR << ", " << graphics.clearColorG << ", " << graphics.clearColorB << ")" << std::endl;
     std::cout << "Target FPS: " << game.targetFPS << std::endl;
     std::cout << "Debug Mode: " << (game.debugMode ? "ON" : "OFF") << std::endl;
+    std::cout << "Hitch Capture: " << (game.hitchCapture ? "ON" : "OFF") << std::endl;
+    std::cout << "Perf Counters: " << (game.perfCounters ? "ON" : "OFF") << std::endl;
+    std::cout << "Allocation Warm-up Frames: " << game.allocationWarmupFrames << std::endl;
     std::cout << "====================" << std::endl;
   }
 };
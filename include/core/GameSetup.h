@@ -6,6 +6,8 @@
 #include "render/OpenGLRenderDriver.h"
 #include "Camera.h"
 #include "Input.h"
+#include "log/Logger.h"
+#include "profile/FlightRecorder.h"
 #include "../scene/Scene.h"
 #include "../scene/MinimalScene.h"
 #include "../scene/SimpleScene.h"
@@ -75,6 +77,9 @@ inline bool GameSetup::initialize()
 {
   std::cout << "=== Game Setup Initialization ===" << std::endl;
 
+  // Per-frame debug logging only when asked for
+  Logger::getInstance().setLevel(settings.game.debugMode ? LogLevel::Debug : LogLevel::Info);
+
   // Print settings
   settings.printSettings();
 
@@ -198,7 +203,7 @@ inline void GameSetup::updateInput()
     if (isPressed)
     {
       anyKeyPressed = true;
-      std::cout << "GLFW Key " << key << " is pressed" << std::endl;
+      LOG_TRACE(Input, "GLFW Key {} is pressed", key);
     }
     input.setKeyState(key, isPressed);
   }
@@ -210,9 +215,7 @@ inline void GameSetup::updateInput()
 
   if (shiftPressed || ctrlPressed || altPressed)
   {
-    std::cout << "Modifier keys - Shift: " << shiftPressed
-              << ", Ctrl: " << ctrlPressed
-              << ", Alt: " << altPressed << std::endl;
+    LOG_TRACE(Input, "Modifier keys - Shift: {}, Ctrl: {}, Alt: {}", shiftPressed, ctrlPressed, altPressed);
   }
 
   input.setKeyState(340, shiftPressed); // Left Shift
@@ -221,7 +224,7 @@ inline void GameSetup::updateInput()
 
   if (anyKeyPressed)
   {
-    std::cout << "Some keys are being pressed!" << std::endl;
+    LOG_TRACE(Input, "Some keys are being pressed!");
   }
 }
 
@@ -240,6 +243,13 @@ inline bool GameSetup::loadScene(Scene scene)
 
   std::cout << "Loaded scene: " << currentScene.getName() << std::endl;
   std::cout << "Nodes in scene: " << currentScene.getNodeCount() << std::endl;
+  FlightRecorder::getInstance().recordEvent("Scene loaded", static_cast<double>(currentScene.getNodeCount()));
+
+  if (auto arena = currentScene.getNodeArena())
+  {
+    std::cout << "Node arena: " << arena->getAllocationCount() << " allocations, "
+              << arena->getBytesUsed() << " bytes in " << arena->getBlockCount() << " blocks" << std::endl;
+  }
 
   // Display information about nodes in the scene
   auto rootNode = currentScene.getRoot();
@@ -248,10 +258,10 @@ inline bool GameSetup::loadScene(Scene scene)
     std::cout << "Nodes loaded from scene:" << std::endl;
     for (const auto &child : rootNode->getChildren())
     {
-      std::cout << "  - " << child->getName() << " (" << typeid(*child).name() << ")" << std::endl;
+      std::cout << "  - " << child->getName() << " (" << nodeTypeName(child->getType()) << ")" << std::endl;
 
       // Check if it's a Sprite2D and get more details
-      if (auto sprite = dynamic_cast<Sprite2D *>(child.get()))
+      if (auto sprite = nodeCast<Sprite2D>(child.get()))
       {
         std::cout << "    Position: (" << sprite->getPosition().x << ", " << sprite->getPosition().y << ")" << std::endl;
         std::cout << "    Scale: (" << sprite->getScale().x << ", " << sprite->getScale().y << ")" << std::endl;
@@ -2,8 +2,10 @@
 
 #include <unordered_map>
 #include <string>
+#include <cstring>
 #include <vector>
 #include <iostream> // Added for debug output
+#include "log/Logger.h"
 
 class Input
 {
@@ -13,11 +15,18 @@ private:
   // Action mapping: action_name -> key_code
   std::unordered_map<std::string, int> actionMap;
 
+  // Key states indexed by key code (GLFW key codes are below MaxKeys);
+  // plain arrays so the per-frame copy never allocates
+  static constexpr int MaxKeys = 512;
+
   // Current frame key states
-  std::unordered_map<int, bool> currentKeyStates;
+  bool currentKeyStates[MaxKeys] = {};
 
   // Previous frame key states (for "just pressed" detection)
-  std::unordered_map<int, bool> previousKeyStates;
+  bool previousKeyStates[MaxKeys] = {};
+
+  static bool isValidKey(int keyCode) { return keyCode >= 0 && keyCode < MaxKeys; }
+  bool wasKeyPressed(int keyCode) const { return isValidKey(keyCode) && previousKeyStates[keyCode]; }
 
   // Private constructor for singleton
   Input() = default;
@@ -79,15 +88,18 @@ inline void Input::setupAction(const std::string &actionName, int keyCode)
 inline void Input::update()
 {
   // Store previous frame states
-  previousKeyStates = currentKeyStates;
+  std::memcpy(previousKeyStates, currentKeyStates, sizeof(currentKeyStates));
 }
 
 inline void Input::setKeyState(int keyCode, bool pressed)
 {
+  if (!isValidKey(keyCode))
+    return;
+
   currentKeyStates[keyCode] = pressed;
   if (pressed)
   {
-    std::cout << "Input class: Key " << keyCode << " set to PRESSED" << std::endl;
+    LOG_TRACE(Input, "Key {} set to PRESSED", keyCode);
   }
 }
 
@@ -96,15 +108,14 @@ inline bool Input::isActionPressed(const std::string &actionName) const
   auto it = actionMap.find(actionName);
   if (it != actionMap.end())
   {
-    auto keyIt = currentKeyStates.find(it->second);
-    bool isPressed = keyIt != currentKeyStates.end() && keyIt->second;
+    bool isPressed = isKeyPressed(it->second);
     if (isPressed)
     {
-      std::cout << "Action '" << actionName << "' (key " << it->second << ") is PRESSED" << std::endl;
+      LOG_TRACE(Input, "Action '{}' (key {}) is PRESSED", actionName, it->second);
     }
     return isPressed;
   }
-  std::cout << "Action '" << actionName << "' not found in action map!" << std::endl;
+  LOG_WARNING(Input, "Action '{}' not found in action map!", actionName);
   return false;
 }
 
@@ -113,14 +124,7 @@ inline bool Input::isActionJustPressed(const std::string &actionName) const
   auto it = actionMap.find(actionName);
   if (it != actionMap.end())
   {
-    int keyCode = it->second;
-    auto currentIt = currentKeyStates.find(keyCode);
-    auto previousIt = previousKeyStates.find(keyCode);
-
-    bool currentlyPressed = currentIt != currentKeyStates.end() && currentIt->second;
-    bool previouslyPressed = previousIt != previousKeyStates.end() && previousIt->second;
-
-    return currentlyPressed && !previouslyPressed;
+    return isKeyJustPressed(it->second);
   }
   return false;
 }
@@ -130,44 +134,24 @@ inline bool Input::isActionJustReleased(const std::string &actionName) const
   auto it = actionMap.find(actionName);
   if (it != actionMap.end())
   {
-    int keyCode = it->second;
-    auto currentIt = currentKeyStates.find(keyCode);
-    auto previousIt = previousKeyStates.find(keyCode);
-
-    bool currentlyPressed = currentIt != currentKeyStates.end() && currentIt->second;
-    bool previouslyPressed = previousIt != previousKeyStates.end() && previousIt->second;
-
-    return !currentlyPressed && previouslyPressed;
+    return isKeyJustReleased(it->second);
   }
   return false;
 }
 
 inline bool Input::isKeyPressed(int keyCode) const
 {
-  auto it = currentKeyStates.find(keyCode);
-  return it != currentKeyStates.end() && it->second;
+  return isValidKey(keyCode) && currentKeyStates[keyCode];
 }
 
 inline bool Input::isKeyJustPressed(int keyCode) const
 {
-  auto currentIt = currentKeyStates.find(keyCode);
-  auto previousIt = previousKeyStates.find(keyCode);
-
-  bool currentlyPressed = currentIt != currentKeyStates.end() && currentIt->second;
-  bool previouslyPressed = previousIt != previousKeyStates.end() && previousIt->second;
-
-  return currentlyPressed && !previouslyPressed;
+  return isKeyPressed(keyCode) && !wasKeyPressed(keyCode);
 }
 
 inline bool Input::isKeyJustReleased(int keyCode) const
 {
-  auto currentIt = currentKeyStates.find(keyCode);
-  auto previousIt = previousKeyStates.find(keyCode);
-
-  bool currentlyPressed = currentIt != currentKeyStates.end() && currentIt->second;
-  bool previouslyPressed = previousIt != previousKeyStates.end() && previousIt->second;
-
-  return !currentlyPressed && previouslyPressed;
+  return !isKeyPressed(keyCode) && wasKeyPressed(keyCode);
 }
 
 inline int Input::getActionKey(const std::string &actionName) const
@@ -179,8 +163,8 @@ inline int Input::getActionKey(const std::string &actionName) const
 inline void Input::clearActions()
 {
   actionMap.clear();
-  currentKeyStates.clear();
-  previousKeyStates.clear();
+  std::memset(currentKeyStates, 0, sizeof(currentKeyStates));
+  std::memset(previousKeyStates, 0, sizeof(previousKeyStates));
 }
 
 // Initialize static member
@@ -145,6 +145,69 @@ struct Transform3D
   const Vector3 &getRotation() const { return rotation; }
 };
 
+constexpr float Pi = 3.14159265358979f;
+constexpr float TwoPi = 6.28318530717959f;
+
+// Sine of x in [-pi, pi]: folded into [-pi/2, pi/2] and evaluated as an odd
+// 7th order polynomial, max error about 7e-7. Branch-free, for batched loops.
+inline float fastSinFolded(float x)
+{
+  x = x < Pi - x ? x : Pi - x;
+  x = x > -Pi - x ? x : -Pi - x;
+  float x2 = x * x;
+  return x * (0.99999660f + x2 * (-0.16664824f + x2 * (0.00830629f + x2 * -0.00018363f)));
+}
+
+// Approximate sine and cosine of any angle in radians
+inline float fastSin(float x)
+{
+  float turns = x * (1.0f / TwoPi);
+  int whole = static_cast<int>(turns + (turns >= 0.0f ? 0.5f : -0.5f));
+  return fastSinFolded(x - static_cast<float>(whole) * TwoPi);
+}
+inline float fastCos(float x) { return fastSin(x + 0.5f * Pi); }
+
+// 2D affine transform as a 2x3 matrix: x' = a * x + c * y + tx, y' = b * x + d * y + ty
+struct Affine2D
+{
+  float a, b, c, d, tx, ty;
+
+  Affine2D(float a = 1.0f, float b = 0.0f, float c = 0.0f, float d = 1.0f, float tx = 0.0f, float ty = 0.0f)
+      : a(a), b(b), c(c), d(d), tx(tx), ty(ty) {}
+
+  // Translate, rotate, then scale, as RenderDevice::setTransform does
+  static Affine2D fromTransform(const Transform2D &transform)
+  {
+    float radians = transform.rotation * (Pi / 180.0f);
+    float cosine = fastCos(radians);
+    float sine = fastSin(radians);
+    return Affine2D(cosine * transform.scale.x, sine * transform.scale.x, -sine * transform.scale.y,
+                    cosine * transform.scale.y, transform.position.x, transform.position.y);
+  }
+
+  // `other` first, then this
+  Affine2D operator*(const Affine2D &other) const
+  {
+    return Affine2D(a * other.a + c * other.b, b * other.a + d * other.b, a * other.c + c * other.d,
+                    b * other.c + d * other.d, a * other.tx + c * other.ty + tx, b * other.tx + d * other.ty + ty);
+  }
+
+  Vector2 apply(const Vector2 &point) const { return Vector2(a * point.x + c * point.y + tx, b * point.x + d * point.y + ty); }
+
+  // Identity if the matrix is singular (e.g. a zero scale)
+  Affine2D inverse() const
+  {
+    float determinant = a * d - b * c;
+    if (determinant == 0.0f)
+      return Affine2D();
+    float inv = 1.0f / determinant;
+    Affine2D result(d * inv, -b * inv, -c * inv, a * inv);
+    result.tx = -(result.a * tx + result.c * ty);
+    result.ty = -(result.b * tx + result.d * ty);
+    return result;
+  }
+};
+
 // Static Colors class with predefined colors
 class Colors
 {
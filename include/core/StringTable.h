@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Interned string handle (index into the StringTable)
+using StringId = uint32_t;
+constexpr StringId InvalidStringId = 0xFFFFFFFFu;
+
+// 32-bit FNV-1a; stable across runs and platforms
+struct Fnv1aHash
+{
+  size_t operator()(std::string_view text) const
+  {
+    uint32_t hash = 2166136261u;
+    for (char c : text)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 16777619u;
+    }
+    return hash;
+  }
+};
+
+// Global table of interned strings (node names, paths, ...).
+// Strings are stored in fixed-size chunks that never move, so get() can hand
+// out references without locking while other threads intern new strings.
+class StringTable
+{
+private:
+  static constexpr size_t ChunkSize = 1024;
+  static constexpr size_t MaxChunks = 4096;
+
+  std::unique_ptr<std::string[]> chunks[MaxChunks];
+  std::atomic<uint32_t> count;
+  std::unordered_map<std::string_view, StringId, Fnv1aHash> lookup;
+  mutable std::mutex mutex;
+
+  // Private constructor for singleton
+  StringTable() : count(0) {}
+
+public:
+  // Singleton access
+  static StringTable &getInstance()
+  {
+    static StringTable instance;
+    return instance;
+  }
+
+  // Prevent copying
+  StringTable(const StringTable &) = delete;
+  StringTable &operator=(const StringTable &) = delete;
+
+  // Get the id for a string, adding it to the table if needed
+  StringId intern(std::string_view text);
+
+  // Get the id for a string without adding it (InvalidStringId if unknown)
+  StringId find(std::string_view text) const;
+
+  // Get the string for an id (empty string for InvalidStringId)
+  const std::string &get(StringId id) const;
+
+  size_t size() const { return count.load(std::memory_order_acquire); }
+};
+
+// Implementation
+inline StringId StringTable::intern(std::string_view text)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = lookup.find(text);
+  if (it != lookup.end())
+  {
+    return it->second;
+  }
+
+  StringId id = count.load(std::memory_order_relaxed);
+  size_t chunk = id / ChunkSize;
+  if (chunk >= MaxChunks)
+  {
+    return InvalidStringId;
+  }
+  if (!chunks[chunk])
+  {
+    chunks[chunk] = std::make_unique<std::string[]>(ChunkSize);
+  }
+
+  std::string &stored = chunks[chunk][id % ChunkSize];
+  stored.assign(text.data(), text.size());
+  lookup.emplace(std::string_view(stored), id);
+  count.store(id + 1, std::memory_order_release);
+  return id;
+}
+
+inline StringId StringTable::find(std::string_view text) const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = lookup.find(text);
+  return it != lookup.end() ? it->second : InvalidStringId;
+}
+
+inline const std::string &StringTable::get(StringId id) const
+{
+  static const std::string empty;
+  if (id >= count.load(std::memory_order_acquire))
+  {
+    return empty;
+  }
+  return chunks[id / ChunkSize][id % ChunkSize];
+}
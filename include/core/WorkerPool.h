@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for splitting a loop over a large array.
+// parallelFor() cuts [0, count) into ranges of `grain` items that the caller
+// and the workers take in turn, and returns once every range has run. With no
+// worker threads (the default) the whole loop runs on the caller.
+class WorkerPool
+{
+public:
+  using RangeJob = std::function<void(size_t begin, size_t end)>;
+
+private:
+  std::vector<std::thread> threads;
+  std::mutex callMutex; // One parallelFor at a time
+
+  // Current job, guarded by mutex; workers only join while job is set
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  const RangeJob *job;
+  size_t jobCount;
+  size_t jobGrain;
+  size_t rangeCount;
+  size_t activeWorkers;
+  bool running;
+
+  std::atomic<size_t> nextRange;
+  std::atomic<size_t> remainingRanges;
+
+  WorkerPool() : job(nullptr), jobCount(0), jobGrain(1), rangeCount(0), activeWorkers(0), running(false),
+                 nextRange(0), remainingRanges(0) {}
+
+  static size_t &workerIndex()
+  {
+    thread_local size_t index = 0;
+    return index;
+  }
+
+  void run(size_t index);
+  void runRanges(const RangeJob &body, size_t count, size_t grain, size_t ranges);
+  void stop();
+
+public:
+  // Singleton access
+  static WorkerPool &getInstance()
+  {
+    static WorkerPool instance;
+    return instance;
+  }
+
+  ~WorkerPool() { stop(); }
+
+  // Prevent copying
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  // Threads besides the caller; 0 runs every job inline. Not during a parallelFor.
+  void setThreadCount(size_t count);
+  size_t getThreadCount() const { return threads.size(); }
+
+  // Call body(begin, end) over [0, count) in ranges of `grain`, on the caller and the workers
+  void parallelFor(size_t count, size_t grain, const RangeJob &body);
+
+  // 1-based index of the calling worker thread, 0 on any other thread
+  // (e.g. the SceneCommandBuffer lane a job writes to)
+  static size_t getWorkerIndex() { return workerIndex(); }
+};
+
+// Implementation
+inline void WorkerPool::setThreadCount(size_t count)
+{
+  std::lock_guard<std::mutex> serial(callMutex);
+  stop();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    running = true;
+  }
+  for (size_t i = 0; i < count; ++i)
+  {
+    threads.emplace_back(&WorkerPool::run, this, i + 1);
+  }
+}
+
+inline void WorkerPool::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+  }
+  wake.notify_all();
+  for (std::thread &thread : threads)
+  {
+    if (thread.joinable())
+      thread.join();
+  }
+  threads.clear();
+}
+
+inline void WorkerPool::parallelFor(size_t count, size_t grain, const RangeJob &body)
+{
+  if (count == 0)
+    return;
+  grain = std::max<size_t>(grain, 1);
+  size_t ranges = (count + grain - 1) / grain;
+  if (threads.empty() || ranges == 1)
+  {
+    body(0, count);
+    return;
+  }
+
+  std::lock_guard<std::mutex> serial(callMutex);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &body;
+    jobCount = count;
+    jobGrain = grain;
+    rangeCount = ranges;
+    nextRange.store(0);
+    remainingRanges.store(ranges);
+  }
+  wake.notify_all();
+
+  runRanges(body, count, grain, ranges);
+
+  // Workers that joined must leave before the job (and nextRange) can be reused
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this]
+            { return remainingRanges.load() == 0 && activeWorkers == 0; });
+  job = nullptr;
+}
+
+inline void WorkerPool::runRanges(const RangeJob &body, size_t count, size_t grain, size_t ranges)
+{
+  for (;;)
+  {
+    size_t range = nextRange.fetch_add(1);
+    if (range >= ranges)
+      return;
+    size_t begin = range * grain;
+    body(begin, std::min(count, begin + grain));
+    if (remainingRanges.fetch_sub(1) == 1)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      done.notify_all();
+    }
+  }
+}
+
+inline void WorkerPool::run(size_t index)
+{
+  workerIndex() = index;
+  std::unique_lock<std::mutex> lock(mutex);
+  for (;;)
+  {
+    wake.wait(lock, [this]
+              { return !running || (job && nextRange.load() < rangeCount); });
+    if (!running)
+      return;
+
+    const RangeJob *body = job;
+    size_t count = jobCount, grain = jobGrain, ranges = rangeCount;
+    activeWorkers++;
+    lock.unlock();
+    runRanges(*body, count, grain, ranges);
+    lock.lock();
+    if (--activeWorkers == 0)
+      done.notify_all();
+  }
+}
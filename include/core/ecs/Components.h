@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../Math.h"
+#include <cstdint>
+
+// Component types known to the entity/component store
+enum class ComponentType : uint8_t
+{
+  Transform,
+  Velocity,
+  SpriteFrame,
+  Animation,
+  Color,
+  Count
+};
+
+// Bit set of component types (one bit per ComponentType)
+using ComponentMask = uint32_t;
+
+constexpr ComponentMask componentBit(ComponentType type)
+{
+  return ComponentMask(1) << static_cast<uint32_t>(type);
+}
+
+// Linear velocity in world units per second
+struct Velocity2D
+{
+  float x, y;
+
+  Velocity2D(float x = 0.0f, float y = 0.0f) : x(x), y(y) {}
+};
+
+// Sprite sheet frame to draw; the texture is owned elsewhere (e.g. EcsWorldNode)
+struct SpriteFrame
+{
+  unsigned int textureId;
+  int textureWidth;
+  int textureHeight;
+  int hframes;
+  int vframes;
+  int frame;
+
+  SpriteFrame(unsigned int texId = 0, int texWidth = 0, int texHeight = 0,
+              int h = 1, int v = 1, int f = 0)
+      : textureId(texId), textureWidth(texWidth), textureHeight(texHeight),
+        hframes(h), vframes(v), frame(f) {}
+};
+
+// Flipbook playback state for a single contiguous frame range
+struct AnimationState
+{
+  int startFrame;
+  int frameCount;
+  float frameRate; // Frames per second
+  float frameTimer;
+  int currentFrame;
+  bool loop;
+  bool playing;
+
+  AnimationState(int start = 0, int count = 1, float fps = 12.0f, bool shouldLoop = true)
+      : startFrame(start), frameCount(count), frameRate(fps), frameTimer(0.0f),
+        currentFrame(0), loop(shouldLoop), playing(true) {}
+};
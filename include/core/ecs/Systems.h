@@ -0,0 +1,142 @@
+#pragma once
+
+#include "World.h"
+#include "../render/RenderDevice.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Systems that run over whole archetype columns instead of individual nodes
+namespace EcsSystems
+{
+  // Move every entity that has a velocity
+  inline void integrateVelocity(World &world, float deltaTime)
+  {
+    const ComponentMask required = componentBit(ComponentType::Transform) | componentBit(ComponentType::Velocity);
+
+    for (auto &archetype : world.getArchetypes())
+    {
+      if (!archetype.matches(required))
+        continue;
+
+      Transform2D *transforms = archetype.transforms.data();
+      const Velocity2D *velocities = archetype.velocities.data();
+      size_t count = archetype.size();
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        transforms[i].position.x += velocities[i].x * deltaTime;
+        transforms[i].position.y += velocities[i].y * deltaTime;
+      }
+    }
+  }
+
+  // Advance flipbook animations and write the resulting sprite sheet frame
+  inline void advanceAnimations(World &world, float deltaTime)
+  {
+    const ComponentMask required = componentBit(ComponentType::Animation) | componentBit(ComponentType::SpriteFrame);
+
+    for (auto &archetype : world.getArchetypes())
+    {
+      if (!archetype.matches(required))
+        continue;
+
+      AnimationState *animations = archetype.animations.data();
+      SpriteFrame *frames = archetype.spriteFrames.data();
+      size_t count = archetype.size();
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        AnimationState &anim = animations[i];
+        if (!anim.playing || anim.frameCount <= 0 || anim.frameRate <= 0.0f)
+          continue;
+
+        float frameTime = 1.0f / anim.frameRate;
+        anim.frameTimer += deltaTime;
+
+        // Step as many frames as the delta covers in one go, as
+        // AnimationSystem::advance does, so a huge delta cannot spin
+        if (anim.frameTimer >= frameTime)
+        {
+          uint64_t steps = static_cast<uint64_t>(anim.frameTimer / frameTime);
+          uint64_t frameCount = static_cast<uint64_t>(anim.frameCount);
+          uint64_t frame = static_cast<uint64_t>(anim.currentFrame);
+
+          if (!anim.loop && steps >= frameCount - frame)
+          {
+            anim.currentFrame = anim.frameCount - 1;
+            anim.frameTimer = 0.0f;
+            anim.playing = false;
+          }
+          else
+          {
+            anim.currentFrame = static_cast<int>((frame + steps % frameCount) % frameCount);
+            anim.frameTimer = std::fmod(anim.frameTimer, frameTime);
+          }
+        }
+
+        frames[i].frame = anim.startFrame + anim.currentFrame;
+      }
+    }
+  }
+
+  // Draw every entity that has a transform through the RenderDevice
+  inline void renderSprites(const World &world)
+  {
+    auto &renderDevice = RenderDevice::getInstance();
+
+    for (const auto &archetype : world.getArchetypes())
+    {
+      if (!archetype.matches(componentBit(ComponentType::Transform)))
+        continue;
+
+      bool hasSprite = archetype.has(ComponentType::SpriteFrame);
+      bool hasColor = archetype.has(ComponentType::Color);
+      size_t count = archetype.size();
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        const Transform2D &transform = archetype.transforms[i];
+        renderDevice.setTransform(transform.position.x, transform.position.y, transform.rotation,
+                                  transform.scale.x, transform.scale.y);
+
+        if (hasColor)
+        {
+          const Color &color = archetype.colors[i];
+          renderDevice.setColor(color.x, color.y, color.z);
+        }
+        else
+        {
+          renderDevice.setColor(1.0f, 1.0f, 1.0f);
+        }
+
+        if (hasSprite && archetype.spriteFrames[i].textureId != 0)
+        {
+          const SpriteFrame &sprite = archetype.spriteFrames[i];
+
+          // Same sheet layout as Sprite2D::render
+          float frameWidth = 1.0f / sprite.hframes;
+          float frameHeight = 1.0f / sprite.vframes;
+          int frameX = sprite.frame % sprite.hframes;
+          int frameY = (sprite.frame / sprite.hframes) % sprite.vframes;
+
+          float texLeft = frameX * frameWidth;
+          float texRight = texLeft + frameWidth;
+          float texTop = 1.0f - (frameY * frameHeight);
+          float texBottom = texTop - frameHeight;
+
+          float width = static_cast<float>(sprite.textureWidth) / sprite.hframes;
+          float height = static_cast<float>(sprite.textureHeight) / sprite.vframes;
+
+          renderDevice.drawSprite(-width / 2, -height / 2, width, height, sprite.textureId, texLeft, texTop, texRight, texBottom);
+        }
+        else
+        {
+          renderDevice.drawRectangle(-0.5f, -0.5f, 1.0f, 1.0f);
+        }
+      }
+    }
+
+    renderDevice.resetTransform();
+  }
+}
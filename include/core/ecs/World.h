@@ -0,0 +1,411 @@
+#pragma once
+
+#include "Components.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Handle to an entity; the generation guards against stale handles after destruction
+struct Entity
+{
+  static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+  uint32_t index;
+  uint32_t generation;
+
+  Entity(uint32_t idx = InvalidIndex, uint32_t gen = 0) : index(idx), generation(gen) {}
+
+  bool isValid() const { return index != InvalidIndex; }
+  bool operator==(const Entity &other) const { return index == other.index && generation == other.generation; }
+  bool operator!=(const Entity &other) const { return !(*this == other); }
+};
+
+// All entities sharing the same component set, stored as one dense column per component
+class Archetype
+{
+public:
+  ComponentMask mask;
+  std::vector<Entity> entities;
+  std::vector<Transform2D> transforms;
+  std::vector<Velocity2D> velocities;
+  std::vector<SpriteFrame> spriteFrames;
+  std::vector<AnimationState> animations;
+  std::vector<Color> colors;
+
+  explicit Archetype(ComponentMask componentMask) : mask(componentMask) {}
+
+  size_t size() const { return entities.size(); }
+  bool has(ComponentType type) const { return (mask & componentBit(type)) != 0; }
+
+  // True if this archetype holds at least the required components and has entities
+  bool matches(ComponentMask required) const { return (mask & required) == required && !entities.empty(); }
+
+  // Append a row with default-constructed components, returns the row index
+  size_t pushRow(Entity entity);
+
+  // Remove a row by moving the last row into it, returns the entity that moved (or invalid)
+  Entity swapRemove(size_t row);
+
+  // Copy the components both archetypes share from another archetype's row into our last row
+  void copySharedFrom(const Archetype &source, size_t sourceRow);
+
+  void reserve(size_t count);
+  void clear();
+};
+
+// Maps a component struct to its ComponentType and column
+template <typename T>
+struct ComponentTraits;
+
+template <>
+struct ComponentTraits<Transform2D>
+{
+  static constexpr ComponentType type = ComponentType::Transform;
+  static std::vector<Transform2D> &column(Archetype &a) { return a.transforms; }
+  static const std::vector<Transform2D> &column(const Archetype &a) { return a.transforms; }
+};
+
+template <>
+struct ComponentTraits<Velocity2D>
+{
+  static constexpr ComponentType type = ComponentType::Velocity;
+  static std::vector<Velocity2D> &column(Archetype &a) { return a.velocities; }
+  static const std::vector<Velocity2D> &column(const Archetype &a) { return a.velocities; }
+};
+
+template <>
+struct ComponentTraits<SpriteFrame>
+{
+  static constexpr ComponentType type = ComponentType::SpriteFrame;
+  static std::vector<SpriteFrame> &column(Archetype &a) { return a.spriteFrames; }
+  static const std::vector<SpriteFrame> &column(const Archetype &a) { return a.spriteFrames; }
+};
+
+template <>
+struct ComponentTraits<AnimationState>
+{
+  static constexpr ComponentType type = ComponentType::Animation;
+  static std::vector<AnimationState> &column(Archetype &a) { return a.animations; }
+  static const std::vector<AnimationState> &column(const Archetype &a) { return a.animations; }
+};
+
+template <>
+struct ComponentTraits<Color>
+{
+  static constexpr ComponentType type = ComponentType::Color;
+  static std::vector<Color> &column(Archetype &a) { return a.colors; }
+  static const std::vector<Color> &column(const Archetype &a) { return a.colors; }
+};
+
+// Archetype-based entity/component store
+class World
+{
+private:
+  struct EntityRecord
+  {
+    uint32_t archetype;
+    uint32_t row;
+    uint32_t generation;
+    bool alive;
+  };
+
+  std::vector<Archetype> archetypes;
+  std::vector<EntityRecord> records;
+  std::vector<uint32_t> freeIndices;
+  size_t entityCount;
+
+public:
+  World() : entityCount(0) {}
+
+  // Entity lifetime
+  Entity createEntity(ComponentMask mask);
+  void destroyEntity(Entity entity);
+  bool isAlive(Entity entity) const;
+
+  // Component access (nullptr if the entity is dead or lacks the component)
+  template <typename T>
+  T *get(Entity entity);
+
+  template <typename T>
+  const T *get(Entity entity) const;
+
+  // Set a component, moving the entity to a new archetype if it did not have it yet
+  template <typename T>
+  void set(Entity entity, const T &value);
+
+  // Remove a component, moving the entity to a new archetype
+  template <typename T>
+  void remove(Entity entity);
+
+  // Archetype storage, iterated by systems (filter with Archetype::matches)
+  std::vector<Archetype> &getArchetypes() { return archetypes; }
+  const std::vector<Archetype> &getArchetypes() const { return archetypes; }
+
+  // Pre-allocate storage for a component set
+  void reserve(ComponentMask mask, size_t count);
+
+  // Destroy all entities (archetype storage is kept for reuse)
+  void clear();
+
+  size_t getEntityCount() const { return entityCount; }
+  size_t getArchetypeCount() const { return archetypes.size(); }
+
+private:
+  uint32_t findOrCreateArchetype(ComponentMask mask);
+  void moveEntity(Entity entity, ComponentMask newMask);
+};
+
+// Implementation of Archetype methods
+inline size_t Archetype::pushRow(Entity entity)
+{
+  entities.push_back(entity);
+  if (has(ComponentType::Transform))
+    transforms.emplace_back();
+  if (has(ComponentType::Velocity))
+    velocities.emplace_back();
+  if (has(ComponentType::SpriteFrame))
+    spriteFrames.emplace_back();
+  if (has(ComponentType::Animation))
+    animations.emplace_back();
+  if (has(ComponentType::Color))
+    colors.emplace_back(Colors::white);
+  return entities.size() - 1;
+}
+
+inline Entity Archetype::swapRemove(size_t row)
+{
+  size_t last = entities.size() - 1;
+  Entity moved;
+
+  if (row != last)
+  {
+    moved = entities[last];
+    entities[row] = entities[last];
+    if (has(ComponentType::Transform))
+      transforms[row] = transforms[last];
+    if (has(ComponentType::Velocity))
+      velocities[row] = velocities[last];
+    if (has(ComponentType::SpriteFrame))
+      spriteFrames[row] = spriteFrames[last];
+    if (has(ComponentType::Animation))
+      animations[row] = animations[last];
+    if (has(ComponentType::Color))
+      colors[row] = colors[last];
+  }
+
+  entities.pop_back();
+  if (has(ComponentType::Transform))
+    transforms.pop_back();
+  if (has(ComponentType::Velocity))
+    velocities.pop_back();
+  if (has(ComponentType::SpriteFrame))
+    spriteFrames.pop_back();
+  if (has(ComponentType::Animation))
+    animations.pop_back();
+  if (has(ComponentType::Color))
+    colors.pop_back();
+
+  return moved;
+}
+
+inline void Archetype::copySharedFrom(const Archetype &source, size_t sourceRow)
+{
+  size_t row = entities.size() - 1;
+  if (has(ComponentType::Transform) && source.has(ComponentType::Transform))
+    transforms[row] = source.transforms[sourceRow];
+  if (has(ComponentType::Velocity) && source.has(ComponentType::Velocity))
+    velocities[row] = source.velocities[sourceRow];
+  if (has(ComponentType::SpriteFrame) && source.has(ComponentType::SpriteFrame))
+    spriteFrames[row] = source.spriteFrames[sourceRow];
+  if (has(ComponentType::Animation) && source.has(ComponentType::Animation))
+    animations[row] = source.animations[sourceRow];
+  if (has(ComponentType::Color) && source.has(ComponentType::Color))
+    colors[row] = source.colors[sourceRow];
+}
+
+inline void Archetype::reserve(size_t count)
+{
+  entities.reserve(count);
+  if (has(ComponentType::Transform))
+    transforms.reserve(count);
+  if (has(ComponentType::Velocity))
+    velocities.reserve(count);
+  if (has(ComponentType::SpriteFrame))
+    spriteFrames.reserve(count);
+  if (has(ComponentType::Animation))
+    animations.reserve(count);
+  if (has(ComponentType::Color))
+    colors.reserve(count);
+}
+
+inline void Archetype::clear()
+{
+  entities.clear();
+  transforms.clear();
+  velocities.clear();
+  spriteFrames.clear();
+  animations.clear();
+  colors.clear();
+}
+
+// Implementation of World methods
+inline Entity World::createEntity(ComponentMask mask)
+{
+  uint32_t index;
+  if (!freeIndices.empty())
+  {
+    index = freeIndices.back();
+    freeIndices.pop_back();
+  }
+  else
+  {
+    index = static_cast<uint32_t>(records.size());
+    records.push_back({0, 0, 0, false});
+  }
+
+  EntityRecord &record = records[index];
+  Entity entity(index, record.generation);
+
+  record.archetype = findOrCreateArchetype(mask);
+  record.row = static_cast<uint32_t>(archetypes[record.archetype].pushRow(entity));
+  record.alive = true;
+  entityCount++;
+  return entity;
+}
+
+inline void World::destroyEntity(Entity entity)
+{
+  if (!isAlive(entity))
+    return;
+
+  EntityRecord &record = records[entity.index];
+  Entity moved = archetypes[record.archetype].swapRemove(record.row);
+  if (moved.isValid())
+  {
+    records[moved.index].row = record.row;
+  }
+
+  record.alive = false;
+  record.generation++;
+  freeIndices.push_back(entity.index);
+  entityCount--;
+}
+
+inline bool World::isAlive(Entity entity) const
+{
+  return entity.index < records.size() &&
+         records[entity.index].alive &&
+         records[entity.index].generation == entity.generation;
+}
+
+template <typename T>
+inline T *World::get(Entity entity)
+{
+  if (!isAlive(entity))
+    return nullptr;
+
+  const EntityRecord &record = records[entity.index];
+  Archetype &archetype = archetypes[record.archetype];
+  if (!archetype.has(ComponentTraits<T>::type))
+    return nullptr;
+  return &ComponentTraits<T>::column(archetype)[record.row];
+}
+
+template <typename T>
+inline const T *World::get(Entity entity) const
+{
+  return const_cast<World *>(this)->get<T>(entity);
+}
+
+template <typename T>
+inline void World::set(Entity entity, const T &value)
+{
+  if (!isAlive(entity))
+    return;
+
+  ComponentMask bit = componentBit(ComponentTraits<T>::type);
+  ComponentMask mask = archetypes[records[entity.index].archetype].mask;
+  if ((mask & bit) == 0)
+  {
+    moveEntity(entity, mask | bit);
+  }
+
+  *get<T>(entity) = value;
+}
+
+template <typename T>
+inline void World::remove(Entity entity)
+{
+  if (!isAlive(entity))
+    return;
+
+  ComponentMask bit = componentBit(ComponentTraits<T>::type);
+  ComponentMask mask = archetypes[records[entity.index].archetype].mask;
+  if ((mask & bit) != 0)
+  {
+    moveEntity(entity, mask & ~bit);
+  }
+}
+
+inline void World::reserve(ComponentMask mask, size_t count)
+{
+  archetypes[findOrCreateArchetype(mask)].reserve(count);
+  records.reserve(records.size() + count);
+}
+
+inline void World::clear()
+{
+  for (auto &archetype : archetypes)
+  {
+    archetype.clear();
+  }
+
+  freeIndices.clear();
+  for (uint32_t i = 0; i < records.size(); ++i)
+  {
+    if (records[i].alive)
+    {
+      records[i].alive = false;
+      records[i].generation++;
+    }
+    freeIndices.push_back(static_cast<uint32_t>(records.size()) - 1 - i);
+  }
+  entityCount = 0;
+}
+
+inline uint32_t World::findOrCreateArchetype(ComponentMask mask)
+{
+  // Worlds only ever hold a handful of component combinations, so a linear search is enough
+  for (uint32_t i = 0; i < archetypes.size(); ++i)
+  {
+    if (archetypes[i].mask == mask)
+    {
+      return i;
+    }
+  }
+
+  archetypes.emplace_back(mask);
+  return static_cast<uint32_t>(archetypes.size() - 1);
+}
+
+inline void World::moveEntity(Entity entity, ComponentMask newMask)
+{
+  uint32_t target = findOrCreateArchetype(newMask);
+  EntityRecord &record = records[entity.index];
+
+  Archetype &destination = archetypes[target];
+  Archetype &source = archetypes[record.archetype];
+
+  size_t newRow = destination.pushRow(entity);
+  destination.copySharedFrom(source, record.row);
+
+  Entity moved = source.swapRemove(record.row);
+  if (moved.isValid())
+  {
+    records[moved.index].row = record.row;
+  }
+
+  record.archetype = target;
+  record.row = static_cast<uint32_t>(newRow);
+}
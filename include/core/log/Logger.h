@@ -0,0 +1,549 @@
+#pragma once
+
+#include "../memory/AllocationTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Log calls below this level are compiled out entirely (arguments are not evaluated).
+// 0 = Trace, 1 = Debug, 2 = Info, 3 = Warning, 4 = Error
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL 2
+#else
+#define LOG_COMPILE_LEVEL 0
+#endif
+#endif
+
+enum class LogLevel : uint8_t
+{
+  Trace,
+  Debug,
+  Info,
+  Warning,
+  Error,
+  Off
+};
+
+enum class LogCategory : uint8_t
+{
+  Core,
+  Input,
+  Render,
+  Scene,
+  Animation,
+  Count
+};
+
+constexpr const char *logLevelNames[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "OFF"};
+constexpr const char *logCategoryNames[] = {"Core", "Input", "Render", "Scene", "Animation"};
+
+// Single-producer / single-consumer byte ring holding encoded log records.
+// The owning thread writes, the logger thread reads; neither side locks.
+class LogRing
+{
+public:
+  static constexpr size_t Capacity = 64 * 1024; // Power of two
+
+private:
+  std::unique_ptr<unsigned char[]> buffer;
+  alignas(64) std::atomic<uint64_t> head; // Written by the producer
+  alignas(64) std::atomic<uint64_t> tail; // Written by the consumer
+  std::atomic<uint64_t> dropped;
+
+  void copyIn(uint64_t position, const void *data, size_t size)
+  {
+    size_t offset = position & (Capacity - 1);
+    size_t first = std::min(size, Capacity - offset);
+    std::memcpy(buffer.get() + offset, data, first);
+    std::memcpy(buffer.get(), static_cast<const unsigned char *>(data) + first, size - first);
+  }
+
+  void copyOut(uint64_t position, void *data, size_t size) const
+  {
+    size_t offset = position & (Capacity - 1);
+    size_t first = std::min(size, Capacity - offset);
+    std::memcpy(data, buffer.get() + offset, first);
+    std::memcpy(static_cast<unsigned char *>(data) + first, buffer.get(), size - first);
+  }
+
+public:
+  LogRing() : buffer(new unsigned char[Capacity]), head(0), tail(0), dropped(0) {}
+
+  LogRing(const LogRing &) = delete;
+  LogRing &operator=(const LogRing &) = delete;
+
+  // Producer side; returns false (and counts a drop) when the ring is full
+  bool push(const void *record, size_t size)
+  {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    uint64_t t = tail.load(std::memory_order_acquire);
+    if (Capacity - (h - t) < size)
+    {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    copyIn(h, record, size);
+    head.store(h + size, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side; records start with their uint16_t size. Returns 0 when empty.
+  size_t pop(void *record, size_t maxSize)
+  {
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    uint64_t h = head.load(std::memory_order_acquire);
+    if (h == t)
+      return 0;
+
+    uint16_t size = 0;
+    copyOut(t, &size, sizeof(size));
+    if (size > maxSize)
+    {
+      // Cannot happen with records from LogRecordWriter; skip rather than overrun
+      tail.store(t + size, std::memory_order_release);
+      return 0;
+    }
+    copyOut(t, record, size);
+    tail.store(t + size, std::memory_order_release);
+    return size;
+  }
+
+  uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+// Encoded record: header followed by tagged arguments. The format string is
+// stored as a pointer, so it must be a string literal (or otherwise outlive the logger).
+struct LogRecordHeader
+{
+  uint16_t size;
+  LogLevel level;
+  LogCategory category;
+  uint64_t timestamp; // Nanoseconds since the logger started
+  const char *format;
+};
+
+enum class LogArgType : uint8_t
+{
+  Int,
+  UInt,
+  Double,
+  Bool,
+  Char,
+  String
+};
+
+// Serializes arguments into a fixed stack buffer (long strings are truncated)
+class LogRecordWriter
+{
+public:
+  static constexpr size_t MaxRecordSize = 512;
+
+private:
+  unsigned char data[MaxRecordSize];
+  size_t used;
+
+  template <typename T>
+  void put(const T &value)
+  {
+    if (used + sizeof(T) <= MaxRecordSize)
+    {
+      std::memcpy(data + used, &value, sizeof(T));
+      used += sizeof(T);
+    }
+  }
+
+public:
+  explicit LogRecordWriter(const LogRecordHeader &header) : used(sizeof(LogRecordHeader))
+  {
+    std::memcpy(data, &header, sizeof(header));
+  }
+
+  template <typename T>
+  void add(const T &value)
+  {
+    using Type = std::decay_t<T>;
+    if (used + 1 + sizeof(uint64_t) > MaxRecordSize)
+      return;
+
+    if constexpr (std::is_same_v<Type, bool>)
+    {
+      put(LogArgType::Bool);
+      put(static_cast<uint8_t>(value));
+    }
+    else if constexpr (std::is_same_v<Type, char>)
+    {
+      put(LogArgType::Char);
+      put(value);
+    }
+    else if constexpr (std::is_enum_v<Type>)
+    {
+      put(LogArgType::Int);
+      put(static_cast<int64_t>(value));
+    }
+    else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+    {
+      put(LogArgType::Int);
+      put(static_cast<int64_t>(value));
+    }
+    else if constexpr (std::is_integral_v<Type>)
+    {
+      put(LogArgType::UInt);
+      put(static_cast<uint64_t>(value));
+    }
+    else if constexpr (std::is_floating_point_v<Type>)
+    {
+      put(LogArgType::Double);
+      put(static_cast<double>(value));
+    }
+    else
+    {
+      static_assert(std::is_convertible_v<const T &, std::string_view>, "Unsupported log argument type");
+      std::string_view text = value;
+      size_t room = MaxRecordSize - used - 1 - sizeof(uint16_t);
+      uint16_t length = static_cast<uint16_t>(std::min(text.size(), room));
+      put(LogArgType::String);
+      put(length);
+      std::memcpy(data + used, text.data(), length);
+      used += length;
+    }
+  }
+
+  const unsigned char *finish()
+  {
+    uint16_t size = static_cast<uint16_t>(used);
+    std::memcpy(data, &size, sizeof(size));
+    return data;
+  }
+
+  size_t size() const { return used; }
+};
+
+// Asynchronous logger. Callers encode a binary record (format pointer plus
+// raw argument values) into their thread's LogRing; a background thread
+// drains the rings, formats the text and writes it out. Nothing on the calling
+// thread formats, allocates (after the first call) or touches stdout.
+class Logger
+{
+private:
+  std::atomic<uint8_t> levels[static_cast<size_t>(LogCategory::Count)];
+  std::chrono::steady_clock::time_point startTime;
+
+  std::mutex registryMutex; // Only taken when a thread logs for the first time
+  std::vector<std::unique_ptr<LogRing>> rings;
+
+  std::mutex drainMutex;
+  std::vector<std::pair<uint64_t, std::string>> pending; // Reused by drain()
+  std::string outputText;
+  FILE *output;
+  std::atomic<uint64_t> written;
+
+  std::thread worker;
+  std::mutex wakeMutex;
+  std::condition_variable wake;
+  bool running;
+
+  // Private constructor for singleton
+  Logger();
+
+  LogRing *threadRing();
+  void run();
+  size_t drain();
+  void formatRecord(const unsigned char *record, std::string &text) const;
+
+public:
+  // Singleton access
+  static Logger &getInstance()
+  {
+    static Logger instance;
+    return instance;
+  }
+
+  ~Logger() { stop(); }
+
+  // Prevent copying
+  Logger(const Logger &) = delete;
+  Logger &operator=(const Logger &) = delete;
+
+  // Runtime thresholds (the compile-time LOG_COMPILE_LEVEL still applies)
+  void setLevel(LogLevel level);
+  void setLevel(LogCategory category, LogLevel level);
+  bool isEnabled(LogLevel level, LogCategory category) const
+  {
+    return static_cast<uint8_t>(level) >= levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+  }
+
+  // Queue a record; "{}" in format is replaced by the next argument when it is written out
+  template <typename... Args>
+  void log(LogLevel level, LogCategory category, const char *format, const Args &...args);
+
+  // Write everything queued so far before returning
+  void flush() { drain(); }
+
+  // Drain and join the background thread (called on exit)
+  void stop();
+
+  // Destination for formatted text (stdout by default)
+  void setOutput(FILE *file);
+
+  // Statistics
+  uint64_t getDroppedCount();
+  uint64_t getWrittenCount() const { return written.load(std::memory_order_relaxed); }
+};
+
+// Logging macros: LOG_DEBUG(Input, "Key {} pressed", key)
+#define LOG_AT(level, category, ...)                                                      \
+  do                                                                                      \
+  {                                                                                       \
+    if constexpr ((level) >= static_cast<LogLevel>(LOG_COMPILE_LEVEL))                   \
+    {                                                                                     \
+      Logger &logger_ = Logger::getInstance();                                            \
+      if (logger_.isEnabled(level, LogCategory::category))                                \
+        logger_.log(level, LogCategory::category, __VA_ARGS__);                           \
+    }                                                                                     \
+  } while (0)
+
+#define LOG_TRACE(category, ...) LOG_AT(LogLevel::Trace, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG_AT(LogLevel::Debug, category, __VA_ARGS__)
+#define LOG_INFO(category, ...) LOG_AT(LogLevel::Info, category, __VA_ARGS__)
+#define LOG_WARNING(category, ...) LOG_AT(LogLevel::Warning, category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) LOG_AT(LogLevel::Error, category, __VA_ARGS__)
+
+// Implementation
+inline Logger::Logger()
+    : startTime(std::chrono::steady_clock::now()), output(stdout), written(0), running(true)
+{
+  for (auto &level : levels)
+  {
+    level.store(static_cast<uint8_t>(LogLevel::Info), std::memory_order_relaxed);
+  }
+  worker = std::thread(&Logger::run, this);
+}
+
+inline void Logger::setLevel(LogLevel level)
+{
+  for (auto &categoryLevel : levels)
+  {
+    categoryLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+  }
+}
+
+inline void Logger::setLevel(LogCategory category, LogLevel level)
+{
+  levels[static_cast<size_t>(category)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+template <typename... Args>
+inline void Logger::log(LogLevel level, LogCategory category, const char *format, const Args &...args)
+{
+  LogRing *ring = threadRing();
+
+  LogRecordHeader header;
+  header.size = 0;
+  header.level = level;
+  header.category = category;
+  header.timestamp = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+  header.format = format;
+
+  LogRecordWriter writer(header);
+  (writer.add(args), ...);
+  const unsigned char *record = writer.finish();
+  ring->push(record, writer.size());
+}
+
+inline LogRing *Logger::threadRing()
+{
+  thread_local LogRing *ring = nullptr;
+  if (!ring)
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    rings.push_back(std::make_unique<LogRing>());
+    ring = rings.back().get();
+  }
+  return ring;
+}
+
+inline void Logger::run()
+{
+  std::unique_lock<std::mutex> lock(wakeMutex);
+  while (running)
+  {
+    lock.unlock();
+    drain();
+    lock.lock();
+    wake.wait_for(lock, std::chrono::milliseconds(2), [this] { return !running; });
+  }
+}
+
+inline size_t Logger::drain()
+{
+  ALLOCATION_TAG_SCOPE(Log);
+  std::lock_guard<std::mutex> drainLock(drainMutex);
+
+  // Rings never go away, so a snapshot of the registry is safe to read unlocked
+  std::vector<LogRing *> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    snapshot.reserve(rings.size());
+    for (auto &ring : rings)
+    {
+      snapshot.push_back(ring.get());
+    }
+  }
+
+  pending.clear();
+  unsigned char record[LogRecordWriter::MaxRecordSize];
+  for (LogRing *ring : snapshot)
+  {
+    while (ring->pop(record, sizeof(record)) != 0)
+    {
+      LogRecordHeader header;
+      std::memcpy(&header, record, sizeof(header));
+      pending.emplace_back(header.timestamp, std::string());
+      formatRecord(record, pending.back().second);
+    }
+  }
+
+  if (pending.empty())
+    return 0;
+
+  // Interleave threads by time
+  std::stable_sort(pending.begin(), pending.end(),
+                   [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  outputText.clear();
+  for (const auto &entry : pending)
+  {
+    outputText += entry.second;
+  }
+  std::fwrite(outputText.data(), 1, outputText.size(), output);
+  std::fflush(output);
+
+  written.fetch_add(pending.size(), std::memory_order_relaxed);
+  return pending.size();
+}
+
+inline void Logger::formatRecord(const unsigned char *record, std::string &text) const
+{
+  LogRecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+  const unsigned char *cursor = record + sizeof(header);
+  const unsigned char *end = record + header.size;
+
+  char prefix[96];
+  std::snprintf(prefix, sizeof(prefix), "[%11.6f] [%s] [%s] ",
+                header.timestamp / 1e9,
+                logLevelNames[static_cast<size_t>(header.level)],
+                logCategoryNames[static_cast<size_t>(header.category)]);
+  text += prefix;
+
+  for (const char *f = header.format; *f; ++f)
+  {
+    if (f[0] != '{' || f[1] != '}' || cursor >= end)
+    {
+      text += *f;
+      continue;
+    }
+    ++f;
+
+    LogArgType type;
+    std::memcpy(&type, cursor, sizeof(type));
+    cursor += sizeof(type);
+
+    char number[32];
+    switch (type)
+    {
+    case LogArgType::Int:
+    {
+      int64_t value;
+      std::memcpy(&value, cursor, sizeof(value));
+      cursor += sizeof(value);
+      std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(value));
+      text += number;
+      break;
+    }
+    case LogArgType::UInt:
+    {
+      uint64_t value;
+      std::memcpy(&value, cursor, sizeof(value));
+      cursor += sizeof(value);
+      std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(value));
+      text += number;
+      break;
+    }
+    case LogArgType::Double:
+    {
+      double value;
+      std::memcpy(&value, cursor, sizeof(value));
+      cursor += sizeof(value);
+      std::snprintf(number, sizeof(number), "%g", value);
+      text += number;
+      break;
+    }
+    case LogArgType::Bool:
+      text += *cursor ? "true" : "false";
+      cursor += 1;
+      break;
+    case LogArgType::Char:
+      text += static_cast<char>(*cursor);
+      cursor += 1;
+      break;
+    case LogArgType::String:
+    {
+      uint16_t length;
+      std::memcpy(&length, cursor, sizeof(length));
+      cursor += sizeof(length);
+      text.append(reinterpret_cast<const char *>(cursor), length);
+      cursor += length;
+      break;
+    }
+    }
+  }
+  text += '\n';
+}
+
+inline void Logger::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    if (!running)
+      return;
+    running = false;
+  }
+  wake.notify_one();
+  if (worker.joinable())
+  {
+    worker.join();
+  }
+  drain();
+}
+
+inline void Logger::setOutput(FILE *file)
+{
+  std::lock_guard<std::mutex> lock(drainMutex);
+  output = file ? file : stdout;
+}
+
+inline uint64_t Logger::getDroppedCount()
+{
+  std::lock_guard<std::mutex> lock(registryMutex);
+  uint64_t total = 0;
+  for (const auto &ring : rings)
+  {
+    total += ring->getDroppedCount();
+  }
+  return total;
+}
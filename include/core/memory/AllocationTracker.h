@@ -0,0 +1,440 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// Set ALLOCATION_TRACKING to 0 to compile the global operator new/delete hooks out
+#ifndef ALLOCATION_TRACKING
+#define ALLOCATION_TRACKING 1
+#endif
+
+// Subsystem an allocation is charged to (see ALLOCATION_TAG_SCOPE)
+enum class AllocationTag : uint8_t
+{
+  Untagged,
+  Core,
+  Input,
+  Scene,
+  Animation,
+  Render,
+  Log,
+  Profile,
+  Count
+};
+
+constexpr uint32_t AllocationTagCount = static_cast<uint32_t>(AllocationTag::Count);
+
+inline const char *allocationTagName(AllocationTag tag)
+{
+  switch (tag)
+  {
+  case AllocationTag::Untagged:
+    return "Untagged";
+  case AllocationTag::Core:
+    return "Core";
+  case AllocationTag::Input:
+    return "Input";
+  case AllocationTag::Scene:
+    return "Scene";
+  case AllocationTag::Animation:
+    return "Animation";
+  case AllocationTag::Render:
+    return "Render";
+  case AllocationTag::Log:
+    return "Log";
+  case AllocationTag::Profile:
+    return "Profile";
+  default:
+    return "Unknown";
+  }
+}
+
+struct AllocationCounts
+{
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+};
+
+// Counts every global operator new/delete, per subsystem tag, and per frame on
+// the frame thread. After a warm-up period it can also treat any allocation on
+// the frame thread as a bug ("steady-state" mode): the call stack is captured
+// into a fixed buffer inside the hook and reported from endFrame().
+//
+// The hooks themselves are defined in exactly one translation unit:
+//   #define ALLOCATION_TRACKER_IMPLEMENTATION
+//   #include "core/memory/AllocationTracker.h"
+class AllocationTracker
+{
+public:
+  static constexpr int MaxStackDepth = 16;
+  static constexpr uint32_t MaxViolations = 32; // Kept per reporting interval
+
+  struct Violation
+  {
+    uint64_t frame;
+    size_t size;
+    AllocationTag tag;
+    int depth;
+    void *stack[MaxStackDepth];
+  };
+
+private:
+  struct TagCounters
+  {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+  };
+
+  TagCounters tags[AllocationTagCount];
+  std::atomic<uint64_t> frees{0};
+
+  // Frame-thread counters; only the frame thread touches these
+  AllocationCounts frameCounts[AllocationTagCount];
+  AllocationCounts lastFrameCounts[AllocationTagCount];
+  AllocationCounts lastFrameTotal;
+  AllocationCounts steadyTotal; // Since the end of the warm-up
+  uint64_t maxFrameAllocations;
+  uint64_t frameIndex;
+
+  // Steady-state mode
+  uint64_t warmupFrames;
+  bool steadyStateEnabled;
+  bool steadyStateArmed;
+  bool abortOnViolation;
+  Violation violations[MaxViolations];
+  uint32_t violationCount;
+  uint64_t violationTotal;
+
+  static bool &isFrameThread()
+  {
+    thread_local bool frameThread = false;
+    return frameThread;
+  }
+
+  static bool &inHook()
+  {
+    thread_local bool busy = false;
+    return busy;
+  }
+
+  // Private constructor for singleton; must not allocate
+  AllocationTracker()
+      : maxFrameAllocations(0), frameIndex(0), warmupFrames(0), steadyStateEnabled(false),
+        steadyStateArmed(false), abortOnViolation(false), violationCount(0), violationTotal(0) {}
+
+  void reportViolations();
+
+public:
+  // Singleton access
+  static AllocationTracker &getInstance()
+  {
+    static AllocationTracker instance;
+    return instance;
+  }
+
+  // Prevent copying
+  AllocationTracker(const AllocationTracker &) = delete;
+  AllocationTracker &operator=(const AllocationTracker &) = delete;
+
+  // Tag charged for allocations on the calling thread
+  static AllocationTag &currentTag()
+  {
+    thread_local AllocationTag tag = AllocationTag::Untagged;
+    return tag;
+  }
+
+  // Called by the operator new/delete hooks
+  void recordAllocation(size_t size);
+  void recordFree() { frees.fetch_add(1, std::memory_order_relaxed); }
+
+  // The thread that runs the game loop; per-frame counts and steady-state
+  // checks only look at this thread
+  void setFrameThread() { isFrameThread() = true; }
+
+  // Called by the game loop once per frame
+  void endFrame();
+
+  // After warmup frames, report every allocation on the frame thread with its
+  // call stack (optionally aborting on the first report)
+  void enableSteadyStateCheck(uint64_t warmup, bool abortOnAllocation = false);
+  void disableSteadyStateCheck() { steadyStateEnabled = steadyStateArmed = false; }
+  bool isSteadyState() const { return steadyStateArmed; }
+
+  // Statistics
+  AllocationCounts getTotal(AllocationTag tag) const;
+  AllocationCounts getTotal() const;
+  uint64_t getFreeCount() const { return frees.load(std::memory_order_relaxed); }
+  const AllocationCounts &getLastFrame(AllocationTag tag) const { return lastFrameCounts[static_cast<uint32_t>(tag)]; }
+  const AllocationCounts &getLastFrame() const { return lastFrameTotal; }
+  const AllocationCounts &getSteadyStateTotal() const { return steadyTotal; }
+  uint64_t getMaxFrameAllocations() const { return maxFrameAllocations; }
+  uint64_t getFrameCount() const { return frameIndex; }
+  uint64_t getViolationCount() const { return violationTotal; }
+
+  // Per-tag totals and per-frame figures since the warm-up
+  void printReport(std::ostream &out) const;
+};
+
+// Charges allocations on this thread to a subsystem for the lifetime of the scope
+class AllocationTagScope
+{
+private:
+  AllocationTag previous;
+
+public:
+  explicit AllocationTagScope(AllocationTag tag) : previous(AllocationTracker::currentTag())
+  {
+    AllocationTracker::currentTag() = tag;
+  }
+  ~AllocationTagScope() { AllocationTracker::currentTag() = previous; }
+
+  AllocationTagScope(const AllocationTagScope &) = delete;
+  AllocationTagScope &operator=(const AllocationTagScope &) = delete;
+};
+
+#define ALLOCATION_TAG_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_TAG_CONCAT(a, b) ALLOCATION_TAG_CONCAT_INNER(a, b)
+#define ALLOCATION_TAG_SCOPE(tag) \
+  AllocationTagScope ALLOCATION_TAG_CONCAT(allocationTagScope_, __LINE__)(AllocationTag::tag)
+
+// Implementation
+inline void AllocationTracker::recordAllocation(size_t size)
+{
+  AllocationTag tag = currentTag();
+  uint32_t index = static_cast<uint32_t>(tag);
+  tags[index].allocations.fetch_add(1, std::memory_order_relaxed);
+  tags[index].bytes.fetch_add(size, std::memory_order_relaxed);
+
+  if (!isFrameThread() || inHook())
+    return;
+
+  frameCounts[index].allocations++;
+  frameCounts[index].bytes += size;
+
+  if (!steadyStateArmed)
+    return;
+
+  inHook() = true;
+  violationTotal++;
+  if (violationCount < MaxViolations)
+  {
+    Violation &violation = violations[violationCount++];
+    violation.frame = frameIndex;
+    violation.size = size;
+    violation.tag = tag;
+#if defined(__GLIBC__)
+    violation.depth = backtrace(violation.stack, MaxStackDepth);
+#else
+    violation.depth = 0;
+#endif
+  }
+  inHook() = false;
+
+  if (abortOnViolation)
+  {
+    reportViolations();
+    std::abort();
+  }
+}
+
+inline void AllocationTracker::endFrame()
+{
+  AllocationCounts total;
+  for (uint32_t i = 0; i < AllocationTagCount; ++i)
+  {
+    lastFrameCounts[i] = frameCounts[i];
+    total.allocations += frameCounts[i].allocations;
+    total.bytes += frameCounts[i].bytes;
+    frameCounts[i] = AllocationCounts();
+  }
+  lastFrameTotal = total;
+
+  if (steadyStateArmed)
+  {
+    steadyTotal.allocations += total.allocations;
+    steadyTotal.bytes += total.bytes;
+    if (total.allocations > maxFrameAllocations)
+      maxFrameAllocations = total.allocations;
+  }
+
+  if (violationCount != 0)
+  {
+    reportViolations();
+  }
+
+  frameIndex++;
+  if (steadyStateEnabled && !steadyStateArmed && frameIndex >= warmupFrames)
+  {
+    steadyStateArmed = true;
+    std::cout << "AllocationTracker: steady state from frame " << frameIndex << std::endl;
+  }
+}
+
+inline void AllocationTracker::enableSteadyStateCheck(uint64_t warmup, bool abortOnAllocation)
+{
+#if defined(__GLIBC__)
+  // The first backtrace() loads the unwinder, which allocates; do it now
+  void *stack[2];
+  backtrace(stack, 2);
+#endif
+  warmupFrames = frameIndex + warmup;
+  abortOnViolation = abortOnAllocation;
+  steadyStateEnabled = true;
+  steadyStateArmed = false;
+  steadyTotal = AllocationCounts();
+  maxFrameAllocations = 0;
+}
+
+inline void AllocationTracker::reportViolations()
+{
+  // Printing may allocate; do not record those allocations
+  inHook() = true;
+  std::cerr << "AllocationTracker: " << violationCount << " allocation(s) after warm-up in frame "
+            << frameIndex << std::endl;
+  for (uint32_t i = 0; i < violationCount; ++i)
+  {
+    const Violation &violation = violations[i];
+    std::cerr << "  " << violation.size << " bytes [" << allocationTagName(violation.tag) << "] at:" << std::endl;
+#if defined(__GLIBC__)
+    // Writes straight to stderr without allocating (link with -rdynamic for symbol names)
+    backtrace_symbols_fd(violation.stack, violation.depth, STDERR_FILENO);
+#endif
+  }
+  violationCount = 0;
+  inHook() = false;
+}
+
+inline AllocationCounts AllocationTracker::getTotal(AllocationTag tag) const
+{
+  const TagCounters &counters = tags[static_cast<uint32_t>(tag)];
+  AllocationCounts counts;
+  counts.allocations = counters.allocations.load(std::memory_order_relaxed);
+  counts.bytes = counters.bytes.load(std::memory_order_relaxed);
+  return counts;
+}
+
+inline AllocationCounts AllocationTracker::getTotal() const
+{
+  AllocationCounts total;
+  for (uint32_t i = 0; i < AllocationTagCount; ++i)
+  {
+    AllocationCounts counts = getTotal(static_cast<AllocationTag>(i));
+    total.allocations += counts.allocations;
+    total.bytes += counts.bytes;
+  }
+  return total;
+}
+
+inline void AllocationTracker::printReport(std::ostream &out) const
+{
+  out << "=== Allocations ===" << std::endl;
+  for (uint32_t i = 0; i < AllocationTagCount; ++i)
+  {
+    AllocationCounts counts = getTotal(static_cast<AllocationTag>(i));
+    if (counts.allocations == 0)
+      continue;
+    out << allocationTagName(static_cast<AllocationTag>(i)) << ": " << counts.allocations
+        << " allocations, " << counts.bytes << " bytes" << std::endl;
+  }
+  out << "Frees: " << getFreeCount() << std::endl;
+
+  if (steadyStateArmed)
+  {
+    uint64_t steadyFrames = frameIndex > warmupFrames ? frameIndex - warmupFrames : 0;
+    double perFrame = steadyFrames ? static_cast<double>(steadyTotal.allocations) / steadyFrames : 0.0;
+    out << "Steady state (" << steadyFrames << " frames): " << perFrame << " allocations/frame, max "
+        << maxFrameAllocations << ", " << violationTotal << " reported" << std::endl;
+  }
+  out << "===================" << std::endl;
+}
+
+#if ALLOCATION_TRACKING && defined(ALLOCATION_TRACKER_IMPLEMENTATION)
+// Global allocation hooks (replaceable operator new/delete; one definition per program)
+namespace allocation_tracker_detail
+{
+  inline void *allocate(std::size_t size)
+  {
+    AllocationTracker::getInstance().recordAllocation(size);
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+      throw std::bad_alloc();
+    return ptr;
+  }
+
+  inline void *allocateAligned(std::size_t size, std::align_val_t alignment)
+  {
+    AllocationTracker::getInstance().recordAllocation(size);
+    std::size_t align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+    void *ptr = _aligned_malloc(size ? size : 1, align);
+#else
+    void *ptr = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+    if (!ptr)
+      throw std::bad_alloc();
+    return ptr;
+  }
+
+  inline void release(void *ptr) noexcept
+  {
+    if (!ptr)
+      return;
+    AllocationTracker::getInstance().recordFree();
+    std::free(ptr);
+  }
+
+  inline void releaseAligned(void *ptr) noexcept
+  {
+    if (!ptr)
+      return;
+    AllocationTracker::getInstance().recordFree();
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+  }
+}
+
+void *operator new(std::size_t size) { return allocation_tracker_detail::allocate(size); }
+void *operator new[](std::size_t size) { return allocation_tracker_detail::allocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocation_tracker_detail::allocateAligned(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocation_tracker_detail::allocateAligned(size, alignment); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  AllocationTracker::getInstance().recordAllocation(size);
+  return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+  AllocationTracker::getInstance().recordAllocation(size);
+  return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept { allocation_tracker_detail::release(ptr); }
+void operator delete[](void *ptr) noexcept { allocation_tracker_detail::release(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { allocation_tracker_detail::release(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { allocation_tracker_detail::release(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { allocation_tracker_detail::releaseAligned(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { allocation_tracker_detail::releaseAligned(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { allocation_tracker_detail::releaseAligned(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { allocation_tracker_detail::releaseAligned(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { allocation_tracker_detail::release(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { allocation_tracker_detail::release(ptr); }
+#endif
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+// Linear (bump) arena reset as a whole. Requests that do not fit the fixed
+// buffer fall back to the heap and are released on the next reset.
+class FrameArena
+{
+private:
+  struct OverflowBlock
+  {
+    OverflowBlock *next;
+  };
+
+  unsigned char *buffer;
+  size_t capacity;
+  size_t offset;
+  OverflowBlock *overflow; // Heap blocks handed out since the last reset
+  size_t overflowBytes;
+  size_t overflowCount;
+
+public:
+  explicit FrameArena(size_t bytes = 0)
+      : buffer(nullptr), capacity(0), offset(0), overflow(nullptr), overflowBytes(0), overflowCount(0)
+  {
+    if (bytes)
+      setCapacity(bytes);
+  }
+
+  ~FrameArena()
+  {
+    reset();
+    std::free(buffer);
+  }
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  // Replace the buffer (drops everything allocated so far)
+  void setCapacity(size_t bytes);
+
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+  {
+    size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+    if (aligned + size <= capacity)
+    {
+      offset = aligned + size;
+      return buffer + aligned;
+    }
+    return allocateOverflow(size, alignment);
+  }
+
+  // Release everything at once
+  void reset();
+
+  size_t getCapacity() const { return capacity; }
+  size_t getUsed() const { return offset; }
+  size_t getOverflowBytes() const { return overflowBytes; }
+  size_t getOverflowCount() const { return overflowCount; }
+
+private:
+  void *allocateOverflow(size_t size, size_t alignment);
+};
+
+// Frame-scoped scratch memory for transient data (draw lists, query results,
+// sort buffers, temporary strings). Each thread gets its own pair of arenas so
+// allocation never locks; the pair is double-buffered, so memory allocated in
+// frame N stays valid until beginFrame() of frame N + 2. That lets the render
+// side of a pipelined frame read what update produced in the previous one.
+//
+// Nothing is freed individually: deallocate is a no-op and the whole arena is
+// reset when its turn comes around again.
+class FrameAllocator
+{
+private:
+  struct ThreadArenas
+  {
+    FrameArena arenas[2];
+  };
+
+  size_t arenaBytes;
+  std::atomic<uint32_t> parity;
+  uint64_t frameIndex;
+
+  std::mutex registryMutex; // Only taken when a thread allocates for the first time
+  std::vector<std::unique_ptr<ThreadArenas>> threads;
+
+  // Statistics
+  size_t lastFrameBytes;
+  size_t highWaterBytes;
+  size_t totalOverflowCount;
+
+  // Private constructor for singleton
+  FrameAllocator()
+      : arenaBytes(1 << 20), parity(0), frameIndex(0), lastFrameBytes(0), highWaterBytes(0), totalOverflowCount(0) {}
+
+  ThreadArenas *threadArenas();
+
+public:
+  // Singleton access
+  static FrameAllocator &getInstance()
+  {
+    static FrameAllocator instance;
+    return instance;
+  }
+
+  // Prevent copying
+  FrameAllocator(const FrameAllocator &) = delete;
+  FrameAllocator &operator=(const FrameAllocator &) = delete;
+
+  // Bytes per arena for threads that have not allocated yet (each thread owns two)
+  void setArenaSize(size_t bytes) { arenaBytes = bytes; }
+
+  // Called at the top of every frame, while no job is allocating. Resets the
+  // arenas used two frames ago and makes them current.
+  void beginFrame();
+
+  // Scratch memory valid until the next-but-one beginFrame()
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+  {
+    uint32_t current = parity.load(std::memory_order_relaxed);
+    return threadArenas()->arenas[current].allocate(size, alignment);
+  }
+
+  template <typename T>
+  T *allocateArray(size_t count)
+  {
+    return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+  }
+
+  // Statistics (bytes in the fixed arenas plus heap fallback, all threads)
+  size_t getLastFrameBytes() const { return lastFrameBytes; }
+  size_t getHighWaterBytes() const { return highWaterBytes; }
+  size_t getOverflowCount() const { return totalOverflowCount; }
+  uint64_t getFrameIndex() const { return frameIndex; }
+};
+
+// STL allocator adapter, e.g. FrameVector<DrawCommand> or FrameString
+template <typename T>
+struct FrameStlAllocator
+{
+  using value_type = T;
+
+  FrameStlAllocator() = default;
+  template <typename U>
+  FrameStlAllocator(const FrameStlAllocator<U> &) {}
+
+  T *allocate(size_t count) { return FrameAllocator::getInstance().allocateArray<T>(count); }
+  void deallocate(T *, size_t) {}
+
+  template <typename U>
+  bool operator==(const FrameStlAllocator<U> &) const { return true; }
+  template <typename U>
+  bool operator!=(const FrameStlAllocator<U> &) const { return false; }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameStlAllocator<char>>;
+
+// Implementation
+inline void FrameArena::setCapacity(size_t bytes)
+{
+  reset();
+  std::free(buffer);
+  buffer = static_cast<unsigned char *>(std::malloc(bytes));
+  capacity = buffer ? bytes : 0;
+}
+
+inline void *FrameArena::allocateOverflow(size_t size, size_t alignment)
+{
+  // Header first, then the payload at the requested alignment
+  size_t header = (sizeof(OverflowBlock) + alignment - 1) & ~(alignment - 1);
+  unsigned char *block = static_cast<unsigned char *>(std::malloc(header + size + alignment));
+  if (!block)
+    throw std::bad_alloc();
+
+  OverflowBlock *node = reinterpret_cast<OverflowBlock *>(block);
+  node->next = overflow;
+  overflow = node;
+  overflowBytes += size;
+  overflowCount++;
+
+  uintptr_t payload = reinterpret_cast<uintptr_t>(block) + header;
+  payload = (payload + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+  return reinterpret_cast<void *>(payload);
+}
+
+inline void FrameArena::reset()
+{
+  while (overflow)
+  {
+    OverflowBlock *next = overflow->next;
+    std::free(overflow);
+    overflow = next;
+  }
+  offset = 0;
+  overflowBytes = 0;
+  overflowCount = 0;
+}
+
+inline FrameAllocator::ThreadArenas *FrameAllocator::threadArenas()
+{
+  thread_local ThreadArenas *arenas = nullptr;
+  if (!arenas)
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    threads.push_back(std::make_unique<ThreadArenas>());
+    arenas = threads.back().get();
+    arenas->arenas[0].setCapacity(arenaBytes);
+    arenas->arenas[1].setCapacity(arenaBytes);
+  }
+  return arenas;
+}
+
+inline void FrameAllocator::beginFrame()
+{
+  std::lock_guard<std::mutex> lock(registryMutex);
+  uint32_t current = parity.load(std::memory_order_relaxed);
+
+  // Account for the frame that just ended
+  size_t used = 0;
+  for (const auto &thread : threads)
+  {
+    const FrameArena &arena = thread->arenas[current];
+    used += arena.getUsed() + arena.getOverflowBytes();
+    totalOverflowCount += arena.getOverflowCount();
+  }
+  lastFrameBytes = used;
+  if (used > highWaterBytes)
+    highWaterBytes = used;
+
+  // Flip and reset the buffers from two frames ago
+  current ^= 1;
+  for (auto &thread : threads)
+  {
+    thread->arenas[current].reset();
+  }
+  parity.store(current, std::memory_order_relaxed);
+  frameIndex++;
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Bump allocator for scene nodes.
+// Node::operator new allocates from the arena that is current on the calling
+// thread (see NodeArena::Scope), so std::make_unique<Triangle>(...) keeps
+// working unchanged. A freed node goes on a free list for its size class and
+// the next node of that size reuses it, so nodes created and freed at runtime
+// do not grow the arena. Blocks are returned in bulk when the arena is reset
+// or destroyed. Nodes are still destroyed one by one (each runs its
+// destructor), so the bulk release saves the heap frees, not the teardown walk.
+class NodeArena
+{
+private:
+  struct Block
+  {
+    std::unique_ptr<unsigned char[]> memory;
+    size_t size;
+    size_t used;
+  };
+
+  // Sizes are rounded up to a multiple of this; one free list per multiple
+  static constexpr size_t SizeClassBytes = alignof(std::max_align_t);
+  static constexpr size_t MaxPooledSize = 4096; // Larger frees wait for reset()
+
+  std::vector<Block> blocks;
+  std::vector<void *> freeLists; // Per size class, linked through the first bytes of each free allocation
+  size_t blockSize;
+  size_t liveCount;       // Allocations not yet freed
+  size_t allocationCount; // Allocations since the last reset
+  size_t reuseCount;      // Of those, served from a free list
+  size_t bytesUsed;       // Bytes taken from the blocks since the last reset
+  size_t blockAllocations;
+  bool orphaned; // Owner is gone, delete the arena once the last node is freed
+
+  static NodeArena *&current()
+  {
+    thread_local NodeArena *arena = nullptr;
+    return arena;
+  }
+
+public:
+  explicit NodeArena(size_t blockBytes = 64 * 1024)
+      : blockSize(blockBytes), liveCount(0), allocationCount(0), reuseCount(0), bytesUsed(0),
+        blockAllocations(0), orphaned(false) {}
+
+  ~NodeArena() = default;
+
+  NodeArena(const NodeArena &) = delete;
+  NodeArena &operator=(const NodeArena &) = delete;
+
+  // Allocation (size must be the size that was allocated, as sized delete passes it)
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+  void deallocate(void *ptr, size_t size);
+
+  // Release every block at once; only valid when no allocation is still live
+  bool reset();
+
+  // Statistics
+  size_t getLiveCount() const { return liveCount; }
+  size_t getAllocationCount() const { return allocationCount; }
+  size_t getReuseCount() const { return reuseCount; }
+  size_t getBytesUsed() const { return bytesUsed; }
+  size_t getBlockCount() const { return blocks.size(); }
+  size_t getBlockAllocations() const { return blockAllocations; }
+
+  // Arena used by Node::operator new on this thread (nullptr = global heap)
+  static NodeArena *getCurrent() { return current(); }
+
+  // Makes an arena current for the lifetime of the scope
+  class Scope
+  {
+  private:
+    NodeArena *previous;
+
+  public:
+    explicit Scope(NodeArena *arena) : previous(current()) { current() = arena; }
+    ~Scope() { current() = previous; }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+  };
+
+  // Deleter for owners: frees the arena now, or as soon as the last escaped node is freed
+  struct Deleter
+  {
+    void operator()(NodeArena *arena) const
+    {
+      if (arena->liveCount == 0)
+      {
+        delete arena;
+      }
+      else
+      {
+        arena->orphaned = true;
+      }
+    }
+  };
+};
+
+// Implementation
+inline void *NodeArena::allocate(size_t size, size_t alignment)
+{
+  size = (size + SizeClassBytes - 1) & ~(SizeClassBytes - 1);
+
+  // Reuse a freed allocation of the same size class
+  size_t sizeClass = size / SizeClassBytes;
+  if (alignment <= SizeClassBytes && sizeClass < freeLists.size() && freeLists[sizeClass])
+  {
+    void *result = freeLists[sizeClass];
+    freeLists[sizeClass] = *static_cast<void **>(result);
+    liveCount++;
+    allocationCount++;
+    reuseCount++;
+    return result;
+  }
+
+  if (!blocks.empty())
+  {
+    Block &block = blocks.back();
+    size_t offset = (block.used + alignment - 1) & ~(alignment - 1);
+    if (offset + size <= block.size)
+    {
+      block.used = offset + size;
+      liveCount++;
+      allocationCount++;
+      bytesUsed += size;
+      return block.memory.get() + offset;
+    }
+  }
+
+  // Start a new block (oversized requests get a block of their own)
+  size_t newBlockSize = size + alignment > blockSize ? size + alignment : blockSize;
+  Block block{std::unique_ptr<unsigned char[]>(new unsigned char[newBlockSize]), newBlockSize, 0};
+  blockAllocations++;
+
+  uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+  size_t offset = ((base + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+  block.used = offset + size;
+  void *result = block.memory.get() + offset;
+  blocks.push_back(std::move(block));
+
+  liveCount++;
+  allocationCount++;
+  bytesUsed += size;
+  return result;
+}
+
+inline void NodeArena::deallocate(void *ptr, size_t size)
+{
+  if (!ptr)
+    return;
+
+  // Over-aligned allocations share the lists too: their memory suits any smaller alignment
+  size = (size + SizeClassBytes - 1) & ~(SizeClassBytes - 1);
+  if (size <= MaxPooledSize)
+  {
+    size_t sizeClass = size / SizeClassBytes;
+    if (sizeClass >= freeLists.size())
+    {
+      freeLists.resize(sizeClass + 1, nullptr);
+    }
+    *static_cast<void **>(ptr) = freeLists[sizeClass];
+    freeLists[sizeClass] = ptr;
+  }
+
+  liveCount--;
+  if (orphaned && liveCount == 0)
+  {
+    delete this;
+  }
+}
+
+inline bool NodeArena::reset()
+{
+  if (liveCount != 0)
+  {
+    return false;
+  }
+
+  blocks.clear();
+  freeLists.clear();
+  allocationCount = 0;
+  reuseCount = 0;
+  bytesUsed = 0;
+  return true;
+}
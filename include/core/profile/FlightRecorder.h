@@ -0,0 +1,377 @@
+#pragma once
+
+#include "Profiler.h"
+#include "FrameStats.h"
+#include "../memory/AllocationTracker.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Engine event kept by the flight recorder (name must be a string literal)
+struct FlightRecorderEvent
+{
+  const char *name;
+  uint64_t timestamp;
+  double value;
+};
+
+struct FlightRecorderFrame
+{
+  uint64_t index;
+  uint64_t end; // Profiler timestamp at the end of the frame
+  FrameTimes times;
+};
+
+// Always-on hitch recorder. While enabled, the profiler records continuously
+// into per-thread rings and the recorder keeps the recent frame times and
+// engine events in fixed-size rings. When a frame exceeds the threshold the
+// last windowSeconds of all three are copied into a preallocated snapshot and
+// written as a Chrome trace by a background thread, so the loop only pays
+// for the copy.
+class FlightRecorder
+{
+private:
+  struct Snapshot
+  {
+    std::vector<std::pair<uint32_t, ProfileZone>> zones;
+    std::vector<FlightRecorderFrame> frames;
+    std::vector<FlightRecorderEvent> events;
+    std::string path;
+    uint64_t hitchFrame = 0;
+    float hitchMs = 0.0f;
+  };
+
+  bool enabled;
+  float windowSeconds;
+  float thresholdMs;
+  float cooldownSeconds;
+  std::string outputPrefix;
+
+  std::vector<FlightRecorderFrame> frames;
+  size_t frameNext;
+  size_t frameCount;
+  uint64_t frameIndex;
+
+  std::mutex eventMutex;
+  std::vector<FlightRecorderEvent> events;
+  size_t eventNext;
+  size_t eventCount;
+
+  uint64_t lastSnapshotTime;
+  uint64_t skippedCount; // Hitches ignored because the writer was busy or cooling down
+
+  // Writer thread
+  Snapshot snapshot;
+  std::thread writer;
+  std::mutex writerMutex;
+  std::condition_variable writerWake;
+  std::condition_variable writerIdle;
+  bool snapshotPending;
+  bool stopping;
+  std::atomic<uint64_t> snapshotsWritten;
+  std::string lastPath;
+
+  // Private constructor for singleton
+  FlightRecorder()
+      : enabled(false), windowSeconds(5.0f), thresholdMs(33.3f), cooldownSeconds(5.0f), outputPrefix("hitch"),
+        frameNext(0), frameCount(0), frameIndex(0), eventNext(0), eventCount(0),
+        lastSnapshotTime(0), skippedCount(0), snapshotPending(false), stopping(false), snapshotsWritten(0) {}
+
+  void takeSnapshot(float frameMs);
+  void runWriter();
+  bool writeSnapshot(const Snapshot &data) const;
+
+public:
+  // Singleton access
+  static FlightRecorder &getInstance()
+  {
+    static FlightRecorder instance;
+    return instance;
+  }
+
+  ~FlightRecorder() { disable(); }
+
+  // Prevent copying
+  FlightRecorder(const FlightRecorder &) = delete;
+  FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+  // Start recording: keep the last `seconds`, dump frames slower than `hitchMs`
+  // to "<prefix>_<frame>.json". All buffers are allocated here.
+  void enable(float seconds, float hitchMs, size_t zonesPerThread = 1 << 16,
+              const std::string &prefix = "hitch", size_t eventCapacity = 1024);
+  void disable();
+  bool isEnabled() const { return enabled; }
+
+  // Minimum time between two dumps
+  void setCooldown(float seconds) { cooldownSeconds = seconds; }
+
+  // Note an engine event (scene load, texture upload, ...)
+  void recordEvent(const char *name, double value = 0.0);
+
+  // Called by the game loop once per frame, after the frame's zones have closed
+  void endFrame(const FrameTimes &times);
+
+  // Block until any pending dump has been written (tests, shutdown)
+  void waitForWriter();
+
+  // Statistics
+  uint64_t getSnapshotCount() const { return snapshotsWritten.load(std::memory_order_acquire); }
+  uint64_t getSkippedCount() const { return skippedCount; }
+  std::string getLastSnapshotPath();
+};
+
+// Implementation
+inline void FlightRecorder::enable(float seconds, float hitchMs, size_t zonesPerThread,
+                                   const std::string &prefix, size_t eventCapacity)
+{
+  disable();
+
+  windowSeconds = seconds;
+  thresholdMs = hitchMs;
+  outputPrefix = prefix;
+
+  // Enough frame slots for the window at up to 240 fps
+  frames.assign(static_cast<size_t>(seconds * 240.0f) + 1, FlightRecorderFrame{});
+  frameNext = 0;
+  frameCount = 0;
+  {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    events.assign(eventCapacity, FlightRecorderEvent{});
+    eventNext = 0;
+    eventCount = 0;
+  }
+
+  snapshot.zones.reserve(zonesPerThread * 2);
+  snapshot.frames.reserve(frames.size());
+  snapshot.events.reserve(eventCapacity);
+
+  Profiler::getInstance().setRingCapacity(zonesPerThread);
+
+  stopping = false;
+  snapshotPending = false;
+  writer = std::thread(&FlightRecorder::runWriter, this);
+  enabled = true;
+}
+
+inline void FlightRecorder::disable()
+{
+  if (!enabled)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    stopping = true;
+  }
+  writerWake.notify_one();
+  if (writer.joinable())
+  {
+    writer.join();
+  }
+
+  Profiler::getInstance().setRingCapacity(0);
+  enabled = false;
+}
+
+inline void FlightRecorder::recordEvent(const char *name, double value)
+{
+  if (!enabled)
+    return;
+
+  std::lock_guard<std::mutex> lock(eventMutex);
+  events[eventNext] = {name, Profiler::getInstance().now(), value};
+  eventNext = (eventNext + 1) % events.size();
+  if (eventCount < events.size())
+    eventCount++;
+}
+
+inline void FlightRecorder::endFrame(const FrameTimes &times)
+{
+  if (!enabled)
+    return;
+
+  uint64_t now = Profiler::getInstance().now();
+  frames[frameNext] = {frameIndex, now, times};
+  frameNext = (frameNext + 1) % frames.size();
+  if (frameCount < frames.size())
+    frameCount++;
+  frameIndex++;
+
+  if (times.frameMs <= thresholdMs)
+    return;
+
+  bool coolingDown = lastSnapshotTime != 0 &&
+                     now - lastSnapshotTime < static_cast<uint64_t>(cooldownSeconds * 1e9);
+  bool writerBusy;
+  {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    writerBusy = snapshotPending;
+  }
+  if (coolingDown || writerBusy)
+  {
+    skippedCount++;
+    return;
+  }
+
+  lastSnapshotTime = now;
+  takeSnapshot(times.frameMs);
+}
+
+inline void FlightRecorder::takeSnapshot(float frameMs)
+{
+  auto &profiler = Profiler::getInstance();
+  uint64_t now = profiler.now();
+  uint64_t windowNs = static_cast<uint64_t>(windowSeconds * 1e9);
+  uint64_t since = now > windowNs ? now - windowNs : 0;
+
+  // The writer is idle here, so the snapshot buffers are ours
+  snapshot.zones.clear();
+  snapshot.frames.clear();
+  snapshot.events.clear();
+
+  profiler.copyZonesSince(since, snapshot.zones);
+
+  for (size_t i = 0; i < frameCount; ++i)
+  {
+    const FlightRecorderFrame &frame = frames[(frameNext + frames.size() - frameCount + i) % frames.size()];
+    if (frame.end >= since)
+      snapshot.frames.push_back(frame);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    for (size_t i = 0; i < eventCount; ++i)
+    {
+      const FlightRecorderEvent &event = events[(eventNext + events.size() - eventCount + i) % events.size()];
+      if (event.timestamp >= since)
+        snapshot.events.push_back(event);
+    }
+  }
+
+  snapshot.hitchFrame = frameIndex - 1;
+  snapshot.hitchMs = frameMs;
+  snapshot.path = outputPrefix + "_" + std::to_string(snapshot.hitchFrame) + ".json";
+
+  {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    snapshotPending = true;
+  }
+  writerWake.notify_one();
+}
+
+inline void FlightRecorder::runWriter()
+{
+  ALLOCATION_TAG_SCOPE(Profile);
+  std::unique_lock<std::mutex> lock(writerMutex);
+  while (true)
+  {
+    writerWake.wait(lock, [this] { return snapshotPending || stopping; });
+    if (snapshotPending)
+    {
+      lock.unlock();
+      bool ok = writeSnapshot(snapshot);
+      lock.lock();
+
+      if (ok)
+      {
+        lastPath = snapshot.path;
+        snapshotsWritten.fetch_add(1, std::memory_order_release);
+      }
+      snapshotPending = false;
+      writerIdle.notify_all();
+    }
+    if (stopping)
+      break;
+  }
+}
+
+inline void FlightRecorder::waitForWriter()
+{
+  std::unique_lock<std::mutex> lock(writerMutex);
+  writerIdle.wait(lock, [this] { return !snapshotPending; });
+}
+
+inline std::string FlightRecorder::getLastSnapshotPath()
+{
+  std::lock_guard<std::mutex> lock(writerMutex);
+  return lastPath;
+}
+
+inline bool FlightRecorder::writeSnapshot(const Snapshot &data) const
+{
+  FILE *file = std::fopen(data.path.c_str(), "w");
+  if (!file)
+  {
+    std::cerr << "FlightRecorder: cannot open " << data.path << " for writing" << std::endl;
+    return false;
+  }
+
+  auto writeEscaped = [file](const char *text)
+  {
+    for (const char *c = text; *c; ++c)
+    {
+      if (*c == '"' || *c == '\\')
+        std::fputc('\\', file);
+      std::fputc(*c, file);
+    }
+  };
+
+  std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"hitchFrame\":%llu,\"hitchMs\":%.3f},\"traceEvents\":[\n",
+               static_cast<unsigned long long>(data.hitchFrame), data.hitchMs);
+
+  bool first = true;
+  auto separator = [&first, file]()
+  {
+    std::fputs(first ? "" : ",\n", file);
+    first = false;
+  };
+
+  // Profiler zones
+  for (const auto &entry : data.zones)
+  {
+    const ProfileZone &zone = entry.second;
+    separator();
+    std::fputs("{\"ph\":\"X\",\"pid\":1,\"name\":\"", file);
+    writeEscaped(zone.name);
+    std::fputs("\",\"cat\":\"", file);
+    writeEscaped(zone.category);
+    std::fprintf(file, "\",\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                 entry.first, zone.start / 1000.0, (zone.end - zone.start) / 1000.0);
+  }
+
+  // Frame times as counters
+  for (const auto &frame : data.frames)
+  {
+    separator();
+    std::fprintf(file, "{\"ph\":\"C\",\"pid\":1,\"name\":\"Frame ms\",\"ts\":%.3f,"
+                       "\"args\":{\"frame\":%.3f,\"update\":%.3f,\"render\":%.3f,\"swap\":%.3f}}",
+                 frame.end / 1000.0, frame.times.frameMs, frame.times.updateMs,
+                 frame.times.renderMs, frame.times.swapMs);
+  }
+
+  // Engine events as instant events
+  for (const auto &event : data.events)
+  {
+    separator();
+    std::fputs("{\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"name\":\"", file);
+    writeEscaped(event.name);
+    std::fprintf(file, "\",\"ts\":%.3f,\"args\":{\"value\":%g}}", event.timestamp / 1000.0, event.value);
+  }
+
+  std::fputs("\n]}\n", file);
+
+  bool ok = std::ferror(file) == 0;
+  std::fclose(file);
+  if (!ok)
+  {
+    std::cerr << "FlightRecorder: failed writing " << data.path << std::endl;
+  }
+  return ok;
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+#include "../render/RenderDevice.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Times for one frame, in milliseconds
+struct FrameTimes
+{
+  float frameMs;
+  float updateMs;
+  float renderMs;
+  float swapMs;
+};
+
+struct FrameChannelStats
+{
+  float min;
+  float avg;
+  float p50;
+  float p95;
+  float p99;
+  float max;
+};
+
+// Rolling frame-time statistics with an optional on-screen overlay.
+// addFrame() is O(1); percentiles are recomputed every refreshInterval frames
+// over the rolling window, and the overlay's text is rebuilt only then.
+class FrameStats
+{
+public:
+  enum Channel
+  {
+    Frame,
+    Update,
+    Render,
+    Swap,
+    ChannelCount
+  };
+
+private:
+  struct OverlayRect
+  {
+    float x, y, width, height;
+  };
+
+  // Rolling window used for statistics and the graph
+  std::vector<FrameTimes> window;
+  size_t windowNext;
+  size_t windowCount;
+
+  // Longer history for the CSV dump (fixed size, oldest frames are overwritten)
+  std::vector<FrameTimes> history;
+  size_t historyNext;
+  size_t historyCount;
+
+  uint64_t frameCount;
+  uint64_t hitchCount;
+  size_t windowHitchCount;
+  float hitchThresholdMs;
+
+  FrameChannelStats stats[ChannelCount];
+  int refreshInterval;
+  int framesSinceRefresh;
+  std::vector<float> sorted; // Scratch for percentiles
+
+  std::vector<OverlayRect> textRects; // Cached glyph pixels for the overlay text
+
+  float channelValue(const FrameTimes &times, Channel channel) const;
+  void rebuildText();
+  void addText(const char *text, float x, float y);
+
+public:
+  explicit FrameStats(size_t windowFrames = 240, size_t historyFrames = 36000)
+      : window(windowFrames), windowNext(0), windowCount(0),
+        history(historyFrames), historyNext(0), historyCount(0),
+        frameCount(0), hitchCount(0), windowHitchCount(0), hitchThresholdMs(33.3f),
+        stats(), refreshInterval(30), framesSinceRefresh(0)
+  {
+    sorted.reserve(windowFrames);
+    textRects.reserve(1024);
+  }
+
+  // Frames longer than this count as hitches (e.g. 2x the target frame time)
+  void setHitchThreshold(float milliseconds) { hitchThresholdMs = milliseconds; }
+  float getHitchThreshold() const { return hitchThresholdMs; }
+
+  // Record one frame
+  void addFrame(const FrameTimes &times);
+
+  // Recompute statistics over the rolling window now
+  void refresh();
+
+  // Statistics
+  const FrameChannelStats &getStats(Channel channel) const { return stats[channel]; }
+  uint64_t getFrameCount() const { return frameCount; }
+  uint64_t getHitchCount() const { return hitchCount; }
+  size_t getWindowHitchCount() const { return windowHitchCount; }
+  size_t getWindowCount() const { return windowCount; }
+
+  // Draw the graph and numbers in the top-left corner of the 2D viewport
+  void drawOverlay() const;
+
+  // Write the recorded history as CSV
+  bool writeCsv(const std::string &path) const;
+};
+
+// 3x5 pixel font for the overlay: 15 bits, top row first, leftmost pixel highest
+inline uint16_t overlayGlyph(char c)
+{
+  switch (c)
+  {
+  case '0': return 0b111'101'101'101'111;
+  case '1': return 0b010'110'010'010'111;
+  case '2': return 0b111'001'111'100'111;
+  case '3': return 0b111'001'111'001'111;
+  case '4': return 0b101'101'111'001'001;
+  case '5': return 0b111'100'111'001'111;
+  case '6': return 0b111'100'111'101'111;
+  case '7': return 0b111'001'001'001'001;
+  case '8': return 0b111'101'111'101'111;
+  case '9': return 0b111'101'111'001'111;
+  case 'A': return 0b010'101'111'101'101;
+  case 'B': return 0b110'101'110'101'110;
+  case 'C': return 0b011'100'100'100'011;
+  case 'D': return 0b110'101'101'101'110;
+  case 'E': return 0b111'100'110'100'111;
+  case 'F': return 0b111'100'110'100'100;
+  case 'G': return 0b011'100'101'101'011;
+  case 'H': return 0b101'101'111'101'101;
+  case 'I': return 0b111'010'010'010'111;
+  case 'J': return 0b001'001'001'101'010;
+  case 'K': return 0b101'101'110'101'101;
+  case 'L': return 0b100'100'100'100'111;
+  case 'M': return 0b101'111'111'101'101;
+  case 'N': return 0b110'101'101'101'101;
+  case 'O': return 0b010'101'101'101'010;
+  case 'P': return 0b110'101'110'100'100;
+  case 'Q': return 0b010'101'101'110'011;
+  case 'R': return 0b110'101'110'101'101;
+  case 'S': return 0b011'100'010'001'110;
+  case 'T': return 0b111'010'010'010'010;
+  case 'U': return 0b101'101'101'101'111;
+  case 'V': return 0b101'101'101'101'010;
+  case 'W': return 0b101'101'111'111'101;
+  case 'X': return 0b101'101'010'101'101;
+  case 'Y': return 0b101'101'010'010'010;
+  case 'Z': return 0b111'001'010'100'111;
+  case '.': return 0b000'000'000'000'010;
+  case ':': return 0b000'010'000'010'000;
+  case '-': return 0b000'000'111'000'000;
+  case '/': return 0b001'001'010'100'100;
+  case '%': return 0b101'001'010'100'101;
+  default: return 0;
+  }
+}
+
+// Implementation
+inline float FrameStats::channelValue(const FrameTimes &times, Channel channel) const
+{
+  switch (channel)
+  {
+  case Frame: return times.frameMs;
+  case Update: return times.updateMs;
+  case Render: return times.renderMs;
+  case Swap: return times.swapMs;
+  default: return 0.0f;
+  }
+}
+
+inline void FrameStats::addFrame(const FrameTimes &times)
+{
+  if (!window.empty())
+  {
+    window[windowNext] = times;
+    windowNext = (windowNext + 1) % window.size();
+    windowCount = std::min(windowCount + 1, window.size());
+  }
+
+  if (!history.empty())
+  {
+    history[historyNext] = times;
+    historyNext = (historyNext + 1) % history.size();
+    historyCount = std::min(historyCount + 1, history.size());
+  }
+
+  frameCount++;
+  if (times.frameMs > hitchThresholdMs)
+  {
+    hitchCount++;
+  }
+
+  if (++framesSinceRefresh >= refreshInterval)
+  {
+    refresh();
+  }
+}
+
+inline void FrameStats::refresh()
+{
+  framesSinceRefresh = 0;
+  if (windowCount == 0)
+    return;
+
+  windowHitchCount = 0;
+  for (size_t i = 0; i < windowCount; ++i)
+  {
+    if (window[i].frameMs > hitchThresholdMs)
+      windowHitchCount++;
+  }
+
+  for (int channel = 0; channel < ChannelCount; ++channel)
+  {
+    sorted.clear();
+    double sum = 0.0;
+    for (size_t i = 0; i < windowCount; ++i)
+    {
+      float value = channelValue(window[i], static_cast<Channel>(channel));
+      sorted.push_back(value);
+      sum += value;
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    // Nearest-rank percentiles
+    auto percentile = [this](float p)
+    {
+      size_t rank = static_cast<size_t>(p * (sorted.size() - 1) + 0.5f);
+      return sorted[rank];
+    };
+
+    FrameChannelStats &channelStats = stats[channel];
+    channelStats.min = sorted.front();
+    channelStats.max = sorted.back();
+    channelStats.avg = static_cast<float>(sum / windowCount);
+    channelStats.p50 = percentile(0.50f);
+    channelStats.p95 = percentile(0.95f);
+    channelStats.p99 = percentile(0.99f);
+  }
+
+  rebuildText();
+}
+
+inline void FrameStats::addText(const char *text, float x, float y)
+{
+  for (const char *c = text; *c; ++c, x += 4.0f)
+  {
+    uint16_t glyph = overlayGlyph(*c);
+    if (!glyph)
+      continue;
+
+    // One rectangle per horizontal run of pixels, extended downwards when the
+    // same run repeats on the next row (keeps the draw count low)
+    size_t glyphStart = textRects.size();
+    for (int row = 0; row < 5; ++row)
+    {
+      int bits = (glyph >> (12 - row * 3)) & 0b111;
+      int column = 0;
+      while (column < 3)
+      {
+        if (!(bits & (0b100 >> column)))
+        {
+          column++;
+          continue;
+        }
+        int start = column;
+        while (column < 3 && (bits & (0b100 >> column)))
+          column++;
+        OverlayRect run{x + start, y + row, static_cast<float>(column - start), 1.0f};
+
+        bool merged = false;
+        for (size_t i = glyphStart; i < textRects.size(); ++i)
+        {
+          OverlayRect &above = textRects[i];
+          if (above.x == run.x && above.width == run.width && above.y + above.height == run.y)
+          {
+            above.height += 1.0f;
+            merged = true;
+            break;
+          }
+        }
+        if (!merged)
+        {
+          textRects.push_back(run);
+        }
+      }
+    }
+  }
+}
+
+inline void FrameStats::rebuildText()
+{
+  textRects.clear();
+
+  const FrameChannelStats &frame = stats[Frame];
+  char line[64];
+
+  std::snprintf(line, sizeof(line), "FPS %.1f AVG %.2fMS", frame.avg > 0.0f ? 1000.0f / frame.avg : 0.0f, frame.avg);
+  addText(line, 4.0f, 4.0f);
+  std::snprintf(line, sizeof(line), "P50 %.1f P95 %.1f P99 %.1f", frame.p50, frame.p95, frame.p99);
+  addText(line, 4.0f, 10.0f);
+  std::snprintf(line, sizeof(line), "UPD %.2f REN %.2f SWP %.1f", stats[Update].avg, stats[Render].avg, stats[Swap].avg);
+  addText(line, 4.0f, 16.0f);
+  std::snprintf(line, sizeof(line), "HITCH %zu/%zu TOTAL %llu", windowHitchCount, windowCount,
+                static_cast<unsigned long long>(hitchCount));
+  addText(line, 4.0f, 22.0f);
+}
+
+inline void FrameStats::drawOverlay() const
+{
+  auto &renderDevice = RenderDevice::getInstance();
+  renderDevice.resetTransform();
+
+  // Background
+  const float graphTop = 29.0f;
+  const float graphHeight = 20.0f;
+  renderDevice.setColor(0.0f, 0.0f, 0.0f, 0.6f);
+  renderDevice.drawRectangle(2.0f, 2.0f, 112.0f, graphTop + graphHeight);
+
+  // Numbers
+  renderDevice.setColor(1.0f, 1.0f, 1.0f, 1.0f);
+  for (const auto &rect : textRects)
+  {
+    renderDevice.drawRectangle(rect.x, rect.y, rect.width, rect.height);
+  }
+
+  // Graph of the most recent frames, one pixel per frame; full height is 2x the hitch threshold
+  const size_t bars = std::min<size_t>(windowCount, 108);
+  const float scale = graphHeight / (hitchThresholdMs * 2.0f);
+  for (size_t i = 0; i < bars; ++i)
+  {
+    size_t index = (windowNext + window.size() - bars + i) % window.size();
+    float frameMs = window[index].frameMs;
+    float height = std::min(frameMs * scale, graphHeight);
+
+    if (frameMs > hitchThresholdMs)
+      renderDevice.setColor(1.0f, 0.2f, 0.2f, 1.0f);
+    else
+      renderDevice.setColor(0.2f, 1.0f, 0.3f, 1.0f);
+    renderDevice.drawRectangle(4.0f + i, graphTop + graphHeight - height, 1.0f, height);
+  }
+
+  // Hitch threshold line
+  renderDevice.setColor(1.0f, 1.0f, 0.0f, 0.5f);
+  renderDevice.drawRectangle(4.0f, graphTop + graphHeight - hitchThresholdMs * scale, 108.0f, 0.5f);
+}
+
+inline bool FrameStats::writeCsv(const std::string &path) const
+{
+  FILE *file = std::fopen(path.c_str(), "w");
+  if (!file)
+  {
+    std::cerr << "FrameStats: cannot open " << path << " for writing" << std::endl;
+    return false;
+  }
+
+  std::fprintf(file, "frame,frame_ms,update_ms,render_ms,swap_ms,hitch\n");
+  uint64_t firstFrame = frameCount - historyCount;
+  for (size_t i = 0; i < historyCount; ++i)
+  {
+    size_t index = (historyNext + history.size() - historyCount + i) % history.size();
+    const FrameTimes &times = history[index];
+    std::fprintf(file, "%llu,%.4f,%.4f,%.4f,%.4f,%d\n",
+                 static_cast<unsigned long long>(firstFrame + i),
+                 times.frameMs, times.updateMs, times.renderMs, times.swapMs,
+                 times.frameMs > hitchThresholdMs ? 1 : 0);
+  }
+
+  bool ok = std::ferror(file) == 0;
+  std::fclose(file);
+  return ok;
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware events sampled by PerfCounters
+enum class PerfEvent : uint32_t
+{
+  Cycles,
+  Instructions,
+  L1DMisses,
+  LLCMisses,
+  BranchMisses,
+  Count
+};
+
+constexpr uint32_t PerfEventCount = static_cast<uint32_t>(PerfEvent::Count);
+
+inline const char *perfEventName(PerfEvent event)
+{
+  switch (event)
+  {
+  case PerfEvent::Cycles:
+    return "cycles";
+  case PerfEvent::Instructions:
+    return "instructions";
+  case PerfEvent::L1DMisses:
+    return "l1d_misses";
+  case PerfEvent::LLCMisses:
+    return "llc_misses";
+  case PerfEvent::BranchMisses:
+    return "branch_misses";
+  default:
+    return "unknown";
+  }
+}
+
+// One reading of every counter (events that could not be opened stay 0)
+struct PerfSample
+{
+  uint64_t values[PerfEventCount] = {};
+
+  uint64_t operator[](PerfEvent event) const { return values[static_cast<uint32_t>(event)]; }
+};
+
+// Counter deltas accumulated for one phase of the frame (update, render, ...)
+struct PerfPhaseStats
+{
+  uint64_t totals[PerfEventCount] = {};
+  uint64_t frames = 0;
+  uint64_t nodes = 0; // Sum of nodes visited over all frames
+
+  uint64_t total(PerfEvent event) const { return totals[static_cast<uint32_t>(event)]; }
+
+  double ipc() const
+  {
+    uint64_t cycles = total(PerfEvent::Cycles);
+    return cycles ? static_cast<double>(total(PerfEvent::Instructions)) / cycles : 0.0;
+  }
+
+  double perNode(PerfEvent event) const
+  {
+    return nodes ? static_cast<double>(total(event)) / nodes : 0.0;
+  }
+
+  double perFrame(PerfEvent event) const
+  {
+    return frames ? static_cast<double>(total(event)) / frames : 0.0;
+  }
+};
+
+// Per-thread hardware counters via perf_event_open (Linux only). The counters
+// are opened as one group on the calling thread, user space only, and count
+// only while that thread runs. Anything that cannot be opened (no PMU in a
+// VM or container, perf_event_paranoid too strict, non-Linux builds) is left
+// unavailable and reads as zero, so callers never have to special-case it.
+class PerfCounters
+{
+private:
+  int fds[PerfEventCount];
+  uint64_t ids[PerfEventCount];
+  int leader;
+  bool available[PerfEventCount];
+  uint32_t openCount;
+  bool multiplexed; // Kernel time-sliced the group; values are scaled estimates
+
+#if defined(__linux__)
+  static int openEvent(uint32_t type, uint64_t config, int groupFd)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+  }
+
+  static uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result)
+  {
+    return cache | (op << 8) | (result << 16);
+  }
+#endif
+
+public:
+  PerfCounters() : leader(-1), openCount(0), multiplexed(false)
+  {
+    for (uint32_t i = 0; i < PerfEventCount; ++i)
+    {
+      fds[i] = -1;
+      ids[i] = 0;
+      available[i] = false;
+    }
+  }
+
+  ~PerfCounters() { close(); }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  // Open and start the counters for the calling thread. Returns false if no
+  // counter could be opened; individual events may still be missing on true.
+  bool open();
+  void close();
+
+  bool isOpen() const { return openCount != 0; }
+  bool isAvailable(PerfEvent event) const { return available[static_cast<uint32_t>(event)]; }
+  bool isMultiplexed() const { return multiplexed; }
+
+  // Current counter values (monotonic since open)
+  bool read(PerfSample &sample);
+};
+
+// Samples a PerfCounters group around named phases of the frame.
+// begin()/end() pairs must not nest.
+class PerfFrameCounters
+{
+public:
+  enum Phase
+  {
+    Update,
+    Render,
+    PhaseCount
+  };
+
+private:
+  PerfCounters counters;
+  PerfSample beginSample;
+  PerfPhaseStats phases[PhaseCount];
+  bool enabled;
+
+public:
+  PerfFrameCounters() : enabled(false) {}
+
+  // Open the counters on the calling thread (the one that runs the phases)
+  bool enable();
+  bool isEnabled() const { return enabled; }
+  const PerfCounters &getCounters() const { return counters; }
+
+  void begin()
+  {
+    if (enabled)
+      counters.read(beginSample);
+  }
+
+  void end(Phase phase, size_t nodeCount)
+  {
+    if (!enabled)
+      return;
+    PerfSample endSample;
+    counters.read(endSample);
+    PerfPhaseStats &stats = phases[phase];
+    for (uint32_t i = 0; i < PerfEventCount; ++i)
+    {
+      stats.totals[i] += endSample.values[i] - beginSample.values[i];
+    }
+    stats.frames++;
+    stats.nodes += nodeCount;
+  }
+
+  const PerfPhaseStats &getPhase(Phase phase) const { return phases[phase]; }
+  void reset()
+  {
+    for (auto &stats : phases)
+      stats = PerfPhaseStats();
+  }
+
+  static const char *phaseName(Phase phase) { return phase == Update ? "update" : "render"; }
+
+  // Human-readable summary (one line per phase)
+  void print(std::ostream &out) const;
+};
+
+// Implementation
+inline bool PerfCounters::open()
+{
+  close();
+
+#if defined(__linux__)
+  struct EventConfig
+  {
+    uint32_t type;
+    uint64_t config;
+  };
+  const EventConfig configs[PerfEventCount] = {
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+      {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+  };
+
+  for (uint32_t i = 0; i < PerfEventCount; ++i)
+  {
+    int fd = openEvent(configs[i].type, configs[i].config, leader);
+    if (fd == -1)
+      continue;
+
+    if (ioctl(fd, PERF_EVENT_IOC_ID, &ids[i]) == -1)
+    {
+      ::close(fd);
+      continue;
+    }
+    fds[i] = fd;
+    available[i] = true;
+    openCount++;
+    if (leader == -1)
+      leader = fd;
+  }
+
+  if (leader == -1)
+    return false;
+
+  ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+#else
+  return false;
+#endif
+}
+
+inline void PerfCounters::close()
+{
+#if defined(__linux__)
+  for (uint32_t i = 0; i < PerfEventCount; ++i)
+  {
+    if (fds[i] != -1)
+      ::close(fds[i]);
+    fds[i] = -1;
+    ids[i] = 0;
+    available[i] = false;
+  }
+#endif
+  leader = -1;
+  openCount = 0;
+  multiplexed = false;
+}
+
+inline bool PerfCounters::read(PerfSample &sample)
+{
+#if defined(__linux__)
+  if (leader == -1)
+    return false;
+
+  // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, {value, id} * nr
+  uint64_t buffer[3 + 2 * PerfEventCount];
+  ssize_t bytes = ::read(leader, buffer, sizeof(buffer));
+  if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)))
+    return false;
+
+  uint64_t count = buffer[0];
+  uint64_t enabledTime = buffer[1];
+  uint64_t runningTime = buffer[2];
+  multiplexed = runningTime != 0 && runningTime < enabledTime;
+  double scale = multiplexed ? static_cast<double>(enabledTime) / runningTime : 1.0;
+
+  for (uint64_t n = 0; n < count && n < PerfEventCount; ++n)
+  {
+    uint64_t value = buffer[3 + 2 * n];
+    uint64_t id = buffer[4 + 2 * n];
+    for (uint32_t i = 0; i < PerfEventCount; ++i)
+    {
+      if (available[i] && ids[i] == id)
+      {
+        sample.values[i] = multiplexed ? static_cast<uint64_t>(value * scale) : value;
+        break;
+      }
+    }
+  }
+  return true;
+#else
+  (void)sample;
+  return false;
+#endif
+}
+
+inline bool PerfFrameCounters::enable()
+{
+  enabled = counters.open();
+  if (!enabled)
+  {
+    std::cerr << "PerfCounters: hardware counters unavailable on this system, skipping" << std::endl;
+  }
+  return enabled;
+}
+
+inline void PerfFrameCounters::print(std::ostream &out) const
+{
+  if (!enabled)
+  {
+    out << "Perf counters: unavailable" << std::endl;
+    return;
+  }
+
+  char line[256];
+  for (int phase = 0; phase < PhaseCount; ++phase)
+  {
+    const PerfPhaseStats &stats = phases[phase];
+    std::snprintf(line, sizeof(line),
+                  "Perf %s: IPC %.2f, per node: L1D misses %.2f, LLC misses %.3f, branch misses %.2f (%llu frames)",
+                  phaseName(static_cast<Phase>(phase)), stats.ipc(),
+                  stats.perNode(PerfEvent::L1DMisses), stats.perNode(PerfEvent::LLCMisses),
+                  stats.perNode(PerfEvent::BranchMisses), static_cast<unsigned long long>(stats.frames));
+    out << line << std::endl;
+  }
+
+  for (uint32_t i = 0; i < PerfEventCount; ++i)
+  {
+    if (!counters.isAvailable(static_cast<PerfEvent>(i)))
+    {
+      out << "  (" << perfEventName(static_cast<PerfEvent>(i)) << " not available)" << std::endl;
+    }
+  }
+}
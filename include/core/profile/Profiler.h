@@ -0,0 +1,412 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Set PROFILE_ENABLED to 0 to remove every PROFILE_SCOPE from the build
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 1
+#endif
+
+// One finished zone; name and category must be string literals (or otherwise static)
+struct ProfileZone
+{
+  const char *name;
+  const char *category;
+  uint64_t start; // Nanoseconds since the profiler was created
+  uint64_t end;
+  uint32_t depth;
+};
+
+// Zones recorded by one thread; only that thread appends. In ring mode zones
+// has a fixed size and zone n goes to slot n % size; the owner publishes each
+// one by bumping written, so other threads can copy the ring while it records.
+struct ProfileThreadBuffer
+{
+  std::vector<ProfileZone> zones;
+  bool ring = false;
+  size_t next = 0;                  // Ring slot the owner writes next (written % size)
+  std::atomic<uint64_t> written{0}; // Zones stored in the ring since the last clear
+  uint32_t threadIndex = 0;
+  uint32_t depth = 0;
+  uint64_t dropped = 0;
+
+  // Zones held, and the i-th of them oldest first
+  size_t count() const
+  {
+    return ring ? static_cast<size_t>(std::min<uint64_t>(written.load(std::memory_order_acquire), zones.size()))
+                : zones.size();
+  }
+  const ProfileZone &at(size_t i) const
+  {
+    if (!ring)
+      return zones[i];
+    uint64_t end = written.load(std::memory_order_acquire);
+    uint64_t first = end > zones.size() ? end - zones.size() : 0;
+    return zones[(first + i) % zones.size()];
+  }
+};
+
+// Hierarchical CPU profiler. PROFILE_SCOPE("Scene::update") records a zone
+// with nanosecond start/end into the calling thread's buffer while a capture
+// is running; outside a capture a zone costs one relaxed load. Captures are
+// exported as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+class Profiler
+{
+private:
+  std::chrono::steady_clock::time_point startTime;
+  std::atomic<bool> capturing;
+  size_t maxZonesPerThread;
+  size_t ringCapacity; // Non-zero: record continuously, keeping the newest zones
+
+  std::mutex registryMutex; // Only taken when a thread records for the first time
+  std::vector<std::unique_ptr<ProfileThreadBuffer>> buffers;
+
+  // Frame-limited capture (see captureFrames)
+  int framesRemaining;
+  std::string capturePath;
+
+  // Private constructor for singleton
+  Profiler()
+      : startTime(std::chrono::steady_clock::now()), capturing(false), maxZonesPerThread(1 << 20),
+        ringCapacity(0), framesRemaining(0) {}
+
+  ProfileThreadBuffer *threadBuffer();
+
+public:
+  // Singleton access
+  static Profiler &getInstance()
+  {
+    static Profiler instance;
+    return instance;
+  }
+
+  // Prevent copying
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  // Timestamp in nanoseconds since the profiler was created
+  uint64_t now() const
+  {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+  }
+
+  // Capture control. Start/stop and export from the main thread while no
+  // other thread is inside a zone.
+  void startCapture();
+  void stopCapture() { capturing.store(false, std::memory_order_relaxed); }
+  bool isCapturing() const { return capturing.load(std::memory_order_relaxed); }
+
+  // Capture the next frameCount frames, then write them to path
+  void captureFrames(int frameCount, const std::string &path);
+
+  // Record continuously into per-thread rings of this many zones, overwriting
+  // the oldest (used by the FlightRecorder). 0 returns to normal captures.
+  void setRingCapacity(size_t zonesPerThread);
+  size_t getRingCapacity() const { return ringCapacity; }
+
+  // Copy zones that ended at or after the given time, tagged with their thread
+  // index. Rings may be copied while their threads keep recording; growing
+  // (non-ring) buffers only once the capture has stopped.
+  void copyZonesSince(uint64_t since, std::vector<std::pair<uint32_t, ProfileZone>> &out);
+
+  // Called by the game loop once per frame
+  void endFrame();
+
+  // Zone recording (used by ProfileScope)
+  ProfileThreadBuffer *beginZone()
+  {
+    if (!capturing.load(std::memory_order_relaxed))
+      return nullptr;
+    ProfileThreadBuffer *buffer = threadBuffer();
+    buffer->depth++;
+    return buffer;
+  }
+
+  void endZone(ProfileThreadBuffer *buffer, const char *name, const char *category, uint64_t start)
+  {
+    uint64_t end = now();
+    buffer->depth--;
+    if (buffer->ring)
+    {
+      buffer->zones[buffer->next] = {name, category, start, end, buffer->depth};
+      buffer->next = buffer->next + 1 == buffer->zones.size() ? 0 : buffer->next + 1;
+      buffer->written.store(buffer->written.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    else if (buffer->zones.size() < maxZonesPerThread)
+    {
+      buffer->zones.push_back({name, category, start, end, buffer->depth});
+    }
+    else
+    {
+      buffer->dropped++;
+    }
+  }
+
+  // Export
+  bool writeChromeTrace(const std::string &path) const;
+
+  // Statistics
+  size_t getZoneCount() const;
+  uint64_t getDroppedCount() const;
+  void setMaxZonesPerThread(size_t count) { maxZonesPerThread = count; }
+
+  // Recorded zones per thread (for tools and tests)
+  template <typename Fn>
+  void forEachZone(Fn &&fn) const
+  {
+    for (const auto &buffer : buffers)
+    {
+      for (size_t i = 0; i < buffer->count(); ++i)
+      {
+        fn(buffer->threadIndex, buffer->at(i));
+      }
+    }
+  }
+};
+
+// RAII zone
+class ProfileScope
+{
+private:
+  ProfileThreadBuffer *buffer;
+  const char *name;
+  const char *category;
+  uint64_t start;
+
+public:
+  ProfileScope(const char *zoneName, const char *zoneCategory = "cpu")
+      : buffer(Profiler::getInstance().beginZone()), name(zoneName), category(zoneCategory), start(0)
+  {
+    if (buffer)
+    {
+      start = Profiler::getInstance().now();
+    }
+  }
+
+  ~ProfileScope()
+  {
+    if (buffer)
+    {
+      Profiler::getInstance().endZone(buffer, name, category, start);
+    }
+  }
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILE_ENABLED
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_SCOPE_CAT(name, category) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name, category)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_SCOPE_CAT(name, category) ((void)0)
+#endif
+
+// Implementation
+inline ProfileThreadBuffer *Profiler::threadBuffer()
+{
+  thread_local ProfileThreadBuffer *buffer = nullptr;
+  if (!buffer)
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffers.push_back(std::make_unique<ProfileThreadBuffer>());
+    buffer = buffers.back().get();
+    buffer->threadIndex = static_cast<uint32_t>(buffers.size() - 1);
+    if (ringCapacity != 0)
+    {
+      buffer->ring = true;
+      buffer->zones.resize(ringCapacity);
+    }
+    else
+    {
+      buffer->zones.reserve(4096);
+    }
+  }
+  return buffer;
+}
+
+inline void Profiler::startCapture()
+{
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto &buffer : buffers)
+    {
+      if (!buffer->ring)
+        buffer->zones.clear();
+      buffer->next = 0;
+      buffer->written.store(0, std::memory_order_relaxed);
+      buffer->dropped = 0;
+    }
+  }
+  capturing.store(true, std::memory_order_relaxed);
+}
+
+inline void Profiler::setRingCapacity(size_t zonesPerThread)
+{
+  stopCapture();
+  ringCapacity = zonesPerThread;
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto &buffer : buffers)
+    {
+      buffer->ring = zonesPerThread != 0;
+      buffer->zones.assign(zonesPerThread, ProfileZone());
+      buffer->next = 0;
+      buffer->written.store(0, std::memory_order_relaxed);
+    }
+  }
+  if (ringCapacity != 0)
+  {
+    startCapture();
+  }
+}
+
+inline void Profiler::copyZonesSince(uint64_t since, std::vector<std::pair<uint32_t, ProfileZone>> &out)
+{
+  std::lock_guard<std::mutex> lock(registryMutex);
+  for (const auto &buffer : buffers)
+  {
+    if (!buffer->ring)
+    {
+      if (isCapturing())
+        continue; // Still growing: its owner may reallocate under us
+
+      for (const auto &zone : buffer->zones)
+      {
+        if (zone.end >= since)
+          out.emplace_back(buffer->threadIndex, zone);
+      }
+      continue;
+    }
+
+    // Copy the published zones, then check which slots the owner may have
+    // started overwriting meanwhile (it writes zone n before publishing n + 1)
+    // and drop those copies: they may be torn
+    size_t size = buffer->zones.size();
+    uint64_t end = buffer->written.load(std::memory_order_acquire);
+    uint64_t first = end > size ? end - size : 0;
+    size_t base = out.size();
+    for (uint64_t n = first; n < end; ++n)
+    {
+      out.emplace_back(buffer->threadIndex, buffer->zones[n % size]);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = buffer->written.load(std::memory_order_relaxed);
+    uint64_t firstIntact = after + 1 > size ? after + 1 - size : 0;
+    size_t torn = static_cast<size_t>(std::min<uint64_t>(firstIntact > first ? firstIntact - first : 0, end - first));
+    out.erase(out.begin() + base, out.begin() + base + torn);
+
+    // Keep the zones inside the window
+    out.erase(std::remove_if(out.begin() + base, out.end(),
+                             [since](const std::pair<uint32_t, ProfileZone> &entry)
+                             { return entry.second.end < since; }),
+              out.end());
+  }
+}
+
+inline void Profiler::captureFrames(int frameCount, const std::string &path)
+{
+  framesRemaining = frameCount;
+  capturePath = path;
+  startCapture();
+}
+
+inline void Profiler::endFrame()
+{
+  if (framesRemaining <= 0)
+    return;
+
+  if (--framesRemaining == 0)
+  {
+    stopCapture();
+    if (writeChromeTrace(capturePath))
+    {
+      std::cout << "Profiler: wrote " << getZoneCount() << " zones to " << capturePath << std::endl;
+    }
+  }
+}
+
+inline bool Profiler::writeChromeTrace(const std::string &path) const
+{
+  FILE *file = std::fopen(path.c_str(), "w");
+  if (!file)
+  {
+    std::cerr << "Profiler: cannot open " << path << " for writing" << std::endl;
+    return false;
+  }
+
+  auto writeEscaped = [file](const char *text)
+  {
+    for (const char *c = text; *c; ++c)
+    {
+      if (*c == '"' || *c == '\\')
+        std::fputc('\\', file);
+      std::fputc(*c, file);
+    }
+  };
+
+  std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+  bool first = true;
+  for (const auto &buffer : buffers)
+  {
+    for (size_t i = 0; i < buffer->count(); ++i)
+    {
+      const ProfileZone &zone = buffer->at(i);
+      std::fputs(first ? "" : ",\n", file);
+      first = false;
+
+      // Complete ("X") events, timestamps in microseconds
+      std::fputs("{\"ph\":\"X\",\"pid\":1,\"name\":\"", file);
+      writeEscaped(zone.name);
+      std::fputs("\",\"cat\":\"", file);
+      writeEscaped(zone.category);
+      std::fprintf(file, "\",\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                   buffer->threadIndex, zone.start / 1000.0, (zone.end - zone.start) / 1000.0);
+    }
+  }
+  std::fputs("\n]}\n", file);
+
+  bool ok = std::ferror(file) == 0;
+  std::fclose(file);
+  if (!ok)
+  {
+    std::cerr << "Profiler: failed writing " << path << std::endl;
+  }
+  return ok;
+}
+
+inline size_t Profiler::getZoneCount() const
+{
+  size_t count = 0;
+  for (const auto &buffer : buffers)
+  {
+    count += buffer->count();
+  }
+  return count;
+}
+
+inline uint64_t Profiler::getDroppedCount() const
+{
+  uint64_t count = 0;
+  for (const auto &buffer : buffers)
+  {
+    count += buffer->dropped;
+  }
+  return count;
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "RenderDriver.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// What a frame asked the driver to do
+struct RenderStats
+{
+  uint64_t drawCalls = 0;       // Triangles, rectangles, sprites, meshes and particle batches
+  uint64_t spriteDraws = 0;
+  uint64_t meshDraws = 0;       // drawTexturedTriangles calls
+  uint64_t meshTriangles = 0;
+  uint64_t particleDraws = 0;   // drawParticles calls
+  uint64_t particles = 0;
+  uint64_t textureSwitches = 0; // Sprite draws whose texture differs from the previous draw
+  uint64_t colorChanges = 0;    // setColor calls that changed the color
+  uint64_t transformChanges = 0;
+  uint64_t textureUploads = 0;
+  uint64_t uploadedBytes = 0;
+  uint64_t renderTargetPasses = 0; // beginRenderTarget calls
+  uint64_t offscreenDrawCalls = 0; // Draws that went into a render target (also in drawCalls)
+
+  // Any change of pipeline state between draws
+  uint64_t stateChanges() const { return textureSwitches + colorChanges + transformChanges; }
+};
+
+// Driver that draws nothing and only counts what it is asked to do.
+// Used by the benchmarks and tests, which must run headless without a GPU.
+// Render targets are plain RGBA images that are allocated but never drawn to.
+class NullRenderDriver : public RenderDriver
+{
+private:
+  RenderStats stats;
+  unsigned int nextTextureId;
+  unsigned int boundTexture;
+  unsigned int activeTarget;
+  float color[4];
+  bool closeRequested;
+  std::unordered_map<unsigned int, std::vector<uint32_t>> targetImages;
+
+  void countDraw()
+  {
+    stats.drawCalls++;
+    if (activeTarget != 0)
+      stats.offscreenDrawCalls++;
+  }
+
+public:
+  NullRenderDriver()
+      : nextTextureId(1), boundTexture(0), activeTarget(0), color{1.0f, 1.0f, 1.0f, 1.0f}, closeRequested(false) {}
+
+  // Counters since the last reset
+  const RenderStats &getStats() const { return stats; }
+  void resetStats() { stats = RenderStats(); }
+
+  // Make shouldClose() return true (ends a GameLoop)
+  void requestClose() { closeRequested = true; }
+
+  // Implementation of RenderDriver interface
+  bool initialize(Window *) override { return true; }
+  void cleanup() override {}
+
+  std::string getDriverName() const override { return "Null"; }
+  std::string getVersion() const override { return "1.0"; }
+
+  void setup2DRendering(int, int) override {}
+  void clear(float, float, float, float) override { boundTexture = 0; }
+
+  void setTransform(float, float, float, float, float) override { stats.transformChanges++; }
+  void resetTransform() override {}
+
+  void setColor(float r, float g, float b, float a) override
+  {
+    if (r != color[0] || g != color[1] || b != color[2] || a != color[3])
+    {
+      color[0] = r;
+      color[1] = g;
+      color[2] = b;
+      color[3] = a;
+      stats.colorChanges++;
+    }
+  }
+
+  void drawTriangle(float, float, float, float, float, float) override { countDraw(); }
+  void drawRectangle(float, float, float, float) override { countDraw(); }
+
+  void drawSprite(float, float, float, float, unsigned int textureId, float, float, float, float) override
+  {
+    countDraw();
+    stats.spriteDraws++;
+    if (textureId != boundTexture)
+    {
+      boundTexture = textureId;
+      stats.textureSwitches++;
+    }
+  }
+
+  void drawTexturedTriangles(unsigned int textureId, const float *, const float *, const uint16_t *, size_t indexCount) override
+  {
+    countDraw();
+    stats.meshDraws++;
+    stats.meshTriangles += indexCount / 3;
+    if (textureId != boundTexture)
+    {
+      boundTexture = textureId;
+      stats.textureSwitches++;
+    }
+  }
+
+  void drawParticles(const ParticleBatch &batch) override
+  {
+    countDraw();
+    stats.particleDraws++;
+    stats.particles += batch.count;
+    if (batch.textureId != boundTexture)
+    {
+      boundTexture = batch.textureId;
+      stats.textureSwitches++;
+    }
+    color[0] = color[1] = color[2] = color[3] = 1.0f;
+  }
+
+  unsigned int createTexture() override { return nextTextureId++; }
+  void deleteTexture(unsigned int textureId) override
+  {
+    if (textureId == boundTexture)
+      boundTexture = 0;
+  }
+
+  void uploadTexture(unsigned int, int width, int height, const void *, bool) override
+  {
+    stats.textureUploads++;
+    stats.uploadedBytes += static_cast<uint64_t>(width) * height * 4;
+  }
+
+  unsigned int createRenderTarget(int width, int height) override
+  {
+    if (width <= 0 || height <= 0)
+      return 0;
+    unsigned int targetId = nextTextureId++;
+    targetImages[targetId].assign(static_cast<size_t>(width) * height, 0);
+    return targetId;
+  }
+
+  void deleteRenderTarget(unsigned int targetId) override
+  {
+    targetImages.erase(targetId);
+    deleteTexture(targetId);
+  }
+
+  bool beginRenderTarget(unsigned int targetId, float, float, float, float) override
+  {
+    if (activeTarget != 0 || targetImages.find(targetId) == targetImages.end())
+      return false;
+    activeTarget = targetId;
+    stats.renderTargetPasses++;
+    return true;
+  }
+
+  void endRenderTarget() override { activeTarget = 0; }
+
+  // Size of a render target's image in pixels (0 if it does not exist)
+  size_t getRenderTargetPixels(unsigned int targetId) const
+  {
+    auto it = targetImages.find(targetId);
+    return it != targetImages.end() ? it->second.size() : 0;
+  }
+
+  void swapBuffers() override {}
+  void pollEvents() override {}
+  bool shouldClose() const override { return closeRequested; }
+};
@@ -4,7 +4,24 @@
 #include "../window/Window.h"
 #include <GLFW/glfw3.h>
 #include <GL/gl.h>
+#include <algorithm>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
+
+// Framebuffer objects (GL 3.0 / ARB_framebuffer_object) are loaded at
+// initialization, since the GL 1.x headers do not declare them
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+
+#if defined(_WIN32)
+#define GL_LOADED_CALL __stdcall
+#else
+#define GL_LOADED_CALL
+#endif
 
 class OpenGLRenderDriver : public RenderDriver
 {
@@ -12,6 +29,51 @@ private:
   GLFWwindow *m_window;
   bool m_initialized;
 
+  using GenFramebuffersFn = void(GL_LOADED_CALL *)(GLsizei, GLuint *);
+  using DeleteFramebuffersFn = void(GL_LOADED_CALL *)(GLsizei, const GLuint *);
+  using BindFramebufferFn = void(GL_LOADED_CALL *)(GLenum, GLuint);
+  using FramebufferTexture2DFn = void(GL_LOADED_CALL *)(GLenum, GLenum, GLenum, GLuint, GLint);
+  using CheckFramebufferStatusFn = GLenum(GL_LOADED_CALL *)(GLenum);
+  GenFramebuffersFn m_genFramebuffers = nullptr;
+  DeleteFramebuffersFn m_deleteFramebuffers = nullptr;
+  BindFramebufferFn m_bindFramebuffer = nullptr;
+  FramebufferTexture2DFn m_framebufferTexture2D = nullptr;
+  CheckFramebufferStatusFn m_checkFramebufferStatus = nullptr;
+
+  // Framebuffer of each render target, keyed by its color texture
+  struct RenderTarget
+  {
+    GLuint framebuffer;
+    int width;
+    int height;
+  };
+  std::unordered_map<unsigned int, RenderTarget> m_renderTargets;
+  GLint m_savedViewport[4] = {0, 0, 0, 0};
+  bool m_inRenderTarget = false;
+
+  // Leaves the pointers null when the context has no framebuffer objects,
+  // so createRenderTarget reports them unsupported
+  void loadFramebufferFunctions()
+  {
+    m_genFramebuffers = reinterpret_cast<GenFramebuffersFn>(glfwGetProcAddress("glGenFramebuffers"));
+    m_deleteFramebuffers = reinterpret_cast<DeleteFramebuffersFn>(glfwGetProcAddress("glDeleteFramebuffers"));
+    m_bindFramebuffer = reinterpret_cast<BindFramebufferFn>(glfwGetProcAddress("glBindFramebuffer"));
+    m_framebufferTexture2D = reinterpret_cast<FramebufferTexture2DFn>(glfwGetProcAddress("glFramebufferTexture2D"));
+    m_checkFramebufferStatus = reinterpret_cast<CheckFramebufferStatusFn>(glfwGetProcAddress("glCheckFramebufferStatus"));
+    if (!m_genFramebuffers || !m_deleteFramebuffers || !m_bindFramebuffer || !m_framebufferTexture2D ||
+        !m_checkFramebufferStatus)
+    {
+      std::cerr << "OpenGLRenderDriver: Framebuffer objects unavailable, render targets disabled" << std::endl;
+      m_genFramebuffers = nullptr;
+    }
+  }
+
+  // Quad corners for drawParticles, filled one chunk at a time
+  static constexpr size_t ParticleChunk = 4096;
+  std::vector<float> m_particleVertices;
+  std::vector<float> m_particleTexCoords;
+  std::vector<uint32_t> m_particleColors;
+
 public:
   OpenGLRenderDriver() : m_window(nullptr), m_initialized(false) {}
 
@@ -53,6 +115,8 @@ public:
       return false;
     }
 
+    loadFramebufferFunctions();
+
     m_initialized = true;
     std::cout << "OpenGLRenderDriver: Initialized successfully" << std::endl;
     return true;
@@ -62,6 +126,12 @@ public:
   {
     if (m_initialized)
     {
+      for (auto &entry : m_renderTargets)
+      {
+        m_deleteFramebuffers(1, &entry.second.framebuffer);
+        deleteTexture(entry.first);
+      }
+      m_renderTargets.clear();
       m_initialized = false;
       m_window = nullptr;
       std::cout << "OpenGLRenderDriver: Cleaned up" << std::endl;
@@ -158,6 +228,96 @@ public:
     glDisable(GL_TEXTURE_2D);
   }
 
+  void drawTexturedTriangles(unsigned int textureId, const float *positions, const float *texCoords, const uint16_t *indices, size_t indexCount) override
+  {
+    if (textureId != 0)
+    {
+      glEnable(GL_TEXTURE_2D);
+      glBindTexture(GL_TEXTURE_2D, textureId);
+      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+      glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, positions);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_SHORT, indices);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    if (textureId != 0)
+    {
+      glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+      glDisable(GL_TEXTURE_2D);
+    }
+  }
+
+  void drawParticles(const ParticleBatch &batch) override
+  {
+    if (batch.count == 0)
+      return;
+
+    if (m_particleVertices.empty())
+    {
+      m_particleVertices.resize(ParticleChunk * 8);
+      m_particleColors.resize(ParticleChunk * 4);
+      m_particleTexCoords.resize(ParticleChunk * 8);
+      static const float corners[8] = {0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f};
+      for (size_t i = 0; i < ParticleChunk; ++i)
+        std::copy(corners, corners + 8, &m_particleTexCoords[i * 8]);
+    }
+
+    if (batch.textureId != 0)
+    {
+      glEnable(GL_TEXTURE_2D);
+      glBindTexture(GL_TEXTURE_2D, batch.textureId);
+      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+      glTexCoordPointer(2, GL_FLOAT, 0, m_particleTexCoords.data());
+    }
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, m_particleVertices.data());
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, m_particleColors.data());
+
+    float sizeRange = batch.endSize - batch.startSize;
+    float alphaRange = batch.endAlpha - batch.startAlpha;
+    for (size_t first = 0; first < batch.count; first += ParticleChunk)
+    {
+      size_t count = std::min(ParticleChunk, batch.count - first);
+      for (size_t i = 0; i < count; ++i)
+      {
+        size_t p = first + i;
+        float age = batch.age[p];
+        float half = 0.5f * (batch.startSize + sizeRange * age) * (batch.sizes ? batch.sizes[p] : 1.0f);
+        float left = batch.x[p] - half, right = batch.x[p] + half;
+        float top = batch.y[p] - half, bottom = batch.y[p] + half;
+        float *v = &m_particleVertices[i * 8];
+        v[0] = left;
+        v[1] = top;
+        v[2] = right;
+        v[3] = top;
+        v[4] = right;
+        v[5] = bottom;
+        v[6] = left;
+        v[7] = bottom;
+
+        uint32_t color = batch.colors[p];
+        float alpha = static_cast<float>(color >> 24) * (batch.startAlpha + alphaRange * age);
+        color = (color & 0x00FFFFFFu) | (static_cast<uint32_t>(std::min(std::max(alpha, 0.0f), 255.0f)) << 24);
+        uint32_t *c = &m_particleColors[i * 4];
+        c[0] = c[1] = c[2] = c[3] = color;
+      }
+      glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(count * 4));
+    }
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    if (batch.textureId != 0)
+    {
+      glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+      glDisable(GL_TEXTURE_2D);
+    }
+  }
+
   unsigned int createTexture() override
   {
     unsigned int textureId;
@@ -186,6 +346,83 @@ public:
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
   }
 
+  unsigned int createRenderTarget(int width, int height) override
+  {
+    if (!m_genFramebuffers || width <= 0 || height <= 0)
+      return 0;
+
+    unsigned int textureId = createTexture();
+    uploadTexture(textureId, width, height, nullptr, false);
+
+    RenderTarget target = {0, width, height};
+    m_genFramebuffers(1, &target.framebuffer);
+    m_bindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    m_framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
+    bool complete = m_checkFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    m_bindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete)
+    {
+      std::cerr << "OpenGLRenderDriver: Incomplete framebuffer for a " << width << "x" << height << " render target" << std::endl;
+      m_deleteFramebuffers(1, &target.framebuffer);
+      deleteTexture(textureId);
+      return 0;
+    }
+
+    m_renderTargets[textureId] = target;
+    return textureId;
+  }
+
+  void deleteRenderTarget(unsigned int targetId) override
+  {
+    auto it = m_renderTargets.find(targetId);
+    if (it == m_renderTargets.end())
+      return;
+    m_deleteFramebuffers(1, &it->second.framebuffer);
+    m_renderTargets.erase(it);
+    deleteTexture(targetId);
+  }
+
+  bool beginRenderTarget(unsigned int targetId, float left, float top, float right, float bottom) override
+  {
+    auto it = m_renderTargets.find(targetId);
+    if (it == m_renderTargets.end() || m_inRenderTarget)
+      return false;
+
+    glGetIntegerv(GL_VIEWPORT, m_savedViewport);
+    m_bindFramebuffer(GL_FRAMEBUFFER, it->second.framebuffer);
+    glViewport(0, 0, it->second.width, it->second.height);
+
+    // World top lands on the top row, which is texture v = 1
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(left, right, bottom, top, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    GLfloat clearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+    m_inRenderTarget = true;
+    return true;
+  }
+
+  void endRenderTarget() override
+  {
+    if (!m_inRenderTarget)
+      return;
+    m_bindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(m_savedViewport[0], m_savedViewport[1], m_savedViewport[2], m_savedViewport[3]);
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    m_inRenderTarget = false;
+  }
+
   std::string getDriverName() const override
   {
     return "OpenGL";
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RenderDriver.h"
+#include "../profile/Profiler.h"
 #include <memory>
 #include <string>
 #include <iostream>
@@ -103,12 +104,14 @@ public:
   // Convenience methods that delegate to the driver
   void setup2DRendering(int viewportWidth, int viewportHeight)
   {
+    PROFILE_SCOPE_CAT("RenderDriver::setup2DRendering", "driver");
     if (m_driver)
       m_driver->setup2DRendering(viewportWidth, viewportHeight);
   }
 
   void clear(float r, float g, float b, float a)
   {
+    PROFILE_SCOPE_CAT("RenderDriver::clear", "driver");
     if (m_driver)
       m_driver->clear(r, g, b, a);
   }
@@ -133,22 +136,39 @@ public:
 
   void drawTriangle(float x1, float y1, float x2, float y2, float x3, float y3)
   {
+    PROFILE_SCOPE_CAT("RenderDriver::drawTriangle", "driver");
     if (m_driver)
       m_driver->drawTriangle(x1, y1, x2, y2, x3, y3);
   }
 
   void drawRectangle(float x, float y, float width, float height)
   {
+    PROFILE_SCOPE_CAT("RenderDriver::drawRectangle", "driver");
     if (m_driver)
       m_driver->drawRectangle(x, y, width, height);
   }
 
   void drawSprite(float x, float y, float width, float height, unsigned int textureId, float texLeft = 0.0f, float texTop = 0.0f, float texRight = 1.0f, float texBottom = 1.0f)
   {
+    PROFILE_SCOPE_CAT("RenderDriver::drawSprite", "driver");
     if (m_driver)
       m_driver->drawSprite(x, y, width, height, textureId, texLeft, texTop, texRight, texBottom);
   }
 
+  void drawTexturedTriangles(unsigned int textureId, const float *positions, const float *texCoords, const uint16_t *indices, size_t indexCount)
+  {
+    PROFILE_SCOPE_CAT("RenderDriver::drawTexturedTriangles", "driver");
+    if (m_driver)
+      m_driver->drawTexturedTriangles(textureId, positions, texCoords, indices, indexCount);
+  }
+
+  void drawParticles(const ParticleBatch &batch)
+  {
+    PROFILE_SCOPE_CAT("RenderDriver::drawParticles", "driver");
+    if (m_driver)
+      m_driver->drawParticles(batch);
+  }
+
   unsigned int createTexture()
   {
     return m_driver ? m_driver->createTexture() : 0;
@@ -162,13 +182,39 @@ public:
 
   void uploadTexture(unsigned int textureId, int width, int height, const void *data, bool useLinearFiltering = true)
   {
+    PROFILE_SCOPE_CAT("RenderDriver::uploadTexture", "driver");
     if (m_driver)
       m_driver->uploadTexture(textureId, width, height, data, useLinearFiltering);
   }
 
+  unsigned int createRenderTarget(int width, int height)
+  {
+    return m_driver ? m_driver->createRenderTarget(width, height) : 0;
+  }
+
+  void deleteRenderTarget(unsigned int targetId)
+  {
+    if (m_driver)
+      m_driver->deleteRenderTarget(targetId);
+  }
+
+  bool beginRenderTarget(unsigned int targetId, float left, float top, float right, float bottom)
+  {
+    PROFILE_SCOPE_CAT("RenderDriver::beginRenderTarget", "driver");
+    return m_driver && m_driver->beginRenderTarget(targetId, left, top, right, bottom);
+  }
+
+  void endRenderTarget()
+  {
+    PROFILE_SCOPE_CAT("RenderDriver::endRenderTarget", "driver");
+    if (m_driver)
+      m_driver->endRenderTarget();
+  }
+
   // Window management (rendering-related)
   void swapBuffers()
   {
+    PROFILE_SCOPE_CAT("RenderDriver::swapBuffers", "driver");
     if (m_driver)
       m_driver->swapBuffers();
   }
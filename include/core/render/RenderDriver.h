@@ -1,10 +1,29 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 // Forward declarations
 class Window;
 
+// One emitter's particles as structure-of-arrays, drawn as axis-aligned quads
+// in a single call. Size and alpha ramp linearly from start to end over age.
+struct ParticleBatch
+{
+  const float *x = nullptr;
+  const float *y = nullptr;
+  const float *age = nullptr;       // 0 at birth, 1 at death
+  const float *sizes = nullptr;     // Per-particle scale on the size ramp, or null
+  const uint32_t *colors = nullptr; // RGBA8, red in the low byte
+  size_t count = 0;
+  float startSize = 1.0f;
+  float endSize = 1.0f;
+  float startAlpha = 1.0f;
+  float endAlpha = 1.0f;
+  unsigned int textureId = 0; // 0 draws untextured quads
+};
+
 // Abstract base class for render drivers
 class RenderDriver
 {
@@ -28,12 +47,26 @@ public:
   virtual void drawTriangle(float x1, float y1, float x2, float y2, float x3, float y3) = 0;
   virtual void drawRectangle(float x, float y, float width, float height) = 0;
   virtual void drawSprite(float x, float y, float width, float height, unsigned int textureId, float texLeft = 0.0f, float texTop = 0.0f, float texRight = 1.0f, float texBottom = 1.0f) = 0;
+  // Indexed triangles in one call; positions and texCoords hold x, y and u, v per
+  // vertex. Texture 0 draws them untextured in the current color.
+  virtual void drawTexturedTriangles(unsigned int textureId, const float *positions, const float *texCoords, const uint16_t *indices, size_t indexCount) = 0;
+  // Per-particle colors replace the current color, which is left white
+  virtual void drawParticles(const ParticleBatch &batch) = 0;
 
   // Texture management
   virtual unsigned int createTexture() = 0;
   virtual void deleteTexture(unsigned int textureId) = 0;
   virtual void uploadTexture(unsigned int textureId, int width, int height, const void *data, bool useLinearFiltering = true) = 0;
 
+  // Offscreen render targets. createRenderTarget returns a texture id (0 if
+  // unsupported); between begin/endRenderTarget draws go into it, with the
+  // given world rectangle filling the cleared target. drawSprite then draws it
+  // like any texture, top edge at texture v = 1 as with sprite sheets.
+  virtual unsigned int createRenderTarget(int width, int height) = 0;
+  virtual void deleteRenderTarget(unsigned int targetId) = 0;
+  virtual bool beginRenderTarget(unsigned int targetId, float left, float top, float right, float bottom) = 0;
+  virtual void endRenderTarget() = 0;
+
   // Window management (rendering-related)
   virtual void swapBuffers() = 0;
   virtual void pollEvents() = 0;
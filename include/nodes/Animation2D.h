@@ -1,256 +1,472 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
-#include <map>
 #include <vector>
 #include <memory>
 #include <iostream>
+#include "AnimationLibrary.h"
+#include "AnimationSystem.h"
+#include "../core/log/Logger.h"
 
-// Animation frame data structure
-struct AnimationFrame
+// Per-sprite playback state; the clips themselves live in a shared AnimationClipSet
+struct AnimationPlayback
 {
-  int startFrame; // Starting frame index
-  int frameCount; // Number of frames in this animation
-
-  AnimationFrame(int start = 0, int count = 1)
-      : startFrame(start), frameCount(count) {}
-};
-
-// Animation data structure
-struct Animation
-{
-  std::string name;
-  std::vector<AnimationFrame> frames;
-  float frameRate; // Frames per second
-  bool loop;
+  enum Flags : uint16_t
+  {
+    Playing = 1 << 0
+  };
 
-  Animation(const std::string &animName = "", float fps = 12.0f, bool shouldLoop = true)
-      : name(animName), frameRate(fps), loop(shouldLoop) {}
+  AnimationClipHandle clip = InvalidAnimationClip;
+  uint16_t flags = 0;
+  uint32_t frame = 0; // Frame within the clip
+  uint32_t time = 0;  // Ticks (microseconds) spent on the current frame
 };
 
 class Animation2D
 {
 private:
-  std::map<std::string, Animation> animations;
-  std::string currentAnimation;
-  float currentFrame;
-  float frameTimer;
-  bool playing;
+  std::shared_ptr<const AnimationClipSet> clips;
+  AnimationClipSet *ownedClips; // Set built by addAnimation and not shared yet (else null)
+  AnimationSystem *system;
+  AnimationPlayback playback; // Stale while attached to a system, which then owns the state
+  uint32_t systemSlot;        // Beside the 12-byte playback so the two fill 16 bytes
+
+  // The set to add to or remove from: a private copy if the current one is shared
+  AnimationClipSet &editableClips()
+  {
+    if (!ownedClips || clips.use_count() > 1)
+    {
+      auto copy = clips ? std::make_shared<AnimationClipSet>(*clips) : std::make_shared<AnimationClipSet>();
+      ownedClips = copy.get();
+      clips = std::move(copy);
+    }
+    return *ownedClips;
+  }
+
+  // Edits work on `playback`; while attached, fetch it from the system first and store it back after
+  AnimationPlayback &beginEdit()
+  {
+    if (system)
+      playback = system->getPlayback(systemSlot);
+    return playback;
+  }
+  void endEdit()
+  {
+    if (system)
+      system->setPlayback(systemSlot, clips.get(), playback);
+  }
 
 public:
-  Animation2D()
-      : currentAnimation(""), currentFrame(0.0f), frameTimer(0.0f), playing(false)
+  Animation2D() : ownedClips(nullptr), system(nullptr), systemSlot(AnimationSystem::InvalidSlot) {}
+  ~Animation2D() { detach(); }
+
+  // Copies get the clips and playback state but are never attached
+  Animation2D(const Animation2D &other)
+      : clips(other.clips), ownedClips(other.ownedClips), system(nullptr), playback(other.getPlayback()),
+        systemSlot(AnimationSystem::InvalidSlot) {}
+
+  Animation2D &operator=(const Animation2D &other)
+  {
+    if (this != &other)
+    {
+      clips = other.clips;
+      ownedClips = other.ownedClips;
+      playback = other.getPlayback();
+      endEdit();
+    }
+    return *this;
+  }
+
+  // Use a shared clip set (e.g. from AnimationLibrary); stops playback
+  void setClips(std::shared_ptr<const AnimationClipSet> clipSet)
   {
+    clips = std::move(clipSet);
+    ownedClips = nullptr;
+    playback = AnimationPlayback();
+    endEdit();
   }
-  ~Animation2D() = default;
+  const std::shared_ptr<const AnimationClipSet> &getClips() const { return clips; }
 
-  // Animation management
+  // Animation management (copies a shared set before changing it)
   void addAnimation(const std::string &name, const Animation &animation)
   {
-    animations[name] = animation;
-    std::cout << "Added animation: " << name << " with " << animation.frames.size() << " frame groups" << std::endl;
+    beginEdit();
+    editableClips().addClip(name, animation);
+    endEdit();
   }
 
   void addAnimation(const std::string &name, const std::vector<AnimationFrame> &frames,
                     float frameRate = 12.0f, bool loop = true)
   {
-    Animation anim(name, frameRate, loop);
-    anim.frames = frames;
-    animations[name] = anim;
-    std::cout << "Added animation: " << name << " with " << frames.size() << " frame groups" << std::endl;
+    beginEdit();
+    editableClips().addClip(name, frames, frameRate, loop);
+    endEdit();
   }
 
   void removeAnimation(const std::string &name)
   {
-    auto it = animations.find(name);
-    if (it != animations.end())
+    if (!hasAnimation(name))
+      return;
+
+    std::string currentName = getCurrentAnimation();
+    AnimationPlayback &state = beginEdit();
+    editableClips().removeClip(name);
+    if (currentName == name)
     {
-      animations.erase(it);
-      if (currentAnimation == name)
-      {
-        currentAnimation = "";
-        currentFrame = 0.0f;
-        playing = false;
-      }
+      state = AnimationPlayback();
     }
+    else if (state.clip != InvalidAnimationClip)
+    {
+      state.clip = clips->find(currentName);
+    }
+    endEdit();
   }
 
   bool hasAnimation(const std::string &name) const
   {
-    return animations.find(name) != animations.end();
+    return clips && clips->has(name);
+  }
+
+  // Handle of a clip by name (look it up once at setup, then play by handle)
+  AnimationClipHandle findAnimation(const std::string &name) const
+  {
+    return clips ? clips->find(name) : InvalidAnimationClip;
   }
 
   // Playback control
   void play(const std::string &animationName)
   {
-    if (animations.find(animationName) == animations.end())
+    AnimationClipHandle handle = findAnimation(animationName);
+    if (handle == InvalidAnimationClip)
     {
       std::cerr << "Animation not found: " << animationName << std::endl;
       return;
     }
+    play(handle);
+  }
 
-    currentAnimation = animationName;
-    currentFrame = 0.0f;
-    frameTimer = 0.0f;
-    playing = true;
-    std::cout << "Playing animation: " << animationName << std::endl;
+  void play(AnimationClipHandle handle)
+  {
+    if (!clips || !clips->isValid(handle))
+      return;
+
+    AnimationPlayback &state = beginEdit();
+    state.clip = handle;
+    state.frame = 0;
+    state.time = 0;
+    state.flags |= AnimationPlayback::Playing;
+    endEdit();
+    LOG_DEBUG(Animation, "Playing animation: {}", clips->getName(handle));
   }
 
   void stop()
   {
-    playing = false;
-    currentFrame = 0.0f;
-    frameTimer = 0.0f;
+    AnimationPlayback &state = beginEdit();
+    state.flags &= ~AnimationPlayback::Playing;
+    state.frame = 0;
+    state.time = 0;
+    endEdit();
   }
 
   void pause()
   {
-    playing = false;
+    beginEdit().flags &= ~AnimationPlayback::Playing;
+    endEdit();
   }
 
   void resume()
   {
-    if (!currentAnimation.empty())
+    AnimationPlayback &state = beginEdit();
+    if (state.clip != InvalidAnimationClip)
     {
-      playing = true;
+      state.flags |= AnimationPlayback::Playing;
     }
+    endEdit();
   }
 
   void reset()
   {
-    currentFrame = 0.0f;
-    frameTimer = 0.0f;
+    AnimationPlayback &state = beginEdit();
+    state.frame = 0;
+    state.time = 0;
+    endEdit();
   }
 
   // Current animation info
-  std::string getCurrentAnimation() const { return currentAnimation; }
-  bool isPlaying() const { return playing; }
-  float getCurrentFrame() const { return currentFrame; }
+  const std::string &getCurrentAnimation() const
+  {
+    static const std::string none;
+    AnimationClipHandle clip = getCurrentClip();
+    return clip != InvalidAnimationClip ? clips->getName(clip) : none;
+  }
+  AnimationClipHandle getCurrentClip() const { return getPlayback().clip; }
+  bool isPlaying() const { return (getPlayback().flags & AnimationPlayback::Playing) != 0; }
+  float getCurrentFrame() const { return static_cast<float>(getPlayback().frame); }
+  AnimationPlayback getPlayback() const { return system ? system->getPlayback(systemSlot) : playback; }
+
+  // Batched playback: while attached, the system advances this animator and
+  // writes its sheet frame to `output`; update() does nothing
+  void attach(AnimationSystem &animationSystem, int *output)
+  {
+    if (system == &animationSystem)
+      return;
+    detach();
+    systemSlot = animationSystem.add(&systemSlot, output);
+    system = &animationSystem;
+    endEdit();
+  }
+
+  // Take the playback state back from the system
+  void detach()
+  {
+    if (!system)
+      return;
+    playback = system->getPlayback(systemSlot);
+    system->remove(systemSlot);
+    system = nullptr;
+    systemSlot = AnimationSystem::InvalidSlot;
+  }
+
+  bool isAttached() const { return system != nullptr; }
+
+  // Where the animated sprite is, for the system's level of detail (no-op while detached)
+  void setLodBounds(const Transform2D *transform, float halfWidth, float halfHeight)
+  {
+    if (system)
+      system->setBounds(systemSlot, transform, halfWidth, halfHeight);
+  }
 
   // Update animation (call this in your game loop)
   void update(float deltaTime)
   {
-    if (!playing || currentAnimation.empty())
+    if (system || !(playback.flags & AnimationPlayback::Playing))
       return;
 
-    auto it = animations.find(currentAnimation);
-    if (it == animations.end())
-      return;
+    advance(clips->getClip(playback.clip), deltaTime);
+  }
 
-    const Animation &anim = it->second;
-    if (anim.frames.empty())
-      return;
+  // update() then getCurrentFrameIndex() in one pass, for sprites driving
+  // their own animator; -1 while attached or without a clip
+  int updateFrame(float deltaTime)
+  {
+    if (system || playback.clip == InvalidAnimationClip)
+      return -1;
 
-    // Update frame timer
-    frameTimer += deltaTime;
-    float frameTime = 1.0f / anim.frameRate;
+    const AnimationClip &clip = clips->getClip(playback.clip);
+    if (clip.frameCount == 0)
+      return 0;
+    if (playback.flags & AnimationPlayback::Playing)
+      advance(clip, deltaTime);
+    return clips->getSheetFrame(clip, playback.frame);
+  }
 
-    if (frameTimer >= frameTime)
-    {
-      frameTimer -= frameTime;
-      currentFrame += 1.0f;
+private:
+  void advance(const AnimationClip &clip, float deltaTime)
+  {
+    if (clip.frameCount == 0 || clip.frameTime == AnimationNeverAdvances)
+      return;
 
-      // Calculate total frames in current animation
-      int totalFrames = 0;
-      for (const auto &frame : anim.frames)
-      {
-        totalFrames += frame.frameCount;
-      }
+    // Update frame timer (saturates if a slow game loop keeps falling behind)
+    uint64_t time = static_cast<uint64_t>(playback.time) + toAnimationTicks(deltaTime);
+    playback.time = static_cast<uint32_t>(std::min<uint64_t>(time, 0xFFFFFFFFu));
+    if (playback.time >= clip.frameTime)
+    {
+      playback.time -= clip.frameTime;
+      playback.frame++;
 
       // Handle looping or stopping
-      if (currentFrame >= totalFrames)
+      if (playback.frame >= clip.frameCount)
       {
-        if (anim.loop)
+        if (clip.loop)
         {
-          currentFrame = 0.0f;
+          playback.frame = 0;
         }
         else
         {
-          currentFrame = static_cast<float>(totalFrames - 1);
-          playing = false;
+          // Rest at the start of the last frame, however late this update is
+          playback.frame = clip.frameCount - 1;
+          playback.time = 0;
+          playback.flags &= ~AnimationPlayback::Playing;
         }
       }
     }
   }
 
+public:
   // Get current frame data for rendering
   int getCurrentFrameIndex() const
   {
-    if (currentAnimation.empty())
-      return 0;
-
-    auto it = animations.find(currentAnimation);
-    if (it == animations.end())
+    AnimationPlayback state = getPlayback();
+    if (state.clip == InvalidAnimationClip)
       return 0;
 
-    const Animation &anim = it->second;
-    if (anim.frames.empty())
+    const AnimationClip &clip = clips->getClip(state.clip);
+    if (clip.frameCount == 0)
       return 0;
-
-    int frameIndex = static_cast<int>(currentFrame);
-    int currentFrameInAnimation = 0;
-
-    for (const auto &frame : anim.frames)
-    {
-      if (frameIndex < frame.frameCount)
-      {
-        return frame.startFrame + frameIndex;
-      }
-      frameIndex -= frame.frameCount;
-      currentFrameInAnimation += frame.frameCount;
-    }
-
-    // Fallback to first frame of first animation
-    return anim.frames[0].startFrame;
+    return clips->getSheetFrame(clip, state.frame);
   }
 
-  AnimationFrame getCurrentAnimationFrame() const
+  // Clip data access
+  const AnimationClip *getAnimation(const std::string &name) const
   {
-    if (currentAnimation.empty())
-      return AnimationFrame(0, 1);
+    AnimationClipHandle handle = findAnimation(name);
+    return handle != InvalidAnimationClip ? &clips->getClip(handle) : nullptr;
+  }
 
-    auto it = animations.find(currentAnimation);
-    if (it == animations.end())
-      return AnimationFrame(0, 1);
+  // Clear all animations
+  void clear()
+  {
+    clips.reset();
+    ownedClips = nullptr;
+    playback = AnimationPlayback();
+    endEdit();
+  }
+};
 
-    const Animation &anim = it->second;
-    if (anim.frames.empty())
-      return AnimationFrame(0, 1);
+// Implementation of the AnimationSystem methods used by Animation2D
+inline uint32_t AnimationSystem::add(uint32_t *ownerSlot, int *output)
+{
+  frameStarts.push_back(0);
+  frameTimes.push_back(1);
+  frames.push_back(0);
+  frameCounts.push_back(1);
+  flags.push_back(Frozen);
+  frameTables.push_back(nullptr);
+  outputs.push_back(output);
+  transforms.push_back(nullptr);
+  radii.push_back(0.0f);
+  ownerSlots.push_back(ownerSlot);
+  clipSets.push_back(nullptr);
+  clips.push_back(InvalidAnimationClip);
+
+  // New animators are evaluated until they are classified as hidden
+  size_t slot = activeCount++;
+  swapSlots(slot, frames.size() - 1);
+  return static_cast<uint32_t>(slot);
+}
+
+inline void AnimationSystem::remove(uint32_t slot)
+{
+  // Move the slot to the end of the evaluated range, then swap-remove it from the hidden range
+  size_t freed = slot;
+  if (freed < activeCount)
+  {
+    swapSlots(freed, --activeCount);
+    freed = activeCount;
+  }
 
-    int frameIndex = static_cast<int>(currentFrame);
+  size_t last = frames.size() - 1;
+  if (freed != last)
+  {
+    frameStarts[freed] = frameStarts[last];
+    frameTimes[freed] = frameTimes[last];
+    frames[freed] = frames[last];
+    frameCounts[freed] = frameCounts[last];
+    flags[freed] = flags[last];
+    frameTables[freed] = frameTables[last];
+    outputs[freed] = outputs[last];
+    transforms[freed] = transforms[last];
+    radii[freed] = radii[last];
+    ownerSlots[freed] = ownerSlots[last];
+    clipSets[freed] = clipSets[last];
+    clips[freed] = clips[last];
+    *ownerSlots[freed] = static_cast<uint32_t>(freed);
+  }
 
-    for (const auto &frame : anim.frames)
+  frameStarts.pop_back();
+  frameTimes.pop_back();
+  frames.pop_back();
+  frameCounts.pop_back();
+  flags.pop_back();
+  frameTables.pop_back();
+  outputs.pop_back();
+  transforms.pop_back();
+  radii.pop_back();
+  ownerSlots.pop_back();
+  clipSets.pop_back();
+  clips.pop_back();
+}
+
+inline void AnimationSystem::setPlayback(uint32_t slot, const AnimationClipSet *clipSet, const AnimationPlayback &playback)
+{
+  clipSets[slot] = clipSet;
+  clips[slot] = playback.clip;
+  frames[slot] = playback.frame;
+  frameTimes[slot] = 1;
+  frameCounts[slot] = 1;
+  frameTables[slot] = nullptr;
+
+  // Keep the level of detail; it belongs to the sprite, not the clip
+  uint8_t state = flags[slot] & (Reduced | Hidden);
+  if (playback.flags & AnimationPlayback::Playing)
+    state |= Playing;
+
+  if (clipSet && clipSet->isValid(playback.clip))
+  {
+    const AnimationClip &clip = clipSet->getClip(playback.clip);
+    if (clip.loop)
+      state |= Loop;
+    if (clip.frameCount > 0)
     {
-      if (frameIndex < frame.frameCount)
-      {
-        return frame;
-      }
-      frameIndex -= frame.frameCount;
+      state |= HasClip;
+      frameCounts[slot] = clip.frameCount;
+      frameTables[slot] = clipSet->getFrameTable(clip);
+      if (frames[slot] >= clip.frameCount)
+        frames[slot] = clip.frameCount - 1;
     }
+    if (clip.frameCount > 0 && clip.frameTime != AnimationNeverAdvances)
+      frameTimes[slot] = clip.frameTime;
+    else
+      state |= Frozen; // Animation2D never advances these either
+  }
+  else
+  {
+    state |= Frozen;
+  }
+  flags[slot] = state;
+
+  // Running animators count from the clock, the rest keep their time as is
+  frameStarts[slot] = isRunning(slot) ? clock - playback.time : playback.time;
 
-    // Fallback to first frame
-    return anim.frames[0];
+  if ((state & HasClip) && outputs[slot])
+    *outputs[slot] = frameTables[slot][frames[slot]];
+}
+
+inline AnimationPlayback AnimationSystem::getPlayback(uint32_t slot) const
+{
+  AnimationPlayback playback;
+  playback.clip = clips[slot];
+  playback.frame = frames[slot];
+  playback.flags = (flags[slot] & Playing) ? AnimationPlayback::Playing : 0;
+  if (!isRunning(slot))
+  {
+    playback.time = static_cast<uint32_t>(frameStarts[slot]);
+    return playback;
   }
 
-  // Animation data access
-  const std::map<std::string, Animation> &getAllAnimations() const { return animations; }
-  const Animation *getAnimation(const std::string &name) const
+  // Level of detail may have skipped this animator; evaluate it now
+  uint64_t elapsed = clock - frameStarts[slot];
+  if (elapsed >= frameTimes[slot])
   {
-    auto it = animations.find(name);
-    if (it != animations.end())
+    Advance next = advance(slot, elapsed);
+    playback.frame = next.frame;
+    if (next.stopped)
     {
-      return &it->second;
+      playback.flags = 0;
+      playback.time = static_cast<uint32_t>(next.frameStart);
+      return playback;
     }
-    return nullptr;
+    elapsed = clock - next.frameStart;
   }
+  playback.time = static_cast<uint32_t>(elapsed);
+  return playback;
+}
 
-  // Clear all animations
-  void clear()
-  {
-    animations.clear();
-    currentAnimation = "";
-    currentFrame = 0.0f;
-    frameTimer = 0.0f;
-    playing = false;
-  }
-};
+inline void AnimationSystem::setBounds(uint32_t slot, const Transform2D *transform, float halfWidth, float halfHeight)
+{
+  transforms[slot] = transform;
+  radii[slot] = std::sqrt(halfWidth * halfWidth + halfHeight * halfHeight);
+  if (lodEnabled)
+    classify(slot);
+}
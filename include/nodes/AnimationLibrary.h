@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../core/log/Logger.h"
+
+// Animation frame data structure
+struct AnimationFrame
+{
+  int startFrame; // Starting frame index
+  int frameCount; // Number of frames in this animation
+
+  AnimationFrame(int start = 0, int count = 1)
+      : startFrame(start), frameCount(count) {}
+};
+
+// Animation data structure (setup-time description of a clip)
+struct Animation
+{
+  std::string name;
+  std::vector<AnimationFrame> frames;
+  float frameRate; // Frames per second
+  bool loop;
+
+  Animation(const std::string &animName = "", float fps = 12.0f, bool shouldLoop = true)
+      : name(animName), frameRate(fps), loop(shouldLoop) {}
+};
+
+// Animation time is counted in whole microseconds, so one large step lands on
+// exactly the frame that many small steps reach (see AnimationSystem)
+constexpr uint32_t AnimationTicksPerSecond = 1000000;
+constexpr uint32_t AnimationNeverAdvances = 0xFFFFFFFFu; // Frame time of a zero frame rate clip
+
+inline uint32_t toAnimationTicks(float seconds)
+{
+  if (!(seconds > 0.0f))
+    return 0;
+  double ticks = static_cast<double>(seconds) * AnimationTicksPerSecond + 0.5; // Rounded
+  return ticks < AnimationNeverAdvances ? static_cast<uint32_t>(ticks) : AnimationNeverAdvances - 1;
+}
+
+// Index of a clip within its AnimationClipSet
+using AnimationClipHandle = uint16_t;
+constexpr AnimationClipHandle InvalidAnimationClip = 0xFFFF;
+
+// A clip flattened for playback: its frame groups are expanded into one run
+// of sheet indices in the owning set's frame table
+struct AnimationClip
+{
+  uint32_t firstFrame; // Offset into the frame table
+  uint32_t frameCount; // Total frames over all groups
+  float frameRate;
+  uint32_t frameTime; // Ticks per frame (AnimationNeverAdvances for a zero frame rate)
+  bool loop;
+};
+
+// Clips shared by every sprite that animates the same sheet. Built once at
+// setup, then handed out as shared_ptr<const AnimationClipSet> so a thousand
+// sprites reference one copy instead of carrying a thousand.
+class AnimationClipSet
+{
+private:
+  std::vector<AnimationClip> clips;
+  std::vector<std::string> names;
+  std::vector<int> frameTable; // Sheet frame index of every clip frame
+
+public:
+  // Add a clip (or replace the one with the same name) and return its handle
+  AnimationClipHandle addClip(const std::string &name, const std::vector<AnimationFrame> &frames,
+                              float frameRate = 12.0f, bool loop = true);
+  AnimationClipHandle addClip(const std::string &name, const Animation &animation)
+  {
+    return addClip(name, animation.frames, animation.frameRate, animation.loop);
+  }
+
+  // Remove a clip; handles of the clips added after it shift down by one
+  bool removeClip(const std::string &name);
+
+  // Name lookup, for setup code; InvalidAnimationClip if there is none
+  AnimationClipHandle find(const std::string &name) const;
+  bool has(const std::string &name) const { return find(name) != InvalidAnimationClip; }
+
+  bool isValid(AnimationClipHandle handle) const { return handle < clips.size(); }
+  size_t getClipCount() const { return clips.size(); }
+  const AnimationClip &getClip(AnimationClipHandle handle) const { return clips[handle]; }
+  const std::string &getName(AnimationClipHandle handle) const { return names[handle]; }
+
+  // Sheet frame index of frame `frame` (0-based, < frameCount) of a clip
+  int getSheetFrame(const AnimationClip &clip, uint32_t frame) const { return frameTable[clip.firstFrame + frame]; }
+  const int *getFrameTable(const AnimationClip &clip) const { return frameTable.data() + clip.firstFrame; }
+
+  // Approximate footprint of the set (object, clips, names, frame table)
+  size_t getMemoryBytes() const;
+};
+
+// Named clip sets shared across scenes, e.g. "alien" for the alien sheet
+class AnimationLibrary
+{
+private:
+  std::map<std::string, std::shared_ptr<const AnimationClipSet>> sets;
+
+  // Private constructor for singleton
+  AnimationLibrary() = default;
+
+public:
+  // Singleton access
+  static AnimationLibrary &getInstance()
+  {
+    static AnimationLibrary instance;
+    return instance;
+  }
+
+  // Prevent copying
+  AnimationLibrary(const AnimationLibrary &) = delete;
+  AnimationLibrary &operator=(const AnimationLibrary &) = delete;
+
+  // Register a set (replaces a set with the same name; sprites keep the old one)
+  void add(const std::string &name, std::shared_ptr<const AnimationClipSet> clipSet) { sets[name] = std::move(clipSet); }
+
+  // nullptr if no set has this name
+  std::shared_ptr<const AnimationClipSet> get(const std::string &name) const
+  {
+    auto it = sets.find(name);
+    return it != sets.end() ? it->second : nullptr;
+  }
+
+  bool has(const std::string &name) const { return sets.find(name) != sets.end(); }
+  void remove(const std::string &name) { sets.erase(name); }
+  void clear() { sets.clear(); }
+};
+
+// Implementation
+inline AnimationClipHandle AnimationClipSet::addClip(const std::string &name, const std::vector<AnimationFrame> &frames,
+                                                     float frameRate, bool loop)
+{
+  AnimationClip clip;
+  clip.firstFrame = static_cast<uint32_t>(frameTable.size());
+  clip.frameCount = 0;
+  clip.frameRate = frameRate;
+  clip.frameTime = AnimationNeverAdvances;
+  if (frameRate > 0.0f)
+  {
+    uint32_t ticks = toAnimationTicks(1.0f / frameRate);
+    clip.frameTime = ticks > 0 ? ticks : 1;
+  }
+  clip.loop = loop;
+
+  // A replaced clip's old frames stay in the table; sets are built once, so that is cheap
+  for (const AnimationFrame &group : frames)
+  {
+    for (int i = 0; i < group.frameCount; ++i)
+    {
+      frameTable.push_back(group.startFrame + i);
+    }
+    if (group.frameCount > 0)
+      clip.frameCount += group.frameCount;
+  }
+
+  AnimationClipHandle handle = find(name);
+  if (handle != InvalidAnimationClip)
+  {
+    clips[handle] = clip;
+  }
+  else
+  {
+    if (clips.size() >= InvalidAnimationClip)
+    {
+      std::cerr << "AnimationClipSet: too many clips, cannot add " << name << std::endl;
+      return InvalidAnimationClip;
+    }
+    handle = static_cast<AnimationClipHandle>(clips.size());
+    clips.push_back(clip);
+    names.push_back(name);
+  }
+
+  LOG_DEBUG(Animation, "Added animation: {} with {} frames", name, clip.frameCount);
+  return handle;
+}
+
+inline bool AnimationClipSet::removeClip(const std::string &name)
+{
+  AnimationClipHandle handle = find(name);
+  if (handle == InvalidAnimationClip)
+    return false;
+
+  clips.erase(clips.begin() + handle);
+  names.erase(names.begin() + handle);
+  return true;
+}
+
+inline AnimationClipHandle AnimationClipSet::find(const std::string &name) const
+{
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    if (names[i] == name)
+      return static_cast<AnimationClipHandle>(i);
+  }
+  return InvalidAnimationClip;
+}
+
+inline size_t AnimationClipSet::getMemoryBytes() const
+{
+  size_t bytes = sizeof(*this) + clips.capacity() * sizeof(AnimationClip) +
+                 names.capacity() * sizeof(std::string) + frameTable.capacity() * sizeof(int);
+  for (const std::string &name : names)
+  {
+    bytes += name.size() + 1;
+  }
+  return bytes;
+}
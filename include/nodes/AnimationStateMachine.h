@@ -0,0 +1,545 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Animation2D.h"
+#include "AnimationLibrary.h"
+
+enum class AnimationParameterType : uint8_t
+{
+  Bool,
+  Float,
+  Trigger // Bool that is reset when a transition testing it fires
+};
+
+enum class AnimationCondition : uint8_t
+{
+  IsTrue,
+  IsFalse,
+  Greater,
+  Less
+};
+
+// Compiled state machine: states bound to clips and one flat transition table,
+// shared by every character that uses it. Bool and trigger parameters are bits
+// of one word per character, so a transition's bool tests are a single
+// mask-and-compare; float tests and the clip-finished event are kept aside.
+// With few bools, the transition each state takes for every bit pattern is
+// precomputed, so most characters are evaluated with one table load.
+class AnimationStateMachine
+{
+public:
+  static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+  static constexpr size_t MaxBoolParameters = 32;
+  static constexpr uint32_t MaxLookupBits = 10; // Bools covered by the lookup table
+  static constexpr uint32_t ScanTransitions = 0xFFFFFFFEu; // Lookup entry of a state that tests more than bools
+
+  struct FloatCondition
+  {
+    uint32_t slot; // Index among the float parameters
+    AnimationCondition test;
+    float threshold;
+  };
+
+  struct Transition
+  {
+    uint32_t mask;  // Bool parameters tested
+    uint32_t value; // Their required values
+    uint32_t triggers; // Trigger bits consumed when it fires
+    uint32_t target;
+    uint32_t firstCondition; // Float conditions
+    uint32_t conditionCount;
+    bool afterClipFinished; // Also requires the current (non-looping) clip to have finished
+  };
+
+private:
+  // States; the transitions of state s are [firstTransition[s], firstTransition[s + 1])
+  std::vector<AnimationClipHandle> stateClips;
+  std::vector<uint32_t> firstTransition;
+  std::vector<Transition> transitions;
+  std::vector<FloatCondition> conditions;
+  uint32_t initialState = 0;
+
+  // Transition (or InvalidIndex, or ScanTransitions) at (state << lookupBits) | (bits & lookupMask)
+  std::vector<uint32_t> lookup;
+  uint32_t lookupBits = 0;
+  uint32_t lookupMask = 0;
+
+  // Parameters: bit index (bools, triggers) or float index of each
+  std::vector<AnimationParameterType> parameterTypes;
+  std::vector<uint32_t> parameterSlots;
+  uint32_t defaultBits = 0;
+  std::vector<float> defaultFloats;
+
+  // Setup-time lookup
+  std::vector<std::string> stateNames;
+  std::vector<std::string> parameterNames;
+
+  friend class AnimationStateMachineBuilder;
+  friend class AnimationStateBatch;
+
+public:
+  uint32_t findState(const std::string &name) const;
+  uint32_t findParameter(const std::string &name) const;
+
+  size_t getStateCount() const { return stateClips.size(); }
+  size_t getParameterCount() const { return parameterTypes.size(); }
+  size_t getTransitionCount() const { return transitions.size(); }
+  uint32_t getInitialState() const { return initialState; }
+  AnimationClipHandle getClip(uint32_t state) const { return stateClips[state]; }
+  const std::string &getStateName(uint32_t state) const { return stateNames[state]; }
+};
+
+// Describes a state machine by name and compiles it against a clip set
+class AnimationStateMachineBuilder
+{
+public:
+  struct TransitionDesc
+  {
+    std::string from; // Empty for a transition from any state
+    std::string to;
+    bool afterClipFinished = false;
+    std::vector<std::string> parameters;
+    std::vector<AnimationCondition> tests;
+    std::vector<float> thresholds;
+
+    TransitionDesc &when(const std::string &parameter, AnimationCondition test = AnimationCondition::IsTrue,
+                         float threshold = 0.0f)
+    {
+      parameters.push_back(parameter);
+      tests.push_back(test);
+      thresholds.push_back(threshold);
+      return *this;
+    }
+    TransitionDesc &whenNot(const std::string &parameter) { return when(parameter, AnimationCondition::IsFalse); }
+    TransitionDesc &whenClipFinished()
+    {
+      afterClipFinished = true;
+      return *this;
+    }
+  };
+
+private:
+  struct ParameterDesc
+  {
+    std::string name;
+    AnimationParameterType type;
+    float defaultValue;
+  };
+  struct StateDesc
+  {
+    std::string name;
+    std::string clip;
+  };
+
+  std::vector<ParameterDesc> parameters;
+  std::vector<StateDesc> states;
+  std::deque<TransitionDesc> transitions; // Deque, so returned references stay valid
+  std::string initialState;
+
+public:
+  // At most MaxBoolParameters bools and triggers together
+  void addBool(const std::string &name, bool defaultValue = false)
+  {
+    parameters.push_back({name, AnimationParameterType::Bool, defaultValue ? 1.0f : 0.0f});
+  }
+  void addFloat(const std::string &name, float defaultValue = 0.0f)
+  {
+    parameters.push_back({name, AnimationParameterType::Float, defaultValue});
+  }
+  void addTrigger(const std::string &name) { parameters.push_back({name, AnimationParameterType::Trigger, 0.0f}); }
+
+  // The first state added is the initial one unless setInitialState is called
+  void addState(const std::string &name, const std::string &clip) { states.push_back({name, clip}); }
+  void setInitialState(const std::string &name) { initialState = name; }
+
+  // Transitions are tried in the order they were added, any-state ones first;
+  // the first whose conditions all hold fires
+  TransitionDesc &addTransition(const std::string &from, const std::string &to)
+  {
+    transitions.push_back(TransitionDesc());
+    transitions.back().from = from;
+    transitions.back().to = to;
+    return transitions.back();
+  }
+
+  // From every state except `to` itself
+  TransitionDesc &addAnyTransition(const std::string &to) { return addTransition("", to); }
+
+  // Resolve every name; nullptr (with the reason on stderr) if the description is invalid
+  std::shared_ptr<const AnimationStateMachine> compile(const AnimationClipSet &clips) const;
+};
+
+// Runs one state machine for many characters at once. Per-character state and
+// parameters are stored in flat arrays; update() walks them in one pass,
+// fires at most one transition per character and plays the new state's clip
+// on that character's animator.
+class AnimationStateBatch
+{
+private:
+  std::shared_ptr<const AnimationStateMachine> machine;
+  const uint32_t *slots; // machine->parameterSlots
+  size_t floatCount;
+  std::vector<uint32_t> states;
+  std::vector<uint32_t> bits; // Bool and trigger parameters
+  std::vector<float> floats; // floatCount values per instance
+  std::vector<Animation2D *> animators;
+
+  uint32_t findTransition(size_t instance, uint32_t state, uint32_t word) const;
+
+public:
+  explicit AnimationStateBatch(std::shared_ptr<const AnimationStateMachine> stateMachine)
+      : machine(std::move(stateMachine)), slots(machine ? machine->parameterSlots.data() : nullptr),
+        floatCount(machine ? machine->defaultFloats.size() : 0) {}
+
+  const std::shared_ptr<const AnimationStateMachine> &getMachine() const { return machine; }
+
+  // Start a character in the initial state (plays its clip); returns its instance
+  // index, or InvalidIndex if the batch has no machine
+  uint32_t add(Animation2D *animator);
+
+  // Swap-remove: the last instance takes over this index
+  void remove(uint32_t instance);
+
+  // Parameters by index (AnimationStateMachine::findParameter)
+  void setBool(uint32_t instance, uint32_t parameter, bool value)
+  {
+    uint32_t bit = 1u << slots[parameter];
+    bits[instance] = value ? bits[instance] | bit : bits[instance] & ~bit;
+  }
+  void setTrigger(uint32_t instance, uint32_t parameter) { setBool(instance, parameter, true); }
+  bool getBool(uint32_t instance, uint32_t parameter) const
+  {
+    return (bits[instance] >> slots[parameter]) & 1u;
+  }
+  void setFloat(uint32_t instance, uint32_t parameter, float value)
+  {
+    floats[instance * floatCount + slots[parameter]] = value;
+  }
+  float getFloat(uint32_t instance, uint32_t parameter) const
+  {
+    return floats[instance * floatCount + slots[parameter]];
+  }
+
+  uint32_t getState(uint32_t instance) const { return states[instance]; }
+  Animation2D *getAnimator(uint32_t instance) const { return animators[instance]; }
+  size_t size() const { return states.size(); }
+
+  // Evaluate every instance; returns the number of transitions that fired
+  size_t update();
+};
+
+// Implementation
+inline uint32_t AnimationStateMachine::findState(const std::string &name) const
+{
+  for (size_t i = 0; i < stateNames.size(); ++i)
+  {
+    if (stateNames[i] == name)
+      return static_cast<uint32_t>(i);
+  }
+  return InvalidIndex;
+}
+
+inline uint32_t AnimationStateMachine::findParameter(const std::string &name) const
+{
+  for (size_t i = 0; i < parameterNames.size(); ++i)
+  {
+    if (parameterNames[i] == name)
+      return static_cast<uint32_t>(i);
+  }
+  return InvalidIndex;
+}
+
+inline std::shared_ptr<const AnimationStateMachine> AnimationStateMachineBuilder::compile(const AnimationClipSet &clips) const
+{
+  auto machine = std::make_shared<AnimationStateMachine>();
+  if (states.empty())
+  {
+    std::cerr << "AnimationStateMachine: no states" << std::endl;
+    return nullptr;
+  }
+
+  uint32_t boolCount = 0;
+  for (const ParameterDesc &parameter : parameters)
+  {
+    uint32_t slot;
+    if (parameter.type == AnimationParameterType::Float)
+    {
+      slot = static_cast<uint32_t>(machine->defaultFloats.size());
+      machine->defaultFloats.push_back(parameter.defaultValue);
+    }
+    else
+    {
+      if (boolCount == AnimationStateMachine::MaxBoolParameters)
+      {
+        std::cerr << "AnimationStateMachine: too many bool parameters, cannot add " << parameter.name << std::endl;
+        return nullptr;
+      }
+      slot = boolCount++;
+      if (parameter.defaultValue != 0.0f)
+        machine->defaultBits |= 1u << slot;
+    }
+    machine->parameterNames.push_back(parameter.name);
+    machine->parameterTypes.push_back(parameter.type);
+    machine->parameterSlots.push_back(slot);
+  }
+
+  for (const StateDesc &state : states)
+  {
+    AnimationClipHandle clip = clips.find(state.clip);
+    if (clip == InvalidAnimationClip)
+    {
+      std::cerr << "AnimationStateMachine: state " << state.name << " uses unknown clip " << state.clip << std::endl;
+      return nullptr;
+    }
+    machine->stateNames.push_back(state.name);
+    machine->stateClips.push_back(clip);
+  }
+
+  if (!initialState.empty())
+  {
+    machine->initialState = machine->findState(initialState);
+    if (machine->initialState == AnimationStateMachine::InvalidIndex)
+    {
+      std::cerr << "AnimationStateMachine: unknown initial state " << initialState << std::endl;
+      return nullptr;
+    }
+  }
+
+  // Resolve every transition once
+  struct Resolved
+  {
+    uint32_t from; // InvalidIndex = any state
+    AnimationStateMachine::Transition transition;
+  };
+  std::vector<Resolved> resolved;
+  for (const TransitionDesc &desc : transitions)
+  {
+    Resolved entry;
+    entry.from = desc.from.empty() ? AnimationStateMachine::InvalidIndex : machine->findState(desc.from);
+    AnimationStateMachine::Transition &transition = entry.transition;
+    transition.target = machine->findState(desc.to);
+    if ((!desc.from.empty() && entry.from == AnimationStateMachine::InvalidIndex) ||
+        transition.target == AnimationStateMachine::InvalidIndex)
+    {
+      std::cerr << "AnimationStateMachine: transition " << (desc.from.empty() ? "*" : desc.from) << " -> " << desc.to
+                << " uses an unknown state" << std::endl;
+      return nullptr;
+    }
+
+    transition.mask = 0;
+    transition.value = 0;
+    transition.triggers = 0;
+    transition.firstCondition = static_cast<uint32_t>(machine->conditions.size());
+    transition.conditionCount = 0;
+    transition.afterClipFinished = desc.afterClipFinished;
+    for (size_t i = 0; i < desc.parameters.size(); ++i)
+    {
+      uint32_t parameter = machine->findParameter(desc.parameters[i]);
+      if (parameter == AnimationStateMachine::InvalidIndex)
+      {
+        std::cerr << "AnimationStateMachine: transition to " << desc.to << " tests unknown parameter "
+                  << desc.parameters[i] << std::endl;
+        return nullptr;
+      }
+
+      AnimationParameterType type = machine->parameterTypes[parameter];
+      uint32_t slot = machine->parameterSlots[parameter];
+      AnimationCondition test = desc.tests[i];
+      if (type == AnimationParameterType::Float)
+      {
+        machine->conditions.push_back({slot, test, desc.thresholds[i]});
+        transition.conditionCount++;
+      }
+      else if (test == AnimationCondition::IsTrue || test == AnimationCondition::IsFalse)
+      {
+        transition.mask |= 1u << slot;
+        if (test == AnimationCondition::IsTrue)
+          transition.value |= 1u << slot;
+        if (type == AnimationParameterType::Trigger)
+          transition.triggers |= 1u << slot;
+      }
+      else
+      {
+        std::cerr << "AnimationStateMachine: bool parameter " << desc.parameters[i]
+                  << " can only be tested for true or false" << std::endl;
+        return nullptr;
+      }
+    }
+    resolved.push_back(entry);
+  }
+
+  // Flatten into one table grouped by source state, any-state transitions first
+  size_t stateCount = machine->stateClips.size();
+  std::vector<bool> boolsOnly(stateCount, true);
+  machine->firstTransition.reserve(stateCount + 1);
+  for (uint32_t state = 0; state < stateCount; ++state)
+  {
+    machine->firstTransition.push_back(static_cast<uint32_t>(machine->transitions.size()));
+    for (int pass = 0; pass < 2; ++pass)
+    {
+      for (const Resolved &entry : resolved)
+      {
+        bool fromHere = pass == 0 ? entry.from == AnimationStateMachine::InvalidIndex && entry.transition.target != state
+                                  : entry.from == state;
+        if (!fromHere)
+          continue;
+        machine->transitions.push_back(entry.transition);
+        if (entry.transition.conditionCount > 0 || entry.transition.afterClipFinished)
+          boolsOnly[state] = false;
+      }
+    }
+  }
+  machine->firstTransition.push_back(static_cast<uint32_t>(machine->transitions.size()));
+
+  // Lookup table: the first matching transition of a bool-only state for every
+  // bit pattern; with too many bools every state scans its transitions instead
+  if (boolCount <= AnimationStateMachine::MaxLookupBits)
+  {
+    machine->lookupBits = boolCount;
+    machine->lookupMask = (1u << boolCount) - 1;
+  }
+  uint32_t patterns = machine->lookupMask + 1;
+  machine->lookup.assign(stateCount * patterns, AnimationStateMachine::ScanTransitions);
+  for (uint32_t state = 0; state < stateCount; ++state)
+  {
+    if (!boolsOnly[state] || machine->lookupBits != boolCount)
+      continue;
+    for (uint32_t word = 0; word < patterns; ++word)
+    {
+      uint32_t found = AnimationStateMachine::InvalidIndex;
+      for (uint32_t t = machine->firstTransition[state]; t < machine->firstTransition[state + 1]; ++t)
+      {
+        if ((word & machine->transitions[t].mask) == machine->transitions[t].value)
+        {
+          found = t;
+          break;
+        }
+      }
+      machine->lookup[(state << machine->lookupBits) | word] = found;
+    }
+  }
+  return machine;
+}
+
+inline uint32_t AnimationStateBatch::add(Animation2D *animator)
+{
+  if (!machine)
+  {
+    std::cerr << "AnimationStateBatch: no state machine" << std::endl;
+    return AnimationStateMachine::InvalidIndex;
+  }
+
+  uint32_t instance = static_cast<uint32_t>(states.size());
+  states.push_back(machine->initialState);
+  bits.push_back(machine->defaultBits);
+  floats.insert(floats.end(), machine->defaultFloats.begin(), machine->defaultFloats.end());
+  animators.push_back(animator);
+  if (animator)
+  {
+    animator->play(machine->stateClips[machine->initialState]);
+  }
+  return instance;
+}
+
+inline void AnimationStateBatch::remove(uint32_t instance)
+{
+  size_t last = states.size() - 1;
+  if (instance != last)
+  {
+    states[instance] = states[last];
+    bits[instance] = bits[last];
+    animators[instance] = animators[last];
+    std::copy(floats.begin() + last * floatCount, floats.begin() + (last + 1) * floatCount,
+              floats.begin() + instance * floatCount);
+  }
+  states.pop_back();
+  bits.pop_back();
+  animators.pop_back();
+  floats.resize(last * floatCount);
+}
+
+inline uint32_t AnimationStateBatch::findTransition(size_t instance, uint32_t state, uint32_t word) const
+{
+  const AnimationStateMachine &table = *machine;
+  const float *values = floats.data() + instance * floatCount;
+  for (uint32_t t = table.firstTransition[state]; t < table.firstTransition[state + 1]; ++t)
+  {
+    const AnimationStateMachine::Transition &transition = table.transitions[t];
+    if ((word & transition.mask) != transition.value)
+      continue;
+
+    bool pass = true;
+    const AnimationStateMachine::FloatCondition *condition = table.conditions.data() + transition.firstCondition;
+    for (uint32_t c = 0; c < transition.conditionCount && pass; ++c, ++condition)
+    {
+      float value = values[condition->slot];
+      switch (condition->test)
+      {
+      case AnimationCondition::IsTrue:
+        pass = value != 0.0f;
+        break;
+      case AnimationCondition::IsFalse:
+        pass = value == 0.0f;
+        break;
+      case AnimationCondition::Greater:
+        pass = value > condition->threshold;
+        break;
+      case AnimationCondition::Less:
+        pass = value < condition->threshold;
+        break;
+      }
+    }
+
+    // The finished event is the costliest test, so it goes last
+    if (pass && transition.afterClipFinished)
+      pass = animators[instance] && !animators[instance]->isPlaying();
+    if (pass)
+      return t;
+  }
+  return AnimationStateMachine::InvalidIndex;
+}
+
+inline size_t AnimationStateBatch::update()
+{
+  if (!machine)
+    return 0;
+
+  const AnimationStateMachine &table = *machine;
+  const uint32_t *lookup = table.lookup.data();
+  const uint32_t lookupBits = table.lookupBits;
+  const uint32_t lookupMask = table.lookupMask;
+  uint32_t *stateData = states.data();
+  uint32_t *bitData = bits.data();
+
+  size_t fired = 0;
+  size_t count = states.size();
+  for (size_t i = 0; i < count; ++i)
+  {
+    uint32_t word = bitData[i];
+    uint32_t state = stateData[i];
+    uint32_t t = lookup[(state << lookupBits) | (word & lookupMask)];
+    if (t == AnimationStateMachine::InvalidIndex)
+      continue;
+    if (t == AnimationStateMachine::ScanTransitions)
+    {
+      t = findTransition(i, state, word);
+      if (t == AnimationStateMachine::InvalidIndex)
+        continue;
+    }
+
+    // Fire: consume the triggers it tested and switch clips
+    const AnimationStateMachine::Transition &transition = table.transitions[t];
+    bitData[i] = word & ~transition.triggers;
+    stateData[i] = transition.target;
+    if (animators[i])
+      animators[i]->play(table.stateClips[transition.target]);
+    fired++;
+  }
+  return fired;
+}
@@ -0,0 +1,363 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "../core/Math.h"
+#include "AnimationLibrary.h"
+
+// Forward declarations
+class Animation2D;
+struct AnimationPlayback;
+
+// Level-of-detail policy for animators with bounds (see AnimationSystem::enableLod)
+struct AnimationLodPolicy
+{
+  // World units around the view that still count as visible. It must cover how
+  // far sprites and view move in 2 * classifyInterval updates, so no sprite
+  // scrolls into view before it is evaluated again.
+  float margin = 256.0f;
+  float minScreenSize = 4.0f;     // Visible sprites smaller than this many pixels on screen run at the reduced rate
+  uint32_t reducedInterval = 4;   // Reduced-rate animators are evaluated every this many updates
+  uint32_t classifyInterval = 16; // Updates it takes to re-classify every animator
+};
+
+// Number of animators at each level of detail after the last classification
+struct AnimationLodStats
+{
+  size_t full = 0;
+  size_t reduced = 0;
+  size_t hidden = 0;
+};
+
+// Advances many animators in one pass. Playback state is kept in parallel
+// arrays (structure of arrays) instead of inside each sprite, so update() is
+// a linear loop over contiguous integers that only leaves them when a frame
+// changes. Unlike Animation2D::update, a large delta advances several frames
+// at once. The sheet frame is written to the animator's output when it
+// changes and whenever playback is changed through Animation2D.
+//
+// A playing animator stores the tick on the system clock at which its current
+// frame began, so its frame is a function of the clock alone. Skipping it for
+// a while and evaluating it later gives exactly the frame it would have had if
+// it had been evaluated every update. Level of detail builds on this: off-screen
+// animators are not evaluated at all and ones too small on screen to notice
+// (tiny, or far away under a zoomed-out view) only every few updates. Reading
+// an animator through Animation2D is always exact.
+//
+// Animators join with Animation2D::attach and leave with detach (Sprite2D does
+// this itself when its scene has batched animation enabled). Slots are
+// swap-removed, so an animator's slot can change while it is attached.
+class AnimationSystem
+{
+public:
+  static constexpr uint32_t InvalidSlot = 0xFFFFFFFFu;
+
+  enum Flags : uint8_t
+  {
+    Playing = 1 << 0,
+    Loop = 1 << 1,
+    HasClip = 1 << 2,
+    Frozen = 1 << 3,  // No clip, empty clip or zero frame rate: never advances
+    Reduced = 1 << 4, // Level of detail: evaluated every reducedInterval updates
+    Hidden = 1 << 5   // Level of detail: not evaluated until it is classified again
+  };
+
+private:
+  uint64_t clock;       // Ticks since the system was created
+  uint32_t updateIndex; // Number of update() calls
+  size_t activeCount;   // Slots [0, activeCount) are evaluated; the Hidden ones are kept after them
+
+  // Hot data, touched by every update
+  std::vector<uint64_t> frameStarts; // Clock tick the current frame began on (while running), else ticks spent on it
+  std::vector<uint32_t> frameTimes;  // Ticks per frame (1 when there is no clip or it is frozen)
+  std::vector<uint32_t> frames;      // Frame within the clip
+  std::vector<uint32_t> frameCounts; // At least 1
+  std::vector<uint8_t> flags;
+
+  // Output: the clip's run in its set's frame table and where to write the sheet frame
+  std::vector<const int *> frameTables;
+  std::vector<int *> outputs;
+
+  // Level of detail: where the animator's sprite is and its radius at unit scale
+  std::vector<const Transform2D *> transforms;
+  std::vector<float> radii;
+  bool lodEnabled;
+  AnimationLodPolicy lodPolicy;
+  float viewLeft, viewTop, viewRight, viewBottom, viewZoom;
+
+  // Cold data
+  std::vector<uint32_t *> ownerSlots; // Each animator's record of its slot, kept current across swaps
+  std::vector<const AnimationClipSet *> clipSets;
+  std::vector<AnimationClipHandle> clips;
+
+  friend class Animation2D;
+
+  // Used by Animation2D (defined in Animation2D.h, next to AnimationPlayback)
+  uint32_t add(uint32_t *ownerSlot, int *output);
+  void remove(uint32_t slot);
+  void setPlayback(uint32_t slot, const AnimationClipSet *clipSet, const AnimationPlayback &playback);
+  AnimationPlayback getPlayback(uint32_t slot) const;
+  void setBounds(uint32_t slot, const Transform2D *transform, float halfWidth, float halfHeight);
+
+  bool isRunning(size_t slot) const { return (flags[slot] & (Playing | Frozen)) == Playing; }
+
+  // Where a running animator is `elapsed` ticks after its frame began
+  struct Advance
+  {
+    uint32_t frame;
+    uint64_t frameStart; // Still a clock tick, or 0 once stopped
+    bool stopped;
+  };
+  Advance advance(size_t slot, uint64_t elapsed) const;
+
+  // Swap two slots in every array and tell their owners
+  void swapSlots(size_t a, size_t b);
+
+  // Update a slot's level of detail; true if it was hidden (another slot now sits at `slot`)
+  bool classify(size_t slot);
+
+public:
+  AnimationSystem()
+      : clock(0), updateIndex(0), activeCount(0), lodEnabled(false), viewLeft(0.0f), viewTop(0.0f), viewRight(0.0f),
+        viewBottom(0.0f), viewZoom(1.0f) {}
+
+  AnimationSystem(const AnimationSystem &) = delete;
+  AnimationSystem &operator=(const AnimationSystem &) = delete;
+
+  // Advance every running animator (subject to level of detail)
+  void update(float deltaTime);
+
+  // Level of detail for animators with bounds (Sprite2D provides them). Set
+  // the view every frame, e.g. from Camera::getLeft/getTop/getRight/getBottom/getZoom;
+  // a slice of the animators is re-classified against it on every update.
+  void enableLod(const AnimationLodPolicy &policy);
+  void disableLod();
+  bool isLodEnabled() const { return lodEnabled; }
+  void setView(float left, float top, float right, float bottom, float zoom);
+
+  // Re-classify every animator now (after a camera cut)
+  void classifyAll();
+  AnimationLodStats getLodStats() const;
+
+  uint64_t getClock() const { return clock; }
+  size_t size() const { return frames.size(); }
+  size_t getPlayingCount() const;
+
+  void reserve(size_t count);
+};
+
+// Implementation of the methods not used by Animation2D
+inline void AnimationSystem::update(float deltaTime)
+{
+  clock += toAnimationTicks(deltaTime);
+  updateIndex++;
+
+  uint32_t reducedInterval = std::max<uint32_t>(lodPolicy.reducedInterval, 1);
+  if (lodEnabled)
+  {
+    // A slice of the slots per update; one moved by a swap waits at most one more round
+    uint32_t classifyInterval = std::max<uint32_t>(lodPolicy.classifyInterval, 1);
+    for (size_t i = updateIndex % classifyInterval; i < frames.size(); i += classifyInterval)
+    {
+      classify(i);
+    }
+  }
+
+  // Hidden animators sit after activeCount and cost nothing here
+  size_t count = activeCount;
+
+  const uint64_t now = clock;
+  uint64_t *frameStart = frameStarts.data();
+  const uint32_t *frameTime = frameTimes.data();
+  uint32_t *frame = frames.data();
+  uint8_t *flag = flags.data();
+  const int *const *table = frameTables.data();
+  int *const *output = outputs.data();
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    if ((flag[i] & (Playing | Frozen)) != Playing)
+      continue;
+    if ((flag[i] & Reduced) && (updateIndex + i) % reducedInterval != 0)
+      continue;
+
+    // Most updates stay on the current frame
+    uint64_t elapsed = now - frameStart[i];
+    if (elapsed < frameTime[i])
+      continue;
+
+    // One or more frames elapsed
+    Advance next = advance(i, elapsed);
+    frameStart[i] = next.frameStart;
+    if (next.stopped)
+      flag[i] &= static_cast<uint8_t>(~Playing);
+    if (next.frame != frame[i])
+    {
+      frame[i] = next.frame;
+      if (output[i])
+        *output[i] = table[i][next.frame];
+    }
+  }
+}
+
+inline AnimationSystem::Advance AnimationSystem::advance(size_t slot, uint64_t elapsed) const
+{
+  uint64_t frameTime = frameTimes[slot];
+  uint64_t frameCount = frameCounts[slot];
+  uint64_t frame = frames[slot];
+  uint64_t steps = elapsed / frameTime;
+
+  Advance result;
+  if (frame + steps >= frameCount && !(flags[slot] & Loop))
+  {
+    // Stops on the step past the last frame and rests at the start of it, as
+    // Animation2D::update does (the time left over would depend on when the
+    // animator happened to be evaluated)
+    result.frame = static_cast<uint32_t>(frameCount - 1);
+    result.frameStart = 0;
+    result.stopped = true;
+    return result;
+  }
+
+  result.frame = static_cast<uint32_t>((frame + steps) % frameCount);
+  result.frameStart = frameStarts[slot] + steps * frameTime;
+  result.stopped = false;
+  return result;
+}
+
+inline void AnimationSystem::swapSlots(size_t a, size_t b)
+{
+  if (a == b)
+    return;
+  std::swap(frameStarts[a], frameStarts[b]);
+  std::swap(frameTimes[a], frameTimes[b]);
+  std::swap(frames[a], frames[b]);
+  std::swap(frameCounts[a], frameCounts[b]);
+  std::swap(flags[a], flags[b]);
+  std::swap(frameTables[a], frameTables[b]);
+  std::swap(outputs[a], outputs[b]);
+  std::swap(transforms[a], transforms[b]);
+  std::swap(radii[a], radii[b]);
+  std::swap(ownerSlots[a], ownerSlots[b]);
+  std::swap(clipSets[a], clipSets[b]);
+  std::swap(clips[a], clips[b]);
+  *ownerSlots[a] = static_cast<uint32_t>(a);
+  *ownerSlots[b] = static_cast<uint32_t>(b);
+}
+
+inline bool AnimationSystem::classify(size_t slot)
+{
+  uint8_t level = 0;
+  if (const Transform2D *transform = transforms[slot])
+  {
+    const Position2D &position = transform->getPosition();
+    const Scale2D &scale = transform->getScale();
+    float radius = radii[slot] * std::max(std::fabs(scale.x), std::fabs(scale.y));
+    float margin = lodPolicy.margin;
+
+    if (position.x + radius < viewLeft - margin || position.x - radius > viewRight + margin ||
+        position.y + radius < viewTop - margin || position.y - radius > viewBottom + margin)
+    {
+      level = Hidden;
+    }
+    else if (radius * 2.0f * viewZoom < lodPolicy.minScreenSize)
+    {
+      level = Reduced;
+    }
+  }
+  bool wasHidden = (flags[slot] & Hidden) != 0;
+  flags[slot] = static_cast<uint8_t>((flags[slot] & ~(Reduced | Hidden)) | level);
+
+  // Keep the hidden slots after the evaluated ones
+  if (level == Hidden && !wasHidden)
+  {
+    swapSlots(slot, --activeCount);
+    return true;
+  }
+  if (level != Hidden && wasHidden)
+  {
+    swapSlots(slot, activeCount++);
+  }
+  return false;
+}
+
+inline void AnimationSystem::enableLod(const AnimationLodPolicy &policy)
+{
+  lodPolicy = policy;
+  lodEnabled = true;
+  classifyAll();
+}
+
+inline void AnimationSystem::disableLod()
+{
+  lodEnabled = false;
+  for (uint8_t &flag : flags)
+  {
+    flag = static_cast<uint8_t>(flag & ~(Reduced | Hidden));
+  }
+  activeCount = frames.size();
+}
+
+inline void AnimationSystem::setView(float left, float top, float right, float bottom, float zoom)
+{
+  viewLeft = left;
+  viewTop = top;
+  viewRight = right;
+  viewBottom = bottom;
+  viewZoom = zoom;
+}
+
+inline void AnimationSystem::classifyAll()
+{
+  if (!lodEnabled)
+    return;
+  for (size_t i = 0; i < frames.size();)
+  {
+    // A slot that was just hidden has been replaced by one not classified yet
+    if (!classify(i) || i >= activeCount)
+      ++i;
+  }
+}
+
+inline AnimationLodStats AnimationSystem::getLodStats() const
+{
+  AnimationLodStats stats;
+  for (uint8_t flag : flags)
+  {
+    if (flag & Hidden)
+      stats.hidden++;
+    else if (flag & Reduced)
+      stats.reduced++;
+    else
+      stats.full++;
+  }
+  return stats;
+}
+
+inline size_t AnimationSystem::getPlayingCount() const
+{
+  size_t playing = 0;
+  for (uint8_t flag : flags)
+  {
+    playing += (flag & Playing) ? 1 : 0;
+  }
+  return playing;
+}
+
+inline void AnimationSystem::reserve(size_t count)
+{
+  frameStarts.reserve(count);
+  frameTimes.reserve(count);
+  frames.reserve(count);
+  frameCounts.reserve(count);
+  flags.reserve(count);
+  frameTables.reserve(count);
+  outputs.reserve(count);
+  transforms.reserve(count);
+  radii.reserve(count);
+  ownerSlots.reserve(count);
+  clipSets.reserve(count);
+  clips.reserve(count);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Node.h"
+#include "Sprite2D.h"
+#include "../core/ecs/World.h"
+#include "../core/ecs/Systems.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Bridge node that hosts an entity/component World inside the scene graph.
+// The whole world updates and renders as a single node, so thousands of
+// entities cost one virtual call instead of one per object.
+class EcsWorldNode : public Node
+{
+  NODE_TYPE(EcsWorldNode)
+
+private:
+  World world;
+  std::vector<std::unique_ptr<TextureData>> textures; // Sprite sheets referenced by SpriteFrame components
+
+public:
+  EcsWorldNode(const std::string &nodeName = "EcsWorld") : Node(nodeName) {}
+
+  // World access
+  World &getWorld() { return world; }
+  const World &getWorld() const { return world; }
+
+  // Load a sprite sheet owned by this node (nullptr on failure)
+  const TextureData *loadTexture(const std::string &path, TextureFilter filter = TextureFilter::NEAREST)
+  {
+    auto texture = loadTextureData(path, filter);
+    if (!texture)
+    {
+      return nullptr;
+    }
+
+    textures.push_back(std::move(texture));
+    return textures.back().get();
+  }
+
+  // Run the movement and animation systems
+  void update(float deltaTime = 0.0f) override
+  {
+    Node::update(deltaTime);
+
+    EcsSystems::integrateVelocity(world, deltaTime);
+    EcsSystems::advanceAnimations(world, deltaTime);
+  }
+
+  // Draw all entities through the RenderDevice
+  void render() const override
+  {
+    EcsSystems::renderSprites(world);
+  }
+};
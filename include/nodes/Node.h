@@ -1,6 +1,15 @@
 #pragma once
 
 #include "../core/Math.h"
+#include "../core/memory/NodeArena.h"
+#include "../core/StringTable.h"
+#include "../core/profile/Profiler.h"
+#include "../scene/SceneTree.h"
+#include "NodeType.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
 #include <vector>
 #include <memory>
 #include <string>
@@ -9,19 +18,36 @@
 class Node
 {
 protected:
-  std::string name;
+  StringId nameId;    // Interned in the global StringTable
+  uint32_t nameSlot;  // Index in the SceneTree's list of nodes sharing this name
+  uint32_t typeSlot;  // Index in the SceneTree's bucket for this node's type
+  uint32_t flatIndex; // Position in the SceneTree's FlatHierarchy, if it has one
   std::vector<std::unique_ptr<Node>> children;
   Node *parent;
+  SceneTree *tree; // Tree this node is attached to (nullptr while detached)
+  Node *prevSameName; // Siblings with the same name, in child order (maintained by SceneTree)
+  Node *nextSameName;
+  int8_t renderLayer; // -1 inherits the parent's layer (the root's is 0)
 
 public:
   Node(const std::string &nodeName = "Node")
-      : name(nodeName), parent(nullptr) {}
+      : nameId(StringTable::getInstance().intern(nodeName)), nameSlot(0), typeSlot(0), flatIndex(FlatHierarchy::InvalidIndex),
+        parent(nullptr), tree(nullptr), prevSameName(nullptr), nextSameName(nullptr), renderLayer(-1) {}
 
   virtual ~Node() = default;
 
+  // Compile-time type id; derived classes declare theirs with NODE_TYPE
+  static constexpr NodeType StaticType = NodeType::Node;
+  virtual NodeType getType() const { return StaticType; }
+
+  // Allocation goes through the thread's current NodeArena, if any
+  static void *operator new(size_t size);
+  static void operator delete(void *ptr, size_t size); // Sized: the arena recycles by size
+
   // Name management
-  const std::string &getName() const { return name; }
-  void setName(const std::string &nodeName) { name = nodeName; }
+  const std::string &getName() const { return StringTable::getInstance().get(nameId); }
+  StringId getNameId() const { return nameId; }
+  void setName(const std::string &nodeName);
 
   // Parent-child relationship
   Node *getParent() const { return parent; }
@@ -29,11 +55,24 @@ public:
 
   void addChild(std::unique_ptr<Node> child);
   std::unique_ptr<Node> removeChild(Node *child);
-  void removeAllChildren() { children.clear(); }
+  void removeAllChildren();
+
+  // Move this node (and its subtree) to the end of another node's children
+  void reparent(Node *newParent);
+
+  // Remove and delete this node at the next command flush (safe to call from
+  // update, including from WorkerPool jobs, which default to their own lane)
+  void queueFree(uint32_t lane = SceneCommandBuffer::currentLane());
 
   const std::vector<std::unique_ptr<Node>> &getChildren() const { return children; }
   size_t getChildCount() const { return children.size(); }
 
+  // Scene tree membership (maintained by SceneTree)
+  SceneTree *getTree() const { return tree; }
+  friend class SceneTree;
+  friend class FlatHierarchy;
+  friend class SceneCommandBuffer;
+
   // Virtual methods for rendering and updating
   virtual void render() const = 0;
   virtual void update(float deltaTime = 0.0f);
@@ -41,8 +80,23 @@ public:
   // Virtual method for input handling
   virtual void handleInput();
 
+  // Called after the node joins or leaves a SceneTree, or the tree's shared
+  // systems change (getTree() is already up to date)
+  virtual void onTreeChanged() {}
+
+  // Render layer of this node and the children that do not set their own
+  // (see RenderLayers); -1 inherits
+  void setRenderLayer(int layer);
+  int getRenderLayer() const { return renderLayer; }
+  int getEffectiveRenderLayer() const;
+
+  // Re-render the static layer this node draws in, if it is on one; setters
+  // that change how a node looks call this
+  void markRenderDirty() const;
+
   // Scene graph traversal
   virtual void renderRecursive() const;
+  void renderLayerRecursive(int layer, int inherited) const; // Only the nodes on `layer`
   virtual void updateRecursive(float deltaTime = 0.0f);
   virtual void handleInputRecursive();
 };
@@ -50,6 +104,8 @@ public:
 // Concrete Root Node class that can be instantiated
 class RootNode : public Node
 {
+  NODE_TYPE(RootNode)
+
 public:
   RootNode(const std::string &nodeName = "Root") : Node(nodeName) {}
 
@@ -59,13 +115,71 @@ public:
   }
 };
 
+// Checked downcast using the node type ids instead of RTTI (nullptr if node is not a T)
+template <typename T>
+inline T *nodeCast(Node *node)
+{
+  return node && isNodeTypeA(node->getType(), T::StaticType) ? static_cast<T *>(node) : nullptr;
+}
+
+template <typename T>
+inline const T *nodeCast(const Node *node)
+{
+  return node && isNodeTypeA(node->getType(), T::StaticType) ? static_cast<const T *>(node) : nullptr;
+}
+
 // Implementation of Node methods
+
+// Every node allocation is prefixed with the arena it came from (nullptr = global heap)
+constexpr size_t NodeAllocationHeader = alignof(std::max_align_t);
+
+inline void *Node::operator new(size_t size)
+{
+  NodeArena *arena = NodeArena::getCurrent();
+  size_t total = size + NodeAllocationHeader;
+
+  unsigned char *raw = static_cast<unsigned char *>(arena ? arena->allocate(total) : ::operator new(total));
+  *reinterpret_cast<NodeArena **>(raw) = arena;
+  return raw + NodeAllocationHeader;
+}
+
+inline void Node::operator delete(void *ptr, size_t size)
+{
+  if (!ptr)
+    return;
+
+  unsigned char *raw = static_cast<unsigned char *>(ptr) - NodeAllocationHeader;
+  NodeArena *arena = *reinterpret_cast<NodeArena **>(raw);
+  if (arena)
+  {
+    arena->deallocate(raw, size + NodeAllocationHeader);
+  }
+  else
+  {
+    ::operator delete(raw);
+  }
+}
+
+inline void Node::setName(const std::string &nodeName)
+{
+  StringId oldName = nameId;
+  nameId = StringTable::getInstance().intern(nodeName);
+  if (tree && oldName != nameId)
+  {
+    tree->renameNode(this, oldName, nameId);
+  }
+}
+
 inline void Node::addChild(std::unique_ptr<Node> child)
 {
   if (child)
   {
     child->setParent(this);
     children.push_back(std::move(child));
+    if (tree)
+    {
+      tree->attachSubtree(children.back().get());
+    }
   }
 }
 
@@ -77,6 +191,11 @@ inline std::unique_ptr<Node> Node::removeChild(Node *child)
     {
       std::unique_ptr<Node> removed = std::move(*it);
       children.erase(it);
+      // Detach while the parent is still set, so the subtree's layers are known
+      if (tree)
+      {
+        tree->detachSubtree(removed.get());
+      }
       removed->setParent(nullptr);
       return removed;
     }
@@ -84,6 +203,64 @@ inline std::unique_ptr<Node> Node::removeChild(Node *child)
   return nullptr;
 }
 
+inline void Node::removeAllChildren()
+{
+  if (tree)
+  {
+    for (auto &child : children)
+    {
+      tree->detachSubtree(child.get());
+    }
+  }
+  children.clear();
+}
+
+inline void Node::reparent(Node *newParent)
+{
+  if (!parent || !newParent || newParent == parent)
+    return;
+
+  // A node cannot move into its own subtree
+  for (Node *ancestor = newParent; ancestor; ancestor = ancestor->parent)
+  {
+    if (ancestor == this)
+      return;
+  }
+
+  // Leaving the tree detaches while the old parent is still set, as removeChild does
+  bool sameTree = tree && tree == newParent->tree;
+  if (sameTree)
+  {
+    tree->invalidateLayers(this);
+  }
+  else if (tree)
+  {
+    tree->detachSubtree(this);
+  }
+
+  Node *oldParent = parent;
+  for (auto it = oldParent->children.begin(); it != oldParent->children.end(); ++it)
+  {
+    if (it->get() == this)
+    {
+      std::unique_ptr<Node> self = std::move(*it);
+      oldParent->children.erase(it);
+      newParent->children.push_back(std::move(self));
+      break;
+    }
+  }
+  parent = newParent;
+
+  if (sameTree)
+  {
+    tree->reparentSubtree(this, oldParent);
+  }
+  else if (newParent->tree)
+  {
+    newParent->tree->attachSubtree(this);
+  }
+}
+
 inline void Node::update(float deltaTime)
 {
   // Base node update - can be overridden by derived classes
@@ -96,6 +273,8 @@ inline void Node::handleInput()
 
 inline void Node::renderRecursive() const
 {
+  PROFILE_SCOPE_CAT(nodeTypeName(getType()), "render");
+
   // Render this node
   render();
 
@@ -106,8 +285,64 @@ inline void Node::renderRecursive() const
   }
 }
 
+inline void Node::renderLayerRecursive(int layer, int inherited) const
+{
+  int effective = renderLayer >= 0 ? renderLayer : inherited;
+  if (effective == layer)
+  {
+    PROFILE_SCOPE_CAT(nodeTypeName(getType()), "render");
+    render();
+  }
+
+  for (const auto &child : children)
+  {
+    child->renderLayerRecursive(layer, effective);
+  }
+}
+
+inline void Node::setRenderLayer(int layer)
+{
+  if (layer < -1 || layer >= static_cast<int>(RenderLayerCount))
+  {
+    std::cerr << "Node: Render layer " << layer << " out of range for " << getName() << std::endl;
+    return;
+  }
+  if (layer == renderLayer)
+    return;
+
+  if (tree)
+    tree->invalidateLayers(this);
+  renderLayer = static_cast<int8_t>(layer);
+  if (tree)
+  {
+    if (layer > 0)
+      tree->getLayers().noteLayer(static_cast<size_t>(layer));
+    tree->invalidateLayers(this);
+  }
+}
+
+inline int Node::getEffectiveRenderLayer() const
+{
+  for (const Node *node = this; node; node = node->parent)
+  {
+    if (node->renderLayer >= 0)
+      return node->renderLayer;
+  }
+  return 0;
+}
+
+inline void Node::markRenderDirty() const
+{
+  if (tree)
+  {
+    tree->invalidateLayer(this);
+  }
+}
+
 inline void Node::updateRecursive(float deltaTime)
 {
+  PROFILE_SCOPE_CAT(nodeTypeName(getType()), "update");
+
   // Update this node
   update(deltaTime);
 
@@ -128,4 +363,827 @@ inline void Node::handleInputRecursive()
   {
     child->handleInputRecursive();
   }
+}
+
+inline void Node::queueFree(uint32_t lane)
+{
+  if (tree)
+  {
+    tree->getCommands().destroy(this, lane);
+  }
+}
+
+// Implementation of SceneTree methods that need the complete Node
+inline void SceneTree::setRoot(Node *rootNode)
+{
+  if (root)
+  {
+    unregisterSubtree(root);
+  }
+
+  root = rootNode;
+  if (root)
+  {
+    registerSubtree(root);
+  }
+
+  if (flatHierarchy)
+  {
+    flatHierarchy->build(root);
+  }
+}
+
+inline void SceneTree::attachSubtree(Node *node)
+{
+  registerSubtree(node);
+  if (flatHierarchy)
+  {
+    flatHierarchy->insertSubtree(node);
+  }
+  invalidateLayers(node);
+}
+
+inline void SceneTree::detachSubtree(Node *node)
+{
+  commands.dropSubtree(node);
+  invalidateLayers(node);
+  if (flatHierarchy)
+  {
+    flatHierarchy->removeSubtree(node);
+  }
+  unregisterSubtree(node);
+}
+
+inline void SceneTree::reparentSubtree(Node *node, Node *oldParent)
+{
+  // Moved to the end of the new parent's children
+  unlinkChild(oldParent, node, node->getNameId());
+  linkChild(node);
+
+  if (flatHierarchy)
+  {
+    flatHierarchy->moveSubtree(node, node->getParent());
+  }
+  invalidateLayers(node);
+}
+
+inline void SceneTree::invalidateLayers(const Node *node)
+{
+  if (renderLayers && renderLayers->hasStaticLayers())
+  {
+    invalidateSubtreeLayers(node, node->getParent() ? node->getParent()->getEffectiveRenderLayer() : 0);
+  }
+}
+
+inline void SceneTree::invalidateLayer(const Node *node)
+{
+  if (renderLayers && renderLayers->hasStaticLayers())
+  {
+    renderLayers->invalidate(static_cast<size_t>(node->getEffectiveRenderLayer()));
+  }
+}
+
+inline void SceneTree::invalidateSubtreeLayers(const Node *node, int inherited)
+{
+  int layer = node->renderLayer >= 0 ? node->renderLayer : inherited;
+  renderLayers->invalidate(static_cast<size_t>(layer));
+  for (const auto &child : node->children)
+  {
+    invalidateSubtreeLayers(child.get(), layer);
+  }
+}
+
+inline void SceneTree::enableFlatHierarchy(bool enable)
+{
+  if (!enable)
+  {
+    flatHierarchy.reset();
+    return;
+  }
+
+  if (!flatHierarchy)
+  {
+    flatHierarchy = std::make_unique<FlatHierarchy>();
+    flatHierarchy->build(root);
+  }
+}
+
+inline void SceneTree::enableAnimationSystem(bool enable)
+{
+  if (enable == (animationSystem != nullptr))
+    return;
+
+  // Keep the old system alive until every animator has left it
+  std::unique_ptr<AnimationSystem> previous = std::move(animationSystem);
+  if (enable)
+  {
+    animationSystem = std::make_unique<AnimationSystem>();
+    animationSystem->reserve(getTypeCount(NodeType::Sprite2D));
+  }
+
+  for (auto &bucket : nodesByType)
+  {
+    for (Node *node : bucket)
+    {
+      node->onTreeChanged();
+    }
+  }
+}
+
+inline void SceneTree::registerSubtree(Node *node)
+{
+  registerNode(node);
+  for (auto &child : node->getChildren())
+  {
+    registerSubtree(child.get());
+  }
+}
+
+inline void SceneTree::unregisterSubtree(Node *node)
+{
+  for (auto &child : node->getChildren())
+  {
+    unregisterSubtree(child.get());
+  }
+  unregisterNode(node);
+}
+
+inline void SceneTree::registerNode(Node *node)
+{
+  node->tree = this;
+  addToNameIndex(node, node->getNameId());
+  if (node->parent)
+  {
+    linkChild(node);
+  }
+  nodeCount++;
+
+  auto &bucket = nodesByType[static_cast<size_t>(node->getType())];
+  node->typeSlot = static_cast<uint32_t>(bucket.size());
+  bucket.push_back(node);
+  if (node->renderLayer > 0)
+  {
+    getLayers().noteLayer(static_cast<size_t>(node->renderLayer));
+  }
+  node->onTreeChanged();
+}
+
+inline void SceneTree::unregisterNode(Node *node)
+{
+  removeFromNameIndex(node, node->getNameId());
+  if (node->parent)
+  {
+    unlinkChild(node->parent, node, node->getNameId());
+  }
+  nodeCount--;
+
+  // Swap-remove from the type bucket
+  auto &bucket = nodesByType[static_cast<size_t>(node->getType())];
+  Node *last = bucket.back();
+  bucket[node->typeSlot] = last;
+  last->typeSlot = node->typeSlot;
+  bucket.pop_back();
+
+  node->tree = nullptr;
+  node->onTreeChanged();
+}
+
+inline void SceneTree::renameNode(Node *node, StringId oldName, StringId newName)
+{
+  removeFromNameIndex(node, oldName);
+  addToNameIndex(node, newName);
+  if (node->parent)
+  {
+    unlinkChild(node->parent, node, oldName);
+    linkChildInOrder(node);
+  }
+}
+
+inline void SceneTree::addToNameIndex(Node *node, StringId nameId)
+{
+  auto &bucket = nodesByName[nameId];
+  node->nameSlot = static_cast<uint32_t>(bucket.size());
+  bucket.push_back(node);
+}
+
+inline void SceneTree::removeFromNameIndex(Node *node, StringId nameId)
+{
+  // Swap-remove, so many nodes sharing one name (bullets, particles) stay O(1)
+  auto &bucket = nodesByName[nameId];
+  Node *last = bucket.back();
+  bucket[node->nameSlot] = last;
+  last->nameSlot = node->nameSlot;
+  bucket.pop_back();
+}
+
+inline void SceneTree::linkChild(Node *node)
+{
+  // Children are only ever appended, so a newly attached node is the last one
+  SameNameChildren &list = childrenByName.try_emplace(ChildKey{node->parent, node->nameId}, SameNameChildren{nullptr, nullptr}).first->second;
+  node->prevSameName = list.last;
+  node->nextSameName = nullptr;
+  if (list.last)
+    list.last->nextSameName = node;
+  else
+    list.first = node;
+  list.last = node;
+}
+
+inline void SceneTree::linkChildInOrder(Node *node)
+{
+  // A renamed node keeps its place: link it after the last earlier sibling
+  // already carrying the new name (walks the children, renames are rare)
+  Node *before = nullptr;
+  for (const auto &child : node->parent->children)
+  {
+    if (child.get() == node)
+      break;
+    if (child->nameId == node->nameId)
+      before = child.get();
+  }
+
+  SameNameChildren &list = childrenByName.try_emplace(ChildKey{node->parent, node->nameId}, SameNameChildren{nullptr, nullptr}).first->second;
+  node->prevSameName = before;
+  node->nextSameName = before ? before->nextSameName : list.first;
+  if (node->nextSameName)
+    node->nextSameName->prevSameName = node;
+  else
+    list.last = node;
+  if (before)
+    before->nextSameName = node;
+  else
+    list.first = node;
+}
+
+inline void SceneTree::unlinkChild(const Node *parent, Node *node, StringId nameId)
+{
+  auto it = childrenByName.find(ChildKey{parent, nameId});
+  if (it == childrenByName.end())
+    return;
+
+  SameNameChildren &list = it->second;
+  if (node->prevSameName)
+    node->prevSameName->nextSameName = node->nextSameName;
+  else
+    list.first = node->nextSameName;
+  if (node->nextSameName)
+    node->nextSameName->prevSameName = node->prevSameName;
+  else
+    list.last = node->prevSameName;
+  node->prevSameName = nullptr;
+  node->nextSameName = nullptr;
+
+  if (!list.first)
+    childrenByName.erase(it);
+}
+
+inline Node *SceneTree::findPath(std::string_view path) const
+{
+  if (!root)
+    return nullptr;
+
+  auto &strings = StringTable::getInstance();
+  const Node *current = nullptr;
+
+  size_t start = 0;
+  while (start <= path.size())
+  {
+    size_t end = path.find('/', start);
+    if (end == std::string_view::npos)
+    {
+      end = path.size();
+    }
+
+    // Unknown segment names cannot match any node
+    StringId segment = strings.find(path.substr(start, end - start));
+    if (segment == InvalidStringId)
+      return nullptr;
+
+    if (!current)
+    {
+      if (root->getNameId() != segment)
+        return nullptr;
+      current = root;
+    }
+    else
+    {
+      current = findChild(current, segment);
+      if (!current)
+        return nullptr;
+    }
+
+    start = end + 1;
+  }
+
+  return const_cast<Node *>(current);
+}
+
+// Implementation of FlatHierarchy methods that need the complete Node
+inline void FlatHierarchy::appendSubtree(Node *node, int32_t parentIndex, uint32_t firstIndex,
+                                         std::vector<Node *> &outNodes, std::vector<int32_t> &outParents,
+                                         std::vector<uint32_t> &outSizes) const
+{
+  struct Pending
+  {
+    Node *node;
+    int32_t parentIndex;
+  };
+
+  size_t base = outNodes.size();
+
+  // Iterative pre-order walk (children pushed in reverse so they come out in order)
+  std::vector<Pending> stack;
+  stack.push_back({node, parentIndex});
+  while (!stack.empty())
+  {
+    Pending pending = stack.back();
+    stack.pop_back();
+
+    uint32_t index = firstIndex + static_cast<uint32_t>(outNodes.size() - base);
+    outNodes.push_back(pending.node);
+    outParents.push_back(pending.parentIndex);
+    outSizes.push_back(1);
+    pending.node->flatIndex = index;
+
+    const auto &children = pending.node->getChildren();
+    for (auto it = children.rbegin(); it != children.rend(); ++it)
+    {
+      stack.push_back({it->get(), static_cast<int32_t>(index)});
+    }
+  }
+
+  // Parents precede their children, so one backwards pass accumulates subtree sizes
+  for (size_t i = outNodes.size() - 1; i > base; --i)
+  {
+    size_t localParent = static_cast<size_t>(outParents[i]) - firstIndex + base;
+    outSizes[localParent] += outSizes[i];
+  }
+}
+
+inline void FlatHierarchy::build(Node *root)
+{
+  nodes.clear();
+  parentIndices.clear();
+  subtreeSizes.clear();
+  deadCount = 0;
+
+  if (root)
+  {
+    appendSubtree(root, -1, 0, nodes, parentIndices, subtreeSizes);
+  }
+}
+
+inline void FlatHierarchy::insertSubtree(Node *node)
+{
+  if (updating)
+  {
+    rebuildPending = true;
+    return;
+  }
+
+  Node *parent = node->getParent();
+  if (!parent || parent->flatIndex == InvalidIndex)
+    return;
+
+  uint32_t parentIndex = parent->flatIndex;
+  uint32_t position = parentIndex + subtreeSizes[parentIndex];
+
+  uint32_t count;
+  if (node->getChildren().empty())
+  {
+    // Single node (the common spawn case): no temporary layout needed
+    count = 1;
+    nodes.insert(nodes.begin() + position, node);
+    parentIndices.insert(parentIndices.begin() + position, static_cast<int32_t>(parentIndex));
+    subtreeSizes.insert(subtreeSizes.begin() + position, 1u);
+    node->flatIndex = position;
+  }
+  else
+  {
+    std::vector<Node *> newNodes;
+    std::vector<int32_t> newParents;
+    std::vector<uint32_t> newSizes;
+    appendSubtree(node, static_cast<int32_t>(parentIndex), position, newNodes, newParents, newSizes);
+    count = static_cast<uint32_t>(newNodes.size());
+
+    nodes.insert(nodes.begin() + position, newNodes.begin(), newNodes.end());
+    parentIndices.insert(parentIndices.begin() + position, newParents.begin(), newParents.end());
+    subtreeSizes.insert(subtreeSizes.begin() + position, newSizes.begin(), newSizes.end());
+  }
+
+  // Everything after the new range shifted by count
+  for (size_t i = position + count; i < nodes.size(); ++i)
+  {
+    if (parentIndices[i] >= static_cast<int32_t>(position))
+    {
+      parentIndices[i] += count;
+    }
+    if (nodes[i])
+    {
+      nodes[i]->flatIndex = static_cast<uint32_t>(i);
+    }
+  }
+
+  // The parent and all its ancestors grew by count
+  for (int32_t ancestor = static_cast<int32_t>(parentIndex); ancestor != -1; ancestor = parentIndices[ancestor])
+  {
+    subtreeSizes[ancestor] += count;
+  }
+}
+
+inline void FlatHierarchy::removeSubtree(Node *node)
+{
+  uint32_t index = node->flatIndex;
+  if (index == InvalidIndex)
+    return;
+
+  uint32_t end = index + subtreeSizes[index];
+  for (uint32_t i = index; i < end; ++i)
+  {
+    if (nodes[i])
+    {
+      nodes[i]->flatIndex = InvalidIndex;
+      nodes[i] = nullptr;
+      deadCount++;
+    }
+  }
+
+  compactIfNeeded();
+}
+
+inline void FlatHierarchy::moveSubtree(Node *node, Node *newParent)
+{
+  if (updating)
+  {
+    rebuildPending = true;
+    return;
+  }
+
+  uint32_t start = node->flatIndex;
+  if (start == InvalidIndex || !newParent || newParent->flatIndex == InvalidIndex)
+    return;
+
+  uint32_t count = subtreeSizes[start];
+  uint32_t newParentIndex = newParent->flatIndex;
+  if (newParentIndex >= start && newParentIndex < start + count)
+    return; // Cannot move into its own subtree
+
+  // Old ancestors shrink
+  for (int32_t ancestor = parentIndices[start]; ancestor != -1; ancestor = parentIndices[ancestor])
+  {
+    subtreeSizes[ancestor] -= count;
+  }
+
+  // Destination is the end of the new parent's range, measured with the subtree taken out
+  uint32_t parentWithout = newParentIndex < start ? newParentIndex : newParentIndex - count;
+  uint32_t destination = parentWithout + subtreeSizes[newParentIndex];
+
+  // Old index -> new index
+  auto remap = [start, count, destination](uint32_t index) -> uint32_t
+  {
+    if (index >= start && index < start + count)
+      return index - start + destination;
+    uint32_t without = index < start ? index : index - count;
+    return without < destination ? without : without + count;
+  };
+
+  for (auto &parentIndex : parentIndices)
+  {
+    if (parentIndex != -1)
+    {
+      parentIndex = static_cast<int32_t>(remap(static_cast<uint32_t>(parentIndex)));
+    }
+  }
+  parentIndices[start] = static_cast<int32_t>(remap(newParentIndex));
+
+  // Rotate the subtree range into place
+  uint32_t first, middle, last;
+  if (destination > start)
+  {
+    first = start;
+    middle = start + count;
+    last = destination + count;
+  }
+  else
+  {
+    first = destination;
+    middle = start;
+    last = start + count;
+  }
+  std::rotate(nodes.begin() + first, nodes.begin() + middle, nodes.begin() + last);
+  std::rotate(parentIndices.begin() + first, parentIndices.begin() + middle, parentIndices.begin() + last);
+  std::rotate(subtreeSizes.begin() + first, subtreeSizes.begin() + middle, subtreeSizes.begin() + last);
+
+  for (uint32_t i = first; i < last; ++i)
+  {
+    if (nodes[i])
+    {
+      nodes[i]->flatIndex = i;
+    }
+  }
+
+  // New ancestors grow
+  for (int32_t ancestor = parentIndices[destination]; ancestor != -1; ancestor = parentIndices[ancestor])
+  {
+    subtreeSizes[ancestor] += count;
+  }
+}
+
+inline void FlatHierarchy::compact()
+{
+  if (deadCount == 0)
+    return;
+
+  // deadBefore[i] = tombstones in [0, i)
+  std::vector<uint32_t> deadBefore(nodes.size() + 1, 0);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    deadBefore[i + 1] = deadBefore[i] + (nodes[i] ? 0 : 1);
+  }
+
+  size_t write = 0;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (!nodes[i])
+      continue;
+
+    uint32_t end = static_cast<uint32_t>(i) + subtreeSizes[i];
+    int32_t parent = parentIndices[i];
+
+    nodes[write] = nodes[i];
+    subtreeSizes[write] = subtreeSizes[i] - (deadBefore[end] - deadBefore[i]);
+    parentIndices[write] = parent == -1 ? -1 : parent - static_cast<int32_t>(deadBefore[parent]);
+    nodes[write]->flatIndex = static_cast<uint32_t>(write);
+    write++;
+  }
+
+  nodes.resize(write);
+  parentIndices.resize(write);
+  subtreeSizes.resize(write);
+  deadCount = 0;
+}
+
+inline void FlatHierarchy::update(float deltaTime)
+{
+  // Edits from node updates are deferred (see the class comment), so the
+  // array neither grows nor shifts under the loop
+  updating = true;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (nodes[i])
+    {
+      PROFILE_SCOPE_CAT(nodeTypeName(nodes[i]->getType()), "update");
+      nodes[i]->update(deltaTime);
+    }
+  }
+  updating = false;
+
+  if (rebuildPending)
+  {
+    // The root is always first and is never removed
+    rebuildPending = false;
+    build(nodes.empty() ? nullptr : nodes[0]);
+  }
+  else
+  {
+    compactIfNeeded();
+  }
+}
+
+inline void FlatHierarchy::render() const
+{
+  for (const Node *node : nodes)
+  {
+    if (node)
+    {
+      PROFILE_SCOPE_CAT(nodeTypeName(node->getType()), "render");
+      node->render();
+    }
+  }
+}
+
+// Implementation of SceneCommandBuffer methods that need the complete Node
+inline SceneCommandBuffer::~SceneCommandBuffer()
+{
+  clear();
+}
+
+inline bool SceneCommandBuffer::isValidLane(uint32_t lane) const
+{
+  if (lane < MaxLanes)
+    return true;
+  std::cerr << "SceneCommandBuffer: lane " << lane << " out of range (max " << MaxLanes - 1
+            << "), command dropped" << std::endl;
+  return false;
+}
+
+inline void SceneCommandBuffer::spawn(Node *parent, std::unique_ptr<Node> node, uint32_t lane)
+{
+  if (parent && node && isValidLane(lane))
+  {
+    lanes[lane].commands.push_back({CommandType::Spawn, nullptr, parent, node.release()});
+  }
+}
+
+inline void SceneCommandBuffer::destroy(Node *node, uint32_t lane)
+{
+  if (node && isValidLane(lane))
+  {
+    lanes[lane].commands.push_back({CommandType::Destroy, node, nullptr, nullptr});
+  }
+}
+
+inline void SceneCommandBuffer::reparent(Node *node, Node *newParent, uint32_t lane)
+{
+  if (node && newParent && isValidLane(lane))
+  {
+    lanes[lane].commands.push_back({CommandType::Reparent, node, newParent, nullptr});
+  }
+}
+
+inline void SceneCommandBuffer::clear()
+{
+  for (auto &lane : lanes)
+  {
+    for (auto &command : lane.commands)
+    {
+      delete command.node;
+    }
+    lane.commands.clear();
+  }
+}
+
+inline void SceneCommandBuffer::dropSubtree(const Node *node)
+{
+  // Walks up from each command's nodes, so the cost does not depend on the
+  // size of the subtree (the detached node's parent may already be unset)
+  auto inSubtree = [node](const Node *candidate)
+  {
+    for (; candidate; candidate = candidate->parent)
+    {
+      if (candidate == node)
+        return true;
+    }
+    return false;
+  };
+
+  for (auto &lane : lanes)
+  {
+    // Marked rather than erased: flush may be iterating this lane
+    for (auto &command : lane.commands)
+    {
+      if (command.type == CommandType::Dropped)
+        continue;
+      if (inSubtree(command.target) || inSubtree(command.parent))
+      {
+        delete command.node;
+        command.node = nullptr;
+        command.type = CommandType::Dropped;
+      }
+    }
+  }
+}
+
+inline size_t SceneCommandBuffer::flush()
+{
+  size_t applied = 0;
+  destroyList.clear();
+
+  // Spawns and reparents, in lane order (index loop: applying may queue more)
+  for (auto &lane : lanes)
+  {
+    for (size_t i = 0; i < lane.commands.size(); ++i)
+    {
+      Command &command = lane.commands[i];
+      switch (command.type)
+      {
+      case CommandType::Spawn:
+        command.parent->addChild(std::unique_ptr<Node>(command.node));
+        command.node = nullptr;
+        applied++;
+        break;
+      case CommandType::Reparent:
+        command.target->reparent(command.parent);
+        applied++;
+        break;
+      case CommandType::Destroy:
+      case CommandType::Dropped:
+        break;
+      }
+    }
+  }
+
+  // Destroys are collected after the moves, which may have dropped some
+  // (a reparent into another tree detaches the subtree from this one)
+  for (auto &lane : lanes)
+  {
+    for (const Command &command : lane.commands)
+    {
+      if (command.type == CommandType::Destroy)
+        destroyList.push_back(command.target);
+    }
+    lane.commands.clear();
+  }
+
+  if (destroyList.empty())
+    return applied;
+
+  // Decide what to delete while every pointer is still valid: skip duplicates
+  // and nodes whose ancestor is also being destroyed. The root cannot be
+  // destroyed and detached nodes are owned elsewhere, so only attached nodes count.
+  doomed.clear();
+  for (Node *node : destroyList)
+  {
+    if (node->getParent())
+    {
+      doomed.push_back(node);
+    }
+  }
+  std::sort(doomed.begin(), doomed.end());
+  doomed.erase(std::unique(doomed.begin(), doomed.end()), doomed.end());
+
+  keep.clear();
+  taken.assign(doomed.size(), 0);
+  for (Node *node : destroyList)
+  {
+    Node *parent = node->getParent();
+    if (!parent)
+      continue;
+
+    bool covered = false;
+    for (Node *ancestor = parent; ancestor; ancestor = ancestor->getParent())
+    {
+      if (std::binary_search(doomed.begin(), doomed.end(), ancestor))
+      {
+        covered = true;
+        break;
+      }
+    }
+    if (covered)
+      continue;
+
+    // Mark as taken so later duplicates are skipped
+    size_t slot = std::lower_bound(doomed.begin(), doomed.end(), node) - doomed.begin();
+    if (taken[slot])
+      continue;
+    taken[slot] = 1;
+    keep.push_back(node);
+  }
+
+  // Detach from the tree, then erase each parent's doomed children in one pass
+  // (removeChild would search and shift the children vector once per node)
+  parents.clear();
+  for (Node *node : keep)
+  {
+    if (node->tree)
+    {
+      node->tree->detachSubtree(node);
+    }
+    parents.push_back(node->parent);
+  }
+
+  doomed.assign(keep.begin(), keep.end());
+  std::sort(doomed.begin(), doomed.end());
+  std::sort(parents.begin(), parents.end());
+  parents.erase(std::unique(parents.begin(), parents.end()), parents.end());
+  taken.assign(parents.size(), 0);
+
+  graveyard.clear();
+  for (Node *node : keep)
+  {
+    // Visit parents in first-seen order so deletion order does not depend on addresses
+    Node *parent = node->parent;
+    size_t slot = std::lower_bound(parents.begin(), parents.end(), parent) - parents.begin();
+    if (taken[slot])
+      continue;
+    taken[slot] = 1;
+
+    auto &siblings = parent->children;
+    size_t write = 0;
+    for (size_t read = 0; read < siblings.size(); ++read)
+    {
+      if (std::binary_search(doomed.begin(), doomed.end(), siblings[read].get()))
+      {
+        graveyard.push_back(siblings[read].release());
+      }
+      else
+      {
+        if (write != read)
+        {
+          siblings[write] = std::move(siblings[read]);
+        }
+        write++;
+      }
+    }
+    siblings.resize(write);
+  }
+
+  for (Node *node : graveyard)
+  {
+    node->parent = nullptr;
+    delete node;
+    applied++;
+  }
+  graveyard.clear();
+  return applied;
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 // 2D Node class - has 2D position, scale, and rotation
 class Node2D : public Node
 {
+  NODE_TYPE(Node2D)
+
 protected:
   Transform2D transform;
 
@@ -19,9 +21,21 @@ public:
   Transform2D &getTransform() { return transform; }
   const Transform2D &getTransform() const { return transform; }
 
-  void setPosition(const Position2D &pos) { transform.setPosition(pos); }
-  void setScale(const Scale2D &scale) { transform.setScale(scale); }
-  void setRotation(float rotation) { transform.setRotation(rotation); }
+  void setPosition(const Position2D &pos)
+  {
+    transform.setPosition(pos);
+    markRenderDirty();
+  }
+  void setScale(const Scale2D &scale)
+  {
+    transform.setScale(scale);
+    markRenderDirty();
+  }
+  void setRotation(float rotation)
+  {
+    transform.setRotation(rotation);
+    markRenderDirty();
+  }
 
   const Position2D &getPosition() const { return transform.getPosition(); }
   const Scale2D &getScale() const { return transform.getScale(); }
@@ -9,6 +9,8 @@
 // 3D Node class - has 3D position, scale, and rotation
 class Node3D : public Node
 {
+  NODE_TYPE(Node3D)
+
 protected:
   Transform3D transform;
 
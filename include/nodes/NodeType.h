@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Compile-time type ids for every node class.
+// When adding a node class: add it here, add its parent to nodeTypeParents,
+// its name to nodeTypeNames, and put NODE_TYPE(ClassName) in the class body.
+enum class NodeType : uint8_t
+{
+  Node,
+  RootNode,
+  Node2D,
+  Node3D,
+  Triangle,
+  Rectangle,
+  RotatingTriangle,
+  OscillatingRectangle,
+  PulsingTriangle,
+  Sprite2D,
+  SkinnedSprite2D,
+  ParticleEmitter2D,
+  TileMap2D,
+  EcsWorldNode,
+  Count
+};
+
+constexpr size_t NodeTypeCount = static_cast<size_t>(NodeType::Count);
+
+// Direct base class of each node type (Node is its own parent)
+constexpr NodeType nodeTypeParents[NodeTypeCount] = {
+    NodeType::Node,      // Node
+    NodeType::Node,      // RootNode
+    NodeType::Node,      // Node2D
+    NodeType::Node,      // Node3D
+    NodeType::Node2D,    // Triangle
+    NodeType::Node2D,    // Rectangle
+    NodeType::Triangle,  // RotatingTriangle
+    NodeType::Rectangle, // OscillatingRectangle
+    NodeType::Triangle,  // PulsingTriangle
+    NodeType::Node2D,    // Sprite2D
+    NodeType::Node2D,    // SkinnedSprite2D
+    NodeType::Node2D,    // ParticleEmitter2D
+    NodeType::Node2D,    // TileMap2D
+    NodeType::Node,      // EcsWorldNode
+};
+
+constexpr const char *nodeTypeNames[NodeTypeCount] = {
+    "Node",
+    "RootNode",
+    "Node2D",
+    "Node3D",
+    "Triangle",
+    "Rectangle",
+    "RotatingTriangle",
+    "OscillatingRectangle",
+    "PulsingTriangle",
+    "Sprite2D",
+    "SkinnedSprite2D",
+    "ParticleEmitter2D",
+    "TileMap2D",
+    "EcsWorldNode",
+};
+
+constexpr const char *nodeTypeName(NodeType type)
+{
+  return nodeTypeNames[static_cast<size_t>(type)];
+}
+
+// True if type is base or derives from it
+constexpr bool isNodeTypeA(NodeType type, NodeType base)
+{
+  while (type != base)
+  {
+    if (type == NodeType::Node)
+      return false;
+    type = nodeTypeParents[static_cast<size_t>(type)];
+  }
+  return true;
+}
+
+// Declares the type id of a node class; place it in the class body
+#define NODE_TYPE(TypeName)                                 \
+public:                                                     \
+  static constexpr NodeType StaticType = NodeType::TypeName; \
+  NodeType getType() const override { return StaticType; }
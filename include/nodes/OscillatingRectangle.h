@@ -7,6 +7,8 @@
 // This creates a specialized Rectangle with built-in oscillation behavior
 class OscillatingRectangle : public Rectangle
 {
+  NODE_TYPE(OscillatingRectangle)
+
 private:
   float amplitude;
   float frequency;
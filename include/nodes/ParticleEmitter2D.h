@@ -0,0 +1,304 @@
+#pragma once
+
+#include "Node2D.h"
+#include "Sprite2D.h"
+#include "../core/Math.h"
+#include "../core/WorkerPool.h"
+#include "../core/render/RenderDevice.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLE_SSE2 1
+#endif
+
+// How an emitter spawns and moves its particles
+struct ParticleEmitterSettings
+{
+  float rate = 100.0f;        // Particles per second while emitting
+  size_t maxParticles = 1000; // Live particles; storage is allocated up front for this many
+  float minLifetime = 1.0f;   // Seconds
+  float maxLifetime = 1.0f;
+  float minSpeed = 50.0f;
+  float maxSpeed = 100.0f;
+  float direction = -90.0f; // Degrees; -90 is up on screen
+  float spread = 30.0f;     // Degrees either side of direction
+  Vector2 spawnExtent;      // Half size of the spawn box around the emitter
+  Vector2 gravity;          // Units per second squared
+  float damping = 0.0f;     // Fraction of the velocity lost per second
+  float startSize = 4.0f;
+  float endSize = 4.0f;
+  float sizeVariation = 0.0f; // Each particle is up to this fraction smaller
+  float startAlpha = 1.0f;
+  float endAlpha = 0.0f;
+  Color color = Colors::white;
+  float colorVariation = 0.0f; // Each particle is up to this fraction darker
+};
+
+// Emits particles into fixed structure-of-arrays storage, so emitting and
+// killing never allocate and each frame is one SIMD pass over the arrays
+// (split across the WorkerPool for large emitters) and one batched draw.
+// Dead particles are swap-removed, so particle order is not stable.
+// Particles live in the emitter's local space and follow its transform.
+class ParticleEmitter2D : public Node2D
+{
+  NODE_TYPE(ParticleEmitter2D)
+
+private:
+  ParticleEmitterSettings settings;
+  size_t count;
+
+  // Capacity rounded up to four, so the SIMD pass needs no scalar tail
+  std::vector<float> positionX, positionY;
+  std::vector<float> velocityX, velocityY;
+  std::vector<float> ages;     // 0 at birth, dead at 1
+  std::vector<float> ageRates; // 1 / lifetime
+  std::vector<float> sizes;
+  std::vector<uint32_t> colors;
+
+  float emitAccumulator;
+  bool emitting;
+  bool parallel;
+  uint32_t randomState;
+  std::shared_ptr<TextureData> textureData;
+
+  float random();
+  void integrate(size_t begin, size_t end, float deltaTime, float damping);
+  void removeDead();
+  void moveParticle(size_t from, size_t to);
+
+public:
+  // Large emitters are split across the WorkerPool in ranges of this many
+  static constexpr size_t ParallelGrain = 32768;
+
+  ParticleEmitter2D(const std::string &nodeName = "ParticleEmitter2D",
+                    const Position2D &pos = Position2D(),
+                    const ParticleEmitterSettings &emitterSettings = ParticleEmitterSettings())
+      : Node2D(nodeName), count(0), emitAccumulator(0.0f), emitting(true), parallel(false), randomState(0x9E3779B9u)
+  {
+    setPosition(pos);
+    setSettings(emitterSettings);
+  }
+
+  // Resizes storage; live particles beyond the new maximum are dropped
+  void setSettings(const ParticleEmitterSettings &emitterSettings);
+  const ParticleEmitterSettings &getSettings() const { return settings; }
+
+  void setEmitting(bool enabled) { emitting = enabled; }
+  bool isEmitting() const { return emitting; }
+
+  // Update across the WorkerPool when it has threads and the emitter is large
+  void setParallel(bool enabled) { parallel = enabled; }
+  bool isParallel() const { return parallel; }
+
+  void setSeed(uint32_t seed) { randomState = seed ? seed : 1u; }
+  void setTexture(std::shared_ptr<TextureData> texture) { textureData = std::move(texture); }
+  const std::shared_ptr<TextureData> &getTexture() const { return textureData; }
+
+  // Spawn up to n particles now; returns how many fit
+  size_t emit(size_t n);
+  void clear()
+  {
+    count = 0;
+    emitAccumulator = 0.0f;
+  }
+
+  size_t getParticleCount() const { return count; }
+  size_t getCapacity() const { return settings.maxParticles; }
+
+  // Particle arrays, valid for getParticleCount() entries
+  const float *getPositionsX() const { return positionX.data(); }
+  const float *getPositionsY() const { return positionY.data(); }
+  const float *getVelocitiesX() const { return velocityX.data(); }
+  const float *getVelocitiesY() const { return velocityY.data(); }
+  const float *getAges() const { return ages.data(); }
+  const float *getAgeRates() const { return ageRates.data(); }
+  const uint32_t *getColors() const { return colors.data(); }
+
+  void update(float deltaTime = 0.0f) override;
+  void render() const override;
+};
+
+// Implementation
+inline void ParticleEmitter2D::setSettings(const ParticleEmitterSettings &emitterSettings)
+{
+  settings = emitterSettings;
+  settings.maxLifetime = std::max(settings.maxLifetime, settings.minLifetime);
+  size_t capacity = (settings.maxParticles + 3) & ~static_cast<size_t>(3);
+  positionX.resize(capacity);
+  positionY.resize(capacity);
+  velocityX.resize(capacity);
+  velocityY.resize(capacity);
+  ages.resize(capacity);
+  ageRates.resize(capacity);
+  sizes.resize(capacity);
+  colors.resize(capacity);
+  count = std::min(count, settings.maxParticles);
+}
+
+// xorshift32, in [0, 1)
+inline float ParticleEmitter2D::random()
+{
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return static_cast<float>(randomState >> 8) * (1.0f / 16777216.0f);
+}
+
+inline size_t ParticleEmitter2D::emit(size_t n)
+{
+  n = std::min(n, settings.maxParticles - count);
+  auto channel = [](float value)
+  { return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); };
+
+  for (size_t i = count; i < count + n; ++i)
+  {
+    float angle = (settings.direction + settings.spread * (2.0f * random() - 1.0f)) * (Pi / 180.0f);
+    float speed = settings.minSpeed + (settings.maxSpeed - settings.minSpeed) * random();
+    float lifetime = settings.minLifetime + (settings.maxLifetime - settings.minLifetime) * random();
+    float shade = 1.0f - settings.colorVariation * random();
+
+    positionX[i] = settings.spawnExtent.x * (2.0f * random() - 1.0f);
+    positionY[i] = settings.spawnExtent.y * (2.0f * random() - 1.0f);
+    velocityX[i] = fastCos(angle) * speed;
+    velocityY[i] = fastSin(angle) * speed;
+    ages[i] = 0.0f;
+    ageRates[i] = lifetime > 0.0f ? 1.0f / lifetime : 1e30f;
+    sizes[i] = 1.0f - settings.sizeVariation * random();
+    colors[i] = channel(settings.color.x * shade) | channel(settings.color.y * shade) << 8 |
+                channel(settings.color.z * shade) << 16 | 0xFF000000u;
+  }
+  count += n;
+  return n;
+}
+
+// Semi-implicit Euler over [begin, end), both multiples of four
+inline void ParticleEmitter2D::integrate(size_t begin, size_t end, float deltaTime, float damping)
+{
+  float *px = positionX.data(), *py = positionY.data();
+  float *vx = velocityX.data(), *vy = velocityY.data();
+  float *age = ages.data();
+  const float *ageRate = ageRates.data();
+
+#ifdef PARTICLE_SSE2
+  const __m128 gravityX = _mm_set1_ps(settings.gravity.x * deltaTime);
+  const __m128 gravityY = _mm_set1_ps(settings.gravity.y * deltaTime);
+  const __m128 keep = _mm_set1_ps(damping);
+  const __m128 step = _mm_set1_ps(deltaTime);
+  for (size_t i = begin; i < end; i += 4)
+  {
+    __m128 velX = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vx + i), gravityX), keep);
+    __m128 velY = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), gravityY), keep);
+    _mm_storeu_ps(vx + i, velX);
+    _mm_storeu_ps(vy + i, velY);
+    _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velX, step)));
+    _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velY, step)));
+    _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), _mm_mul_ps(_mm_loadu_ps(ageRate + i), step)));
+  }
+#else
+  float gravityX = settings.gravity.x * deltaTime, gravityY = settings.gravity.y * deltaTime;
+  for (size_t i = begin; i < end; ++i)
+  {
+    vx[i] = (vx[i] + gravityX) * damping;
+    vy[i] = (vy[i] + gravityY) * damping;
+    px[i] += vx[i] * deltaTime;
+    py[i] += vy[i] * deltaTime;
+    age[i] += ageRate[i] * deltaTime;
+  }
+#endif
+}
+
+inline void ParticleEmitter2D::moveParticle(size_t from, size_t to)
+{
+  positionX[to] = positionX[from];
+  positionY[to] = positionY[from];
+  velocityX[to] = velocityX[from];
+  velocityY[to] = velocityY[from];
+  ages[to] = ages[from];
+  ageRates[to] = ageRates[from];
+  sizes[to] = sizes[from];
+  colors[to] = colors[from];
+}
+
+// Swap-remove particles whose age reached 1, skipping live groups of four at once
+inline void ParticleEmitter2D::removeDead()
+{
+  size_t i = 0;
+#ifdef PARTICLE_SSE2
+  const __m128 one = _mm_set1_ps(1.0f);
+#endif
+  while (i < count)
+  {
+#ifdef PARTICLE_SSE2
+    if (i + 4 <= count && _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(&ages[i]), one)) == 0)
+    {
+      i += 4;
+      continue;
+    }
+#endif
+    if (ages[i] >= 1.0f)
+      moveParticle(--count, i);
+    else
+      ++i;
+  }
+}
+
+inline void ParticleEmitter2D::update(float deltaTime)
+{
+  Node2D::update(deltaTime);
+
+  if (count > 0 && deltaTime > 0.0f)
+  {
+    float damping = std::max(0.0f, 1.0f - settings.damping * deltaTime);
+    size_t end = (count + 3) & ~static_cast<size_t>(3);
+    WorkerPool &pool = WorkerPool::getInstance();
+    if (parallel && pool.getThreadCount() > 0 && end > ParallelGrain)
+    {
+      pool.parallelFor(end, ParallelGrain, [this, deltaTime, damping](size_t begin, size_t rangeEnd)
+                       { integrate(begin, rangeEnd, deltaTime, damping); });
+    }
+    else
+    {
+      integrate(0, end, deltaTime, damping);
+    }
+    removeDead();
+  }
+
+  if (emitting && deltaTime > 0.0f)
+  {
+    emitAccumulator += settings.rate * deltaTime;
+    size_t spawn = static_cast<size_t>(emitAccumulator);
+    emitAccumulator -= static_cast<float>(spawn);
+    emit(spawn);
+  }
+}
+
+inline void ParticleEmitter2D::render() const
+{
+  if (count == 0)
+    return;
+
+  ParticleBatch batch;
+  batch.x = positionX.data();
+  batch.y = positionY.data();
+  batch.age = ages.data();
+  batch.sizes = sizes.data();
+  batch.colors = colors.data();
+  batch.count = count;
+  batch.startSize = settings.startSize;
+  batch.endSize = settings.endSize;
+  batch.startAlpha = settings.startAlpha;
+  batch.endAlpha = settings.endAlpha;
+  batch.textureId = textureData ? textureData->textureId : 0;
+
+  auto &renderDevice = RenderDevice::getInstance();
+  const Position2D &pos = getTransform().getPosition();
+  const Scale2D &scale = getTransform().getScale();
+  renderDevice.setTransform(pos.x, pos.y, getTransform().getRotation(), scale.x, scale.y);
+  renderDevice.drawParticles(batch);
+  renderDevice.resetTransform();
+}
@@ -7,6 +7,8 @@
 // This creates a specialized Triangle with built-in pulsing behavior
 class PulsingTriangle : public Triangle
 {
+  NODE_TYPE(PulsingTriangle)
+
 private:
   float baseScale;
   float pulseAmount;
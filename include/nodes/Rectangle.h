@@ -5,6 +5,8 @@
 
 class Rectangle : public Node2D
 {
+  NODE_TYPE(Rectangle)
+
 private:
   Color color;
   float width;
@@ -35,15 +37,21 @@ public:
   }
 
   // Color management
-  void setColor(const Color &col) { color = col; }
-  void setColor(float r, float g, float b) { color = Color(r, g, b); }
+  void setColor(const Color &col)
+  {
+    color = col;
+    markRenderDirty();
+  }
+  void setColor(float r, float g, float b) { setColor(Color(r, g, b)); }
   const Color &getColor() const { return color; }
+  Color &getColor() { return color; } // e.g. a TweenSystem color target
 
   // Size management
   void setSize(float w, float h)
   {
     width = w;
     height = h;
+    markRenderDirty();
   }
   float getWidth() const { return width; }
   float getHeight() const { return height; }
@@ -7,6 +7,8 @@
 // This creates a specialized Triangle with built-in rotation behavior
 class RotatingTriangle : public Triangle
 {
+  NODE_TYPE(RotatingTriangle)
+
 private:
   float rotationSpeed; // degrees per second
 
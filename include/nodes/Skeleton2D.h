@@ -0,0 +1,649 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../core/Math.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SKELETON_SSE2 1
+#endif
+
+// Index of a bone within its Skeleton2D
+using BoneIndex = uint16_t;
+constexpr BoneIndex InvalidBone = 0xFFFF;
+
+// Bone hierarchy of a cutout character, shared by every instance. Bones are
+// added parents first, so a pose is composed in one forward pass.
+class Skeleton2D
+{
+private:
+  std::vector<std::string> names;
+  std::vector<BoneIndex> parents;    // InvalidBone for a root
+  std::vector<Transform2D> bindPose; // Relative to the parent
+  std::vector<Affine2D> bindWorld;   // Bone to character space at bind
+  std::vector<Affine2D> inverseBind;
+
+public:
+  // InvalidBone if the parent does not exist or the name is taken
+  BoneIndex addBone(const std::string &name, BoneIndex parent, const Transform2D &local);
+  // An empty parent name adds a root
+  BoneIndex addBone(const std::string &name, const std::string &parent, const Transform2D &local);
+
+  BoneIndex findBone(const std::string &name) const;
+  size_t getBoneCount() const { return parents.size(); }
+  const std::string &getName(BoneIndex bone) const { return names[bone]; }
+  BoneIndex getParent(BoneIndex bone) const { return parents[bone]; }
+  const Transform2D &getBindPose(BoneIndex bone) const { return bindPose[bone]; }
+  const Affine2D &getBindWorld(BoneIndex bone) const { return bindWorld[bone]; }
+  const Affine2D &getInverseBind(BoneIndex bone) const { return inverseBind[bone]; }
+};
+
+// Vertex data ready for skinning, built by SkinnedMeshBuilder2D. Vertices are
+// grouped into spans that follow the same pair of bones, and every span is
+// padded to a multiple of four with copies of its last vertex (no index
+// refers to those), so skin() runs four vertices at a time with the span's
+// two matrices held in registers and needs no scalar tail.
+class SkinnedMesh2D
+{
+private:
+  struct Span
+  {
+    BoneIndex bone0;
+    BoneIndex bone1; // Same as bone0 for a rigid span
+    uint32_t first;
+    uint32_t count;
+  };
+
+  std::vector<Span> spans;
+  std::vector<float> bindX, bindY; // Character space at bind
+  std::vector<float> weights;      // Of bone0; bone1 gets the rest
+  std::vector<float> texCoords;    // u, v per vertex
+  std::vector<uint16_t> indices;
+  size_t boneCount; // Bones a skeleton needs to drive the mesh
+
+  friend class SkinnedMeshBuilder2D;
+
+public:
+  SkinnedMesh2D() : boneCount(0) {}
+
+  // Vertices including padding; skin() writes x, y for each of them
+  size_t getVertexCount() const { return bindX.size(); }
+  size_t getSpanCount() const { return spans.size(); }
+  size_t getBoneCount() const { return boneCount; }
+  const float *getTexCoords() const { return texCoords.data(); }
+  const uint16_t *getIndices() const { return indices.data(); }
+  size_t getIndexCount() const { return indices.size(); }
+
+  // Positions for the given skinning matrices (bone pose * inverse bind), as
+  // x, y pairs; `positions` holds 2 * getVertexCount() floats
+  void skin(const Affine2D *boneMatrices, float *positions) const;
+};
+
+// Collects vertices (in character space at bind) and triangles, then sorts
+// them into a SkinnedMesh2D. The skeleton must outlive the builder.
+class SkinnedMeshBuilder2D
+{
+private:
+  struct Vertex
+  {
+    Vector2 position;
+    Vector2 texCoord;
+    BoneIndex bone0;
+    BoneIndex bone1;
+    float weight0;
+  };
+
+  const Skeleton2D &skeleton;
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> triangles;
+
+public:
+  explicit SkinnedMeshBuilder2D(const Skeleton2D &skel) : skeleton(skel) {}
+
+  // A vertex that follows one bone, or two blended by weight0 : 1 - weight0
+  uint32_t addVertex(const Vector2 &position, const Vector2 &texCoord, BoneIndex bone)
+  {
+    return addVertex(position, texCoord, bone, bone, 1.0f);
+  }
+  uint32_t addVertex(const Vector2 &position, const Vector2 &texCoord, BoneIndex bone0, BoneIndex bone1, float weight0);
+  void addTriangle(uint32_t a, uint32_t b, uint32_t c);
+
+  // A rigid quad given in the bone's own space at bind, textured like drawSprite
+  void addPart(BoneIndex bone, const Vector2 &min, const Vector2 &max, float texLeft = 0.0f, float texTop = 1.0f,
+               float texRight = 1.0f, float texBottom = 0.0f);
+
+  // nullptr (and a message) if a bone or index is invalid or the mesh is too large
+  std::shared_ptr<const SkinnedMesh2D> build() const;
+};
+
+// A bone's local transform at a point in time
+struct BoneKeyframe2D
+{
+  float time; // Seconds
+  Transform2D local;
+
+  BoneKeyframe2D(float t = 0.0f, const Transform2D &l = Transform2D()) : time(t), local(l) {}
+};
+
+// Keyframed bone transforms, linearly interpolated. Rotation is interpolated
+// in degrees as given, so 350 -> 370 turns 20 degrees where 350 -> 10 turns
+// back 340. Bones without a track keep their bind pose.
+class SkeletonClip2D
+{
+private:
+  struct Track
+  {
+    BoneIndex bone;
+    uint32_t firstKey;
+    uint32_t keyCount;
+  };
+
+  std::string name;
+  std::vector<Track> tracks;
+  std::vector<float> keyTimes;
+  std::vector<float> keyInvSpans; // 1 / (time of the next key - time), 0 on a track's last key
+  std::vector<Transform2D> keyValues;
+  float duration;
+  bool loop;
+
+  friend class SkeletonPose2D;
+
+public:
+  SkeletonClip2D(const std::string &clipName = "", bool shouldLoop = true)
+      : name(clipName), duration(0.0f), loop(shouldLoop) {}
+
+  // Keys sorted by time; the clip lasts until the last key of its longest track.
+  // False if the keys are empty or unsorted or the bone already has a track.
+  bool addTrack(BoneIndex bone, const std::vector<BoneKeyframe2D> &keys);
+
+  const std::string &getName() const { return name; }
+  float getDuration() const { return duration; }
+  bool isLooping() const { return loop; }
+  size_t getTrackCount() const { return tracks.size(); }
+};
+
+// One character's playback: its clip time, bone matrices and skinned
+// vertices. Skeleton, mesh and clips are shared between characters, and
+// update() does not allocate.
+class SkeletonPose2D
+{
+private:
+  std::shared_ptr<const Skeleton2D> skeleton;
+  std::shared_ptr<const SkinnedMesh2D> mesh;
+  std::shared_ptr<const SkeletonClip2D> clip;
+  float time;
+  float speed;
+  bool finished;
+
+  std::vector<uint32_t> trackKeys; // Current segment of each clip track
+  std::vector<Transform2D> locals;
+  std::vector<Affine2D> world;        // Bone to character space
+  std::vector<Affine2D> skinMatrices; // world * inverse bind
+  std::vector<float> positions;       // Skinned x, y per mesh vertex
+
+  // Bone rotations and their sines and cosines, padded to a multiple of four
+  std::vector<float> rotations, sines, cosines;
+
+  void sample();
+  void compose();
+
+  // Sine and cosine of `count` angles in degrees (count a multiple of four)
+  static void sinCosDegrees(const float *degrees, float *sin, float *cos, size_t count);
+
+public:
+  SkeletonPose2D() : time(0.0f), speed(1.0f), finished(false) {}
+
+  // False if the mesh needs bones the skeleton does not have
+  bool setup(std::shared_ptr<const Skeleton2D> skel, std::shared_ptr<const SkinnedMesh2D> skinnedMesh);
+
+  // Play a clip from startTime; false if it animates bones the skeleton does not have
+  bool play(std::shared_ptr<const SkeletonClip2D> newClip, float startTime = 0.0f);
+  // Back to the bind pose
+  void stop();
+
+  void setSpeed(float playbackSpeed) { speed = playbackSpeed; }
+  float getSpeed() const { return speed; }
+  float getTime() const { return time; }
+  bool isFinished() const { return finished; }
+
+  // Advance the clip, then pose the bones and skin the mesh
+  void update(float deltaTime);
+
+  const std::shared_ptr<const Skeleton2D> &getSkeleton() const { return skeleton; }
+  const std::shared_ptr<const SkinnedMesh2D> &getMesh() const { return mesh; }
+  const std::shared_ptr<const SkeletonClip2D> &getClip() const { return clip; }
+  const Affine2D &getBoneWorld(BoneIndex bone) const { return world[bone]; }
+  const float *getPositions() const { return positions.data(); }
+};
+
+// Implementation
+inline BoneIndex Skeleton2D::addBone(const std::string &name, BoneIndex parent, const Transform2D &local)
+{
+  if (parent != InvalidBone && parent >= parents.size())
+  {
+    std::cerr << "Skeleton2D: parent of bone " << name << " does not exist" << std::endl;
+    return InvalidBone;
+  }
+  if (findBone(name) != InvalidBone || parents.size() >= InvalidBone)
+  {
+    std::cerr << "Skeleton2D: cannot add bone " << name << std::endl;
+    return InvalidBone;
+  }
+
+  Affine2D matrix = Affine2D::fromTransform(local);
+  if (parent != InvalidBone)
+    matrix = bindWorld[parent] * matrix;
+
+  names.push_back(name);
+  parents.push_back(parent);
+  bindPose.push_back(local);
+  bindWorld.push_back(matrix);
+  inverseBind.push_back(matrix.inverse());
+  return static_cast<BoneIndex>(parents.size() - 1);
+}
+
+inline BoneIndex Skeleton2D::addBone(const std::string &name, const std::string &parent, const Transform2D &local)
+{
+  BoneIndex parentBone = parent.empty() ? InvalidBone : findBone(parent);
+  if (!parent.empty() && parentBone == InvalidBone)
+  {
+    std::cerr << "Skeleton2D: parent " << parent << " of bone " << name << " does not exist" << std::endl;
+    return InvalidBone;
+  }
+  return addBone(name, parentBone, local);
+}
+
+inline BoneIndex Skeleton2D::findBone(const std::string &name) const
+{
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    if (names[i] == name)
+      return static_cast<BoneIndex>(i);
+  }
+  return InvalidBone;
+}
+
+inline void SkinnedMesh2D::skin(const Affine2D *boneMatrices, float *positions) const
+{
+  const float *x = bindX.data();
+  const float *y = bindY.data();
+  const float *w = weights.data();
+
+  for (const Span &span : spans)
+  {
+    const Affine2D &m0 = boneMatrices[span.bone0];
+    const Affine2D &m1 = boneMatrices[span.bone1];
+    uint32_t end = span.first + span.count;
+#ifdef SKELETON_SSE2
+    __m128 a0 = _mm_set1_ps(m0.a), b0 = _mm_set1_ps(m0.b), c0 = _mm_set1_ps(m0.c);
+    __m128 d0 = _mm_set1_ps(m0.d), tx0 = _mm_set1_ps(m0.tx), ty0 = _mm_set1_ps(m0.ty);
+    if (span.bone0 == span.bone1)
+    {
+      for (uint32_t i = span.first; i < end; i += 4)
+      {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 ox = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, px), _mm_mul_ps(c0, py)), tx0);
+        __m128 oy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, px), _mm_mul_ps(d0, py)), ty0);
+        _mm_storeu_ps(positions + 2 * i, _mm_unpacklo_ps(ox, oy));
+        _mm_storeu_ps(positions + 2 * i + 4, _mm_unpackhi_ps(ox, oy));
+      }
+      continue;
+    }
+
+    __m128 a1 = _mm_set1_ps(m1.a), b1 = _mm_set1_ps(m1.b), c1 = _mm_set1_ps(m1.c);
+    __m128 d1 = _mm_set1_ps(m1.d), tx1 = _mm_set1_ps(m1.tx), ty1 = _mm_set1_ps(m1.ty);
+    for (uint32_t i = span.first; i < end; i += 4)
+    {
+      __m128 px = _mm_loadu_ps(x + i);
+      __m128 py = _mm_loadu_ps(y + i);
+      __m128 weight = _mm_loadu_ps(w + i);
+      __m128 x0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, px), _mm_mul_ps(c0, py)), tx0);
+      __m128 y0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, px), _mm_mul_ps(d0, py)), ty0);
+      __m128 x1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a1, px), _mm_mul_ps(c1, py)), tx1);
+      __m128 y1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b1, px), _mm_mul_ps(d1, py)), ty1);
+      __m128 ox = _mm_add_ps(x1, _mm_mul_ps(weight, _mm_sub_ps(x0, x1)));
+      __m128 oy = _mm_add_ps(y1, _mm_mul_ps(weight, _mm_sub_ps(y0, y1)));
+      _mm_storeu_ps(positions + 2 * i, _mm_unpacklo_ps(ox, oy));
+      _mm_storeu_ps(positions + 2 * i + 4, _mm_unpackhi_ps(ox, oy));
+    }
+#else
+    for (uint32_t i = span.first; i < end; ++i)
+    {
+      float x0 = m0.a * x[i] + m0.c * y[i] + m0.tx, y0 = m0.b * x[i] + m0.d * y[i] + m0.ty;
+      float x1 = m1.a * x[i] + m1.c * y[i] + m1.tx, y1 = m1.b * x[i] + m1.d * y[i] + m1.ty;
+      positions[2 * i] = x1 + w[i] * (x0 - x1);
+      positions[2 * i + 1] = y1 + w[i] * (y0 - y1);
+    }
+#endif
+  }
+}
+
+inline uint32_t SkinnedMeshBuilder2D::addVertex(const Vector2 &position, const Vector2 &texCoord, BoneIndex bone0,
+                                                BoneIndex bone1, float weight0)
+{
+  // One canonical order per bone pair, so equal pairs land in the same span
+  weight0 = std::min(std::max(weight0, 0.0f), 1.0f);
+  if (weight0 == 1.0f)
+    bone1 = bone0;
+  else if (weight0 == 0.0f)
+    bone0 = bone1, weight0 = 1.0f;
+  else if (bone1 < bone0)
+    std::swap(bone0, bone1), weight0 = 1.0f - weight0;
+
+  vertices.push_back({position, texCoord, bone0, bone1, weight0});
+  return static_cast<uint32_t>(vertices.size() - 1);
+}
+
+inline void SkinnedMeshBuilder2D::addTriangle(uint32_t a, uint32_t b, uint32_t c)
+{
+  triangles.push_back(a);
+  triangles.push_back(b);
+  triangles.push_back(c);
+}
+
+inline void SkinnedMeshBuilder2D::addPart(BoneIndex bone, const Vector2 &min, const Vector2 &max, float texLeft,
+                                          float texTop, float texRight, float texBottom)
+{
+  if (bone >= skeleton.getBoneCount())
+  {
+    std::cerr << "SkinnedMeshBuilder2D: part on a bone the skeleton does not have" << std::endl;
+    return;
+  }
+
+  const Affine2D &bind = skeleton.getBindWorld(bone);
+  uint32_t topLeft = addVertex(bind.apply(Vector2(min.x, min.y)), Vector2(texLeft, texTop), bone);
+  uint32_t topRight = addVertex(bind.apply(Vector2(max.x, min.y)), Vector2(texRight, texTop), bone);
+  uint32_t bottomRight = addVertex(bind.apply(Vector2(max.x, max.y)), Vector2(texRight, texBottom), bone);
+  uint32_t bottomLeft = addVertex(bind.apply(Vector2(min.x, max.y)), Vector2(texLeft, texBottom), bone);
+  addTriangle(topLeft, topRight, bottomRight);
+  addTriangle(topLeft, bottomRight, bottomLeft);
+}
+
+inline std::shared_ptr<const SkinnedMesh2D> SkinnedMeshBuilder2D::build() const
+{
+  auto mesh = std::make_shared<SkinnedMesh2D>();
+  for (const Vertex &vertex : vertices)
+  {
+    if (vertex.bone0 >= skeleton.getBoneCount() || vertex.bone1 >= skeleton.getBoneCount())
+    {
+      std::cerr << "SkinnedMeshBuilder2D: vertex on a bone the skeleton does not have" << std::endl;
+      return nullptr;
+    }
+    mesh->boneCount = std::max<size_t>(mesh->boneCount, std::max(vertex.bone0, vertex.bone1) + 1u);
+  }
+  for (uint32_t index : triangles)
+  {
+    if (index >= vertices.size())
+    {
+      std::cerr << "SkinnedMeshBuilder2D: triangle refers to vertex " << index << " of " << vertices.size() << std::endl;
+      return nullptr;
+    }
+  }
+
+  std::vector<uint32_t> order(vertices.size());
+  for (uint32_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+                   { return vertices[a].bone0 != vertices[b].bone0 ? vertices[a].bone0 < vertices[b].bone0
+                                                                   : vertices[a].bone1 < vertices[b].bone1; });
+
+  // Lay the spans out, padding each to a multiple of four
+  std::vector<uint32_t> remap(vertices.size());
+  for (size_t i = 0; i < order.size();)
+  {
+    const Vertex &head = vertices[order[i]];
+    SkinnedMesh2D::Span span = {head.bone0, head.bone1, static_cast<uint32_t>(mesh->bindX.size()), 0};
+    for (; i < order.size() && vertices[order[i]].bone0 == span.bone0 && vertices[order[i]].bone1 == span.bone1; ++i)
+    {
+      const Vertex &vertex = vertices[order[i]];
+      remap[order[i]] = static_cast<uint32_t>(mesh->bindX.size());
+      mesh->bindX.push_back(vertex.position.x);
+      mesh->bindY.push_back(vertex.position.y);
+      mesh->weights.push_back(vertex.weight0);
+      mesh->texCoords.push_back(vertex.texCoord.x);
+      mesh->texCoords.push_back(vertex.texCoord.y);
+    }
+    while ((mesh->bindX.size() - span.first) % 4 != 0)
+    {
+      mesh->bindX.push_back(mesh->bindX.back());
+      mesh->bindY.push_back(mesh->bindY.back());
+      mesh->weights.push_back(mesh->weights.back());
+      mesh->texCoords.push_back(mesh->texCoords[mesh->texCoords.size() - 2]);
+      mesh->texCoords.push_back(mesh->texCoords[mesh->texCoords.size() - 2]);
+    }
+    span.count = static_cast<uint32_t>(mesh->bindX.size() - span.first);
+    mesh->spans.push_back(span);
+  }
+
+  if (mesh->bindX.size() > 0xFFFF)
+  {
+    std::cerr << "SkinnedMeshBuilder2D: " << mesh->bindX.size() << " vertices do not fit 16-bit indices" << std::endl;
+    return nullptr;
+  }
+  mesh->indices.reserve(triangles.size());
+  for (uint32_t index : triangles)
+    mesh->indices.push_back(static_cast<uint16_t>(remap[index]));
+  return mesh;
+}
+
+inline bool SkeletonClip2D::addTrack(BoneIndex bone, const std::vector<BoneKeyframe2D> &keys)
+{
+  if (keys.empty() || bone == InvalidBone)
+  {
+    std::cerr << "SkeletonClip2D: " << name << " track needs a bone and keys" << std::endl;
+    return false;
+  }
+  for (const Track &track : tracks)
+  {
+    if (track.bone == bone)
+    {
+      std::cerr << "SkeletonClip2D: " << name << " already has a track for bone " << bone << std::endl;
+      return false;
+    }
+  }
+  for (size_t i = 1; i < keys.size(); ++i)
+  {
+    if (!(keys[i].time >= keys[i - 1].time))
+    {
+      std::cerr << "SkeletonClip2D: " << name << " keys must be sorted by time" << std::endl;
+      return false;
+    }
+  }
+
+  tracks.push_back({bone, static_cast<uint32_t>(keyTimes.size()), static_cast<uint32_t>(keys.size())});
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    float span = i + 1 < keys.size() ? keys[i + 1].time - keys[i].time : 0.0f;
+    keyTimes.push_back(keys[i].time);
+    keyInvSpans.push_back(span > 0.0f ? 1.0f / span : 0.0f);
+    keyValues.push_back(keys[i].local);
+  }
+  duration = std::max(duration, keys.back().time);
+  return true;
+}
+
+inline bool SkeletonPose2D::setup(std::shared_ptr<const Skeleton2D> skel, std::shared_ptr<const SkinnedMesh2D> skinnedMesh)
+{
+  if (!skel || (skinnedMesh && skinnedMesh->getBoneCount() > skel->getBoneCount()))
+  {
+    std::cerr << "SkeletonPose2D: the mesh needs bones the skeleton does not have" << std::endl;
+    return false;
+  }
+
+  skeleton = std::move(skel);
+  mesh = std::move(skinnedMesh);
+  clip.reset();
+  size_t bones = skeleton->getBoneCount();
+  world.assign(bones, Affine2D());
+  skinMatrices.assign(bones, Affine2D());
+  rotations.assign((bones + 3) / 4 * 4, 0.0f);
+  sines.assign(rotations.size(), 0.0f);
+  cosines.assign(rotations.size(), 1.0f);
+  positions.assign(mesh ? 2 * mesh->getVertexCount() : 0, 0.0f);
+  stop();
+  return true;
+}
+
+inline bool SkeletonPose2D::play(std::shared_ptr<const SkeletonClip2D> newClip, float startTime)
+{
+  if (!skeleton || !newClip)
+    return false;
+  for (const SkeletonClip2D::Track &track : newClip->tracks)
+  {
+    if (track.bone >= skeleton->getBoneCount())
+    {
+      std::cerr << "SkeletonPose2D: clip " << newClip->getName() << " animates bone " << track.bone
+                << " of a " << skeleton->getBoneCount() << " bone skeleton" << std::endl;
+      return false;
+    }
+  }
+
+  clip = std::move(newClip);
+  trackKeys.assign(clip->tracks.size(), 0);
+  for (size_t bone = 0; bone < locals.size(); ++bone)
+    locals[bone] = skeleton->getBindPose(static_cast<BoneIndex>(bone));
+  time = startTime;
+  finished = false;
+  update(0.0f);
+  return true;
+}
+
+inline void SkeletonPose2D::stop()
+{
+  clip.reset();
+  trackKeys.clear();
+  time = 0.0f;
+  finished = false;
+  if (!skeleton)
+    return;
+
+  locals.resize(skeleton->getBoneCount());
+  for (size_t bone = 0; bone < locals.size(); ++bone)
+    locals[bone] = skeleton->getBindPose(static_cast<BoneIndex>(bone));
+  compose();
+}
+
+inline void SkeletonPose2D::update(float deltaTime)
+{
+  // A finished clip holds its last pose
+  if (!clip || finished)
+    return;
+
+  time += deltaTime * speed;
+  float duration = clip->duration;
+  if (time >= duration || time < 0.0f)
+  {
+    if (clip->loop && duration > 0.0f)
+    {
+      time -= std::floor(time / duration) * duration;
+    }
+    else
+    {
+      time = time < 0.0f ? 0.0f : duration;
+      finished = time >= duration;
+    }
+  }
+
+  sample();
+  compose();
+}
+
+inline void SkeletonPose2D::sample()
+{
+  const SkeletonClip2D &source = *clip;
+  for (size_t t = 0; t < source.tracks.size(); ++t)
+  {
+    const SkeletonClip2D::Track &track = source.tracks[t];
+    const float *times = source.keyTimes.data() + track.firstKey;
+
+    // Forward from the cached segment; a wrap starts over
+    uint32_t key = trackKeys[t];
+    if (time < times[key])
+      key = 0;
+    while (key + 1 < track.keyCount && times[key + 1] <= time)
+      ++key;
+    trackKeys[t] = key;
+
+    const Transform2D &from = source.keyValues[track.firstKey + key];
+    if (key + 1 >= track.keyCount || time <= times[key])
+    {
+      locals[track.bone] = from;
+      continue;
+    }
+
+    const Transform2D &to = source.keyValues[track.firstKey + key + 1];
+    float u = (time - times[key]) * source.keyInvSpans[track.firstKey + key];
+    Transform2D &local = locals[track.bone];
+    local.position.x = from.position.x + u * (to.position.x - from.position.x);
+    local.position.y = from.position.y + u * (to.position.y - from.position.y);
+    local.scale.x = from.scale.x + u * (to.scale.x - from.scale.x);
+    local.scale.y = from.scale.y + u * (to.scale.y - from.scale.y);
+    local.rotation = from.rotation + u * (to.rotation - from.rotation);
+  }
+}
+
+// The rotations are turned into sines and cosines in one batch first: one at
+// a time, inside the walk down the hierarchy, they cost twice as much.
+inline void SkeletonPose2D::compose()
+{
+  const Skeleton2D &bones = *skeleton;
+  for (size_t bone = 0; bone < locals.size(); ++bone)
+    rotations[bone] = locals[bone].rotation;
+  sinCosDegrees(rotations.data(), sines.data(), cosines.data(), rotations.size());
+
+  for (size_t bone = 0; bone < world.size(); ++bone)
+  {
+    BoneIndex parent = bones.getParent(static_cast<BoneIndex>(bone));
+    const Transform2D &transform = locals[bone];
+    Affine2D local(cosines[bone] * transform.scale.x, sines[bone] * transform.scale.x, -sines[bone] * transform.scale.y,
+                   cosines[bone] * transform.scale.y, transform.position.x, transform.position.y);
+    world[bone] = parent == InvalidBone ? local : world[parent] * local;
+    skinMatrices[bone] = world[bone] * bones.getInverseBind(static_cast<BoneIndex>(bone));
+  }
+  if (mesh)
+    mesh->skin(skinMatrices.data(), positions.data());
+}
+
+inline void SkeletonPose2D::sinCosDegrees(const float *degrees, float *sin, float *cos, size_t count)
+{
+#ifdef SKELETON_SSE2
+  const __m128 pi = _mm_set1_ps(Pi), minusPi = _mm_set1_ps(-Pi), twoPi = _mm_set1_ps(TwoPi);
+  auto sinFolded = [&](__m128 x)
+  {
+    // fastSinFolded, four lanes
+    x = _mm_min_ps(x, _mm_sub_ps(pi, x));
+    x = _mm_max_ps(x, _mm_sub_ps(minusPi, x));
+    __m128 x2 = _mm_mul_ps(x, x);
+    __m128 p = _mm_add_ps(_mm_set1_ps(0.00830629f), _mm_mul_ps(x2, _mm_set1_ps(-0.00018363f)));
+    p = _mm_add_ps(_mm_set1_ps(-0.16664824f), _mm_mul_ps(x2, p));
+    p = _mm_add_ps(_mm_set1_ps(0.99999660f), _mm_mul_ps(x2, p));
+    return _mm_mul_ps(x, p);
+  };
+
+  for (size_t i = 0; i < count; i += 4)
+  {
+    // Reduce to [-pi, pi] (rounding to the nearest whole turn), and the cosine's angle with it
+    __m128 radians = _mm_mul_ps(_mm_loadu_ps(degrees + i), _mm_set1_ps(Pi / 180.0f));
+    __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(radians, _mm_set1_ps(1.0f / TwoPi))));
+    radians = _mm_sub_ps(radians, _mm_mul_ps(turns, twoPi));
+    __m128 shifted = _mm_add_ps(radians, _mm_set1_ps(0.5f * Pi));
+    shifted = _mm_sub_ps(shifted, _mm_and_ps(_mm_cmpgt_ps(shifted, pi), twoPi));
+    _mm_storeu_ps(sin + i, sinFolded(radians));
+    _mm_storeu_ps(cos + i, sinFolded(shifted));
+  }
+#else
+  for (size_t i = 0; i < count; ++i)
+  {
+    float radians = degrees[i] * (Pi / 180.0f);
+    sin[i] = fastSin(radians);
+    cos[i] = fastCos(radians);
+  }
+#endif
+}
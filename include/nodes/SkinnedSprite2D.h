@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Node2D.h"
+#include "Skeleton2D.h"
+#include "Sprite2D.h"
+#include "../core/render/RenderDevice.h"
+#include <memory>
+#include <string>
+
+// Cutout character: a textured mesh skinned to a keyframed bone hierarchy and
+// drawn in one textured-triangle call. Skeleton, mesh, clips and texture are
+// shared between characters; each node only keeps its pose.
+class SkinnedSprite2D : public Node2D
+{
+  NODE_TYPE(SkinnedSprite2D)
+
+private:
+  SkeletonPose2D pose;
+  std::shared_ptr<TextureData> textureData;
+  Color tintColor;
+
+public:
+  SkinnedSprite2D(const std::string &nodeName = "SkinnedSprite2D",
+                  const Position2D &pos = Position2D(),
+                  const Scale2D &scale = Scale2D(1.0f, 1.0f))
+      : Node2D(nodeName), tintColor(Colors::white)
+  {
+    setPosition(pos);
+    setScale(scale);
+  }
+
+  // Shared data; false if the mesh does not fit the skeleton
+  bool setSkeleton(std::shared_ptr<const Skeleton2D> skeleton, std::shared_ptr<const SkinnedMesh2D> mesh)
+  {
+    return pose.setup(std::move(skeleton), std::move(mesh));
+  }
+  void setTexture(std::shared_ptr<TextureData> texture) { textureData = std::move(texture); }
+  const std::shared_ptr<TextureData> &getTexture() const { return textureData; }
+
+  bool play(std::shared_ptr<const SkeletonClip2D> clip, float startTime = 0.0f) { return pose.play(std::move(clip), startTime); }
+  void stop() { pose.stop(); }
+  SkeletonPose2D &getPose() { return pose; }
+  const SkeletonPose2D &getPose() const { return pose; }
+
+  void setTint(const Color &color) { tintColor = color; }
+  const Color &getTint() const { return tintColor; }
+
+  void update(float deltaTime = 0.0f) override
+  {
+    Node2D::update(deltaTime);
+    pose.update(deltaTime);
+  }
+
+  void render() const override
+  {
+    const SkinnedMesh2D *mesh = pose.getMesh().get();
+    if (!mesh || mesh->getIndexCount() == 0)
+      return;
+
+    auto &renderDevice = RenderDevice::getInstance();
+    const Position2D &pos = getTransform().getPosition();
+    const Scale2D &scale = getTransform().getScale();
+    renderDevice.setTransform(pos.x, pos.y, getTransform().getRotation(), scale.x, scale.y);
+    renderDevice.setColor(tintColor.x, tintColor.y, tintColor.z);
+    renderDevice.drawTexturedTriangles(textureData ? textureData->textureId : 0, pose.getPositions(),
+                                       mesh->getTexCoords(), mesh->getIndices(), mesh->getIndexCount());
+    renderDevice.resetTransform();
+  }
+};
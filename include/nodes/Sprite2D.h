@@ -4,6 +4,8 @@
 #include "../core/GameSettings.h"
 #include "../core/render/RenderDevice.h"
 #include "Animation2D.h"
+#include "../core/log/Logger.h"
+#include "../core/memory/AllocationTracker.h"
 #include <string>
 #include <memory>
 #include <iostream>
@@ -34,11 +36,69 @@ struct TextureData
   }
 };
 
+// Upload RGBA pixels into a new texture on the current render device
+inline std::unique_ptr<TextureData> createTextureData(int width, int height, const void *pixels,
+                                                      TextureFilter filter = TextureFilter::NEAREST)
+{
+  auto textureData = std::make_unique<TextureData>();
+  textureData->width = width;
+  textureData->height = height;
+  textureData->channels = 4;
+
+  auto &renderDevice = RenderDevice::getInstance();
+  textureData->textureId = renderDevice.createTexture();
+  renderDevice.uploadTexture(textureData->textureId, width, height, pixels, filter == TextureFilter::LINEAR);
+  return textureData;
+}
+
+// Load an image file into a new texture on the current render device (nullptr on failure)
+inline std::unique_ptr<TextureData> loadTextureData(const std::string &path, TextureFilter filter = TextureFilter::NEAREST)
+{
+  PROFILE_SCOPE("loadTextureData");
+
+  LOG_DEBUG(Render, "Attempting to load texture: {}", path);
+
+  // Load image using stb_image
+  int width, height, channels;
+  unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+
+  if (!data)
+  {
+    std::cerr << "Failed to load image: " << path << std::endl;
+    std::cerr << "stb_image error: " << stbi_failure_reason() << std::endl;
+
+    // Check if file exists
+    std::ifstream file(path);
+    if (file.good())
+    {
+      std::cerr << "File exists but stb_image failed to load it" << std::endl;
+    }
+    else
+    {
+      std::cerr << "File does not exist or cannot be opened" << std::endl;
+    }
+    file.close();
+
+    return nullptr;
+  }
+
+  // Create the texture (we force 4 channels, RGBA)
+  auto textureData = createTextureData(width, height, data, filter);
+
+  // Free the image data
+  stbi_image_free(data);
+
+  LOG_DEBUG(Render, "Loaded texture {} ({}x{}), id {}", path, width, height, textureData->textureId);
+  return textureData;
+}
+
 class Sprite2D : public Node2D
 {
+  NODE_TYPE(Sprite2D)
+
 private:
   std::string imagePath;
-  std::unique_ptr<TextureData> textureData;
+  std::shared_ptr<TextureData> textureData; // Shared between sprites cut from the same sheet
   bool textureLoaded;
   Color tintColor;
   bool useTint;
@@ -48,8 +108,8 @@ private:
   int vframes; // Number of vertical frames in the sprite sheet
   int frame;   // Current frame index (0-based)
 
-  // Animation system
-  std::unique_ptr<Animation2D> animator;
+  // Animation system (playback state only; clips are shared)
+  Animation2D animator;
 
 public:
   Sprite2D(const std::string &nodeName = "Sprite2D",
@@ -64,8 +124,7 @@ public:
   {
     setPosition(pos);
     setScale(scale);
-    animator = std::make_unique<Animation2D>();
-    std::cout << "Sprite2D constructor called with imagePath: " << imagePath << std::endl;
+    LOG_DEBUG(Render, "Sprite2D constructor called with imagePath: {}", imagePath);
     if (!imagePath.empty())
     {
       loadTexture(imagePath);
@@ -85,7 +144,6 @@ public:
   {
     setPosition(Position2D(x, y));
     setScale(Scale2D(scaleX, scaleY));
-    animator = std::make_unique<Animation2D>();
     if (!imgPath.empty())
     {
       loadTexture(imgPath);
@@ -95,67 +153,41 @@ public:
   // Destructor to clean up OpenGL resources
   ~Sprite2D()
   {
-    // The unique_ptr will automatically clean up the TextureData
+    // The shared_ptr cleans up the TextureData once the last sprite using it is gone
   }
 
   // Image management
   bool loadTexture(const std::string &path, TextureFilter filter = TextureFilter::NEAREST)
   {
+    PROFILE_SCOPE("Sprite2D::loadTexture");
+
     // Clean up existing texture
     textureData.reset();
     textureLoaded = false;
 
-    std::cout << "Attempting to load texture: " << path << std::endl;
-
-    // Load image using stb_image
-    int width, height, channels;
-    unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, 4);
-
-    if (!data)
+    textureData = loadTextureData(path, filter);
+    if (!textureData)
     {
-      std::cerr << "Failed to load image: " << path << std::endl;
-      std::cerr << "stb_image error: " << stbi_failure_reason() << std::endl;
-
-      // Check if file exists
-      std::ifstream file(path);
-      if (file.good())
-      {
-        std::cerr << "File exists but stb_image failed to load it" << std::endl;
-      }
-      else
-      {
-        std::cerr << "File does not exist or cannot be opened" << std::endl;
-      }
-      file.close();
-
       return false;
     }
 
-    // Create texture data
-    textureData = std::make_unique<TextureData>();
-    textureData->width = width;
-    textureData->height = height;
-    textureData->channels = 4; // We force 4 channels (RGBA)
-
-    // Generate texture using render device
-    auto &renderDevice = RenderDevice::getInstance();
-    textureData->textureId = renderDevice.createTexture();
-
-    // Upload texture data with filtering
-    bool useLinearFiltering = (filter == TextureFilter::LINEAR);
-    renderDevice.uploadTexture(textureData->textureId, width, height, data, useLinearFiltering);
-
-    // Free the image data
-    stbi_image_free(data);
-
     textureLoaded = true;
     imagePath = path;
+    updateAnimationBounds();
 
-    std::cout << "Successfully loaded texture: " << path << " (" << width << "x" << height << ")" << std::endl;
-    std::cout << "Texture ID: " << textureData->textureId << std::endl;
-    std::cout << "HFrames: " << hframes << ", VFrames: " << vframes << std::endl;
+    LOG_DEBUG(Render, "HFrames: {}, VFrames: {}", hframes, vframes);
     return true;
   }
+
+  // Use an already uploaded texture (e.g. one sheet shared by many sprites)
+  void setTexture(std::shared_ptr<TextureData> texture)
+  {
+    textureData = std::move(texture);
+    textureLoaded = textureData != nullptr;
+    updateAnimationBounds();
+    markRenderDirty();
+  }
+  const std::shared_ptr<TextureData> &getTexture() const { return textureData; }
   bool isTextureLoaded() const { return textureLoaded; }
   const std::string &getImagePath() const { return imagePath; }
 
@@ -164,13 +196,19 @@ public:
   {
     tintColor = color;
     useTint = true;
+    markRenderDirty();
   }
   void setTint(float r, float g, float b)
   {
     tintColor = Color(r, g, b);
     useTint = true;
+    markRenderDirty();
+  }
+  void clearTint()
+  {
+    useTint = false;
+    markRenderDirty();
   }
-  void clearTint() { useTint = false; }
   const Color &getTint() const { return tintColor; }
   bool hasTint() const { return useTint; }
 
@@ -180,56 +218,96 @@ public:
   int getFrame() const { return frame; }
   int getTotalFrames() const { return hframes * vframes; }
 
-  void setHFrames(int h) { hframes = h > 0 ? h : 1; }
-  void setVFrames(int v) { vframes = v > 0 ? v : 1; }
-  void setFrame(int f) { frame = f % (hframes * vframes); }
+  void setHFrames(int h)
+  {
+    hframes = h > 0 ? h : 1;
+    updateAnimationBounds();
+    markRenderDirty();
+  }
+  void setVFrames(int v)
+  {
+    vframes = v > 0 ? v : 1;
+    updateAnimationBounds();
+    markRenderDirty();
+  }
+  void setFrame(int f)
+  {
+    frame = f % (hframes * vframes);
+    markRenderDirty();
+  }
 
   // Animation system methods
-  Animation2D *getAnimator() { return animator.get(); }
-  const Animation2D *getAnimator() const { return animator.get(); }
+  Animation2D *getAnimator() { return &animator; }
+  const Animation2D *getAnimator() const { return &animator; }
+
+  // Share a clip set (e.g. AnimationLibrary::getInstance().get("alien"))
+  void setAnimationClips(std::shared_ptr<const AnimationClipSet> clips) { animator.setClips(std::move(clips)); }
 
   // Update animation (call this in your game loop)
   void updateAnimation(float deltaTime)
   {
-    if (animator)
+    // Sprites without a clip keep the frame set with setFrame(); batched
+    // sprites are advanced by the tree's AnimationSystem
+    int newFrame = animator.updateFrame(deltaTime);
+    if (newFrame < 0)
+      return;
+
+    // Update the current frame based on animation
+    if (newFrame != frame)
     {
-      animator->update(deltaTime);
-      // Update the current frame based on animation
-      int newFrame = animator->getCurrentFrameIndex();
-      if (newFrame != frame)
-      {
-        std::cout << "Frame changed from " << frame << " to " << newFrame << " for " << getName() << std::endl;
-        frame = newFrame;
-      }
+      ALLOCATION_TAG_SCOPE(Animation);
+      LOG_DEBUG(Animation, "Frame changed from {} to {} for {}", frame, newFrame, getName());
+      frame = newFrame;
     }
   }
 
-  // Play animation by name
+  // Play animation by name (looks the clip up) or by handle
   void playAnimation(const std::string &animationName)
   {
-    if (animator)
-    {
-      animator->play(animationName);
-    }
+    animator.play(animationName);
+  }
+  void playAnimation(AnimationClipHandle clip)
+  {
+    animator.play(clip);
   }
 
   // Stop current animation
   void stopAnimation()
   {
-    if (animator)
-    {
-      animator->stop();
-    }
+    animator.stop();
   }
 
   // Get current animation name
-  std::string getCurrentAnimation() const
+  const std::string &getCurrentAnimation() const
+  {
+    return animator.getCurrentAnimation();
+  }
+  AnimationClipHandle getCurrentAnimationClip() const { return animator.getCurrentClip(); }
+
+  // Size of one frame as rendered at unit scale, for the AnimationSystem's level of detail
+  void updateAnimationBounds()
   {
-    if (animator)
+    if (!animator.isAttached())
+      return;
+    bool textured = textureLoaded && textureData;
+    float width = textured ? static_cast<float>(textureData->width) / hframes : 1.0f;
+    float height = textured ? static_cast<float>(textureData->height) / vframes : 1.0f;
+    animator.setLodBounds(&getTransform(), width / 2.0f, height / 2.0f);
+  }
+
+  // Join the tree's AnimationSystem while it has one
+  void onTreeChanged() override
+  {
+    AnimationSystem *system = getTree() ? getTree()->getAnimationSystem() : nullptr;
+    if (system)
+    {
+      animator.attach(*system, &frame);
+      updateAnimationBounds();
+    }
+    else
     {
-      return animator->getCurrentAnimation();
+      animator.detach();
     }
-    return "";
   }
 
   // Override update to handle animations
@@ -249,7 +327,7 @@ public:
 
     if (!textureLoaded || !textureData)
     {
-      std::cout << "Rendering placeholder - texture not loaded" << std::endl;
+      LOG_TRACE(Render, "Rendering placeholder - texture not loaded");
       // If no texture is loaded, render a placeholder colored rectangle
 
       // Apply transformations
@@ -0,0 +1,584 @@
+#pragma once
+
+#include "Node2D.h"
+#include "Sprite2D.h"
+#include "../core/render/RenderDevice.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TILEMAP_MMAP 1
+#endif
+
+// Index into a tile set; 0 is an empty cell and tile n draws atlas cell n - 1
+using TileId = uint16_t;
+constexpr TileId EmptyTile = 0;
+
+// Tiles per chunk side
+constexpr int TileChunkSize = 32;
+constexpr int TileChunkTiles = TileChunkSize * TileChunkSize;
+
+// Level file layout: this header, then every chunk (row-major over the map)
+// as TileChunkTiles little-endian TileIds in row-major order. Edge chunks are
+// stored whole, padded with EmptyTile.
+struct TileLevelHeader
+{
+  char magic[4];      // "TMAP"
+  uint32_t version;   // 1
+  uint32_t width;     // In tiles
+  uint32_t height;
+  uint32_t chunkSize; // TileChunkSize when written
+};
+
+// A level file mapped read-only. Chunks are read straight out of the mapping,
+// so a chunk is paged in from disk when it is first drawn. Without mmap the
+// whole file is read into memory instead.
+class TileLevelFile
+{
+private:
+  const uint8_t *data;
+  size_t size;
+  bool mapped;
+  std::vector<uint8_t> contents; // Without mmap
+  int width;
+  int height;
+
+public:
+  TileLevelFile() : data(nullptr), size(0), mapped(false), width(0), height(0) {}
+  ~TileLevelFile() { close(); }
+
+  TileLevelFile(const TileLevelFile &) = delete;
+  TileLevelFile &operator=(const TileLevelFile &) = delete;
+
+  bool open(const std::string &path);
+  void close();
+  bool isOpen() const { return data != nullptr; }
+
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  int getChunkCountX() const { return (width + TileChunkSize - 1) / TileChunkSize; }
+  int getChunkCountY() const { return (height + TileChunkSize - 1) / TileChunkSize; }
+
+  // TileChunkTiles tiles of one chunk
+  const TileId *getChunk(int chunkX, int chunkY) const
+  {
+    size_t index = static_cast<size_t>(chunkY) * getChunkCountX() + chunkX;
+    return reinterpret_cast<const TileId *>(data + sizeof(TileLevelHeader)) + index * TileChunkTiles;
+  }
+
+  // Ask the OS to start reading a chunk that is about to be drawn
+  void prefetch(int chunkX, int chunkY) const;
+};
+
+// What the last render() of a TileMap2D did
+struct TileMapStats
+{
+  size_t visibleChunks = 0; // Inside the view, empty or not
+  size_t drawnChunks = 0;   // One draw call each
+  size_t drawnTiles = 0;
+  size_t chunkBuilds = 0; // Chunks whose geometry was (re)built
+  size_t cachedChunks = 0;
+};
+
+// Grid of tiles drawn from one atlas. Tiles are stored in fixed-size chunks;
+// each chunk caches its quads and is drawn with one textured-triangle call,
+// rebuilt only after one of its tiles changes. Chunks outside the view are
+// skipped, and the least recently drawn chunk geometry is recycled once the
+// cache limit is reached. Chunks that were never written take no tile memory;
+// a level file is streamed by mapping it and copying a chunk only on its
+// first edit. Culling assumes the node is not rotated.
+class TileMap2D : public Node2D
+{
+  NODE_TYPE(TileMap2D)
+
+private:
+  struct Chunk
+  {
+    const TileId *tiles = nullptr; // Into the level, into ownTiles, or null while empty
+    std::vector<TileId> ownTiles;
+
+    // Cached geometry, built during render()
+    mutable std::vector<float> positions; // x, y per quad corner, in map space
+    mutable std::vector<float> texCoords;
+    mutable size_t quadCount = 0;
+    mutable uint64_t lastDrawn = 0;
+    mutable bool dirty = true;
+    mutable bool cached = false;
+  };
+
+  int width;
+  int height;
+  int chunksX;
+  int chunksY;
+  float tileSize;
+  std::vector<Chunk> chunks;
+  std::unique_ptr<TileLevelFile> level;
+
+  // Atlas cells as left, top, right, bottom texture coordinates
+  std::shared_ptr<TextureData> textureData;
+  std::vector<float> tileUVs;
+
+  // Corner indices of TileChunkTiles quads, shared by every chunk
+  std::vector<uint16_t> quadIndices;
+
+  bool hasView;
+  float viewLeft, viewTop, viewRight, viewBottom;
+  size_t cacheLimit;
+
+  mutable std::vector<size_t> cachedChunks;
+  mutable uint64_t frame;
+  mutable int prefetchedRange[4];
+  mutable TileMapStats stats;
+
+  Chunk &chunkAt(int x, int y) { return chunks[static_cast<size_t>(y / TileChunkSize) * chunksX + x / TileChunkSize]; }
+  void invalidateAll();
+  void buildChunk(size_t index) const;
+
+public:
+  TileMap2D(const std::string &nodeName = "TileMap2D",
+            const Position2D &pos = Position2D(),
+            int mapWidth = 0, int mapHeight = 0, float tileSizeInUnits = 16.0f)
+      : Node2D(nodeName), width(0), height(0), chunksX(0), chunksY(0), tileSize(tileSizeInUnits), hasView(false),
+        viewLeft(0.0f), viewTop(0.0f), viewRight(0.0f), viewBottom(0.0f), cacheLimit(256), frame(0),
+        prefetchedRange{0, -1, 0, -1}
+  {
+    setPosition(pos);
+    setTileSet(nullptr, 1, 1);
+    quadIndices.resize(TileChunkTiles * 6);
+    for (size_t quad = 0; quad < TileChunkTiles; ++quad)
+    {
+      uint16_t corner = static_cast<uint16_t>(quad * 4);
+      uint16_t *index = &quadIndices[quad * 6];
+      index[0] = corner;
+      index[1] = static_cast<uint16_t>(corner + 1);
+      index[2] = static_cast<uint16_t>(corner + 2);
+      index[3] = corner;
+      index[4] = static_cast<uint16_t>(corner + 2);
+      index[5] = static_cast<uint16_t>(corner + 3);
+    }
+    resize(mapWidth, mapHeight);
+  }
+
+  // Empty map of width x height tiles (closes any level)
+  void resize(int mapWidth, int mapHeight);
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  int getChunkCountX() const { return chunksX; }
+  int getChunkCountY() const { return chunksY; }
+
+  void setTileSize(float size)
+  {
+    tileSize = size;
+    invalidateAll();
+  }
+  float getTileSize() const { return tileSize; }
+
+  // Atlas of columns x rows cells; tiles past the last cell are not drawn
+  void setTileSet(std::shared_ptr<TextureData> texture, int columns, int rows);
+  const std::shared_ptr<TextureData> &getTexture() const { return textureData; }
+
+  // False outside the map
+  bool setTile(int x, int y, TileId tile);
+  TileId getTile(int x, int y) const;
+  void fill(int x, int y, int fillWidth, int fillHeight, TileId tile);
+
+  // Stream the tiles of a level file, replacing the map; saveLevel writes one.
+  // Do not save over the file the map is streaming from.
+  bool openLevel(const std::string &path);
+  bool saveLevel(const std::string &path) const;
+  bool isStreaming() const { return level != nullptr; }
+
+  // World-space rectangle to draw, e.g. from Camera::getLeft/getTop/getRight/getBottom.
+  // Without a view every chunk is drawn.
+  void setView(float left, float top, float right, float bottom);
+  void clearView() { hasView = false; }
+
+  // Chunks whose geometry stays cached; more are kept while all are in view
+  void setCacheLimit(size_t chunkCount) { cacheLimit = std::max<size_t>(chunkCount, 1); }
+  size_t getCacheLimit() const { return cacheLimit; }
+
+  const TileMapStats &getStats() const { return stats; }
+
+  void render() const override;
+};
+
+// Implementation
+inline bool TileLevelFile::open(const std::string &path)
+{
+  close();
+
+#ifdef TILEMAP_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cerr << "TileLevelFile: cannot open " << path << std::endl;
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(TileLevelHeader)))
+  {
+    std::cerr << "TileLevelFile: " << path << " is not a level file" << std::endl;
+    ::close(fd);
+    return false;
+  }
+  void *mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    std::cerr << "TileLevelFile: cannot map " << path << std::endl;
+    return false;
+  }
+  data = static_cast<const uint8_t *>(mapping);
+  size = static_cast<size_t>(info.st_size);
+  mapped = true;
+#else
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file)
+  {
+    std::cerr << "TileLevelFile: cannot open " << path << std::endl;
+    return false;
+  }
+  contents.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char *>(contents.data()), static_cast<std::streamsize>(contents.size())) ||
+      contents.size() < sizeof(TileLevelHeader))
+  {
+    std::cerr << "TileLevelFile: " << path << " is not a level file" << std::endl;
+    contents.clear();
+    return false;
+  }
+  data = contents.data();
+  size = contents.size();
+#endif
+
+  TileLevelHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  width = static_cast<int>(header.width);
+  height = static_cast<int>(header.height);
+  size_t expected = sizeof(TileLevelHeader) +
+                    static_cast<size_t>(getChunkCountX()) * getChunkCountY() * TileChunkTiles * sizeof(TileId);
+  if (std::memcmp(header.magic, "TMAP", 4) != 0 || header.version != 1 || header.chunkSize != TileChunkSize ||
+      header.width > 0xFFFFFF || header.height > 0xFFFFFF || size < expected)
+  {
+    std::cerr << "TileLevelFile: " << path << " is not a version 1 level file" << std::endl;
+    close();
+    return false;
+  }
+  return true;
+}
+
+inline void TileLevelFile::close()
+{
+#ifdef TILEMAP_MMAP
+  if (mapped)
+    munmap(const_cast<uint8_t *>(data), size);
+#endif
+  contents.clear();
+  data = nullptr;
+  size = 0;
+  mapped = false;
+  width = height = 0;
+}
+
+inline void TileLevelFile::prefetch(int chunkX, int chunkY) const
+{
+#ifdef TILEMAP_MMAP
+  if (!mapped)
+    return;
+  static const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  uintptr_t begin = reinterpret_cast<uintptr_t>(getChunk(chunkX, chunkY));
+  uintptr_t end = begin + TileChunkTiles * sizeof(TileId);
+  begin &= ~(pageSize - 1);
+  madvise(reinterpret_cast<void *>(begin), end - begin, MADV_WILLNEED);
+#else
+  (void)chunkX;
+  (void)chunkY;
+#endif
+}
+
+inline void TileMap2D::resize(int mapWidth, int mapHeight)
+{
+  level.reset();
+  width = std::max(mapWidth, 0);
+  height = std::max(mapHeight, 0);
+  chunksX = (width + TileChunkSize - 1) / TileChunkSize;
+  chunksY = (height + TileChunkSize - 1) / TileChunkSize;
+  chunks.clear();
+  chunks.resize(static_cast<size_t>(chunksX) * chunksY);
+  cachedChunks.clear();
+  prefetchedRange[1] = prefetchedRange[3] = -1;
+}
+
+inline void TileMap2D::invalidateAll()
+{
+  for (const Chunk &chunk : chunks)
+    chunk.dirty = true;
+}
+
+inline void TileMap2D::setTileSet(std::shared_ptr<TextureData> texture, int columns, int rows)
+{
+  textureData = std::move(texture);
+  columns = std::max(columns, 1);
+  rows = std::max(rows, 1);
+  tileUVs.resize(static_cast<size_t>(columns) * rows * 4);
+  for (int cell = 0; cell < columns * rows; ++cell)
+  {
+    // Same orientation as Sprite2D frames: row 0 at the top of the image
+    float *uv = &tileUVs[static_cast<size_t>(cell) * 4];
+    uv[0] = static_cast<float>(cell % columns) / columns;
+    uv[1] = 1.0f - static_cast<float>(cell / columns) / rows;
+    uv[2] = uv[0] + 1.0f / columns;
+    uv[3] = uv[1] - 1.0f / rows;
+  }
+  invalidateAll();
+}
+
+inline bool TileMap2D::setTile(int x, int y, TileId tile)
+{
+  if (x < 0 || y < 0 || x >= width || y >= height)
+    return false;
+
+  Chunk &chunk = chunkAt(x, y);
+  size_t offset = static_cast<size_t>(y % TileChunkSize) * TileChunkSize + x % TileChunkSize;
+  if (chunk.tiles != chunk.ownTiles.data() || chunk.ownTiles.empty())
+  {
+    if (!chunk.tiles && tile == EmptyTile)
+      return true;
+    // First edit: take a copy of the level's tiles, or start from empty
+    if (chunk.tiles)
+      chunk.ownTiles.assign(chunk.tiles, chunk.tiles + TileChunkTiles);
+    else
+      chunk.ownTiles.assign(TileChunkTiles, EmptyTile);
+    chunk.tiles = chunk.ownTiles.data();
+  }
+  if (chunk.ownTiles[offset] != tile)
+  {
+    chunk.ownTiles[offset] = tile;
+    chunk.dirty = true;
+  }
+  return true;
+}
+
+inline TileId TileMap2D::getTile(int x, int y) const
+{
+  if (x < 0 || y < 0 || x >= width || y >= height)
+    return EmptyTile;
+  const Chunk &chunk = chunks[static_cast<size_t>(y / TileChunkSize) * chunksX + x / TileChunkSize];
+  return chunk.tiles ? chunk.tiles[(y % TileChunkSize) * TileChunkSize + x % TileChunkSize] : EmptyTile;
+}
+
+inline void TileMap2D::fill(int x, int y, int fillWidth, int fillHeight, TileId tile)
+{
+  int right = std::min(x + fillWidth, width), bottom = std::min(y + fillHeight, height);
+  for (int row = std::max(y, 0); row < bottom; ++row)
+  {
+    for (int column = std::max(x, 0); column < right; ++column)
+      setTile(column, row, tile);
+  }
+}
+
+inline bool TileMap2D::openLevel(const std::string &path)
+{
+  auto file = std::make_unique<TileLevelFile>();
+  if (!file->open(path))
+    return false;
+
+  resize(file->getWidth(), file->getHeight());
+  for (int chunkY = 0; chunkY < chunksY; ++chunkY)
+  {
+    for (int chunkX = 0; chunkX < chunksX; ++chunkX)
+      chunks[static_cast<size_t>(chunkY) * chunksX + chunkX].tiles = file->getChunk(chunkX, chunkY);
+  }
+  level = std::move(file);
+  return true;
+}
+
+inline bool TileMap2D::saveLevel(const std::string &path) const
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file)
+  {
+    std::cerr << "TileMap2D: cannot write " << path << std::endl;
+    return false;
+  }
+
+  TileLevelHeader header = {{'T', 'M', 'A', 'P'}, 1, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                            TileChunkSize};
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  const std::vector<TileId> empty(TileChunkTiles, EmptyTile);
+  for (const Chunk &chunk : chunks)
+  {
+    const TileId *tiles = chunk.tiles ? chunk.tiles : empty.data();
+    file.write(reinterpret_cast<const char *>(tiles), TileChunkTiles * sizeof(TileId));
+  }
+  if (!file)
+  {
+    std::cerr << "TileMap2D: failed writing " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+inline void TileMap2D::setView(float left, float top, float right, float bottom)
+{
+  hasView = true;
+  viewLeft = left;
+  viewTop = top;
+  viewRight = right;
+  viewBottom = bottom;
+}
+
+// Quads of the chunk's non-empty tiles, reusing the buffers of the least
+// recently drawn chunk once the cache is full
+inline void TileMap2D::buildChunk(size_t index) const
+{
+  const Chunk &chunk = chunks[index];
+  if (!chunk.cached)
+  {
+    size_t victim = cachedChunks.size();
+    if (cachedChunks.size() >= cacheLimit)
+    {
+      for (size_t i = 0; i < cachedChunks.size(); ++i)
+      {
+        const Chunk &candidate = chunks[cachedChunks[i]];
+        if (candidate.lastDrawn < frame && (victim == cachedChunks.size() || candidate.lastDrawn < chunks[cachedChunks[victim]].lastDrawn))
+          victim = i;
+      }
+    }
+    if (victim < cachedChunks.size())
+    {
+      const Chunk &evicted = chunks[cachedChunks[victim]];
+      chunk.positions.swap(evicted.positions);
+      chunk.texCoords.swap(evicted.texCoords);
+      evicted.cached = false;
+      evicted.dirty = true;
+      cachedChunks[victim] = index;
+    }
+    else
+    {
+      cachedChunks.push_back(index);
+    }
+    chunk.positions.resize(TileChunkTiles * 8);
+    chunk.texCoords.resize(TileChunkTiles * 8);
+    chunk.cached = true;
+  }
+
+  int originX = static_cast<int>(index % chunksX) * TileChunkSize;
+  int originY = static_cast<int>(index / chunksX) * TileChunkSize;
+  size_t cells = tileUVs.size() / 4;
+  size_t quads = 0;
+  for (int row = 0; row < TileChunkSize; ++row)
+  {
+    const TileId *tiles = chunk.tiles + row * TileChunkSize;
+    float top = static_cast<float>(originY + row) * tileSize, bottom = top + tileSize;
+    for (int column = 0; column < TileChunkSize; ++column)
+    {
+      size_t cell = static_cast<size_t>(tiles[column]) - 1;
+      if (tiles[column] == EmptyTile || cell >= cells)
+        continue;
+
+      float left = static_cast<float>(originX + column) * tileSize, right = left + tileSize;
+      const float *uv = &tileUVs[cell * 4];
+      float *position = &chunk.positions[quads * 8];
+      float *texCoord = &chunk.texCoords[quads * 8];
+      position[0] = left;
+      position[1] = top;
+      position[2] = right;
+      position[3] = top;
+      position[4] = right;
+      position[5] = bottom;
+      position[6] = left;
+      position[7] = bottom;
+      texCoord[0] = uv[0];
+      texCoord[1] = uv[1];
+      texCoord[2] = uv[2];
+      texCoord[3] = uv[1];
+      texCoord[4] = uv[2];
+      texCoord[5] = uv[3];
+      texCoord[6] = uv[0];
+      texCoord[7] = uv[3];
+      quads++;
+    }
+  }
+  chunk.quadCount = quads;
+  chunk.dirty = false;
+  stats.chunkBuilds++;
+}
+
+inline void TileMap2D::render() const
+{
+  stats = TileMapStats();
+  if (chunks.empty())
+    return;
+  frame++;
+
+  // Chunks overlapping the view, in map space
+  const Position2D &pos = getTransform().getPosition();
+  const Scale2D &scale = getTransform().getScale();
+  int firstX = 0, firstY = 0, lastX = chunksX - 1, lastY = chunksY - 1;
+  if (hasView)
+  {
+    float chunkWidth = tileSize * TileChunkSize * scale.x, chunkHeight = tileSize * TileChunkSize * scale.y;
+    firstX = std::max(firstX, static_cast<int>(std::floor((viewLeft - pos.x) / chunkWidth)));
+    firstY = std::max(firstY, static_cast<int>(std::floor((viewTop - pos.y) / chunkHeight)));
+    lastX = std::min(lastX, static_cast<int>(std::floor((viewRight - pos.x) / chunkWidth)));
+    lastY = std::min(lastY, static_cast<int>(std::floor((viewBottom - pos.y) / chunkHeight)));
+  }
+
+  // Read ahead the ring of level chunks around a view that moved
+  if (level && hasView &&
+      (firstX != prefetchedRange[0] || lastX != prefetchedRange[1] || firstY != prefetchedRange[2] || lastY != prefetchedRange[3]))
+  {
+    for (int chunkY = std::max(firstY - 1, 0); chunkY <= std::min(lastY + 1, chunksY - 1); ++chunkY)
+    {
+      for (int chunkX = std::max(firstX - 1, 0); chunkX <= std::min(lastX + 1, chunksX - 1); ++chunkX)
+      {
+        const Chunk &chunk = chunks[static_cast<size_t>(chunkY) * chunksX + chunkX];
+        if (!chunk.cached && chunk.tiles == level->getChunk(chunkX, chunkY))
+          level->prefetch(chunkX, chunkY);
+      }
+    }
+    prefetchedRange[0] = firstX;
+    prefetchedRange[1] = lastX;
+    prefetchedRange[2] = firstY;
+    prefetchedRange[3] = lastY;
+  }
+
+  auto &renderDevice = RenderDevice::getInstance();
+  unsigned int textureId = textureData ? textureData->textureId : 0;
+  renderDevice.setTransform(pos.x, pos.y, getTransform().getRotation(), scale.x, scale.y);
+  for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+  {
+    for (int chunkX = firstX; chunkX <= lastX; ++chunkX)
+    {
+      size_t index = static_cast<size_t>(chunkY) * chunksX + chunkX;
+      const Chunk &chunk = chunks[index];
+      stats.visibleChunks++;
+      if (!chunk.tiles)
+        continue;
+      if (chunk.dirty || !chunk.cached)
+        buildChunk(index);
+      chunk.lastDrawn = frame;
+      if (chunk.quadCount == 0)
+        continue;
+
+      renderDevice.drawTexturedTriangles(textureId, chunk.positions.data(), chunk.texCoords.data(), quadIndices.data(),
+                                         chunk.quadCount * 6);
+      stats.drawnChunks++;
+      stats.drawnTiles += chunk.quadCount;
+    }
+  }
+  renderDevice.resetTransform();
+  stats.cachedChunks = cachedChunks.size();
+}
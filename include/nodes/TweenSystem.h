@@ -0,0 +1,553 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "../core/Math.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TWEEN_SSE2 1
+#endif
+
+// Targets are scattered over the nodes, so their cache lines are requested ahead
+#if defined(__GNUC__) || defined(__clang__)
+#define TWEEN_PREFETCH(address) __builtin_prefetch((address), 1)
+#else
+#define TWEEN_PREFETCH(address) ((void)0)
+#endif
+constexpr size_t TweenPrefetchDistance = 16;
+
+// Node properties a tween can drive, with their float count
+enum class TweenChannel : uint8_t
+{
+  Position, // 2
+  Rotation, // 1 (degrees)
+  Scale,    // 2
+  Color     // 3
+};
+
+// How a keyframe segment moves from its key to the next
+enum class TweenEase : uint8_t
+{
+  Step,   // Hold the key's value
+  Linear,
+  Cubic   // Ease in and out (smoothstep)
+};
+
+enum class TweenLoop : uint8_t
+{
+  Once, // Stop on the last key
+  Loop,
+  PingPong
+};
+
+struct TweenKeyframe
+{
+  float time; // Seconds
+  Vector3 value; // Only the channel's first components are used
+  TweenEase ease;
+
+  TweenKeyframe(float t = 0.0f, const Vector3 &v = Vector3(), TweenEase e = TweenEase::Linear)
+      : time(t), value(v), ease(e) {}
+};
+
+using TweenCurveHandle = uint32_t;
+using TweenId = uint32_t;
+constexpr uint32_t InvalidTween = 0xFFFFFFFFu;
+
+// Property tracks for many nodes, stored by kind in flat arrays and advanced
+// together by update():
+// - oscillators (base + amplitude * sin(phase)), evaluated four at a time with
+//   fastSinFolded, replace per-node sin() scripts such as OscillatingRectangle;
+// - spins add a constant rate and wrap (RotatingTriangle);
+// - keyframe tracks sample a shared curve with step, linear or cubic easing.
+// Each track writes 1-3 floats to a target such as a node's Transform2D; the
+// target must outlive the track (remove the track before destroying its node).
+class TweenSystem
+{
+private:
+  enum class Kind : uint8_t
+  {
+    Oscillator,
+    Spin,
+    Keyframes
+  };
+
+  struct Curve
+  {
+    uint32_t firstKey;
+    uint32_t keyCount;
+    uint32_t components;
+    float duration;
+    float period; // Of Loop and PingPong playback
+    float invPeriod;
+    TweenLoop loop;
+  };
+
+  // Curves: keys of every curve back to back
+  std::vector<Curve> curves;
+  std::vector<float> keyTimes;
+  std::vector<float> keyInvSpans; // 1 / (time of the next key - time), 0 on the last key
+  std::vector<TweenEase> keyEases;
+  std::vector<float> keyValues; // Curve components per key
+
+  // Id -> (kind, dense index)
+  struct Slot
+  {
+    Kind kind;
+    uint32_t index;
+  };
+  std::vector<Slot> slots;
+  std::vector<TweenId> freeSlots;
+
+  // Oscillators; phase stays in [0, 2pi) and omega is never negative
+  std::vector<float> oscPhase, oscOmega, oscBase, oscAmplitude;
+  std::vector<float *> oscTargets;
+  std::vector<uint8_t> oscComponents;
+  std::vector<TweenId> oscIds;
+
+  // Spins; value stays in [0, wrap)
+  std::vector<float> spinValue, spinRate, spinWrap;
+  std::vector<float *> spinTargets;
+  std::vector<TweenId> spinIds;
+
+  // Keyframe players
+  std::vector<float> playTime, playSpeed;
+  std::vector<uint32_t> playCurve, playKey; // playKey caches the current segment
+  std::vector<float *> playTargets;
+  std::vector<TweenId> playIds;
+
+  TweenId allocate(Kind kind, uint32_t index);
+
+  // Swap-remove element `index` of a kind's arrays, re-pointing the moved track's slot
+  template <typename... Arrays>
+  void swapRemove(std::vector<TweenId> &ids, uint32_t index, Arrays &...arrays);
+
+  void writeOscillator(size_t index, float value);
+  void updateOscillators(float deltaTime);
+  void updateSpins(float deltaTime);
+  void updateKeyframes(float deltaTime);
+
+public:
+  // Float count of a channel, and where it lives on a node (node->getTransform())
+  static uint32_t getComponentCount(TweenChannel channel);
+  static float *getTarget(Transform2D &transform, TweenChannel channel);
+  static float *getTarget(Color &color) { return &color.x; }
+
+  // Keys sorted by time (the first usually at 0); the curve lasts until the last key
+  TweenCurveHandle addCurve(const std::vector<TweenKeyframe> &keys, uint32_t components,
+                            TweenLoop loop = TweenLoop::Once);
+  TweenCurveHandle addCurve(const std::vector<TweenKeyframe> &keys, TweenChannel channel,
+                            TweenLoop loop = TweenLoop::Once)
+  {
+    return addCurve(keys, getComponentCount(channel), loop);
+  }
+
+  // Play a curve into `target` (speed 1 = real time); InvalidTween on a bad curve
+  TweenId play(TweenCurveHandle curve, float *target, float speed = 1.0f, float startTime = 0.0f);
+  TweenId play(TweenCurveHandle curve, Transform2D &transform, TweenChannel channel, float speed = 1.0f)
+  {
+    return play(curve, getTarget(transform, channel), speed);
+  }
+
+  // target[0..components) = base + amplitude * sin(angularFrequency * t + phase)
+  TweenId oscillate(float *target, uint32_t components, float base, float amplitude, float angularFrequency,
+                    float phase = 0.0f);
+
+  // *target advances by rate per second, wrapped into [0, wrap)
+  TweenId spin(float *target, float rate, float start = 0.0f, float wrap = 360.0f);
+
+  void remove(TweenId id);
+  bool isValid(TweenId id) const { return id < slots.size() && slots[id].index != InvalidTween; }
+
+  // A Once keyframe track that has reached its last key
+  bool isFinished(TweenId id) const;
+
+  // Advance every track and write its target
+  void update(float deltaTime);
+
+  size_t size() const { return oscIds.size() + spinIds.size() + playIds.size(); }
+  size_t getCurveCount() const { return curves.size(); }
+  void reserve(size_t tracks);
+  void clear();
+};
+
+// Implementation
+inline uint32_t TweenSystem::getComponentCount(TweenChannel channel)
+{
+  switch (channel)
+  {
+  case TweenChannel::Position:
+  case TweenChannel::Scale:
+    return 2;
+  case TweenChannel::Rotation:
+    return 1;
+  case TweenChannel::Color:
+    return 3;
+  }
+  return 1;
+}
+
+inline float *TweenSystem::getTarget(Transform2D &transform, TweenChannel channel)
+{
+  switch (channel)
+  {
+  case TweenChannel::Position:
+    return &transform.position.x;
+  case TweenChannel::Rotation:
+    return &transform.rotation;
+  case TweenChannel::Scale:
+    return &transform.scale.x;
+  case TweenChannel::Color:
+    break;
+  }
+  std::cerr << "TweenSystem: a transform has no color, pass the node's Color instead" << std::endl;
+  return nullptr;
+}
+
+inline TweenCurveHandle TweenSystem::addCurve(const std::vector<TweenKeyframe> &keys, uint32_t components,
+                                              TweenLoop loop)
+{
+  if (keys.empty() || components == 0 || components > 3)
+  {
+    std::cerr << "TweenSystem: a curve needs keys and 1-3 components" << std::endl;
+    return InvalidTween;
+  }
+
+  for (size_t i = 1; i < keys.size(); ++i)
+  {
+    if (keys[i].time < keys[i - 1].time)
+    {
+      std::cerr << "TweenSystem: curve keys must be sorted by time" << std::endl;
+      return InvalidTween;
+    }
+  }
+
+  Curve curve;
+  curve.firstKey = static_cast<uint32_t>(keyTimes.size());
+  curve.keyCount = static_cast<uint32_t>(keys.size());
+  curve.components = components;
+  curve.duration = keys.back().time;
+  curve.period = loop == TweenLoop::PingPong ? 2.0f * curve.duration : curve.duration;
+  curve.invPeriod = curve.period > 0.0f ? 1.0f / curve.period : 0.0f;
+  curve.loop = loop;
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    float span = i + 1 < keys.size() ? keys[i + 1].time - keys[i].time : 0.0f;
+    keyTimes.push_back(keys[i].time);
+    keyInvSpans.push_back(span > 0.0f ? 1.0f / span : 0.0f);
+    keyEases.push_back(keys[i].ease);
+    const float *value = &keys[i].value.x;
+    keyValues.insert(keyValues.end(), value, value + components);
+  }
+  curves.push_back(curve);
+  return static_cast<TweenCurveHandle>(curves.size() - 1);
+}
+
+inline TweenId TweenSystem::allocate(Kind kind, uint32_t index)
+{
+  TweenId id;
+  if (!freeSlots.empty())
+  {
+    id = freeSlots.back();
+    freeSlots.pop_back();
+  }
+  else
+  {
+    id = static_cast<TweenId>(slots.size());
+    slots.push_back(Slot());
+  }
+  slots[id] = {kind, index};
+  return id;
+}
+
+inline TweenId TweenSystem::play(TweenCurveHandle curve, float *target, float speed, float startTime)
+{
+  if (curve >= curves.size() || !target)
+    return InvalidTween;
+
+  uint32_t index = static_cast<uint32_t>(playIds.size());
+  TweenId id = allocate(Kind::Keyframes, index);
+  playTime.push_back(startTime);
+  playSpeed.push_back(speed);
+  playCurve.push_back(curve);
+  playKey.push_back(0);
+  playTargets.push_back(target);
+  playIds.push_back(id);
+  return id;
+}
+
+inline TweenId TweenSystem::oscillate(float *target, uint32_t components, float base, float amplitude,
+                                      float angularFrequency, float phase)
+{
+  if (!target || components == 0 || components > 3)
+    return InvalidTween;
+
+  // sin(-w t + p) = -sin(w t - p), so the phase only ever moves forward
+  if (angularFrequency < 0.0f)
+  {
+    angularFrequency = -angularFrequency;
+    amplitude = -amplitude;
+    phase = -phase;
+  }
+  phase -= std::floor(phase / TwoPi) * TwoPi;
+
+  uint32_t index = static_cast<uint32_t>(oscIds.size());
+  TweenId id = allocate(Kind::Oscillator, index);
+  oscPhase.push_back(phase < TwoPi ? phase : 0.0f);
+  oscOmega.push_back(angularFrequency);
+  oscBase.push_back(base);
+  oscAmplitude.push_back(amplitude);
+  oscTargets.push_back(target);
+  oscComponents.push_back(static_cast<uint8_t>(components));
+  oscIds.push_back(id);
+  return id;
+}
+
+inline TweenId TweenSystem::spin(float *target, float rate, float start, float wrap)
+{
+  if (!target || !(wrap > 0.0f))
+    return InvalidTween;
+
+  uint32_t index = static_cast<uint32_t>(spinIds.size());
+  TweenId id = allocate(Kind::Spin, index);
+  spinValue.push_back(start - std::floor(start / wrap) * wrap);
+  spinRate.push_back(rate);
+  spinWrap.push_back(wrap);
+  spinTargets.push_back(target);
+  spinIds.push_back(id);
+  return id;
+}
+
+template <typename... Arrays>
+inline void TweenSystem::swapRemove(std::vector<TweenId> &ids, uint32_t index, Arrays &...arrays)
+{
+  size_t last = ids.size() - 1;
+  if (index != last)
+  {
+    ((arrays[index] = arrays[last]), ...);
+    ids[index] = ids[last];
+    slots[ids[index]].index = index;
+  }
+  (arrays.pop_back(), ...);
+  ids.pop_back();
+}
+
+inline void TweenSystem::remove(TweenId id)
+{
+  if (!isValid(id))
+    return;
+
+  uint32_t index = slots[id].index;
+  switch (slots[id].kind)
+  {
+  case Kind::Oscillator:
+    swapRemove(oscIds, index, oscPhase, oscOmega, oscBase, oscAmplitude, oscTargets, oscComponents);
+    break;
+  case Kind::Spin:
+    swapRemove(spinIds, index, spinValue, spinRate, spinWrap, spinTargets);
+    break;
+  case Kind::Keyframes:
+    swapRemove(playIds, index, playTime, playSpeed, playCurve, playKey, playTargets);
+    break;
+  }
+
+  slots[id].index = InvalidTween;
+  freeSlots.push_back(id);
+}
+
+inline bool TweenSystem::isFinished(TweenId id) const
+{
+  if (!isValid(id) || slots[id].kind != Kind::Keyframes)
+    return false;
+  uint32_t index = slots[id].index;
+  const Curve &curve = curves[playCurve[index]];
+  return curve.loop == TweenLoop::Once && (playSpeed[index] >= 0.0f ? playTime[index] >= curve.duration
+                                                                      : playTime[index] <= 0.0f);
+}
+
+inline void TweenSystem::writeOscillator(size_t i, float value)
+{
+  float *target = oscTargets[i];
+  target[0] = value;
+  if (oscComponents[i] > 1)
+  {
+    target[1] = value;
+    if (oscComponents[i] > 2)
+      target[2] = value;
+  }
+}
+
+inline void TweenSystem::updateOscillators(float deltaTime)
+{
+  size_t count = oscIds.size();
+  float *phases = oscPhase.data();
+  const float *omegas = oscOmega.data();
+  const float *bases = oscBase.data();
+  const float *amplitudes = oscAmplitude.data();
+  float *const *targets = oscTargets.data();
+
+  // sin(phase) = -sin(phase - pi), and phase - pi lies in the folded range
+  size_t i = 0;
+#ifdef TWEEN_SSE2
+  const __m128 dt = _mm_set1_ps(deltaTime);
+  const __m128 twoPi = _mm_set1_ps(TwoPi);
+  const __m128 invTwoPi = _mm_set1_ps(1.0f / TwoPi);
+  const __m128 pi = _mm_set1_ps(Pi);
+  const __m128 minusPi = _mm_set1_ps(-Pi);
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 phase = _mm_add_ps(_mm_loadu_ps(phases + i), _mm_mul_ps(_mm_loadu_ps(omegas + i), dt));
+    __m128 turns = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(phase, invTwoPi))); // Phase is never negative
+    phase = _mm_sub_ps(phase, _mm_mul_ps(turns, twoPi));
+    _mm_storeu_ps(phases + i, phase);
+
+    __m128 x = _mm_sub_ps(phase, pi);
+    x = _mm_min_ps(x, _mm_sub_ps(pi, x));
+    x = _mm_max_ps(x, _mm_sub_ps(minusPi, x));
+    __m128 x2 = _mm_mul_ps(x, x);
+    __m128 poly = _mm_add_ps(_mm_set1_ps(0.00830629f), _mm_mul_ps(x2, _mm_set1_ps(-0.00018363f)));
+    poly = _mm_add_ps(_mm_set1_ps(-0.16664824f), _mm_mul_ps(x2, poly));
+    poly = _mm_add_ps(_mm_set1_ps(0.99999660f), _mm_mul_ps(x2, poly));
+    __m128 sine = _mm_mul_ps(x, poly); // sin(phase - pi)
+
+    float values[4];
+    _mm_storeu_ps(values, _mm_sub_ps(_mm_loadu_ps(bases + i), _mm_mul_ps(_mm_loadu_ps(amplitudes + i), sine)));
+    for (size_t lane = 0; lane < 4; ++lane)
+    {
+      TWEEN_PREFETCH(targets[i + lane + TweenPrefetchDistance < count ? i + lane + TweenPrefetchDistance : i]);
+      writeOscillator(i + lane, values[lane]);
+    }
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    float phase = phases[i] + omegas[i] * deltaTime;
+    phase -= static_cast<float>(static_cast<int>(phase * (1.0f / TwoPi))) * TwoPi;
+    phases[i] = phase;
+    TWEEN_PREFETCH(targets[i + TweenPrefetchDistance < count ? i + TweenPrefetchDistance : i]);
+    writeOscillator(i, bases[i] - amplitudes[i] * fastSinFolded(phase - Pi));
+  }
+}
+
+inline void TweenSystem::updateSpins(float deltaTime)
+{
+  size_t count = spinIds.size();
+  float *values = spinValue.data();
+  const float *rates = spinRate.data();
+  const float *wraps = spinWrap.data();
+  float *const *targets = spinTargets.data();
+  for (size_t i = 0; i < count; ++i)
+  {
+    TWEEN_PREFETCH(targets[i + TweenPrefetchDistance < count ? i + TweenPrefetchDistance : i]);
+
+    // One wrap per frame is the common case; a long step falls back to floor
+    float wrap = wraps[i];
+    float value = values[i] + rates[i] * deltaTime;
+    value = value >= wrap ? value - wrap : value;
+    value = value < 0.0f ? value + wrap : value;
+    if (value >= wrap || value < 0.0f)
+      value -= std::floor(value / wrap) * wrap;
+    values[i] = value;
+    *targets[i] = value;
+  }
+}
+
+inline void TweenSystem::updateKeyframes(float deltaTime)
+{
+  size_t count = playIds.size();
+  const Curve *curveData = curves.data();
+  const float *times = keyTimes.data();
+  const float *invSpans = keyInvSpans.data();
+  const TweenEase *eases = keyEases.data();
+  const float *keyData = keyValues.data();
+
+  float *const *targets = playTargets.data();
+  for (size_t i = 0; i < count; ++i)
+  {
+    TWEEN_PREFETCH(targets[i + TweenPrefetchDistance < count ? i + TweenPrefetchDistance : i]);
+    const Curve &curve = curveData[playCurve[i]];
+    float duration = curve.duration;
+    float time = playTime[i] + playSpeed[i] * deltaTime;
+
+    // Position on the curve for the loop mode; time stays within one period,
+    // so truncating to whole periods cannot overflow
+    float local;
+    if (curve.loop == TweenLoop::Once || duration <= 0.0f)
+    {
+      time = time < 0.0f ? 0.0f : (time > duration ? duration : time);
+      local = time;
+    }
+    else
+    {
+      time -= static_cast<float>(static_cast<int>(time * curve.invPeriod)) * curve.period;
+      time = time < 0.0f ? time + curve.period : time;
+      local = time <= duration ? time : curve.period - time;
+    }
+    playTime[i] = time;
+
+    // Segment [key, key + 1] holding local; usually the cached one or the next
+    const float *keyTime = times + curve.firstKey;
+    uint32_t last = curve.keyCount - 1;
+    uint32_t key = playKey[i];
+    while (key > 0 && local < keyTime[key])
+      --key;
+    while (key < last && keyTime[key + 1] <= local)
+      ++key;
+    playKey[i] = key;
+
+    const uint32_t components = curve.components;
+    const float *from = keyData + static_cast<size_t>(curve.firstKey + key) * components;
+    float *target = targets[i];
+    if (key == last)
+    {
+      for (uint32_t c = 0; c < components; ++c)
+        target[c] = from[c];
+      continue;
+    }
+
+    float u = (local - keyTime[key]) * invSpans[curve.firstKey + key];
+    u = u < 0.0f ? 0.0f : (u > 1.0f ? 1.0f : u);
+    switch (eases[curve.firstKey + key])
+    {
+    case TweenEase::Step:
+      u = 0.0f;
+      break;
+    case TweenEase::Linear:
+      break;
+    case TweenEase::Cubic:
+      u = u * u * (3.0f - 2.0f * u);
+      break;
+    }
+
+    const float *to = from + components;
+    for (uint32_t c = 0; c < components; ++c)
+      target[c] = from[c] + (to[c] - from[c]) * u;
+  }
+}
+
+inline void TweenSystem::update(float deltaTime)
+{
+  updateOscillators(deltaTime);
+  updateSpins(deltaTime);
+  updateKeyframes(deltaTime);
+}
+
+inline void TweenSystem::reserve(size_t tracks)
+{
+  oscPhase.reserve(tracks);
+  oscOmega.reserve(tracks);
+  oscBase.reserve(tracks);
+  oscAmplitude.reserve(tracks);
+  oscTargets.reserve(tracks);
+  oscComponents.reserve(tracks);
+  oscIds.reserve(tracks);
+  slots.reserve(tracks);
+}
+
+inline void TweenSystem::clear()
+{
+  *this = TweenSystem();
+}
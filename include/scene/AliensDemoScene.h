@@ -3,16 +3,25 @@
 #include "Scene.h"
 #include "../nodes/Sprite2D.h"
 #include "../nodes/Animation2D.h"
+#include "../nodes/AnimationStateMachine.h"
 #include "../core/window/Window.h"
 #include "../core/Input.h"
+#include "../core/log/Logger.h"
 #include <memory>
+#include <vector>
 #include <iostream> // Added for debug output
 
 class AliensDemoScene : public Scene
 {
 public:
-  AliensDemoScene() : Scene("AliensDemo")
+  AliensDemoScene() : Scene("AliensDemo"), alienStates(alienStateMachine())
   {
+    auto arenaScope = useNodeArena();
+    if (alienStates.getMachine())
+    {
+      resolveParameters(*alienStates.getMachine());
+    }
+
     // Create the main alien sprite with all animations
     auto aliensSprite = std::make_unique<Sprite2D>(
         "AliensSprite",
@@ -22,261 +31,335 @@ public:
         6, 21 // hframes, vframes
     );
 
-    // Set up all animations for the alien sprite
-    if (aliensSprite->getAnimator())
+    // All alien sprites share one clip set; the state machine picks their clips
+    aliensSprite->setAnimationClips(alienClips());
+    if (alienStates.add(aliensSprite->getAnimator()) != AnimationStateMachine::InvalidIndex)
+    {
+      aliens.push_back(aliensSprite.get());
+    }
+
+    addNode(std::move(aliensSprite));
+  }
+
+  // Override update to handle delayed animation start
+  void update(float deltaTime = 0.0f) override
+  {
+    // Call base class update
+    Scene::update(deltaTime);
+
+    // Handle movement and animation based on input
+    handleMovement(deltaTime);
+  }
+
+  // Override handleInput to manage input handling
+  void handleInput() override
+  {
+    // Call base class input handling
+    Scene::handleInput();
+
+    // Update input system
+    Input::getInstance().update();
+  }
+
+private:
+  // State machine parameter indices resolved once from their names
+  struct AlienParameters
+  {
+    uint32_t moving = 0;
+    uint32_t running = 0;
+    uint32_t crouching = 0;
+    uint32_t jump = 0;
+    uint32_t punch = 0;
+    uint32_t kick = 0;
+  };
+  AlienParameters parameters;
+
+  // Alien sprites; alienStates instance i drives aliens[i]
+  std::vector<Sprite2D *> aliens;
+  AnimationStateBatch alienStates;
+
+  // The alien sheet's clips, built on first use and shared through the AnimationLibrary
+  static std::shared_ptr<const AnimationClipSet> alienClips()
+  {
+    auto &library = AnimationLibrary::getInstance();
+    if (auto existing = library.get("alien"))
     {
-      auto *animator = aliensSprite->getAnimator();
+      return existing;
+    }
 
-      // IDLE animation
-      animator->addAnimation("IDLE", {AnimationFrame(1, 2)}, 8.0f, true);
+    auto clips = std::make_shared<AnimationClipSet>();
 
-      // WALK animation
-      animator->addAnimation("WALK", {AnimationFrame(3, 6)}, 12.0f, true);
+    // IDLE animation
+    clips->addClip("IDLE", {AnimationFrame(1, 2)}, 8.0f, true);
 
-      // RUN animation
-      animator->addAnimation("RUN", {AnimationFrame(9, 6)}, 15.0f, true);
+    // WALK animation
+    clips->addClip("WALK", {AnimationFrame(3, 6)}, 12.0f, true);
 
-      // JUMP animation
-      animator->addAnimation("JUMP", {AnimationFrame(15, 6)}, 10.0f, false);
+    // RUN animation
+    clips->addClip("RUN", {AnimationFrame(9, 6)}, 15.0f, true);
 
-      // PUNCH animation
-      animator->addAnimation("PUNCH", {AnimationFrame(21, 2)}, 8.0f, false);
+    // JUMP animation
+    clips->addClip("JUMP", {AnimationFrame(15, 6)}, 10.0f, false);
 
-      // KICK animation
-      animator->addAnimation("KICK", {AnimationFrame(23, 2)}, 8.0f, false);
+    // PUNCH animation
+    clips->addClip("PUNCH", {AnimationFrame(21, 2)}, 8.0f, false);
 
-      // PUSH animation
-      animator->addAnimation("PUSH", {AnimationFrame(25, 6)}, 12.0f, false);
+    // KICK animation
+    clips->addClip("KICK", {AnimationFrame(23, 2)}, 8.0f, false);
 
-      // SMASH_DOWN animation
-      animator->addAnimation("SMASH_DOWN", {AnimationFrame(31, 3)}, 10.0f, false);
+    // PUSH animation
+    clips->addClip("PUSH", {AnimationFrame(25, 6)}, 12.0f, false);
 
-      // WALL_CLING animation
-      animator->addAnimation("WALL_CLING", {AnimationFrame(34, 2)}, 6.0f, true);
+    // SMASH_DOWN animation
+    clips->addClip("SMASH_DOWN", {AnimationFrame(31, 3)}, 10.0f, false);
 
-      // LEDGE_GRAB animation
-      animator->addAnimation("LEDGE_GRAB", {AnimationFrame(36, 1)}, 6.0f, true);
+    // WALL_CLING animation
+    clips->addClip("WALL_CLING", {AnimationFrame(34, 2)}, 6.0f, true);
 
-      // LEDGE_CLIMB animation
-      animator->addAnimation("LEDGE_CLIMB", {AnimationFrame(37, 3)}, 8.0f, false);
+    // LEDGE_GRAB animation
+    clips->addClip("LEDGE_GRAB", {AnimationFrame(36, 1)}, 6.0f, true);
 
-      // DANGLING animation
-      animator->addAnimation("DANGLING", {AnimationFrame(40, 4)}, 8.0f, true);
+    // LEDGE_CLIMB animation
+    clips->addClip("LEDGE_CLIMB", {AnimationFrame(37, 3)}, 8.0f, false);
 
-      // WALKING_SLOPE animation
-      animator->addAnimation("WALKING_SLOPE", {AnimationFrame(44, 6)}, 12.0f, true);
+    // DANGLING animation
+    clips->addClip("DANGLING", {AnimationFrame(40, 4)}, 8.0f, true);
 
-      // RUNNING_SLOPE animation
-      animator->addAnimation("RUNNING_SLOPE", {AnimationFrame(50, 6)}, 15.0f, true);
+    // WALKING_SLOPE animation
+    clips->addClip("WALKING_SLOPE", {AnimationFrame(44, 6)}, 12.0f, true);
 
-      // JUMP_FLIP animation
-      animator->addAnimation("JUMP_FLIP", {AnimationFrame(56, 6)}, 10.0f, false);
+    // RUNNING_SLOPE animation
+    clips->addClip("RUNNING_SLOPE", {AnimationFrame(50, 6)}, 15.0f, true);
 
-      // CROUCH_IDLE animation
-      animator->addAnimation("CROUCH_IDLE", {AnimationFrame(62, 2)}, 8.0f, true);
+    // JUMP_FLIP animation
+    clips->addClip("JUMP_FLIP", {AnimationFrame(56, 6)}, 10.0f, false);
 
-      // CROUCH_WALK animation
-      animator->addAnimation("CROUCH_WALK", {AnimationFrame(63, 6)}, 12.0f, true);
+    // CROUCH_IDLE animation
+    clips->addClip("CROUCH_IDLE", {AnimationFrame(62, 2)}, 8.0f, true);
 
-      // DIE animation
-      animator->addAnimation("DIE", {AnimationFrame(70, 6)}, 8.0f, false);
+    // CROUCH_WALK animation
+    clips->addClip("CROUCH_WALK", {AnimationFrame(63, 6)}, 12.0f, true);
 
-      // SLIDE animation
-      animator->addAnimation("SLIDE", {AnimationFrame(76, 2)}, 10.0f, false);
+    // DIE animation
+    clips->addClip("DIE", {AnimationFrame(70, 6)}, 8.0f, false);
 
-      // SWIM animation
-      animator->addAnimation("SWIM", {AnimationFrame(78, 3)}, 8.0f, true);
+    // SLIDE animation
+    clips->addClip("SLIDE", {AnimationFrame(76, 2)}, 10.0f, false);
 
-      // DAMAGE animation
-      animator->addAnimation("DAMAGE", {AnimationFrame(81, 2)}, 6.0f, false);
+    // SWIM animation
+    clips->addClip("SWIM", {AnimationFrame(78, 3)}, 8.0f, true);
 
-      // LADDER animation
-      animator->addAnimation("LADDER", {AnimationFrame(83, 4)}, 8.0f, true);
+    // DAMAGE animation
+    clips->addClip("DAMAGE", {AnimationFrame(81, 2)}, 6.0f, false);
 
-      // LAND animation
-      animator->addAnimation("LAND", {AnimationFrame(87, 3)}, 10.0f, false);
+    // LADDER animation
+    clips->addClip("LADDER", {AnimationFrame(83, 4)}, 8.0f, true);
 
-      // Start with IDLE animation
-      animator->play("IDLE");
-    }
+    // LAND animation
+    clips->addClip("LAND", {AnimationFrame(87, 3)}, 10.0f, false);
 
-    addNode(std::move(aliensSprite));
+    library.add("alien", clips);
+    return clips;
   }
 
-  // Override update to handle delayed animation start
-  void update(float deltaTime = 0.0f) override
+  // Locomotion picks one of five looping states from the movement flags;
+  // actions interrupt any state and return to idle when their clip ends
+  static std::shared_ptr<const AnimationStateMachine> alienStateMachine()
   {
-    // Call base class update
-    Scene::update(deltaTime);
+    static std::shared_ptr<const AnimationStateMachine> machine;
+    if (machine)
+    {
+      return machine;
+    }
 
-    // Handle movement and animation based on input
-    handleMovement(deltaTime);
+    AnimationStateMachineBuilder builder;
+    builder.addBool("moving");
+    builder.addBool("running");
+    builder.addBool("crouching");
+    builder.addTrigger("jump");
+    builder.addTrigger("punch");
+    builder.addTrigger("kick");
+
+    builder.addState("idle", "IDLE");
+    builder.addState("walk", "WALK");
+    builder.addState("run", "RUN");
+    builder.addState("crouchIdle", "CROUCH_IDLE");
+    builder.addState("crouchWalk", "CROUCH_WALK");
+    builder.addState("jump", "JUMP");
+    builder.addState("punch", "PUNCH");
+    builder.addState("kick", "KICK");
+
+    builder.addAnyTransition("jump").when("jump");
+    builder.addAnyTransition("punch").when("punch");
+    builder.addAnyTransition("kick").when("kick");
+
+    const char *locomotion[] = {"idle", "walk", "run", "crouchIdle", "crouchWalk"};
+    for (const char *from : locomotion)
+    {
+      std::string state = from;
+      if (state != "crouchWalk")
+        builder.addTransition(from, "crouchWalk").when("crouching").when("moving");
+      if (state != "crouchIdle")
+        builder.addTransition(from, "crouchIdle").when("crouching").whenNot("moving");
+      if (state != "run")
+        builder.addTransition(from, "run").whenNot("crouching").when("moving").when("running");
+      if (state != "walk")
+        builder.addTransition(from, "walk").whenNot("crouching").when("moving").whenNot("running");
+      if (state != "idle")
+        builder.addTransition(from, "idle").whenNot("crouching").whenNot("moving");
+    }
+
+    const char *actions[] = {"jump", "punch", "kick"};
+    for (const char *from : actions)
+    {
+      builder.addTransition(from, "idle").whenClipFinished();
+    }
+
+    machine = builder.compile(*alienClips());
+    return machine;
   }
 
-  // Override handleInput to manage input handling
-  void handleInput() override
+  void resolveParameters(const AnimationStateMachine &machine)
   {
-    // Call base class input handling
-    Scene::handleInput();
-
-    // Update input system
-    Input::getInstance().update();
+    parameters.moving = machine.findParameter("moving");
+    parameters.running = machine.findParameter("running");
+    parameters.crouching = machine.findParameter("crouching");
+    parameters.jump = machine.findParameter("jump");
+    parameters.punch = machine.findParameter("punch");
+    parameters.kick = machine.findParameter("kick");
   }
 
-private:
   float startTimer = 0.0f;
   bool animationsStarted = false;
   float moveSpeed = 100.0f; // pixels per second
   bool facingRight = true;
 
   void handleMovement(float deltaTime)
+  {
+    for (uint32_t i = 0; i < aliens.size(); ++i)
+    {
+      handleSpriteMovement(aliens[i], i, deltaTime);
+    }
+
+    // One pass over every alien's state; clips change only on transitions
+    size_t transitions = alienStates.update();
+    if (transitions > 0)
+    {
+      LOG_DEBUG(Scene, "Animation state transitions: {}", transitions);
+    }
+  }
+
+  void handleSpriteMovement(Sprite2D *sprite, uint32_t instance, float deltaTime)
   {
     auto &input = Input::getInstance();
-    auto rootNode = getRoot();
 
-    if (!rootNode)
-      return;
+    // Get current position
+    Position2D currentPos = sprite->getPosition();
+    Position2D originalPos = currentPos; // Store original position for comparison
+    bool isMoving = false;
+    bool isRunning = false;
+
+    // Debug: Check if any movement keys are pressed
+    bool leftPressed = input.isActionPressed("move_left");
+    bool rightPressed = input.isActionPressed("move_right");
+    bool upPressed = input.isActionPressed("move_up");
+    bool downPressed = input.isActionPressed("move_down");
+
+    if (leftPressed || rightPressed || upPressed || downPressed)
+    {
+      LOG_DEBUG(Scene, "Input detected - Left: {}, Right: {}, Up: {}, Down: {}", leftPressed, rightPressed, upPressed, downPressed);
+      LOG_DEBUG(Scene, "Current sprite position: ({}, {})", currentPos.x, currentPos.y);
+      LOG_DEBUG(Scene, "Delta time: {}", deltaTime);
+      LOG_DEBUG(Scene, "Move speed: {}", moveSpeed);
+    }
+
+    // Handle horizontal movement
+    if (leftPressed)
+    {
+      currentPos.x -= moveSpeed * deltaTime;
+      isMoving = true;
+      facingRight = false;
+      LOG_DEBUG(Scene, "Moving left - Position change: ({} -> {}, {})", originalPos.x, currentPos.x, currentPos.y);
+    }
+    else if (rightPressed)
+    {
+      currentPos.x += moveSpeed * deltaTime;
+      isMoving = true;
+      facingRight = true;
+      LOG_DEBUG(Scene, "Moving right - Position change: ({} -> {}, {})", originalPos.x, currentPos.x, currentPos.y);
+    }
 
-    for (auto &child : rootNode->getChildren())
+    // Handle vertical movement
+    if (upPressed)
     {
-      if (auto sprite = dynamic_cast<Sprite2D *>(child.get()))
+      currentPos.y += moveSpeed * deltaTime;
+      isMoving = true;
+      LOG_DEBUG(Scene, "Moving up - Position change: ({} -> {})", originalPos.y, currentPos.y);
+    }
+    else if (downPressed)
+    {
+      currentPos.y -= moveSpeed * deltaTime;
+      isMoving = true;
+      LOG_DEBUG(Scene, "Moving down - Position change: ({} -> {})", originalPos.y, currentPos.y);
+    }
+
+    // Handle running (hold shift while moving)
+    if (input.isKeyPressed(340)) // Left Shift key
+    {
+      if (isMoving)
       {
-        // Get current position
-        Position2D currentPos = sprite->getPosition();
-        Position2D originalPos = currentPos; // Store original position for comparison
-        bool isMoving = false;
-        bool isRunning = false;
-        std::string targetAnimation = "IDLE";
-
-        // Debug: Check if any movement keys are pressed
-        bool leftPressed = input.isActionPressed("move_left");
-        bool rightPressed = input.isActionPressed("move_right");
-        bool upPressed = input.isActionPressed("move_up");
-        bool downPressed = input.isActionPressed("move_down");
-
-        if (leftPressed || rightPressed || upPressed || downPressed)
-        {
-          std::cout << "Input detected - Left: " << leftPressed
-                    << ", Right: " << rightPressed
-                    << ", Up: " << upPressed
-                    << ", Down: " << downPressed << std::endl;
-          std::cout << "Current sprite position: (" << currentPos.x << ", " << currentPos.y << ")" << std::endl;
-          std::cout << "Delta time: " << deltaTime << std::endl;
-          std::cout << "Move speed: " << moveSpeed << std::endl;
-        }
-
-        // Handle horizontal movement
-        if (leftPressed)
-        {
-          currentPos.x -= moveSpeed * deltaTime;
-          isMoving = true;
-          facingRight = false;
-          std::cout << "Moving left - Position change: (" << originalPos.x << " -> " << currentPos.x << ", " << currentPos.y << ")" << std::endl;
-        }
-        else if (rightPressed)
-        {
-          currentPos.x += moveSpeed * deltaTime;
-          isMoving = true;
-          facingRight = true;
-          std::cout << "Moving right - Position change: (" << originalPos.x << " -> " << currentPos.x << ", " << currentPos.y << ")" << std::endl;
-        }
-
-        // Handle vertical movement
-        if (upPressed)
-        {
-          currentPos.y += moveSpeed * deltaTime;
-          isMoving = true;
-          std::cout << "Moving up - Position change: (" << originalPos.y << " -> " << currentPos.y << ")" << std::endl;
-        }
-        else if (downPressed)
-        {
-          currentPos.y -= moveSpeed * deltaTime;
-          isMoving = true;
-          std::cout << "Moving down - Position change: (" << originalPos.y << " -> " << currentPos.y << ")" << std::endl;
-        }
-
-        // Handle running (hold shift while moving)
-        if (input.isKeyPressed(340)) // Left Shift key
-        {
-          if (isMoving)
-          {
-            isRunning = true;
-            moveSpeed = 200.0f; // Faster speed when running
-          }
-        }
-        else
-        {
-          moveSpeed = 100.0f; // Normal speed
-        }
-
-        // Handle action inputs
-        if (input.isActionJustPressed("jump"))
-        {
-          targetAnimation = "JUMP";
-          std::cout << "JUMP action triggered!" << std::endl;
-        }
-        else if (input.isActionJustPressed("punch"))
-        {
-          targetAnimation = "PUNCH";
-          std::cout << "PUNCH action triggered!" << std::endl;
-        }
-        else if (input.isActionJustPressed("kick"))
-        {
-          targetAnimation = "KICK";
-          std::cout << "KICK action triggered!" << std::endl;
-        }
-        else if (input.isActionPressed("crouch"))
-        {
-          if (isMoving)
-            targetAnimation = "CROUCH_WALK";
-          else
-            targetAnimation = "CROUCH_IDLE";
-        }
-        else if (isMoving)
-        {
-          if (isRunning)
-            targetAnimation = "RUN";
-          else
-            targetAnimation = "WALK";
-        }
-        else
-        {
-          targetAnimation = "IDLE";
-        }
-
-                // Debug: Verify position was actually set
-        Position2D newPos = sprite->getPosition();
-        if (newPos.x != originalPos.x || newPos.y != originalPos.y)
-        {
-          std::cout << "Sprite position updated: (" << originalPos.x << ", " << originalPos.y << ") -> (" << newPos.x << ", " << newPos.y << ")" << std::endl;
-        }
-        else if (leftPressed || rightPressed || upPressed || downPressed)
-        {
-          std::cout << "WARNING: Position didn't change despite movement input!" << std::endl;
-        }
-
-        // Update sprite position
-        sprite->setPosition(newPos);
-
-        // Update sprite scale based on facing direction
-        Scale2D currentScale = sprite->getScale();
-        if (facingRight && currentScale.x < 0)
-        {
-          sprite->setScale(Scale2D(-currentScale.x, currentScale.y));
-        }
-        else if (!facingRight && currentScale.x > 0)
-        {
-          sprite->setScale(Scale2D(-currentScale.x, currentScale.y));
-        }
-
-        // Play appropriate animation
-        std::string currentAnim = sprite->getCurrentAnimation();
-        if (currentAnim != targetAnimation)
-        {
-          sprite->playAnimation(targetAnimation);
-          std::cout << "Animation changed from " << currentAnim << " to " << targetAnimation << std::endl;
-        }
+        isRunning = true;
+        moveSpeed = 200.0f; // Faster speed when running
       }
     }
+    else
+    {
+      moveSpeed = 100.0f; // Normal speed
+    }
+
+    // Feed the state machine; it picks the clip in handleMovement
+    if (input.isActionJustPressed("jump"))
+    {
+      alienStates.setTrigger(instance, parameters.jump);
+      LOG_DEBUG(Scene, "JUMP action triggered!");
+    }
+    else if (input.isActionJustPressed("punch"))
+    {
+      alienStates.setTrigger(instance, parameters.punch);
+      LOG_DEBUG(Scene, "PUNCH action triggered!");
+    }
+    else if (input.isActionJustPressed("kick"))
+    {
+      alienStates.setTrigger(instance, parameters.kick);
+      LOG_DEBUG(Scene, "KICK action triggered!");
+    }
+    alienStates.setBool(instance, parameters.moving, isMoving);
+    alienStates.setBool(instance, parameters.running, isRunning);
+    alienStates.setBool(instance, parameters.crouching, input.isActionPressed("crouch"));
+
+            // Debug: Verify position was actually set
+    Position2D newPos = sprite->getPosition();
+    if (newPos.x != originalPos.x || newPos.y != originalPos.y)
+    {
+      LOG_DEBUG(Scene, "Sprite position updated: ({}, {}) -> ({}, {})", originalPos.x, originalPos.y, newPos.x, newPos.y);
+    }
+    else if (leftPressed || rightPressed || upPressed || downPressed)
+    {
+      LOG_WARNING(Scene, "Position didn't change despite movement input!");
+    }
+
+    // Update sprite position
+    sprite->setPosition(newPos);
+
+    // Update sprite scale based on facing direction
+    Scale2D currentScale = sprite->getScale();
+    if (facingRight && currentScale.x < 0)
+    {
+      sprite->setScale(Scale2D(-currentScale.x, currentScale.y));
+    }
+    else if (!facingRight && currentScale.x > 0)
+    {
+      sprite->setScale(Scale2D(-currentScale.x, currentScale.y));
+    }
   }
 };
@@ -10,6 +10,8 @@ class ColorfulScene : public Scene
 public:
   ColorfulScene() : Scene("ColorfulScene")
   {
+    auto arenaScope = useNodeArena();
+
     // Create first alien sprite with IDLE and WALK animations
     auto alien1 = std::make_unique<Sprite2D>(
         "Alien1",
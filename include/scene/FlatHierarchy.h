@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Forward declarations
+class Node;
+
+// Depth-first, contiguous mirror of a node hierarchy.
+// Node i's subtree occupies [i, i + subtreeSize[i]) and its first child (if any)
+// is at i + 1, so update/render become a linear loop with no recursion and no
+// pointer chasing through child vectors. Removed nodes leave tombstones (nullptr)
+// that are squeezed out by compact() once they make up a large enough share.
+//
+// Nodes should queue structural changes on the SceneCommandBuffer from
+// update(). Direct edits made while update() runs do not move any element:
+// removals only leave tombstones, and insertions and moves are applied by one
+// rebuild after the loop. Nodes added that way are not updated until the
+// next frame.
+class FlatHierarchy
+{
+private:
+  std::vector<Node *> nodes;           // Depth-first order, nullptr = tombstone
+  std::vector<int32_t> parentIndices;  // -1 for the root
+  std::vector<uint32_t> subtreeSizes;  // Including the node itself and tombstones in range
+  size_t deadCount;
+  bool updating;       // Inside update(): edits must not shift elements
+  bool rebuildPending; // An insertion or move arrived during update()
+
+public:
+  static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+  FlatHierarchy() : deadCount(0), updating(false), rebuildPending(false) {}
+
+  FlatHierarchy(const FlatHierarchy &) = delete;
+  FlatHierarchy &operator=(const FlatHierarchy &) = delete;
+
+  // Rebuild from a pointer tree (iterative, no recursion)
+  void build(Node *root);
+
+  // Incremental maintenance, called by SceneTree
+  void insertSubtree(Node *node);             // node already added to its parent's children
+  void removeSubtree(Node *node);             // leaves tombstones
+  void moveSubtree(Node *node, Node *newParent); // relink a subtree under a new parent
+
+  // Drop tombstones and renumber
+  void compact();
+
+  // Traversal in the same order as Node::updateRecursive / renderRecursive
+  void update(float deltaTime);
+  void render() const;
+
+  // Array access
+  size_t size() const { return nodes.size(); }
+  size_t getDeadCount() const { return deadCount; }
+  Node *getNode(size_t index) const { return nodes[index]; }
+  int32_t getParentIndex(size_t index) const { return parentIndices[index]; }
+  uint32_t getSubtreeSize(size_t index) const { return subtreeSizes[index]; }
+  int32_t getFirstChildIndex(size_t index) const { return subtreeSizes[index] > 1 ? static_cast<int32_t>(index + 1) : -1; }
+
+private:
+  // Append the depth-first layout of a subtree to the given arrays
+  void appendSubtree(Node *node, int32_t parentIndex, uint32_t firstIndex,
+                     std::vector<Node *> &outNodes, std::vector<int32_t> &outParents,
+                     std::vector<uint32_t> &outSizes) const;
+
+  void compactIfNeeded()
+  {
+    // Keep tombstones below a quarter of the array
+    if (!updating && deadCount > 64 && deadCount * 4 > nodes.size())
+    {
+      compact();
+    }
+  }
+};
@@ -12,6 +12,8 @@ private:
 public:
   MinimalScene() : Scene("MinimalScene"), moveSpeed(200.0f)
   {
+    auto arenaScope = useNodeArena();
+
     // Create a simple red rectangle
     auto rect = std::make_unique<Rectangle>(
         "TestRectangle",
@@ -29,20 +31,9 @@ public:
   {
     std::cout << "MinimalScene::handleInput() called" << std::endl;
 
-    // Find the rectangle by name
-    Rectangle *testRectangle = nullptr;
-    auto rootNode = getRoot();
-    if (rootNode)
-    {
-      for (auto &child : rootNode->getChildren())
-      {
-        if (child->getName() == "TestRectangle")
-        {
-          testRectangle = dynamic_cast<Rectangle *>(child.get());
-          break;
-        }
-      }
-    }
+    // Find the rectangle by its interned name
+    static const StringId testRectangleId = StringTable::getInstance().intern("TestRectangle");
+    Rectangle *testRectangle = nodeCast<Rectangle>(findNode(testRectangleId));
 
     if (!testRectangle)
     {
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "../core/render/RenderDevice.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+constexpr size_t RenderLayerCount = 8;
+
+// What the last Scene::render did with the layers
+struct RenderLayerStats
+{
+  size_t redraws = 0;      // Static layers rendered into their target
+  size_t composites = 0;   // Static layers drawn as one cached quad
+  size_t directLayers = 0; // Static layers that could not be cached and were drawn node by node
+};
+
+// Render layers of a SceneTree, drawn in increasing order. Nodes pick one with
+// Node::setRenderLayer (children inherit it). A static layer is rendered once
+// into an offscreen target covering the view plus a margin, then composited
+// with a single quad until one of its nodes changes through a setter, a node
+// joins or leaves it, or the view leaves the cached region or changes zoom.
+// Nodes animated by their own update, the AnimationSystem or the TweenSystem
+// write their state directly and belong on a dynamic layer (or call
+// Node::markRenderDirty after changing).
+class RenderLayers
+{
+private:
+  struct Layer
+  {
+    bool isStatic = false;
+    bool dirty = true;
+    bool cached = false; // The target holds the layer for the region below
+    unsigned int target = 0;
+    int targetWidth = 0;
+    int targetHeight = 0;
+    float left = 0.0f, top = 0.0f, right = 0.0f, bottom = 0.0f;
+    float zoom = 0.0f;
+  };
+
+  Layer layers[RenderLayerCount];
+  uint32_t usedLayers;
+  size_t staticCount;
+
+  bool hasView;
+  float viewLeft, viewTop, viewRight, viewBottom, viewZoom;
+  float margin;            // Fraction of the view size cached beyond each edge
+  bool targetsUnsupported; // The driver returned no render target
+  RenderLayerStats stats;
+
+public:
+  // Largest target edge in pixels; bigger regions are drawn directly
+  static constexpr int MaxTargetSize = 4096;
+
+  RenderLayers()
+      : usedLayers(1), staticCount(0), hasView(false), viewLeft(0.0f), viewTop(0.0f), viewRight(0.0f),
+        viewBottom(0.0f), viewZoom(1.0f), margin(0.25f), targetsUnsupported(false) {}
+
+  ~RenderLayers() { releaseTargets(); }
+
+  RenderLayers(const RenderLayers &) = delete;
+  RenderLayers &operator=(const RenderLayers &) = delete;
+
+  void setStatic(size_t layer, bool enable);
+  bool isStatic(size_t layer) const { return layer < RenderLayerCount && layers[layer].isStatic; }
+  bool hasStaticLayers() const { return staticCount > 0; }
+
+  // Layers any node has been put on (layer 0 always counts)
+  void noteLayer(size_t layer)
+  {
+    if (layer < RenderLayerCount)
+      usedLayers |= 1u << layer;
+  }
+  bool isUsed(size_t layer) const { return layer < RenderLayerCount && (usedLayers >> layer & 1u) != 0; }
+
+  // Re-render a static layer on the next frame
+  void invalidate(size_t layer)
+  {
+    if (layer < RenderLayerCount)
+      layers[layer].dirty = true;
+  }
+  void invalidateAll()
+  {
+    for (Layer &entry : layers)
+      entry.dirty = true;
+  }
+
+  // World-space rectangle on screen and its pixels per unit, e.g. from
+  // Camera::getLeft/getTop/getRight/getBottom/getZoom. Without a view static
+  // layers are drawn directly.
+  void setView(float left, float top, float right, float bottom, float zoom = 1.0f)
+  {
+    hasView = right > left && bottom > top && zoom > 0.0f;
+    viewLeft = left;
+    viewTop = top;
+    viewRight = right;
+    viewBottom = bottom;
+    viewZoom = zoom;
+  }
+  void setMargin(float fraction) { margin = fraction > 0.0f ? fraction : 0.0f; }
+  float getMargin() const { return margin; }
+
+  // Used by Scene::render, in this order for each static layer:
+  // needsRedraw, then beginRedraw/endRedraw around the layer's nodes when it
+  // returned true (false means draw them directly and skip the composite),
+  // then composite
+  void beginFrame() { stats = RenderLayerStats(); }
+  bool needsRedraw(size_t layer) const;
+  bool beginRedraw(size_t layer);
+  void endRedraw(size_t layer);
+  void composite(size_t layer);
+
+  const RenderLayerStats &getStats() const { return stats; }
+  unsigned int getTarget(size_t layer) const { return layer < RenderLayerCount ? layers[layer].target : 0; }
+
+  // Free every target (they are recreated on the next redraw)
+  void releaseTargets();
+};
+
+// Implementation
+inline void RenderLayers::setStatic(size_t layer, bool enable)
+{
+  if (layer >= RenderLayerCount || layers[layer].isStatic == enable)
+    return;
+
+  Layer &entry = layers[layer];
+  entry.isStatic = enable;
+  entry.dirty = true;
+  if (enable)
+  {
+    staticCount++;
+    return;
+  }
+
+  staticCount--;
+  if (entry.target != 0)
+    RenderDevice::getInstance().deleteRenderTarget(entry.target);
+  entry = Layer();
+}
+
+inline bool RenderLayers::needsRedraw(size_t layer) const
+{
+  const Layer &entry = layers[layer];
+  return entry.dirty || !entry.cached || !hasView || entry.zoom != viewZoom || viewLeft < entry.left ||
+         viewTop < entry.top || viewRight > entry.right || viewBottom > entry.bottom;
+}
+
+inline bool RenderLayers::beginRedraw(size_t layer)
+{
+  Layer &entry = layers[layer];
+  entry.cached = false;
+
+  float marginX = (viewRight - viewLeft) * margin;
+  float marginY = (viewBottom - viewTop) * margin;
+  int width = static_cast<int>(std::ceil((viewRight - viewLeft + 2.0f * marginX) * viewZoom));
+  int height = static_cast<int>(std::ceil((viewBottom - viewTop + 2.0f * marginY) * viewZoom));
+  if (!hasView || targetsUnsupported || width > MaxTargetSize || height > MaxTargetSize)
+  {
+    stats.directLayers++;
+    return false;
+  }
+
+  RenderDevice &renderDevice = RenderDevice::getInstance();
+  if (entry.target == 0 || entry.targetWidth != width || entry.targetHeight != height)
+  {
+    if (entry.target != 0)
+      renderDevice.deleteRenderTarget(entry.target);
+    entry.target = renderDevice.createRenderTarget(width, height);
+    entry.targetWidth = width;
+    entry.targetHeight = height;
+    if (entry.target == 0)
+    {
+      targetsUnsupported = true;
+      stats.directLayers++;
+      return false;
+    }
+  }
+
+  // Snap the region to whole pixels so the composite lines up with direct drawing
+  entry.left = viewLeft - marginX;
+  entry.top = viewTop - marginY;
+  entry.right = entry.left + width / viewZoom;
+  entry.bottom = entry.top + height / viewZoom;
+  if (!renderDevice.beginRenderTarget(entry.target, entry.left, entry.top, entry.right, entry.bottom))
+  {
+    stats.directLayers++;
+    return false;
+  }
+
+  entry.zoom = viewZoom;
+  entry.dirty = false;
+  entry.cached = true;
+  stats.redraws++;
+  return true;
+}
+
+inline void RenderLayers::endRedraw(size_t)
+{
+  RenderDevice::getInstance().endRenderTarget();
+}
+
+inline void RenderLayers::composite(size_t layer)
+{
+  const Layer &entry = layers[layer];
+  if (!entry.cached)
+    return;
+
+  RenderDevice &renderDevice = RenderDevice::getInstance();
+  renderDevice.resetTransform();
+  renderDevice.setColor(1.0f, 1.0f, 1.0f);
+  renderDevice.drawSprite(entry.left, entry.top, entry.right - entry.left, entry.bottom - entry.top, entry.target,
+                          0.0f, 1.0f, 1.0f, 0.0f);
+  stats.composites++;
+}
+
+inline void RenderLayers::releaseTargets()
+{
+  for (Layer &entry : layers)
+  {
+    if (entry.target != 0)
+      RenderDevice::getInstance().deleteRenderTarget(entry.target);
+    entry.target = 0;
+    entry.targetWidth = entry.targetHeight = 0;
+    entry.cached = false;
+  }
+  targetsUnsupported = false;
+}
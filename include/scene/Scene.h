@@ -1,25 +1,45 @@
 #pragma once
 
 #include "../nodes/Node.h"
+#include "../core/memory/NodeArena.h"
+#include "SceneTree.h"
+#include "../core/profile/Profiler.h"
+#include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 
 // Scene class to manage nodes
 class Scene
 {
 private:
   std::string name;
+  std::unique_ptr<NodeArena, NodeArena::Deleter> nodeArena; // Must outlive rootNode
+  std::unique_ptr<SceneTree> sceneTree;                     // Heap-allocated so nodes can keep pointing at it across moves
   std::unique_ptr<RootNode> rootNode;
+  float pendingStallMs = 0.0f; // See injectStall
+
+  // The root always lives on the heap so clear() can release the arena in bulk
+  static std::unique_ptr<RootNode> createRoot()
+  {
+    NodeArena::Scope heapScope(nullptr);
+    return std::make_unique<RootNode>("Root");
+  }
 
 public:
   Scene(const std::string &sceneName = "Default Scene")
-      : name(sceneName), rootNode(std::make_unique<RootNode>("Root")) {}
+      : name(sceneName), nodeArena(new NodeArena()), sceneTree(std::make_unique<SceneTree>()), rootNode(createRoot())
+  {
+    sceneTree->setRoot(rootNode.get());
+  }
 
   virtual ~Scene() = default;
 
   // Move constructor
   Scene(Scene &&other) noexcept
-      : name(std::move(other.name)), rootNode(std::move(other.rootNode)) {}
+      : name(std::move(other.name)), nodeArena(std::move(other.nodeArena)),
+        sceneTree(std::move(other.sceneTree)), rootNode(std::move(other.rootNode)),
+        pendingStallMs(other.pendingStallMs) {}
 
   // Move assignment operator
   Scene &operator=(Scene &&other) noexcept
@@ -27,7 +47,11 @@ public:
     if (this != &other)
     {
       name = std::move(other.name);
+      // Tear down our old tree before the arena holding it
       rootNode = std::move(other.rootNode);
+      sceneTree = std::move(other.sceneTree);
+      nodeArena = std::move(other.nodeArena);
+      pendingStallMs = other.pendingStallMs;
     }
     return *this;
   }
@@ -39,15 +63,54 @@ public:
   // Add nodes to the scene
   void addNode(std::unique_ptr<Node> node);
 
-  // Remove nodes (by name)
+  // Remove the first root child with that name
   std::unique_ptr<Node> removeNode(const std::string &nodeName);
 
+  // Find nodes anywhere in the scene without walking the hierarchy
+  Node *findNode(StringId nameId) const { return sceneTree->findNode(nameId); }
+  Node *findNode(const std::string &nodeName) const { return sceneTree->findNode(nodeName); }
+  Node *findPath(const std::string &path) const { return sceneTree->findPath(path); }
+
+  // Traverse through a depth-first FlatHierarchy instead of recursing through children
+  void setFlatTraversal(bool enable) { sceneTree->enableFlatHierarchy(enable); }
+  bool isFlatTraversal() const { return sceneTree->getFlatHierarchy() != nullptr; }
+
+  // Advance sprite animations in one batched pass after the node updates
+  void setBatchedAnimation(bool enable) { sceneTree->enableAnimationSystem(enable); }
+  bool isBatchedAnimation() const { return sceneTree->getAnimationSystem() != nullptr; }
+  AnimationSystem *getAnimationSystem() const { return sceneTree->getAnimationSystem(); }
+
+  // Keyframe, oscillator and spin tracks on node properties, advanced in one
+  // pass after the node updates; clear() drops them with the nodes
+  TweenSystem &getTweens() { return sceneTree->getTweens(); }
+
+  // Render layers; making one static caches it offscreen (see RenderLayers).
+  // Feed it the camera view each frame with getLayers().setView(...)
+  RenderLayers &getLayers() { return sceneTree->getLayers(); }
+
+  // Deferred spawn/destroy/reparent; the game loop flushes once per frame before rendering
+  SceneCommandBuffer &getCommands() { return sceneTree->getCommands(); }
+  size_t flushCommands() { return sceneTree->flushCommands(); }
+
+  // Visit every node of type T (or derived) in the scene, e.g. each<Sprite2D>(fn)
+  template <typename T, typename Fn>
+  void each(Fn &&fn) const { sceneTree->each<T>(std::forward<Fn>(fn)); }
+
+  // Block the next update() for the given time (hitch capture testing)
+  void injectStall(float milliseconds) { pendingStallMs = milliseconds; }
+
   // Clear all nodes
-  void clear() { rootNode->removeAllChildren(); }
+  void clear();
+
+  // Make the scene's node arena current, so nodes created while the returned
+  // scope is alive are bump-allocated and released together with the scene
+  NodeArena::Scope useNodeArena() { return NodeArena::Scope(nodeArena.get()); }
+  const NodeArena *getNodeArena() const { return nodeArena.get(); }
 
   // Get scene info
   const std::string &getName() const { return name; }
   size_t getNodeCount() const { return rootNode->getChildCount(); }
+  size_t getTotalNodeCount() const { return sceneTree->getNodeCount(); }
 
   // Get root node
   RootNode *getRoot() { return rootNode.get(); }
@@ -55,6 +118,11 @@ public:
 
   // Render all nodes in the scene
   void render() const;
+  const RenderLayerStats *getLayerStats() const
+  {
+    RenderLayers *layers = sceneTree->getRenderLayers();
+    return layers ? &layers->getStats() : nullptr;
+  }
 
   // Update all nodes in the scene
   virtual void update(float deltaTime = 0.0f);
@@ -79,25 +147,101 @@ inline void Scene::addNode(std::unique_ptr<Node> node)
 
 inline std::unique_ptr<Node> Scene::removeNode(const std::string &nodeName)
 {
-  // Search through children to find node with matching name
-  for (auto &child : rootNode->getChildren())
+  // The first root child with that name, found through the tree's child index
+  Node *node = sceneTree->findChild(rootNode.get(), nodeName);
+  if (!node)
   {
-    if (child->getName() == nodeName)
-    {
-      return rootNode->removeChild(child.get());
-    }
+    return nullptr;
+  }
+  return rootNode->removeChild(node);
+}
+
+inline void Scene::clear()
+{
+  if (auto tweens = sceneTree->getTweenSystem())
+  {
+    tweens->clear();
+  }
+  rootNode->removeAllChildren();
+  sceneTree->getCommands().clear();
+
+  // Hand all arena blocks back at once (skipped if a removed node is still alive elsewhere)
+  if (nodeArena)
+  {
+    nodeArena->reset();
   }
-  return nullptr;
 }
 
 inline void Scene::render() const
 {
+  // With a static layer, draw layer by layer (this walks the tree, not the FlatHierarchy)
+  RenderLayers *layers = sceneTree->getRenderLayers();
+  if (layers && layers->hasStaticLayers())
+  {
+    layers->beginFrame();
+    for (size_t layer = 0; layer < RenderLayerCount; ++layer)
+    {
+      if (!layers->isUsed(layer))
+        continue;
+
+      int index = static_cast<int>(layer);
+      if (!layers->isStatic(layer))
+      {
+        rootNode->renderLayerRecursive(index, 0);
+        continue;
+      }
+
+      if (layers->needsRedraw(layer))
+      {
+        PROFILE_SCOPE("RenderLayers::redraw");
+        bool offscreen = layers->beginRedraw(layer);
+        rootNode->renderLayerRecursive(index, 0);
+        if (!offscreen)
+          continue;
+        layers->endRedraw(layer);
+      }
+      layers->composite(layer);
+    }
+    return;
+  }
+
+  if (auto flat = sceneTree->getFlatHierarchy())
+  {
+    flat->render();
+    return;
+  }
   rootNode->renderRecursive();
 }
 
 inline void Scene::update(float deltaTime)
 {
-  rootNode->updateRecursive(deltaTime);
+  if (pendingStallMs > 0.0f)
+  {
+    PROFILE_SCOPE("Scene::injectedStall");
+    std::this_thread::sleep_for(std::chrono::duration<float, std::milli>(pendingStallMs));
+    pendingStallMs = 0.0f;
+  }
+
+  if (auto flat = sceneTree->getFlatHierarchy())
+  {
+    flat->update(deltaTime);
+  }
+  else
+  {
+    rootNode->updateRecursive(deltaTime);
+  }
+
+  if (auto animations = sceneTree->getAnimationSystem())
+  {
+    PROFILE_SCOPE("AnimationSystem::update");
+    animations->update(deltaTime);
+  }
+
+  if (auto tweens = sceneTree->getTweenSystem())
+  {
+    PROFILE_SCOPE("TweenSystem::update");
+    tweens->update(deltaTime);
+  }
 }
 
 inline void Scene::handleInput()
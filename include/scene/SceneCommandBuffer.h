@@ -0,0 +1,112 @@
+#pragma once
+
+#include "../core/WorkerPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Forward declarations
+class Node;
+
+// Deferred structural changes (spawn / destroy / reparent) for a SceneTree.
+// Adding or removing children while update() walks the hierarchy invalidates
+// the iteration, so nodes queue the change here instead and the game loop
+// applies everything in one flush between update and render.
+//
+// Commands are written to lanes: one lane per writing thread. By default the
+// lane is the calling thread's WorkerPool::getWorkerIndex() (0 on the main
+// thread). A lane has a single writer, so queueing never locks or contends.
+// Lanes are applied in lane order and each lane in the order it was written.
+// The flush is deterministic as long as work is assigned to lanes
+// deterministically; parallelFor hands ranges to whichever worker is free, so
+// jobs that need a stable order pass their own lane (e.g. from the range).
+//
+// Targets and parents must be attached to the tree that owns the buffer.
+// When a subtree leaves the tree before the flush (removeChild, removeNode,
+// or an ancestor being removed), the commands that point into it are dropped,
+// so the flush never touches a node that may since have been deleted.
+class SceneCommandBuffer
+{
+public:
+  static constexpr uint32_t MaxLanes = 64;
+
+private:
+  enum class CommandType : uint8_t
+  {
+    Spawn,
+    Destroy,
+    Reparent,
+    Dropped // Pointed into a subtree that left the tree before the flush
+  };
+
+  struct Command
+  {
+    CommandType type;
+    Node *target; // Destroy / Reparent
+    Node *parent; // Spawn / Reparent destination
+    Node *node;   // Spawn (owned until flushed or cleared)
+  };
+
+  // Each lane on its own cache line so writers on different threads do not share one
+  struct alignas(64) Lane
+  {
+    std::vector<Command> commands;
+  };
+
+  Lane lanes[MaxLanes];
+
+  // Reused between flushes
+  std::vector<Node *> destroyList;
+  std::vector<Node *> doomed;
+  std::vector<Node *> keep;
+  std::vector<Node *> parents;
+  std::vector<Node *> graveyard;
+  std::vector<uint8_t> taken;
+
+public:
+  SceneCommandBuffer() = default;
+  ~SceneCommandBuffer();
+
+  SceneCommandBuffer(const SceneCommandBuffer &) = delete;
+  SceneCommandBuffer &operator=(const SceneCommandBuffer &) = delete;
+
+  // Lane of the calling thread
+  static uint32_t currentLane() { return static_cast<uint32_t>(WorkerPool::getWorkerIndex()); }
+
+  // Queue a new node to be added to parent's children
+  void spawn(Node *parent, std::unique_ptr<Node> node, uint32_t lane = currentLane());
+
+  // Queue a node (and its subtree) for removal and deletion
+  void destroy(Node *node, uint32_t lane = currentLane());
+
+  // Queue a move of node under newParent
+  void reparent(Node *node, Node *newParent, uint32_t lane = currentLane());
+
+  // Apply every queued command. Spawns and reparents run first in lane order;
+  // destroys run last so every pointer stays valid until then. Must be called
+  // from the main thread while no other thread is writing.
+  // Returns the number of commands applied.
+  size_t flush();
+
+  // Drop all queued commands (pending spawns are deleted)
+  void clear();
+
+  // Drop the commands whose target or parent is node or one of its
+  // descendants (called by SceneTree when the subtree is detached)
+  void dropSubtree(const Node *node);
+
+private:
+  bool isValidLane(uint32_t lane) const;
+
+public:
+  size_t getPendingCount() const
+  {
+    size_t count = 0;
+    for (const auto &lane : lanes)
+    {
+      count += lane.commands.size();
+    }
+    return count;
+  }
+};
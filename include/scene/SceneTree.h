@@ -0,0 +1,186 @@
+#pragma once
+
+#include "../core/StringTable.h"
+#include "../nodes/AnimationSystem.h"
+#include "../nodes/TweenSystem.h"
+#include "../nodes/NodeType.h"
+#include "FlatHierarchy.h"
+#include "RenderLayers.h"
+#include "SceneCommandBuffer.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations
+class Node;
+
+// Per-scene registry of the nodes currently attached under the scene root.
+// Nodes point back to their tree and keep it up to date from addChild/removeChild,
+// so lookups never have to walk the hierarchy or compare strings.
+class SceneTree
+{
+private:
+  // Children of one parent sharing one name, linked in child order through
+  // Node::prevSameName / nextSameName
+  struct ChildKey
+  {
+    const Node *parent;
+    StringId nameId;
+    bool operator==(const ChildKey &other) const { return parent == other.parent && nameId == other.nameId; }
+  };
+
+  struct ChildKeyHash
+  {
+    size_t operator()(const ChildKey &key) const
+    {
+      return std::hash<const void *>()(key.parent) ^ (static_cast<size_t>(key.nameId) * 0x9E3779B97F4A7C15ull);
+    }
+  };
+
+  struct SameNameChildren
+  {
+    Node *first;
+    Node *last;
+  };
+
+  Node *root;
+  std::unordered_map<StringId, std::vector<Node *>> nodesByName; // Nodes sharing each name
+  std::unordered_map<ChildKey, SameNameChildren, ChildKeyHash> childrenByName; // Per parent, for paths
+  size_t nodeCount;
+  std::vector<Node *> nodesByType[NodeTypeCount]; // Bucket per exact type
+  std::unique_ptr<FlatHierarchy> flatHierarchy;   // Optional depth-first mirror used for traversal
+  SceneCommandBuffer commands;                    // Structural changes deferred until the next flush
+  std::unique_ptr<AnimationSystem> animationSystem; // Optional batched playback for the tree's sprites
+  std::unique_ptr<TweenSystem> tweenSystem;         // Property tracks, created on first use
+  std::unique_ptr<RenderLayers> renderLayers;       // Layer settings and cached targets, created on first use
+
+public:
+  SceneTree() : root(nullptr), nodeCount(0) {}
+
+  SceneTree(const SceneTree &) = delete;
+  SceneTree &operator=(const SceneTree &) = delete;
+
+  // Attach the scene root (registers its whole subtree)
+  void setRoot(Node *rootNode);
+  Node *getRoot() const { return root; }
+
+  // Called by Node when a subtree is attached to, detached from or moved within this tree
+  void attachSubtree(Node *node);
+  void detachSubtree(Node *node);
+  void reparentSubtree(Node *node, Node *oldParent);
+
+  // Called by Node::setName
+  void renameNode(Node *node, StringId oldName, StringId newName);
+
+  // Lookup by interned name (any node with that name, nullptr if none)
+  Node *findNode(StringId nameId) const;
+  Node *findNode(std::string_view nodeName) const;
+
+  // First child of parent with that name, in child order (nullptr if none)
+  Node *findChild(const Node *parent, StringId nameId) const;
+  Node *findChild(const Node *parent, std::string_view nodeName) const;
+
+  // Lookup by path from the root, e.g. "Root/Player/Weapon" (one findChild per segment)
+  Node *findPath(std::string_view path) const;
+
+  // Visit every node of type T or a type derived from T (no RTTI, only matching buckets are touched).
+  // The callback must not add or remove nodes.
+  template <typename T, typename Fn>
+  void each(Fn &&fn) const;
+
+  // Number of nodes of exactly this type
+  size_t getTypeCount(NodeType type) const { return nodesByType[static_cast<size_t>(type)].size(); }
+
+  size_t getNodeCount() const { return nodeCount; }
+
+  // Keep a FlatHierarchy in sync with the tree (built from the current root when enabled)
+  void enableFlatHierarchy(bool enable);
+  FlatHierarchy *getFlatHierarchy() const { return flatHierarchy.get(); }
+
+  // Advance the sprites' animations in one AnimationSystem pass instead of
+  // per node (sprites attach and detach as they enter and leave the tree)
+  void enableAnimationSystem(bool enable);
+  AnimationSystem *getAnimationSystem() const { return animationSystem.get(); }
+
+  // Property tracks of the tree's nodes, advanced after the node updates
+  TweenSystem &getTweens()
+  {
+    if (!tweenSystem)
+      tweenSystem = std::make_unique<TweenSystem>();
+    return *tweenSystem;
+  }
+  TweenSystem *getTweenSystem() const { return tweenSystem.get(); }
+
+  // Render layers; nodes stay on layer 0 and render as before until a layer is made static
+  RenderLayers &getLayers()
+  {
+    if (!renderLayers)
+      renderLayers = std::make_unique<RenderLayers>();
+    return *renderLayers;
+  }
+  RenderLayers *getRenderLayers() const { return renderLayers.get(); }
+
+  // Mark the static layers drawn by a subtree, or by one node, for re-rendering
+  void invalidateLayers(const Node *node);
+  void invalidateLayer(const Node *node);
+
+  // Deferred spawn/destroy/reparent, applied by flushCommands() between update and render
+  SceneCommandBuffer &getCommands() { return commands; }
+  size_t flushCommands() { return commands.flush(); }
+
+private:
+  void registerSubtree(Node *node);
+  void unregisterSubtree(Node *node);
+  void registerNode(Node *node);
+  void unregisterNode(Node *node);
+  void addToNameIndex(Node *node, StringId nameId);
+  void removeFromNameIndex(Node *node, StringId nameId);
+  void linkChild(Node *node);
+  void linkChildInOrder(Node *node);
+  void unlinkChild(const Node *parent, Node *node, StringId nameId);
+  void invalidateSubtreeLayers(const Node *node, int inherited);
+};
+
+// Implementation of methods that do not need the complete Node
+// (the rest live in Node.h)
+inline Node *SceneTree::findNode(StringId nameId) const
+{
+  auto it = nodesByName.find(nameId);
+  return it != nodesByName.end() && !it->second.empty() ? it->second.front() : nullptr;
+}
+
+inline Node *SceneTree::findNode(std::string_view nodeName) const
+{
+  StringId nameId = StringTable::getInstance().find(nodeName);
+  return nameId != InvalidStringId ? findNode(nameId) : nullptr;
+}
+
+inline Node *SceneTree::findChild(const Node *parent, StringId nameId) const
+{
+  auto it = childrenByName.find(ChildKey{parent, nameId});
+  return it != childrenByName.end() ? it->second.first : nullptr;
+}
+
+inline Node *SceneTree::findChild(const Node *parent, std::string_view nodeName) const
+{
+  StringId nameId = StringTable::getInstance().find(nodeName);
+  return nameId != InvalidStringId ? findChild(parent, nameId) : nullptr;
+}
+
+template <typename T, typename Fn>
+inline void SceneTree::each(Fn &&fn) const
+{
+  for (size_t type = 0; type < NodeTypeCount; ++type)
+  {
+    if (!isNodeTypeA(static_cast<NodeType>(type), T::StaticType))
+      continue;
+
+    for (Node *node : nodesByType[type])
+    {
+      fn(static_cast<T *>(node));
+    }
+  }
+}
@@ -7,6 +7,8 @@ class SimpleScene : public Scene
 public:
   SimpleScene() : Scene("SimpleScene")
   {
+    auto arenaScope = useNodeArena();
+
     // Simple scene with no additional nodes
     // Just the root node
   }
@@ -8,6 +8,8 @@ class TestScene : public Scene
 public:
   TestScene() : Scene("TestScene")
   {
+    auto arenaScope = useNodeArena();
+
     // Create a test rectangle
     auto testRect = std::make_unique<Rectangle>(
         "TestRect",
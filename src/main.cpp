@@ -1,3 +1,6 @@
+// Global operator new/delete hooks live in this translation unit
+#define ALLOCATION_TRACKER_IMPLEMENTATION
+#include "core/memory/AllocationTracker.h"
 #include "core/GameSetup.h"
 #include "core/GameLoop.h"
 #include "core/Input.h"
@@ -44,6 +47,9 @@ int main(void)
   settings.game.targetFPS = 60;
   settings.game.debugMode = false;
   settings.game.showFPS = false;
+  settings.game.hitchCapture = false;
+  settings.game.perfCounters = false;
+  settings.game.allocationWarmupFrames = 0;
 
   if (!gameSetup.initialize())
   {
@@ -0,0 +1,242 @@
+// Checks that a compiled AnimationStateMachine picks the same clips as the
+// hand-written if/else it replaces, that its lookup table agrees with scanning
+// the transitions, and that triggers, float tests and clip-finished events work.
+
+#include "core/log/Logger.h"
+#include "nodes/AnimationStateMachine.h"
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+static std::shared_ptr<AnimationClipSet> makeClips()
+{
+  auto clips = std::make_shared<AnimationClipSet>();
+  clips->addClip("IDLE", {AnimationFrame(0, 2)}, 8.0f, true);
+  clips->addClip("WALK", {AnimationFrame(2, 6)}, 12.0f, true);
+  clips->addClip("RUN", {AnimationFrame(8, 6)}, 15.0f, true);
+  clips->addClip("CROUCH_IDLE", {AnimationFrame(14, 2)}, 8.0f, true);
+  clips->addClip("CROUCH_WALK", {AnimationFrame(16, 6)}, 12.0f, true);
+  clips->addClip("JUMP", {AnimationFrame(22, 6)}, 10.0f, false);
+  return clips;
+}
+
+// Locomotion as in the aliens demo; `padding` unused bools push the machine
+// past the lookup table so every state scans its transitions
+static std::shared_ptr<const AnimationStateMachine> makeLocomotion(const AnimationClipSet &clips, int padding)
+{
+  AnimationStateMachineBuilder builder;
+  builder.addBool("moving");
+  builder.addBool("running");
+  builder.addBool("crouching");
+  builder.addTrigger("jump");
+  for (int i = 0; i < padding; ++i)
+    builder.addBool("unused" + std::to_string(i));
+
+  builder.addState("idle", "IDLE");
+  builder.addState("walk", "WALK");
+  builder.addState("run", "RUN");
+  builder.addState("crouchIdle", "CROUCH_IDLE");
+  builder.addState("crouchWalk", "CROUCH_WALK");
+  builder.addState("jump", "JUMP");
+
+  builder.addAnyTransition("jump").when("jump");
+  for (const char *from : {"idle", "walk", "run", "crouchIdle", "crouchWalk"})
+  {
+    std::string source = from;
+    if (source != "crouchWalk")
+      builder.addTransition(from, "crouchWalk").when("crouching").when("moving");
+    if (source != "crouchIdle")
+      builder.addTransition(from, "crouchIdle").when("crouching").whenNot("moving");
+    if (source != "run")
+      builder.addTransition(from, "run").whenNot("crouching").when("moving").when("running");
+    if (source != "walk")
+      builder.addTransition(from, "walk").whenNot("crouching").when("moving").whenNot("running");
+    if (source != "idle")
+      builder.addTransition(from, "idle").whenNot("crouching").whenNot("moving");
+  }
+  builder.addTransition("jump", "idle").whenClipFinished();
+  return builder.compile(clips);
+}
+
+// Random input against the if/else chain, through both evaluation paths
+static void testMatchesHandWritten()
+{
+  auto clips = makeClips();
+  auto table = makeLocomotion(*clips, 0);
+  auto scanned = makeLocomotion(*clips, 12);
+  check(table && scanned, "machines compile");
+  if (!table || !scanned)
+    return;
+
+  AnimationClipHandle idle = clips->find("IDLE"), walk = clips->find("WALK"), run = clips->find("RUN");
+  AnimationClipHandle crouchIdle = clips->find("CROUCH_IDLE"), crouchWalk = clips->find("CROUCH_WALK");
+
+  const size_t count = 32;
+  std::vector<Animation2D> tableAnimators(count), scannedAnimators(count);
+  AnimationStateBatch tableBatch(table), scannedBatch(scanned);
+  for (size_t i = 0; i < count; ++i)
+  {
+    tableAnimators[i].setClips(clips);
+    scannedAnimators[i].setClips(clips);
+    tableBatch.add(&tableAnimators[i]);
+    scannedBatch.add(&scannedAnimators[i]);
+  }
+
+  uint32_t moving = table->findParameter("moving"), running = table->findParameter("running");
+  uint32_t crouching = table->findParameter("crouching");
+  std::mt19937 rng(5);
+  for (int step = 0; step < 500; ++step)
+  {
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      bool isMoving = rng() % 2, isRunning = rng() % 2, isCrouching = rng() % 3 == 0;
+      tableBatch.setBool(i, moving, isMoving);
+      tableBatch.setBool(i, running, isRunning);
+      tableBatch.setBool(i, crouching, isCrouching);
+      scannedBatch.setBool(i, moving, isMoving);
+      scannedBatch.setBool(i, running, isRunning);
+      scannedBatch.setBool(i, crouching, isCrouching);
+    }
+    tableBatch.update();
+    scannedBatch.update();
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      bool isMoving = tableBatch.getBool(i, moving), isRunning = tableBatch.getBool(i, running);
+      AnimationClipHandle expected;
+      if (tableBatch.getBool(i, crouching))
+        expected = isMoving ? crouchWalk : crouchIdle;
+      else if (isMoving)
+        expected = isRunning ? run : walk;
+      else
+        expected = idle;
+
+      if (tableAnimators[i].getCurrentClip() != expected || scannedAnimators[i].getCurrentClip() != expected ||
+          tableBatch.getState(i) != scannedBatch.getState(i))
+      {
+        check(false, "step " + std::to_string(step) + " instance " + std::to_string(i) + " plays " +
+                         clips->getName(tableAnimators[i].getCurrentClip()) + " / " +
+                         clips->getName(scannedAnimators[i].getCurrentClip()) + ", expected " + clips->getName(expected));
+        return;
+      }
+    }
+  }
+}
+
+// A trigger fires once; the action plays out, then returns to locomotion
+static void testTriggerAndClipFinished()
+{
+  auto clips = makeClips();
+  auto machine = makeLocomotion(*clips, 0);
+  if (!machine)
+    return;
+
+  Animation2D animator;
+  animator.setClips(clips);
+  AnimationStateBatch batch(machine);
+  uint32_t instance = batch.add(&animator);
+  uint32_t jump = machine->findParameter("jump");
+  uint32_t jumpState = machine->findState("jump");
+  check(animator.getCurrentClip() == clips->find("IDLE"), "starts in the initial state's clip");
+
+  batch.setTrigger(instance, jump);
+  check(batch.update() == 1, "trigger fires a transition");
+  check(batch.getState(instance) == jumpState && animator.getCurrentClip() == clips->find("JUMP"), "jump plays");
+  check(!batch.getBool(instance, jump), "trigger is consumed");
+
+  // JUMP is 6 frames at 10 fps; it must not leave before it has finished
+  for (int step = 0; step < 30; ++step)
+  {
+    animator.update(1.0f / 60.0f);
+    batch.update();
+  }
+  check(batch.getState(instance) == jumpState, "jump holds until its clip finishes");
+  for (int step = 0; step < 40; ++step)
+  {
+    animator.update(1.0f / 60.0f);
+    batch.update();
+  }
+  check(batch.getState(instance) == machine->findState("idle"), "finished jump returns to idle");
+}
+
+static void testFloatConditions()
+{
+  auto clips = makeClips();
+  AnimationStateMachineBuilder builder;
+  builder.addFloat("speed");
+  builder.addState("idle", "IDLE");
+  builder.addState("walk", "WALK");
+  builder.addState("run", "RUN");
+  builder.addTransition("idle", "walk").when("speed", AnimationCondition::Greater, 0.1f);
+  builder.addTransition("walk", "run").when("speed", AnimationCondition::Greater, 5.0f);
+  builder.addTransition("walk", "idle").when("speed", AnimationCondition::Less, 0.1f);
+  builder.addTransition("run", "walk").when("speed", AnimationCondition::Less, 4.0f);
+  auto machine = builder.compile(*clips);
+  check(machine != nullptr, "float machine compiles");
+  if (!machine)
+    return;
+
+  AnimationStateBatch batch(machine);
+  uint32_t instance = batch.add(nullptr);
+  uint32_t speed = machine->findParameter("speed");
+  const float speeds[] = {0.0f, 2.0f, 6.0f, 4.5f, 3.0f, 0.0f};
+  const char *expected[] = {"idle", "walk", "run", "run", "walk", "idle"};
+  for (size_t i = 0; i < 6; ++i)
+  {
+    batch.setFloat(instance, speed, speeds[i]);
+    batch.update();
+    check(batch.getState(instance) == machine->findState(expected[i]),
+          "speed " + std::to_string(speeds[i]) + " is " + expected[i]);
+  }
+}
+
+static void testRemove()
+{
+  auto clips = makeClips();
+  auto machine = makeLocomotion(*clips, 0);
+  if (!machine)
+    return;
+
+  AnimationStateBatch batch(machine);
+  batch.add(nullptr);
+  batch.add(nullptr);
+  uint32_t moving = machine->findParameter("moving");
+  batch.setBool(1, moving, true);
+  batch.update();
+  batch.remove(0);
+  check(batch.size() == 1, "remove shrinks the batch");
+  check(batch.getState(0) == machine->findState("walk") && batch.getBool(0, moving), "last instance moves into the hole");
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  testMatchesHandWritten();
+  testTriggerAndClipFinished();
+  testFloatConditions();
+  testRemove();
+
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "Animation state machine test passed" << std::endl;
+  return 0;
+}
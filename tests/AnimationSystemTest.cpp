@@ -0,0 +1,348 @@
+// Checks that animators advanced by an AnimationSystem match standalone
+// Animation2D::update, that level of detail does not change what is shown,
+// and that attach/detach keep the playback state.
+
+#include "core/log/Logger.h"
+#include "nodes/Sprite2D.h"
+#include "scene/Scene.h"
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+static std::shared_ptr<AnimationClipSet> makeClips()
+{
+  auto clips = std::make_shared<AnimationClipSet>();
+  clips->addClip("Idle", {AnimationFrame(0, 4)}, 8.0f, true);
+  clips->addClip("Run", {AnimationFrame(8, 3), AnimationFrame(20, 5)}, 15.0f, true);
+  clips->addClip("Die", {AnimationFrame(30, 6)}, 12.0f, false);
+  clips->addClip("Still", {AnimationFrame(40, 2)}, 0.0f, true);
+  return clips;
+}
+
+// Batched and standalone animators stepped at 60 fps must agree on every frame
+static void testMatchesStandalone()
+{
+  auto clips = makeClips();
+  const size_t count = 64;
+  std::mt19937 rng(42);
+
+  AnimationSystem system;
+  std::vector<Animation2D> batched(count);
+  std::vector<Animation2D> standalone(count);
+  std::vector<int> outputs(count, -1);
+  for (size_t i = 0; i < count; ++i)
+  {
+    AnimationClipHandle clip = static_cast<AnimationClipHandle>(rng() % clips->getClipCount());
+    standalone[i].setClips(clips);
+    standalone[i].play(clip);
+    batched[i].setClips(clips);
+    batched[i].play(clip);
+    batched[i].attach(system, &outputs[i]);
+  }
+  check(system.size() == count, "every animator is attached");
+
+  for (int step = 0; step < 600; ++step)
+  {
+    // Change clips now and then, the way game code does
+    if (step % 97 == 0)
+    {
+      size_t i = rng() % count;
+      AnimationClipHandle clip = static_cast<AnimationClipHandle>(rng() % clips->getClipCount());
+      standalone[i].play(clip);
+      batched[i].play(clip);
+    }
+
+    system.update(1.0f / 60.0f);
+    for (size_t i = 0; i < count; ++i)
+    {
+      standalone[i].update(1.0f / 60.0f);
+      AnimationPlayback expected = standalone[i].getPlayback();
+      AnimationPlayback actual = batched[i].getPlayback();
+      if (expected.frame != actual.frame || expected.time != actual.time || expected.flags != actual.flags ||
+          outputs[i] != standalone[i].getCurrentFrameIndex())
+      {
+        check(false, "animator " + std::to_string(i) + " diverged at step " + std::to_string(step));
+        return;
+      }
+    }
+  }
+}
+
+static void testLargeDelta()
+{
+  auto clips = makeClips();
+  AnimationSystem system;
+  int output = -1;
+  Animation2D animator;
+  animator.setClips(clips);
+  animator.attach(system, &output);
+
+  // 15 fps: a quarter second is 3.75 frames
+  animator.play("Run");
+  system.update(0.25f);
+  check(animator.getCurrentFrame() == 3.0f, "large delta advances several frames");
+  check(output == 20, "large delta writes the sheet frame of the second group");
+
+  // 8 frames in total, so 10 more wrap to frame 5
+  system.update(10.0f / 15.0f);
+  check(animator.getCurrentFrame() == 5.0f, "looping clip wraps after a large delta");
+
+  // Non-looping clips stop on their last frame
+  animator.play("Die");
+  system.update(2.0f);
+  check(animator.getCurrentFrame() == 5.0f && !animator.isPlaying(), "non-looping clip clamps and stops");
+  check(output == 35, "stopped clip keeps its last sheet frame");
+
+  // Zero frame rate never advances
+  animator.play("Still");
+  system.update(5.0f);
+  check(animator.getCurrentFrame() == 0.0f && animator.isPlaying(), "zero frame rate clip does not advance");
+  check(output == 40, "zero frame rate clip still writes its frame");
+}
+
+static void testControlWhileAttached()
+{
+  auto clips = makeClips();
+  AnimationSystem system;
+  int output = -1;
+  Animation2D animator;
+  animator.setClips(clips);
+  animator.play("Idle");
+  animator.attach(system, &output);
+
+  system.update(0.3f); // 2 frames at 8 fps
+  check(animator.getCurrentFrame() == 2.0f, "attached animator advances");
+
+  animator.pause();
+  system.update(1.0f);
+  check(animator.getCurrentFrame() == 2.0f && !animator.isPlaying(), "paused animator holds its frame");
+
+  animator.resume();
+  system.update(0.125f);
+  check(animator.getCurrentFrame() == 3.0f, "resumed animator advances again");
+
+  animator.stop();
+  system.update(1.0f);
+  check(animator.getCurrentFrame() == 0.0f && system.getPlayingCount() == 0, "stopped animator rewinds and stays");
+
+  // Leaving the system keeps the state, and update() works again
+  animator.play("Idle");
+  system.update(0.25f);
+  animator.detach();
+  check(system.size() == 0, "detach removes the slot");
+  check(animator.getCurrentFrame() == 2.0f && animator.isPlaying(), "detach keeps the playback state");
+  animator.update(0.125f);
+  check(animator.getCurrentFrame() == 3.0f, "detached animator updates itself");
+}
+
+static void testSwapRemove()
+{
+  auto clips = makeClips();
+  AnimationSystem system;
+  std::vector<int> outputs(3, -1);
+  auto first = std::make_unique<Animation2D>();
+  auto middle = std::make_unique<Animation2D>();
+  auto last = std::make_unique<Animation2D>();
+  Animation2D *animators[] = {first.get(), middle.get(), last.get()};
+  const char *names[] = {"Idle", "Run", "Die"};
+  for (int i = 0; i < 3; ++i)
+  {
+    animators[i]->setClips(clips);
+    animators[i]->play(names[i]);
+    animators[i]->attach(system, &outputs[i]);
+  }
+
+  check(outputs[0] == 0 && outputs[1] == 8 && outputs[2] == 30, "play writes the first sheet frame");
+
+  // Destroying the middle animator moves the last one into its slot
+  middle.reset();
+  check(system.size() == 2, "destroyed animator leaves the system");
+  system.update(1.0f / 12.0f);
+  check(last->getCurrentAnimation() == "Die" && last->getCurrentFrame() == 1.0f, "moved animator keeps its state");
+  check(outputs[2] == 31, "moved animator still writes to its own output");
+  check(outputs[1] == 8, "removed animator's output is left alone");
+}
+
+// Animators skipped by level of detail show exactly the full-rate frame when
+// they are visible again, and read back exactly at any time
+static void testLodMatchesFullRate()
+{
+  auto clips = makeClips();
+  const size_t count = 400;
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> levelX(0.0f, 4000.0f);
+
+  AnimationSystem fullRate;
+  AnimationSystem lod;
+  AnimationLodPolicy policy;
+  policy.margin = 64.0f;
+  policy.minScreenSize = 12.0f;
+  policy.reducedInterval = 3;
+  policy.classifyInterval = 5;
+  lod.setView(0.0f, 0.0f, 320.0f, 240.0f, 1.0f);
+  lod.enableLod(policy);
+
+  std::vector<Transform2D> transforms(count);
+  std::vector<Animation2D> reference(count);
+  std::vector<Animation2D> animators(count);
+  std::vector<int> referenceOutputs(count, -1);
+  std::vector<int> outputs(count, -1);
+  for (size_t i = 0; i < count; ++i)
+  {
+    // Every fourth sprite is too small to run at full rate
+    transforms[i].setPosition(Position2D(levelX(rng), 100.0f));
+    transforms[i].setScale(i % 4 == 0 ? Scale2D(0.25f, 0.25f) : Scale2D(1.0f, 1.0f));
+    AnimationClipHandle clip = static_cast<AnimationClipHandle>(rng() % 3);
+    for (Animation2D *animator : {&reference[i], &animators[i]})
+    {
+      animator->setClips(clips);
+      animator->play(clip);
+    }
+    reference[i].attach(fullRate, &referenceOutputs[i]);
+    animators[i].attach(lod, &outputs[i]);
+    animators[i].setLodBounds(&transforms[i], 16.0f, 16.0f);
+  }
+
+  bool sawHidden = false;
+  bool sawReduced = false;
+  for (int step = 0; step < 900; ++step)
+  {
+    // Scroll a 320 wide view across the level at an uneven frame rate
+    float left = step * 4.0f;
+    lod.setView(left, 0.0f, left + 320.0f, 240.0f, 1.0f);
+    float deltaTime = (step % 7 == 0) ? 1.0f / 30.0f : 1.0f / 60.0f;
+
+    if (step % 50 == 0)
+    {
+      size_t i = rng() % count;
+      AnimationClipHandle clip = static_cast<AnimationClipHandle>(rng() % clips->getClipCount());
+      reference[i].play(clip);
+      animators[i].play(clip);
+    }
+
+    fullRate.update(deltaTime);
+    lod.update(deltaTime);
+    AnimationLodStats stats = lod.getLodStats();
+    sawHidden = sawHidden || stats.hidden > 0;
+    sawReduced = sawReduced || stats.reduced > 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      // Sprites on screen that are not too small must show the full-rate frame
+      const Position2D &position = transforms[i].getPosition();
+      bool onScreen = position.x + 16.0f >= left && position.x - 16.0f <= left + 320.0f;
+      if (onScreen && i % 4 != 0 && outputs[i] != referenceOutputs[i])
+      {
+        check(false, "visible animator " + std::to_string(i) + " shows a stale frame at step " + std::to_string(step));
+        return;
+      }
+    }
+  }
+  check(sawHidden && sawReduced, "level of detail hides and slows animators");
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    AnimationPlayback expected = reference[i].getPlayback();
+    AnimationPlayback actual = animators[i].getPlayback();
+    if (expected.frame != actual.frame || expected.time != actual.time || expected.flags != actual.flags)
+    {
+      check(false, "animator " + std::to_string(i) + " reads back differently under level of detail");
+      return;
+    }
+  }
+
+  // Detaching a skipped animator hands over the exact state too
+  animators[0].detach();
+  check(animators[0].getPlayback().frame == reference[0].getPlayback().frame &&
+            animators[0].getPlayback().time == reference[0].getPlayback().time,
+        "detached animator keeps the full-rate state");
+}
+
+// A scene with batched animation shows the same sprite frames as one without
+static void testSceneIntegration()
+{
+  auto clips = makeClips();
+  Scene batchedScene("Batched");
+  Scene plainScene("Plain");
+  batchedScene.setBatchedAnimation(true);
+
+  std::vector<Sprite2D *> batchedSprites;
+  std::vector<Sprite2D *> plainSprites;
+  for (int i = 0; i < 16; ++i)
+  {
+    for (Scene *scene : {&batchedScene, &plainScene})
+    {
+      auto sprite = std::make_unique<Sprite2D>("Sprite" + std::to_string(i), 0.0f, 0.0f, 1.0f, 1.0f, "", 8, 8);
+      sprite->setAnimationClips(clips);
+      sprite->playAnimation(static_cast<AnimationClipHandle>(i % 3));
+      (scene == &batchedScene ? batchedSprites : plainSprites).push_back(sprite.get());
+      scene->addNode(std::move(sprite));
+    }
+  }
+  check(batchedScene.getAnimationSystem()->size() == 16, "sprites attach when they join a batched scene");
+
+  for (int step = 0; step < 120; ++step)
+  {
+    batchedScene.update(1.0f / 60.0f);
+    plainScene.update(1.0f / 60.0f);
+  }
+  bool same = true;
+  for (size_t i = 0; i < batchedSprites.size(); ++i)
+    same = same && batchedSprites[i]->getFrame() == plainSprites[i]->getFrame();
+  check(same, "batched scene renders the same frames");
+
+  // Removed sprites take their state with them
+  std::unique_ptr<Node> removed = batchedScene.removeNode("Sprite1");
+  check(batchedScene.getAnimationSystem()->size() == 15, "removed sprite leaves the system");
+  check(!static_cast<Sprite2D *>(removed.get())->getAnimator()->isAttached(), "removed sprite is detached");
+
+  // Turning batching off hands the animators back to their sprites
+  batchedScene.setBatchedAnimation(false);
+  for (int step = 0; step < 30; ++step)
+  {
+    batchedScene.update(1.0f / 60.0f);
+    plainScene.update(1.0f / 60.0f);
+  }
+  same = true;
+  for (size_t i = 0; i < batchedSprites.size(); ++i)
+  {
+    if (i != 1)
+      same = same && batchedSprites[i]->getFrame() == plainSprites[i]->getFrame();
+  }
+  check(same, "sprites continue in step after batching is turned off");
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  testMatchesStandalone();
+  testLargeDelta();
+  testControlWhileAttached();
+  testSwapRemove();
+  testLodMatchesFullRate();
+  testSceneIntegration();
+
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "Animation system test passed" << std::endl;
+  return 0;
+}
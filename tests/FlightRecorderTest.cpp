@@ -0,0 +1,148 @@
+// Injects a stall into a running frame loop and checks that the flight
+// recorder dumps a trace containing the stalled zone, then that profiler
+// rings can be copied while another thread records into them.
+
+#include "scene/Scene.h"
+#include "core/profile/FlightRecorder.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+// Duration in milliseconds of the first zone with the given name, or -1
+static double findZoneMs(const std::string &trace, const std::string &zoneName)
+{
+  size_t pos = trace.find("\"name\":\"" + zoneName + "\"");
+  if (pos == std::string::npos)
+    return -1.0;
+  size_t dur = trace.find("\"dur\":", pos);
+  if (dur == std::string::npos)
+    return -1.0;
+  return std::stod(trace.substr(dur + 6)) / 1000.0;
+}
+
+int main()
+{
+  using Clock = std::chrono::steady_clock;
+  const float stallMs = 50.0f;
+  const float thresholdMs = 30.0f;
+  const std::string prefix = "flight_recorder_test";
+
+  Scene scene("Flight recorder test");
+  auto &recorder = FlightRecorder::getInstance();
+  recorder.enable(2.0f, thresholdMs, 4096, prefix);
+  recorder.recordEvent("Scene loaded");
+
+  for (int frame = 0; frame < 40; ++frame)
+  {
+    if (frame == 20)
+    {
+      scene.injectStall(stallMs);
+    }
+
+    FrameTimes times{};
+    Clock::time_point start = Clock::now();
+    {
+      PROFILE_SCOPE("Frame");
+      {
+        PROFILE_SCOPE("Scene::update");
+        scene.update(1.0f / 60.0f);
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    times.frameMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    times.updateMs = times.frameMs;
+    recorder.endFrame(times);
+  }
+
+  recorder.waitForWriter();
+  check(recorder.getSnapshotCount() == 1, "expected exactly one hitch snapshot");
+
+  std::string path = recorder.getLastSnapshotPath();
+  check(path == prefix + "_20.json", "snapshot should be named after the hitch frame, got " + path);
+  recorder.disable();
+
+  std::ifstream file(path);
+  check(file.good(), "cannot open " + path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  std::string trace = contents.str();
+
+  check(findZoneMs(trace, "Scene::injectedStall") >= stallMs, "injected stall zone missing or too short");
+  check(findZoneMs(trace, "Scene::update") >= 0.0, "Scene::update zone missing");
+  check(trace.find("\"name\":\"Scene loaded\"") != std::string::npos, "engine event missing");
+  check(trace.find("\"name\":\"Frame ms\"") != std::string::npos, "frame time counters missing");
+
+  std::remove(path.c_str());
+
+  // Copying the rings while another thread records: every copied zone must be
+  // whole (its name matches the parity of its start) and each thread's zones
+  // come out oldest first
+  {
+    static const char *parity[2] = {"even", "odd"};
+    Profiler &profiler = Profiler::getInstance();
+    profiler.setRingCapacity(64);
+    std::atomic<bool> stop(false);
+    std::thread writer([&]
+                       {
+      for (uint64_t n = 1; !stop.load(std::memory_order_relaxed); ++n)
+      {
+        ProfileThreadBuffer *buffer = profiler.beginZone();
+        profiler.endZone(buffer, parity[n & 1], "test", n);
+      } });
+
+    std::vector<std::pair<uint32_t, ProfileZone>> zones;
+    size_t torn = 0, unordered = 0;
+    auto until = Clock::now() + std::chrono::milliseconds(200);
+    while (Clock::now() < until)
+    {
+      zones.clear();
+      profiler.copyZonesSince(0, zones);
+      std::vector<uint64_t> lastStart(16, 0);
+      for (const auto &entry : zones)
+      {
+        const ProfileZone &zone = entry.second;
+        if (std::string(zone.category) != "test")
+          continue;
+        if (zone.name != parity[zone.start & 1])
+          torn++;
+        if (entry.first < lastStart.size())
+        {
+          if (zone.start <= lastStart[entry.first])
+            unordered++;
+          lastStart[entry.first] = zone.start;
+        }
+      }
+    }
+    stop = true;
+    writer.join();
+    profiler.setRingCapacity(0);
+
+    check(torn == 0, std::to_string(torn) + " torn zones copied while recording");
+    check(unordered == 0, std::to_string(unordered) + " zones copied out of order");
+  }
+
+  if (failures != 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "FlightRecorderTest passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,100 @@
+// Checks that nodes created and freed at runtime inside a scene's arena scope
+// reuse freed memory of their size class instead of growing the arena, that
+// different node sizes keep to their own classes, and that clear() still
+// hands every block back at once.
+
+#include "core/log/Logger.h"
+#include "nodes/Rectangle.h"
+#include "scene/Scene.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+static void testRuntimeChurn()
+{
+  Scene scene("Arena");
+  auto arenaScope = scene.useNodeArena();
+  const NodeArena *arena = scene.getNodeArena();
+
+  for (int i = 0; i < 100; ++i)
+    scene.addNode(std::make_unique<Rectangle>("Bullet", Position2D(0.0f, 0.0f)));
+  size_t blocks = arena->getBlockCount();
+  size_t bytes = arena->getBytesUsed();
+
+  // Spawn and free bullets for a while, as a running game does
+  for (int frame = 0; frame < 1000; ++frame)
+  {
+    scene.removeNode("Bullet");
+    scene.addNode(std::make_unique<Rectangle>("Bullet", Position2D(0.0f, 0.0f)));
+  }
+
+  check(arena->getBlockCount() == blocks && arena->getBytesUsed() == bytes, "freed nodes are reused, the arena does not grow");
+  check(arena->getReuseCount() == 1000 && arena->getLiveCount() == 100, "every respawn reuses a freed node");
+}
+
+static void testSizeClasses()
+{
+  Scene scene("Arena");
+  auto arenaScope = scene.useNodeArena();
+  const NodeArena *arena = scene.getNodeArena();
+
+  // A freed rectangle is not handed to a node of another size
+  static_assert(sizeof(Rectangle) >= sizeof(RootNode) + alignof(std::max_align_t), "the check needs two size classes");
+  scene.addNode(std::make_unique<Rectangle>("Rect", Position2D(0.0f, 0.0f)));
+  scene.removeNode("Rect");
+  scene.addNode(std::make_unique<RootNode>("Group"));
+  check(arena->getReuseCount() == 0, "other sizes do not take the freed memory");
+
+  scene.addNode(std::make_unique<Rectangle>("Rect", Position2D(0.0f, 0.0f)));
+  check(arena->getReuseCount() == 1, "the same size does");
+}
+
+static void testClear()
+{
+  Scene scene("Arena");
+  {
+    auto arenaScope = scene.useNodeArena();
+    for (int i = 0; i < 1000; ++i)
+      scene.addNode(std::make_unique<Rectangle>("Tile", Position2D(0.0f, 0.0f)));
+    scene.removeNode("Tile");
+  }
+
+  scene.clear();
+  const NodeArena *arena = scene.getNodeArena();
+  check(arena->getLiveCount() == 0 && arena->getBlockCount() == 0, "clear releases every block");
+
+  auto arenaScope = scene.useNodeArena();
+  scene.addNode(std::make_unique<Rectangle>("Tile", Position2D(0.0f, 0.0f)));
+  check(arena->getReuseCount() == 0 && arena->getBlockCount() == 1, "and the free lists with them");
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  testRuntimeChurn();
+  testSizeClasses();
+  testClear();
+
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "Node arena test passed" << std::endl;
+  return 0;
+}
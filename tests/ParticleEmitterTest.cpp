@@ -0,0 +1,217 @@
+// Checks that ParticleEmitter2D emits at its rate up to its capacity, that the
+// SIMD integration matches the closed form of its Euler steps, that
+// swap-removing dead particles keeps every array in step, that updating on
+// worker threads gives the serial result, and that an emitter draws once.
+
+#include "core/WorkerPool.h"
+#include "core/log/Logger.h"
+#include "core/render/NullRenderDriver.h"
+#include "nodes/ParticleEmitter2D.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+static bool near(float a, float b, float tolerance = 1e-3f) { return std::fabs(a - b) <= tolerance; }
+
+static void testEmission()
+{
+  ParticleEmitterSettings settings;
+  settings.rate = 600.0f;
+  settings.maxParticles = 50;
+  settings.minLifetime = settings.maxLifetime = 10.0f;
+  ParticleEmitter2D emitter("Emitter", Position2D(), settings);
+
+  emitter.update(1.0f / 60.0f);
+  check(emitter.getParticleCount() == 10, "600 per second emits 10 in a frame");
+  emitter.update(1.0f);
+  check(emitter.getParticleCount() == 50, "emission stops at the capacity");
+  check(emitter.emit(5) == 0, "bursts are capped too");
+
+  emitter.clear();
+  emitter.setEmitting(false);
+  emitter.update(1.0f);
+  check(emitter.getParticleCount() == 0, "a stopped emitter does not emit");
+  check(emitter.emit(70) == 50, "a burst fills up to the capacity");
+}
+
+// v(n) = v0 + n g dt and p(n) = n v0 dt + g dt^2 n (n + 1) / 2
+static void testIntegration()
+{
+  ParticleEmitterSettings settings;
+  settings.rate = 0.0f;
+  settings.direction = 0.0f;
+  settings.spread = 0.0f;
+  settings.minSpeed = settings.maxSpeed = 10.0f;
+  settings.minLifetime = settings.maxLifetime = 100.0f;
+  settings.gravity = Vector2(0.0f, 100.0f);
+  ParticleEmitter2D falling("Falling", Position2D(), settings);
+  falling.emit(1);
+
+  const int steps = 100;
+  const float dt = 0.01f;
+  for (int i = 0; i < steps; ++i)
+    falling.update(dt);
+  float n = static_cast<float>(steps);
+  check(near(falling.getPositionsX()[0], 10.0f * n * dt) && near(falling.getVelocitiesX()[0], 10.0f),
+        "horizontal motion is uniform");
+  check(near(falling.getPositionsY()[0], 100.0f * dt * dt * n * (n + 1.0f) / 2.0f, 1e-2f) &&
+            near(falling.getVelocitiesY()[0], 100.0f * n * dt),
+        "gravity accelerates: y " + std::to_string(falling.getPositionsY()[0]));
+  check(near(falling.getAges()[0], 0.01f, 1e-5f), "age advances by dt / lifetime");
+
+  settings.gravity = Vector2();
+  settings.damping = 0.5f;
+  ParticleEmitter2D damped("Damped", Position2D(), settings);
+  damped.emit(1);
+  for (int i = 0; i < 10; ++i)
+    damped.update(0.1f);
+  check(near(damped.getVelocitiesX()[0], 10.0f * std::pow(0.95f, 10.0f)), "damping scales the velocity each step");
+}
+
+// Without gravity each particle satisfies p = v t, so a removal that moved
+// only some of the arrays would show up as a mismatch
+static void testSwapRemove()
+{
+  ParticleEmitterSettings settings;
+  settings.rate = 0.0f;
+  settings.maxParticles = 1001;
+  settings.spread = 180.0f;
+  settings.minLifetime = 0.5f;
+  settings.maxLifetime = 2.0f;
+  settings.colorVariation = 1.0f;
+  ParticleEmitter2D emitter("Emitter", Position2D(), settings);
+  emitter.emit(1001);
+
+  std::vector<float> survivors;
+  for (size_t i = 0; i < emitter.getParticleCount(); ++i)
+  {
+    float rate = emitter.getAgeRates()[i], age = 0.0f;
+    for (int step = 0; step < 4; ++step)
+      age += rate * 0.25f;
+    if (age < 1.0f)
+      survivors.push_back(rate);
+  }
+  check(survivors.size() > 0 && survivors.size() < 1001, "some particles outlive the others");
+
+  for (int step = 0; step < 4; ++step)
+    emitter.update(0.25f);
+
+  std::vector<float> live(emitter.getAgeRates(), emitter.getAgeRates() + emitter.getParticleCount());
+  std::sort(live.begin(), live.end());
+  std::sort(survivors.begin(), survivors.end());
+  check(live == survivors, "exactly the particles past their lifetime are removed");
+
+  bool consistent = true;
+  for (size_t i = 0; i < emitter.getParticleCount(); ++i)
+  {
+    consistent = consistent && near(emitter.getPositionsX()[i], emitter.getVelocitiesX()[i]) &&
+                 near(emitter.getPositionsY()[i], emitter.getVelocitiesY()[i]) &&
+                 near(emitter.getAges()[i], emitter.getAgeRates()[i], 1e-5f) && emitter.getColors()[i] >> 24 == 0xFF;
+  }
+  check(consistent, "the arrays stay in step after swap-removal");
+
+  emitter.update(1.5f);
+  check(emitter.getParticleCount() == 0, "every particle dies by its longest lifetime");
+}
+
+static void testWorkerPool()
+{
+  WorkerPool &pool = WorkerPool::getInstance();
+  pool.setThreadCount(3);
+  std::vector<std::atomic<int>> visits(100003);
+  for (int round = 0; round < 20; ++round)
+  {
+    pool.parallelFor(visits.size(), 1000, [&visits](size_t begin, size_t end)
+                     {
+                       for (size_t i = begin; i < end; ++i)
+                         visits[i]++;
+                     });
+  }
+  check(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int> &v)
+                    { return v.load() == 20; }),
+        "parallelFor runs every index once per call");
+
+  // Same seed, one emitter on the workers and one serial
+  ParticleEmitterSettings settings;
+  settings.rate = 200000.0f;
+  settings.maxParticles = 300000;
+  settings.spread = 180.0f;
+  settings.minLifetime = 0.1f;
+  settings.maxLifetime = 3.0f;
+  settings.gravity = Vector2(0.0f, 98.0f);
+  settings.damping = 0.2f;
+  ParticleEmitter2D serial("Serial", Position2D(), settings), threaded("Threaded", Position2D(), settings);
+  threaded.setParallel(true);
+  threaded.emit(250000);
+  serial.emit(250000);
+  for (int i = 0; i < 30; ++i)
+  {
+    serial.update(1.0f / 60.0f);
+    threaded.update(1.0f / 60.0f);
+  }
+  size_t n = serial.getParticleCount();
+  check(n > ParticleEmitter2D::ParallelGrain && threaded.getParticleCount() == n &&
+            std::memcmp(serial.getPositionsX(), threaded.getPositionsX(), n * sizeof(float)) == 0 &&
+            std::memcmp(serial.getVelocitiesY(), threaded.getVelocitiesY(), n * sizeof(float)) == 0 &&
+            std::memcmp(serial.getAges(), threaded.getAges(), n * sizeof(float)) == 0,
+        "threaded update matches the serial one");
+
+  pool.setThreadCount(0);
+}
+
+static void testRender()
+{
+  auto nullDriver = std::make_unique<NullRenderDriver>();
+  NullRenderDriver *driver = nullDriver.get();
+  RenderDevice::getInstance().setDriver(std::move(nullDriver));
+  RenderDevice::getInstance().initialize(nullptr);
+
+  ParticleEmitterSettings settings;
+  settings.maxParticles = 5000;
+  ParticleEmitter2D sparks("Sparks", Position2D(), settings), smoke("Smoke", Position2D(100.0f, 0.0f), settings);
+  sparks.emit(5000);
+  smoke.emit(1234);
+
+  driver->resetStats();
+  sparks.render();
+  smoke.render();
+  const RenderStats &stats = driver->getStats();
+  check(stats.drawCalls == 2 && stats.particleDraws == 2 && stats.particles == 6234, "one draw per emitter");
+
+  RenderDevice::getInstance().cleanup();
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  testEmission();
+  testIntegration();
+  testSwapRemove();
+  testWorkerPool();
+  testRender();
+
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "Particle emitter test passed" << std::endl;
+  return 0;
+}
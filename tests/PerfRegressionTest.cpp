@@ -0,0 +1,534 @@
+// Performance regression gate: runs fixed-seed stress scenes headless and
+// compares them against tests/perf_baseline.json.
+//
+// Deterministic counters (nodes, draw calls, texture switches, state changes,
+// allocations) must match the baseline exactly. Each scenario runs once to
+// warm up, then several times; timings are the median of those runs. A fixed
+// reference kernel that does not use engine code is timed before every run and
+// the expected timings are scaled by how much it sped up or slowed down,
+// so a busier or throttled host does not read as a regression. The tolerance
+// band is the baseline spread times --sigmas, but never less than
+// --min-tolerance of the expected value. Timings are only enforced on the
+// machine that wrote the baseline; elsewhere they are reported but do not fail.
+//
+//   perf_regression_test --baseline tests/perf_baseline.json
+//   perf_regression_test --baseline tests/perf_baseline.json --counters-only
+//   perf_regression_test --baseline tests/perf_baseline.json --write-baseline
+
+#define ALLOCATION_TRACKER_IMPLEMENTATION
+#include "../bench/SceneBenchmark.h"
+#include "core/log/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct PerfMetric
+{
+  std::string name;
+  bool exact;    // Deterministic counter, otherwise a timing in milliseconds
+  double value;  // Counter value, or median over the repetitions
+  double stddev; // Timings only: median absolute deviation scaled to a standard deviation
+};
+
+struct ScenarioMetrics
+{
+  std::string name;
+  std::vector<PerfMetric> metrics;
+  bool deterministic = true; // Counters were identical in every repetition
+
+  const PerfMetric *find(const std::string &metricName) const
+  {
+    for (const PerfMetric &metric : metrics)
+    {
+      if (metric.name == metricName)
+        return &metric;
+    }
+    return nullptr;
+  }
+};
+
+struct PerfBaseline
+{
+  std::string machine;
+  std::vector<ScenarioMetrics> scenarios;
+};
+
+// Small scenes so the whole gate runs in a few seconds
+static std::vector<SceneBenchConfig> gateScenarios()
+{
+  std::vector<SceneBenchConfig> scenarios;
+  auto add = [&](const char *name, int sheets, int depth, float moving, float animated, bool flat)
+  {
+    SceneBenchConfig config;
+    config.name = name;
+    config.sprites = 10000;
+    config.sheets = sheets;
+    config.depth = depth;
+    config.movingRatio = moving;
+    config.animatedRatio = animated;
+    config.flatTraversal = flat;
+    config.seed = 1234;
+    config.frames = 150;
+    config.warmupFrames = 30;
+    scenarios.push_back(config);
+  };
+
+  add("static_shared_flat", 1, 1, 0.0f, 0.0f, false);
+  add("animated_4sheets_flat", 4, 1, 0.5f, 1.0f, false);
+  add("animated_unique_flat", 0, 1, 0.5f, 1.0f, false);
+  add("animated_shared_deep", 1, 100, 0.5f, 1.0f, false);
+  add("animated_shared_deep_flatlist", 1, 100, 0.5f, 1.0f, true);
+  return scenarios;
+}
+
+// Identifies the hardware a baseline was measured on
+static std::string machineId()
+{
+  std::string model = "unknown";
+#ifdef __linux__
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line))
+  {
+    if (line.compare(0, 10, "model name") == 0)
+    {
+      size_t colon = line.find(':');
+      if (colon != std::string::npos && colon + 2 <= line.size())
+        model = line.substr(colon + 2);
+      break;
+    }
+  }
+#endif
+  for (char &c : model)
+  {
+    if (c == '"' || c == '\\')
+      c = ' ';
+  }
+  return model + " x" + std::to_string(std::thread::hardware_concurrency());
+}
+
+// Name of the reference kernel timing, stored with each scenario's timings
+static const char *const ReferenceMetric = "referenceMs";
+
+static double median(std::vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+  size_t middle = values.size() / 2;
+  return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) * 0.5;
+}
+
+// Median absolute deviation scaled by 1.4826, a standard deviation that one
+// outlier run cannot inflate
+static double spread(const std::vector<double> &values, double center)
+{
+  std::vector<double> deviations;
+  for (double value : values)
+    deviations.push_back(std::fabs(value - center));
+  return 1.4826 * median(deviations);
+}
+
+// Fixed workload independent of the engine, shaped like a scene update: a
+// pass over 10000 node-sized records moving and bouncing each one. Returns
+// the median of several passes in milliseconds, like the scenes' per-frame p50.
+static double runReferenceKernel()
+{
+  struct Record
+  {
+    float x, y, vx, vy;
+    uint32_t frame;
+    char payload[204]; // Pads the record to the size of a Sprite2D
+  };
+  static std::vector<Record> records;
+  if (records.empty())
+  {
+    records.resize(10000);
+    uint32_t state = 1234;
+    for (Record &record : records)
+    {
+      state = state * 1664525u + 1013904223u;
+      record.x = static_cast<float>(state % 1280);
+      record.y = static_cast<float>(state % 720);
+      record.vx = static_cast<float>(state % 200) - 100.0f;
+      record.vy = static_cast<float>(state % 160) - 80.0f;
+      record.frame = state & 7;
+    }
+  }
+
+  std::vector<double> samples;
+  for (int sample = 0; sample < 31; ++sample)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (Record &record : records)
+    {
+      record.x += record.vx * (1.0f / 60.0f);
+      record.y += record.vy * (1.0f / 60.0f);
+      if (record.x < 0.0f || record.x > 1280.0f)
+        record.vx = -record.vx;
+      if (record.y < 0.0f || record.y > 720.0f)
+        record.vy = -record.vy;
+      record.frame = (record.frame + 1) & 7;
+    }
+    auto end = std::chrono::steady_clock::now();
+    samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+  }
+  return median(samples);
+}
+
+static std::vector<PerfMetric> counters(const SceneBenchResult &result)
+{
+  return {
+      {"nodes", true, static_cast<double>(result.nodeCount), 0.0},
+      {"drawCalls", true, static_cast<double>(result.render.drawCalls), 0.0},
+      {"textureSwitches", true, static_cast<double>(result.render.textureSwitches), 0.0},
+      {"stateChanges", true, static_cast<double>(result.render.stateChanges()), 0.0},
+      {"textureUploads", true, static_cast<double>(result.render.textureUploads), 0.0},
+      {"allocations", true, static_cast<double>(result.allocations.allocations), 0.0},
+      {"allocatedBytes", true, static_cast<double>(result.allocations.bytes), 0.0},
+      {"maxFrameAllocations", true, static_cast<double>(result.maxFrameAllocations), 0.0},
+  };
+}
+
+// Run every scenario several times, one round over all of them per
+// repetition so a quiet or busy stretch of the host is shared by every
+// scenario instead of skewing one. Counters from the runs must agree; timings
+// are the median and spread of each run's median. Unless only counters are
+// wanted, a discarded round warms caches and the allocator first, and the
+// reference kernel is timed before each run.
+static std::vector<ScenarioMetrics> measure(SceneBenchmark &benchmark, const std::vector<SceneBenchConfig> &configs,
+                                            int repetitions, bool withTimings)
+{
+  const char *timingNames[] = {"frameMs", "updateMs", "renderMs", ReferenceMetric};
+  std::vector<ScenarioMetrics> scenarios(configs.size());
+  std::vector<std::vector<double>> timings(configs.size() * 4);
+
+  if (withTimings)
+  {
+    for (const SceneBenchConfig &config : configs)
+      benchmark.run(config);
+  }
+
+  for (int run = 0; run < repetitions; ++run)
+  {
+    for (size_t s = 0; s < configs.size(); ++s)
+    {
+      ScenarioMetrics &scenario = scenarios[s];
+      std::vector<double> *scenarioTimings = &timings[s * 4];
+      if (withTimings)
+        scenarioTimings[3].push_back(runReferenceKernel());
+      SceneBenchResult result = benchmark.run(configs[s]);
+      std::vector<PerfMetric> runCounters = counters(result);
+      if (run == 0)
+      {
+        scenario.name = configs[s].name;
+        scenario.metrics = runCounters;
+      }
+      else
+      {
+        for (size_t i = 0; i < runCounters.size(); ++i)
+        {
+          if (runCounters[i].value != scenario.metrics[i].value)
+            scenario.deterministic = false;
+        }
+      }
+      scenarioTimings[0].push_back(result.frameMs.p50);
+      scenarioTimings[1].push_back(result.updateMs.p50);
+      scenarioTimings[2].push_back(result.renderMs.p50);
+    }
+  }
+
+  if (!withTimings)
+    return scenarios;
+
+  for (size_t s = 0; s < configs.size(); ++s)
+  {
+    for (int t = 0; t < 4; ++t)
+    {
+      const std::vector<double> &values = timings[s * 4 + t];
+      double center = median(values);
+      scenarios[s].metrics.push_back({timingNames[t], false, center, spread(values, center)});
+    }
+  }
+  return scenarios;
+}
+
+// Median of one metric over every scenario that has it, 0 if none does
+static double medianMetric(const PerfBaseline &results, const char *metricName)
+{
+  std::vector<double> values;
+  for (const ScenarioMetrics &scenario : results.scenarios)
+  {
+    if (const PerfMetric *metric = scenario.find(metricName))
+      values.push_back(metric->value);
+  }
+  return values.empty() ? 0.0 : median(values);
+}
+
+static bool writeBaseline(const std::string &path, const PerfBaseline &baseline)
+{
+  std::ofstream file(path);
+  if (!file)
+  {
+    std::cerr << "Cannot open " << path << " for writing" << std::endl;
+    return false;
+  }
+
+  // One scenario per line; readBaseline relies on that
+  file << "{\n  \"machine\": \"" << baseline.machine << "\",\n  \"scenarios\": [\n";
+  char number[64];
+  for (size_t s = 0; s < baseline.scenarios.size(); ++s)
+  {
+    const ScenarioMetrics &scenario = baseline.scenarios[s];
+    file << "    {\"name\": \"" << scenario.name << "\"";
+    for (const PerfMetric &metric : scenario.metrics)
+    {
+      if (metric.exact)
+        std::snprintf(number, sizeof(number), "%.0f", metric.value);
+      else
+        std::snprintf(number, sizeof(number), "[%.4f, %.4f]", metric.value, metric.stddev);
+      file << ", \"" << metric.name << "\": " << number;
+    }
+    file << "}" << (s + 1 < baseline.scenarios.size() ? "," : "") << "\n";
+  }
+  file << "  ]\n}\n";
+  return static_cast<bool>(file);
+}
+
+static bool readBaseline(const std::string &path, PerfBaseline &baseline)
+{
+  std::ifstream file(path);
+  if (!file)
+  {
+    std::cerr << "Cannot open baseline " << path << " (create it with --write-baseline)" << std::endl;
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line))
+  {
+    size_t machine = line.find("\"machine\": \"");
+    if (machine != std::string::npos)
+    {
+      size_t start = machine + 12;
+      baseline.machine = line.substr(start, line.find('"', start) - start);
+      continue;
+    }
+
+    size_t name = line.find("{\"name\": \"");
+    if (name == std::string::npos)
+      continue;
+
+    ScenarioMetrics scenario;
+    size_t nameStart = name + 10;
+    size_t pos = line.find('"', nameStart);
+    scenario.name = line.substr(nameStart, pos - nameStart);
+
+    // Remaining entries: , "key": value  or  , "key": [mean, stddev]
+    while ((pos = line.find(", \"", pos)) != std::string::npos)
+    {
+      size_t keyStart = pos + 3;
+      size_t keyEnd = line.find('"', keyStart);
+      PerfMetric metric{line.substr(keyStart, keyEnd - keyStart), true, 0.0, 0.0};
+      const char *value = line.c_str() + keyEnd + 3;
+      if (*value == '[')
+      {
+        metric.exact = false;
+        char *next = nullptr;
+        metric.value = std::strtod(value + 1, &next);
+        metric.stddev = std::strtod(next + 1, nullptr);
+      }
+      else
+      {
+        metric.value = std::strtod(value, nullptr);
+      }
+      scenario.metrics.push_back(metric);
+      pos = keyEnd;
+    }
+    baseline.scenarios.push_back(scenario);
+  }
+
+  if (baseline.scenarios.empty())
+  {
+    std::cerr << "Baseline " << path << " contains no scenarios" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  std::string baselinePath = "perf_baseline.json";
+  bool writeMode = false;
+  bool countersOnly = false;
+  int repetitions = 7;
+  double sigmas = 4.0;        // Band width in baseline spreads
+  double minTolerance = 0.25; // but never narrower than this share of the expected value
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--write-baseline")
+      writeMode = true;
+    else if (arg == "--counters-only")
+      countersOnly = true;
+    else if (arg == "--baseline" && hasValue)
+      baselinePath = argv[++i];
+    else if (arg == "--repetitions" && hasValue)
+      repetitions = std::atoi(argv[++i]);
+    else if (arg == "--sigmas" && hasValue)
+      sigmas = std::atof(argv[++i]);
+    else if (arg == "--min-tolerance" && hasValue)
+      minTolerance = std::atof(argv[++i]);
+    else
+    {
+      std::cerr << "Usage: perf_regression_test [--baseline PATH] [--write-baseline] [--counters-only]"
+                   " [--repetitions N] [--sigmas K] [--min-tolerance R]"
+                << std::endl;
+      return 1;
+    }
+  }
+  if (repetitions < 2)
+  {
+    std::cerr << "--repetitions must be at least 2" << std::endl;
+    return 1;
+  }
+  if (writeMode && countersOnly)
+  {
+    std::cerr << "--write-baseline needs timings; drop --counters-only" << std::endl;
+    return 1;
+  }
+  // Two runs are enough to check that the counters are deterministic
+  if (countersOnly)
+    repetitions = 2;
+
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  PerfBaseline current;
+  current.machine = machineId();
+  SceneBenchmark benchmark;
+  current.scenarios = measure(benchmark, gateScenarios(), repetitions, !countersOnly);
+  Logger::getInstance().stop();
+
+  if (writeMode)
+  {
+    if (!writeBaseline(baselinePath, current))
+      return 1;
+    std::cout << "Baseline written to " << baselinePath << std::endl;
+    return 0;
+  }
+
+  PerfBaseline baseline;
+  if (!readBaseline(baselinePath, baseline))
+    return 1;
+
+  bool enforceTiming = baseline.machine == current.machine;
+  if (!enforceTiming && !countersOnly)
+  {
+    std::cout << "Baseline was measured on '" << baseline.machine << "', this is '" << current.machine
+              << "': timings are reported but not enforced" << std::endl;
+  }
+
+  // Host speed now relative to when the baseline was written, from the
+  // reference kernel over all scenarios
+  double hostScale = 1.0;
+  double currentReference = medianMetric(current, ReferenceMetric);
+  double baselineReference = medianMetric(baseline, ReferenceMetric);
+  if (!countersOnly && currentReference > 0.0 && baselineReference > 0.0)
+  {
+    hostScale = currentReference / baselineReference;
+    std::printf("Reference kernel %.4f ms, baseline %.4f ms: expected timings scaled by %.2f\n", currentReference,
+                baselineReference, hostScale);
+  }
+
+  int failures = 0;
+  std::printf("%-30s %-20s %14s %14s %9s  %s\n", "scenario", "metric", "baseline", "current", "change", "status");
+  for (const ScenarioMetrics &scenario : current.scenarios)
+  {
+    const ScenarioMetrics *reference = nullptr;
+    for (const ScenarioMetrics &candidate : baseline.scenarios)
+    {
+      if (candidate.name == scenario.name)
+        reference = &candidate;
+    }
+    if (!reference)
+    {
+      std::printf("%-30s missing from the baseline (rerun with --write-baseline)\n", scenario.name.c_str());
+      failures++;
+      continue;
+    }
+    if (!scenario.deterministic)
+    {
+      std::printf("%-30s counters differ between repetitions (the workload is not deterministic)\n",
+                  scenario.name.c_str());
+      failures++;
+    }
+
+    for (const PerfMetric &metric : scenario.metrics)
+    {
+      const PerfMetric *expected = reference->find(metric.name);
+      if (!expected)
+      {
+        std::printf("%-30s %-20s %14s %14.4g %9s  MISSING\n", scenario.name.c_str(), metric.name.c_str(), "-",
+                    metric.value, "");
+        failures++;
+        continue;
+      }
+
+      bool isReference = metric.name == ReferenceMetric;
+      double expectedValue = metric.exact || isReference ? expected->value : expected->value * hostScale;
+      double change = expectedValue != 0.0 ? (metric.value - expectedValue) / expectedValue * 100.0 : 0.0;
+      const char *status = "ok";
+      if (isReference)
+      {
+        status = "reference";
+      }
+      else if (metric.exact)
+      {
+        if (metric.value != expected->value)
+        {
+          status = metric.value > expected->value ? "REGRESSED" : "CHANGED (lower, update the baseline)";
+          failures++;
+        }
+      }
+      else
+      {
+        double tolerance = std::max(sigmas * expected->stddev * hostScale, minTolerance * expectedValue);
+        if (metric.value > expectedValue + tolerance)
+        {
+          status = enforceTiming ? "REGRESSED" : "slower (not enforced)";
+          if (enforceTiming)
+            failures++;
+        }
+        else if (metric.value < expectedValue - tolerance)
+        {
+          status = "faster";
+        }
+      }
+
+      // Print every timing, but only the counters that changed
+      if (!metric.exact || std::string(status) != "ok")
+      {
+        const char *format = metric.exact ? "%-30s %-20s %14.0f %14.0f %+8.1f%%  %s\n"
+                                          : "%-30s %-20s %14.4f %14.4f %+8.1f%%  %s\n";
+        std::printf(format, scenario.name.c_str(), metric.name.c_str(), expectedValue, metric.value, change, status);
+      }
+    }
+  }
+
+  if (failures > 0)
+  {
+    std::cout << failures << " performance check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "All performance checks passed" << std::endl;
+  return 0;
+}
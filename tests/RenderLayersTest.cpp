@@ -0,0 +1,179 @@
+// Checks that a static render layer is drawn into an offscreen target once
+// and then composited with a single draw, that it is re-rendered when one of
+// its nodes changes, joins or leaves, or the view leaves the cached region or
+// zooms, that dynamic layers never invalidate it, and that without a view or
+// render targets it is drawn directly.
+
+#include "core/log/Logger.h"
+#include "core/render/NullRenderDriver.h"
+#include "nodes/Rectangle.h"
+#include "scene/Scene.h"
+#include <iostream>
+#include <memory>
+#include <string>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+// Null driver without render targets, like a GL context lacking framebuffer objects
+class NoTargetDriver : public NullRenderDriver
+{
+public:
+  unsigned int createRenderTarget(int, int) override { return 0; }
+};
+
+static NullRenderDriver *driver = nullptr;
+
+// 100 background rectangles on layer 0, two on layer 1
+static Scene buildScene(Rectangle *&background, Rectangle *&player)
+{
+  Scene scene("Layers");
+  for (int i = 0; i < 100; ++i)
+  {
+    auto rectangle = std::make_unique<Rectangle>("Tile" + std::to_string(i), Position2D(i * 10.0f, 0.0f));
+    if (i == 0)
+      background = rectangle.get();
+    scene.addNode(std::move(rectangle));
+  }
+
+  auto actors = std::make_unique<Rectangle>("Player", Position2D(50.0f, 50.0f));
+  player = actors.get();
+  actors->addChild(std::make_unique<Rectangle>("Sword", Position2D(60.0f, 50.0f)));
+  actors->setRenderLayer(1);
+  scene.addNode(std::move(actors));
+  return scene;
+}
+
+static const RenderStats &renderFrame(const Scene &scene)
+{
+  driver->resetStats();
+  scene.render();
+  return driver->getStats();
+}
+
+static void testCaching()
+{
+  Rectangle *background = nullptr, *player = nullptr;
+  Scene scene = buildScene(background, player);
+  check(renderFrame(scene).drawCalls == 102, "without a static layer every node draws");
+
+  RenderLayers &layers = scene.getLayers();
+  layers.setStatic(0, true);
+  layers.setView(0.0f, 0.0f, 800.0f, 600.0f);
+
+  const RenderStats &first = renderFrame(scene);
+  check(first.renderTargetPasses == 1 && first.offscreenDrawCalls == 100 && first.drawCalls == 103,
+        "the first frame renders the layer offscreen, composites it and draws the rest");
+  check(scene.getLayerStats()->redraws == 1 && scene.getLayerStats()->composites == 1, "layer stats");
+  check(driver->getRenderTargetPixels(layers.getTarget(0)) == 1200 * 900, "the target covers the view and its margin");
+
+  const RenderStats &cached = renderFrame(scene);
+  check(cached.renderTargetPasses == 0 && cached.drawCalls == 3, "later frames draw the layer as one quad");
+
+  player->setPosition(Position2D(70.0f, 50.0f));
+  player->setColor(Colors::red);
+  check(renderFrame(scene).renderTargetPasses == 0, "changes on a dynamic layer keep the cache");
+
+  background->setPosition(Position2D(5.0f, 5.0f));
+  check(renderFrame(scene).renderTargetPasses == 1 && renderFrame(scene).renderTargetPasses == 0,
+        "moving a background node re-renders the layer once");
+
+  scene.addNode(std::make_unique<Rectangle>("NewTile", Position2D(300.0f, 300.0f)));
+  check(renderFrame(scene).offscreenDrawCalls == 101, "an added node re-renders its layer");
+  scene.removeNode("NewTile");
+  check(renderFrame(scene).offscreenDrawCalls == 100, "a removed node re-renders its layer");
+
+  player->setRenderLayer(0);
+  check(renderFrame(scene).offscreenDrawCalls == 102, "a subtree moved onto the layer re-renders it");
+  player->setRenderLayer(1);
+  check(renderFrame(scene).offscreenDrawCalls == 100, "and so does moving it off");
+}
+
+static void testView()
+{
+  Rectangle *background = nullptr, *player = nullptr;
+  Scene scene = buildScene(background, player);
+  RenderLayers &layers = scene.getLayers();
+  layers.setStatic(0, true);
+  layers.setView(0.0f, 0.0f, 800.0f, 600.0f);
+  renderFrame(scene);
+
+  // The target covers a quarter of the view beyond each edge
+  layers.setView(150.0f, 100.0f, 950.0f, 700.0f);
+  check(renderFrame(scene).renderTargetPasses == 0, "scrolling within the margin keeps the cache");
+  layers.setView(250.0f, 100.0f, 1050.0f, 700.0f);
+  check(renderFrame(scene).renderTargetPasses == 1, "scrolling past the margin re-renders");
+
+  layers.setView(250.0f, 100.0f, 650.0f, 400.0f, 2.0f);
+  check(renderFrame(scene).renderTargetPasses == 1, "a zoom change re-renders");
+  check(driver->getRenderTargetPixels(layers.getTarget(0)) == 1200 * 900, "zooming in keeps the target's pixel size");
+
+  layers.setView(0.0f, 0.0f, 0.0f, 0.0f);
+  const RenderStats &direct = renderFrame(scene);
+  check(direct.renderTargetPasses == 0 && direct.drawCalls == 102 && scene.getLayerStats()->directLayers == 1,
+        "without a view the layer draws directly");
+
+  unsigned int target = layers.getTarget(0);
+  layers.setStatic(0, false);
+  check(renderFrame(scene).drawCalls == 102 && !layers.hasStaticLayers() && driver->getRenderTargetPixels(target) == 0,
+        "a layer made dynamic again frees its target and draws directly");
+}
+
+static void testTargets()
+{
+  Rectangle *background = nullptr, *player = nullptr;
+  unsigned int target = 0;
+  {
+    Scene scene = buildScene(background, player);
+    scene.getLayers().setStatic(0, true);
+    scene.getLayers().setView(0.0f, 0.0f, 800.0f, 600.0f);
+    renderFrame(scene);
+    target = scene.getLayers().getTarget(0);
+  }
+  check(target != 0 && driver->getRenderTargetPixels(target) == 0, "targets are freed with the scene");
+
+  RenderDevice::getInstance().cleanup();
+  auto noTargets = std::make_unique<NoTargetDriver>();
+  driver = noTargets.get();
+  RenderDevice::getInstance().setDriver(std::move(noTargets));
+  RenderDevice::getInstance().initialize(nullptr);
+
+  Scene scene = buildScene(background, player);
+  scene.getLayers().setStatic(0, true);
+  scene.getLayers().setView(0.0f, 0.0f, 800.0f, 600.0f);
+  const RenderStats &stats = renderFrame(scene);
+  check(stats.renderTargetPasses == 0 && stats.drawCalls == 102, "without render targets the layer draws directly");
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  auto nullDriver = std::make_unique<NullRenderDriver>();
+  driver = nullDriver.get();
+  RenderDevice::getInstance().setDriver(std::move(nullDriver));
+  RenderDevice::getInstance().initialize(nullptr);
+
+  testCaching();
+  testView();
+  testTargets();
+
+  RenderDevice::getInstance().cleanup();
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "Render layers test passed" << std::endl;
+  return 0;
+}
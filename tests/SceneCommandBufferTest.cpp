@@ -0,0 +1,123 @@
+// Checks that queued spawn/destroy/reparent commands are applied at the
+// flush, that destroying a node and one of its ancestors deletes the subtree
+// once, and that commands pointing into a subtree removed before the flush
+// are dropped instead of touching the removed (possibly deleted) nodes.
+
+#include "core/log/Logger.h"
+#include "nodes/Rectangle.h"
+#include "scene/Scene.h"
+#include <iostream>
+#include <memory>
+#include <string>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+static std::unique_ptr<Rectangle> makeNode(const std::string &name)
+{
+  return std::make_unique<Rectangle>(name, Position2D(0.0f, 0.0f));
+}
+
+// Root children "a" and "b"; "a" holds "child", which holds "leaf"
+static void buildScene(Scene &scene)
+{
+  auto a = makeNode("a");
+  auto child = makeNode("child");
+  child->addChild(makeNode("leaf"));
+  a->addChild(std::move(child));
+  scene.addNode(std::move(a));
+  scene.addNode(makeNode("b"));
+}
+
+static void testApplied()
+{
+  Scene scene("Commands");
+  buildScene(scene);
+  Node *a = scene.findNode("a");
+  Node *b = scene.findNode("b");
+
+  scene.getCommands().spawn(b, makeNode("spawned"));
+  scene.getCommands().reparent(scene.findNode("child"), b);
+  check(scene.getTotalNodeCount() == 5, "nothing changes before the flush");
+
+  check(scene.flushCommands() == 2, "the spawn and the reparent are applied");
+  check(scene.findNode("spawned")->getParent() == b && scene.findNode("child")->getParent() == b,
+        "under their new parents");
+
+  // A node and its ancestor both queued: the subtree is deleted once
+  scene.findNode("leaf")->queueFree();
+  b->queueFree();
+  b->queueFree();
+  a->queueFree();
+  check(scene.flushCommands() == 2, "only the outermost destroys are applied");
+  check(scene.getTotalNodeCount() == 1 && scene.getNodeCount() == 0, "the subtrees are gone");
+}
+
+static void testDroppedOnRemoval()
+{
+  Scene scene("Commands");
+  buildScene(scene);
+
+  // Destroy queued, then the node is removed and deleted right away
+  scene.findNode("b")->queueFree();
+  scene.removeNode("b");
+  check(scene.getCommands().getPendingCount() == 1, "the command stays queued");
+  check(scene.flushCommands() == 0, "but is dropped instead of reading the deleted node");
+
+  // Commands into a subtree whose ancestor is removed
+  Node *a = scene.findNode("a");
+  Node *child = scene.findNode("child");
+  scene.findNode("leaf")->queueFree();
+  scene.getCommands().spawn(child, makeNode("spawned"));
+  scene.getCommands().reparent(scene.findNode("leaf"), scene.getRoot());
+  scene.getRoot()->removeChild(a);
+  check(scene.flushCommands() == 0, "commands under a removed ancestor are dropped");
+  check(scene.findNode("spawned") == nullptr && scene.getTotalNodeCount() == 1, "and their nodes never join");
+}
+
+static void testDroppedOnDestination()
+{
+  Scene scene("Commands");
+  buildScene(scene);
+  Node *b = scene.findNode("b");
+
+  // Moving a node into a parent that is removed before the flush
+  scene.getCommands().reparent(b, scene.findNode("leaf"));
+  std::unique_ptr<Node> removed = scene.removeNode("a");
+  check(scene.flushCommands() == 0, "a reparent into a removed subtree is dropped");
+  check(b->getParent() == scene.getRoot(), "and the node stays where it was");
+
+  // A removed node that is added back keeps living: its destroy was dropped
+  Node *child = removed->getChildren().front().get();
+  child->queueFree();
+  std::unique_ptr<Node> detached = removed->removeChild(child);
+  scene.addNode(std::move(detached));
+  check(scene.flushCommands() == 0 && scene.findNode("child") == child, "re-added nodes are not destroyed");
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  testApplied();
+  testDroppedOnRemoval();
+  testDroppedOnDestination();
+
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "Scene command buffer test passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,126 @@
+// Checks the SceneTree's per-parent name index: findChild returns the first
+// child with a name in child order through adds, removals, renames and
+// reparents, findPath resolves one segment per lookup, and Scene::removeNode
+// only removes root children.
+
+#include "core/log/Logger.h"
+#include "nodes/Rectangle.h"
+#include "scene/Scene.h"
+#include <iostream>
+#include <memory>
+#include <string>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+static std::unique_ptr<Rectangle> makeNode(const std::string &name)
+{
+  return std::make_unique<Rectangle>(name, Position2D(0.0f, 0.0f));
+}
+
+static Node *addNode(Node *parent, const std::string &name)
+{
+  auto node = makeNode(name);
+  Node *added = node.get();
+  parent->addChild(std::move(node));
+  return added;
+}
+
+static void testRemoveNodeRootOnly()
+{
+  Scene scene("Tree");
+  Node *holder = addNode(scene.getRoot(), "holder");
+  Node *nested = addNode(holder, "enemy");
+  Node *first = addNode(scene.getRoot(), "enemy");
+  Node *second = addNode(scene.getRoot(), "enemy");
+
+  std::unique_ptr<Node> removed = scene.removeNode("enemy");
+  check(removed.get() == first, "removeNode takes the first root child with the name");
+  check(nested->getParent() == holder, "and leaves nested nodes with that name alone");
+
+  // Put it back at the end: the other root child is now first
+  scene.addNode(std::move(removed));
+  check(scene.removeNode("enemy").get() == second, "order follows the children, not the removal history");
+  check(scene.removeNode("enemy").get() == first, "the re-added node comes after it");
+  check(scene.removeNode("enemy") == nullptr && nested->getTree() != nullptr, "only root children are removed");
+}
+
+static void testFirstChildInOrder()
+{
+  Scene scene("Tree");
+  Node *parent = addNode(scene.getRoot(), "parent");
+  Node *a = addNode(parent, "item");
+  Node *b = addNode(parent, "other");
+  Node *c = addNode(parent, "item");
+  SceneTree *tree = parent->getTree();
+
+  check(tree->findChild(parent, "item") == a, "the first child with the name is found");
+  std::unique_ptr<Node> removedA = parent->removeChild(a);
+  check(tree->findChild(parent, "item") == c, "removing it exposes the next one");
+
+  b->setName("item");
+  check(tree->findChild(parent, "item") == b, "a renamed child keeps its place in child order");
+  check(tree->findChild(parent, "other") == nullptr, "and leaves its old name");
+
+  Node *elsewhere = addNode(scene.getRoot(), "elsewhere");
+  b->reparent(elsewhere);
+  check(tree->findChild(parent, "item") == c && tree->findChild(elsewhere, "item") == b,
+        "reparenting moves the node between parents");
+
+  c->setName("gone");
+  check(tree->findChild(parent, "item") == nullptr && tree->findChild(parent, "gone") == c,
+        "renames update the index");
+
+  scene.clear();
+  check(tree->findChild(elsewhere, "item") == nullptr, "clear drops every entry");
+}
+
+static void testFindPath()
+{
+  Scene scene("Tree");
+  Node *level = addNode(scene.getRoot(), "Level");
+  addNode(level, "Player");
+  Node *other = addNode(level, "Player");
+  Node *weapon = addNode(other, "Weapon");
+
+  check(scene.findPath("Root/Level/Player/Weapon") == nullptr, "paths follow the first child with each name");
+  check(scene.findPath("Root/Level/Player") == level->getChildren().front().get(), "segments resolve in order");
+
+  std::unique_ptr<Node> first = level->removeChild(level->getChildren().front().get());
+  check(scene.findPath("Root/Level/Player/Weapon") == weapon, "and follow removals");
+  check(scene.findPath("Root/Level/Missing") == nullptr && scene.findPath("Level") == nullptr,
+        "unknown segments and paths not starting at the root fail");
+
+  // Moving the subtree into another scene takes its entries along
+  Scene target("Target");
+  level->reparent(target.getRoot());
+  check(scene.findPath("Root/Level") == nullptr && target.findPath("Root/Level/Player/Weapon") == weapon,
+        "reparenting across scenes moves the index entries");
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  testRemoveNodeRootOnly();
+  testFirstChildInOrder();
+  testFindPath();
+
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "Scene tree test passed" << std::endl;
+  return 0;
+}
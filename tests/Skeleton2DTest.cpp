@@ -0,0 +1,205 @@
+// Checks that Skeleton2D composes bone hierarchies, that clips sample and
+// loop as keyed, that the SIMD skinning matches a per-vertex reference for
+// rigid and blended vertices, and that a skinned character is drawn in one
+// textured-triangle call.
+
+#include "core/log/Logger.h"
+#include "core/render/NullRenderDriver.h"
+#include "nodes/SkinnedSprite2D.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+static bool near(float a, float b, float tolerance = 1e-3f) { return std::fabs(a - b) <= tolerance; }
+
+// Upper arm at (10, 0) turned 90 degrees, forearm 20 along it
+static std::shared_ptr<Skeleton2D> makeArm()
+{
+  auto skeleton = std::make_shared<Skeleton2D>();
+  skeleton->addBone("shoulder", "", Transform2D(Position2D(10.0f, 0.0f), Scale2D(1.0f, 1.0f), 90.0f));
+  skeleton->addBone("elbow", "shoulder", Transform2D(Position2D(20.0f, 0.0f)));
+  skeleton->addBone("hand", "elbow", Transform2D(Position2D(15.0f, 0.0f), Scale2D(2.0f, 2.0f)));
+  return skeleton;
+}
+
+static void testHierarchy()
+{
+  auto skeleton = makeArm();
+  check(skeleton->getBoneCount() == 3 && skeleton->findBone("hand") == 2, "bones are added in order");
+  check(skeleton->addBone("hand", "", Transform2D()) == InvalidBone, "duplicate names are rejected");
+  check(skeleton->addBone("finger", "thumb", Transform2D()) == InvalidBone, "unknown parents are rejected");
+
+  // The shoulder turns +x into +y, so the elbow sits 20 below (screen y down) it
+  Vector2 elbow = skeleton->getBindWorld(skeleton->findBone("elbow")).apply(Vector2());
+  Vector2 hand = skeleton->getBindWorld(skeleton->findBone("hand")).apply(Vector2(1.0f, 0.0f));
+  check(near(elbow.x, 10.0f) && near(elbow.y, 20.0f), "elbow at bind");
+  check(near(hand.x, 10.0f) && near(hand.y, 37.0f), "hand scale applies below it");
+
+  Affine2D roundTrip = skeleton->getBindWorld(2) * skeleton->getInverseBind(2);
+  check(near(roundTrip.a, 1.0f) && near(roundTrip.b, 0.0f) && near(roundTrip.tx, 0.0f) && near(roundTrip.ty, 0.0f),
+        "inverse bind undoes the bind pose");
+}
+
+// One degenerate triangle per vertex, so indices[3 * i] is where vertex i ended up
+static void testSkinningMatchesReference()
+{
+  auto skeleton = makeArm();
+  SkinnedMeshBuilder2D builder(*skeleton);
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> coordinate(-30.0f, 30.0f);
+  std::vector<Vector2> points;
+  std::vector<BoneIndex> bone0s, bone1s;
+  std::vector<float> weights;
+  for (uint32_t i = 0; i < 37; ++i)
+  {
+    Vector2 point(coordinate(rng), coordinate(rng));
+    BoneIndex a = static_cast<BoneIndex>(rng() % 3), b = static_cast<BoneIndex>(rng() % 3);
+    float weight = i % 3 == 0 ? 1.0f : static_cast<float>(rng() % 100) / 100.0f;
+    points.push_back(point);
+    bone0s.push_back(a);
+    bone1s.push_back(b);
+    weights.push_back(weight);
+    builder.addVertex(point, Vector2(), a, b, weight);
+    builder.addTriangle(i, i, i);
+  }
+  auto mesh = builder.build();
+  check(mesh != nullptr, "mesh builds");
+  if (!mesh)
+    return;
+  check(mesh->getVertexCount() % 4 == 0 && mesh->getVertexCount() >= points.size(), "spans are padded");
+
+  auto clip = std::make_shared<SkeletonClip2D>("wave");
+  clip->addTrack(0, {BoneKeyframe2D(0.0f, Transform2D(Position2D(10.0f, 0.0f), Scale2D(1.0f, 1.0f), 90.0f)),
+                     BoneKeyframe2D(1.0f, Transform2D(Position2D(14.0f, 3.0f), Scale2D(1.0f, 1.0f), 30.0f))});
+  clip->addTrack(1, {BoneKeyframe2D(0.0f, Transform2D(Position2D(20.0f, 0.0f))),
+                     BoneKeyframe2D(1.0f, Transform2D(Position2D(20.0f, 0.0f), Scale2D(1.5f, 0.5f), -60.0f))});
+
+  SkeletonPose2D pose;
+  check(pose.setup(skeleton, mesh) && pose.play(clip), "pose plays");
+  pose.update(0.37f);
+
+  float worst = 0.0f;
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    Affine2D m0 = pose.getBoneWorld(bone0s[i]) * skeleton->getInverseBind(bone0s[i]);
+    Affine2D m1 = pose.getBoneWorld(bone1s[i]) * skeleton->getInverseBind(bone1s[i]);
+    Vector2 p0 = m0.apply(points[i]), p1 = m1.apply(points[i]);
+    Vector2 expected = p0 * weights[i] + p1 * (1.0f - weights[i]);
+    const float *skinned = pose.getPositions() + 2 * mesh->getIndices()[3 * i];
+    worst = std::fmax(worst, std::fmax(std::fabs(skinned[0] - expected.x), std::fabs(skinned[1] - expected.y)));
+  }
+  check(worst < 1e-3f, "skinned positions differ from the reference by " + std::to_string(worst));
+}
+
+static void testClipPlayback()
+{
+  auto skeleton = makeArm();
+  SkinnedMeshBuilder2D builder(*skeleton);
+  builder.addPart(2, Vector2(0.0f, -1.0f), Vector2(2.0f, 1.0f));
+  auto mesh = builder.build();
+
+  // The elbow swings 0 -> 90 -> 0 over two seconds
+  auto swing = std::make_shared<SkeletonClip2D>("swing", true);
+  swing->addTrack(1, {BoneKeyframe2D(0.0f, Transform2D(Position2D(20.0f, 0.0f))),
+                      BoneKeyframe2D(1.0f, Transform2D(Position2D(20.0f, 0.0f), Scale2D(1.0f, 1.0f), 90.0f)),
+                      BoneKeyframe2D(2.0f, Transform2D(Position2D(20.0f, 0.0f)))});
+  auto once = std::make_shared<SkeletonClip2D>("once", false);
+  once->addTrack(1, {BoneKeyframe2D(0.0f, Transform2D(Position2D(20.0f, 0.0f))),
+                     BoneKeyframe2D(1.0f, Transform2D(Position2D(20.0f, 0.0f), Scale2D(1.0f, 1.0f), 90.0f))});
+  check(!swing->addTrack(1, {BoneKeyframe2D()}), "one track per bone");
+  check(!once->addTrack(0, {BoneKeyframe2D(1.0f), BoneKeyframe2D(0.0f)}), "unsorted keys are rejected");
+
+  SkeletonPose2D pose;
+  pose.setup(skeleton, mesh);
+  const float *bindPositions = pose.getPositions();
+  check(near(bindPositions[0], 12.0f) && near(bindPositions[1], 35.0f), "bind pose skins to the bind mesh");
+
+  pose.play(swing);
+  pose.update(0.5f);
+  Vector2 hand = pose.getBoneWorld(2).apply(Vector2());
+  // Shoulder 90 + elbow 45: the forearm points down-left at 135 degrees
+  check(near(hand.x, 10.0f - 15.0f * std::sqrt(0.5f)) && near(hand.y, 20.0f + 15.0f * std::sqrt(0.5f)), "halfway key");
+  pose.update(2.0f);
+  check(near(pose.getTime(), 0.5f) && !pose.isFinished(), "loop wraps");
+
+  pose.play(once, 0.25f);
+  pose.update(5.0f);
+  hand = pose.getBoneWorld(2).apply(Vector2());
+  check(pose.isFinished() && near(pose.getTime(), 1.0f) && near(hand.x, -5.0f) && near(hand.y, 20.0f),
+        "once holds its last key");
+
+  auto tooWide = std::make_shared<SkeletonClip2D>("tooWide");
+  tooWide->addTrack(7, {BoneKeyframe2D()});
+  check(!pose.play(tooWide), "clips for larger skeletons are rejected");
+}
+
+// Characters share their data and draw with one call each
+static void testRender()
+{
+  auto nullDriver = std::make_unique<NullRenderDriver>();
+  NullRenderDriver *driver = nullDriver.get();
+  RenderDevice::getInstance().setDriver(std::move(nullDriver));
+  RenderDevice::getInstance().initialize(nullptr);
+
+  std::shared_ptr<const Skeleton2D> skeleton = makeArm();
+  SkinnedMeshBuilder2D builder(*skeleton);
+  for (BoneIndex bone = 0; bone < 3; ++bone)
+    builder.addPart(bone, Vector2(0.0f, -2.0f), Vector2(20.0f, 2.0f));
+  std::shared_ptr<const SkinnedMesh2D> mesh = builder.build();
+  std::shared_ptr<TextureData> texture = createTextureData(1, 1, "\xff\xff\xff\xff");
+
+  std::vector<std::unique_ptr<SkinnedSprite2D>> characters;
+  for (int i = 0; i < 10; ++i)
+  {
+    characters.push_back(std::make_unique<SkinnedSprite2D>("Character", Position2D(i * 50.0f, 100.0f)));
+    characters.back()->setSkeleton(skeleton, mesh);
+    characters.back()->setTexture(texture);
+  }
+  check(skeleton.use_count() == 11 && mesh.use_count() == 11 && texture.use_count() == 11,
+        "characters share skeleton, mesh and texture");
+
+  driver->resetStats();
+  for (auto &character : characters)
+  {
+    character->update(1.0f / 60.0f);
+    character->render();
+  }
+  const RenderStats &stats = driver->getStats();
+  check(stats.meshDraws == 10 && stats.drawCalls == 10 && stats.meshTriangles == 60 && stats.textureSwitches == 1,
+        "one textured draw per character");
+
+  characters.clear();
+  RenderDevice::getInstance().cleanup();
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  testHierarchy();
+  testSkinningMatchesReference();
+  testClipPlayback();
+  testRender();
+
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "Skeleton2D test passed" << std::endl;
+  return 0;
+}
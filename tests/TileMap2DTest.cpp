@@ -0,0 +1,184 @@
+// Checks that TileMap2D stores tiles by chunk, draws only the chunks in view
+// with one call each, rebuilds a chunk's quads only after an edit, recycles
+// cached geometry past its limit, and round-trips maps through mapped level
+// files without writing back to them.
+
+#include "core/log/Logger.h"
+#include "core/render/NullRenderDriver.h"
+#include "nodes/TileMap2D.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+// Keeps the first quad of the last mesh draw
+class RecordingDriver : public NullRenderDriver
+{
+public:
+  float positions[8] = {};
+  float texCoords[8] = {};
+
+  void drawTexturedTriangles(unsigned int textureId, const float *vertexPositions, const float *vertexTexCoords,
+                             const uint16_t *indices, size_t indexCount) override
+  {
+    NullRenderDriver::drawTexturedTriangles(textureId, vertexPositions, vertexTexCoords, indices, indexCount);
+    std::copy(vertexPositions, vertexPositions + 8, positions);
+    std::copy(vertexTexCoords, vertexTexCoords + 8, texCoords);
+  }
+};
+
+static RecordingDriver *driver = nullptr;
+
+static void testStorage()
+{
+  TileMap2D map("Map", Position2D(), 100, 70);
+  check(map.getChunkCountX() == 4 && map.getChunkCountY() == 3, "chunks cover the map");
+  check(map.getTile(99, 69) == EmptyTile, "a new map is empty");
+  check(map.setTile(99, 69, 7) && map.getTile(99, 69) == 7 && map.getTile(98, 69) == EmptyTile, "set and get a tile");
+  check(!map.setTile(100, 0, 1) && !map.setTile(0, -1, 1) && map.getTile(-1, 5) == EmptyTile, "outside the map");
+
+  map.fill(-5, -5, 10, 10, 3);
+  check(map.getTile(0, 0) == 3 && map.getTile(4, 4) == 3 && map.getTile(5, 5) == EmptyTile, "fill clips to the map");
+}
+
+// 256 x 256 tiles of 16 units: a chunk is 512 units wide
+static void testCulling()
+{
+  TileMap2D map("Map", Position2D(), 256, 256);
+  map.fill(0, 0, 256, 256, 1);
+  map.setView(0.0f, 0.0f, 1279.0f, 719.0f);
+
+  driver->resetStats();
+  map.render();
+  check(map.getStats().visibleChunks == 6 && map.getStats().drawnChunks == 6 && map.getStats().chunkBuilds == 6,
+        "a 1280x720 view draws 3x2 chunks");
+  check(driver->getStats().meshDraws == 6 && driver->getStats().meshTriangles == 6 * TileChunkTiles * 2,
+        "one draw per chunk");
+
+  map.render();
+  check(map.getStats().chunkBuilds == 0 && map.getStats().drawnTiles == 6 * TileChunkTiles, "cached chunks are reused");
+
+  map.setTile(40, 40, EmptyTile);
+  map.setTile(1000, 40, 2);
+  map.render();
+  check(map.getStats().chunkBuilds == 1 && map.getStats().drawnTiles == 6 * TileChunkTiles - 1,
+        "an edit rebuilds only its chunk");
+
+  map.setPosition(Position2D(-512.0f, 0.0f));
+  map.render();
+  check(map.getStats().visibleChunks == 6 && map.getStats().chunkBuilds == 2, "culling follows the node position");
+
+  map.setView(-3000.0f, -3000.0f, -2000.0f, -2000.0f);
+  driver->resetStats();
+  map.render();
+  check(map.getStats().visibleChunks == 0 && driver->getStats().drawCalls == 0, "nothing outside the map is drawn");
+}
+
+static void testCacheLimit()
+{
+  TileMap2D map("Map", Position2D(), 512, 512);
+  map.fill(0, 0, 512, 512, 1);
+  map.setCacheLimit(4);
+  map.setView(0.0f, 0.0f, 1279.0f, 719.0f);
+  map.render();
+  check(map.getStats().cachedChunks == 6, "chunks in view stay cached beyond the limit");
+
+  map.setView(4096.0f, 4096.0f, 4096.0f + 1279.0f, 4096.0f + 719.0f);
+  map.render();
+  check(map.getStats().chunkBuilds == 6 && map.getStats().cachedChunks == 6, "chunks out of view are recycled");
+
+  map.setView(0.0f, 0.0f, 1279.0f, 719.0f);
+  map.render();
+  check(map.getStats().chunkBuilds == 6 && map.getStats().drawnTiles == 6 * TileChunkTiles,
+        "recycled chunks are rebuilt when seen again");
+}
+
+static void testTileSet()
+{
+  TileMap2D map("Map", Position2D(), 4, 4, 10.0f);
+  map.setTileSet(nullptr, 4, 2);
+  map.setTile(1, 2, 6);
+  map.setTile(2, 2, 9);
+  map.render();
+  check(map.getStats().drawnTiles == 1, "tiles past the last atlas cell are not drawn");
+  check(driver->positions[0] == 10.0f && driver->positions[1] == 20.0f && driver->positions[4] == 20.0f &&
+            driver->positions[5] == 30.0f,
+        "quad at the tile's cell");
+  check(driver->texCoords[0] == 0.25f && driver->texCoords[1] == 0.5f && driver->texCoords[4] == 0.5f &&
+            driver->texCoords[5] == 0.0f,
+        "tile 6 samples the second cell of the second row");
+}
+
+static void testLevelFiles()
+{
+  std::string path = (std::filesystem::temp_directory_path() / "tile_map_2d_test.tmap").string();
+  {
+    TileMap2D map("Map", Position2D(), 100, 70);
+    for (int y = 0; y < 70; y += 3)
+      for (int x = 0; x < 100; x += 2)
+        map.setTile(x, y, static_cast<TileId>(1 + (x * 7 + y) % 50));
+    check(map.saveLevel(path), "save a level");
+  }
+
+  TileMap2D streamed("Streamed");
+  check(streamed.openLevel(path) && streamed.isStreaming(), "open a level");
+  check(streamed.getWidth() == 100 && streamed.getHeight() == 70, "the level sets the map size");
+  bool same = true;
+  for (int y = 0; y < 70; ++y)
+    for (int x = 0; x < 100; ++x)
+      same = same && streamed.getTile(x, y) == ((x % 2 == 0 && y % 3 == 0) ? 1 + (x * 7 + y) % 50 : EmptyTile);
+  check(same, "level tiles match the saved map");
+
+  streamed.setTile(0, 0, 42);
+  TileMap2D reopened("Reopened");
+  reopened.openLevel(path);
+  check(streamed.getTile(0, 0) == 42 && streamed.getTile(2, 0) == 1 + 14 && reopened.getTile(0, 0) == 1,
+        "edits copy the chunk instead of writing to the file");
+
+  {
+    std::ofstream junk(path, std::ios::binary | std::ios::trunc);
+    junk << "not a level";
+  }
+  TileMap2D broken("Broken", Position2D(), 8, 8);
+  check(!broken.openLevel(path) && !broken.isStreaming() && broken.getWidth() == 8, "a bad file leaves the map alone");
+  std::remove(path.c_str());
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  auto recordingDriver = std::make_unique<RecordingDriver>();
+  driver = recordingDriver.get();
+  RenderDevice::getInstance().setDriver(std::move(recordingDriver));
+  RenderDevice::getInstance().initialize(nullptr);
+
+  testStorage();
+  testCulling();
+  testCacheLimit();
+  testTileSet();
+  testLevelFiles();
+
+  RenderDevice::getInstance().cleanup();
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "TileMap2D test passed" << std::endl;
+  return 0;
+}
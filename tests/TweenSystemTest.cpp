@@ -0,0 +1,144 @@
+// Checks that TweenSystem oscillators and spins reproduce the motion of the
+// per-node script classes, that keyframe easing and loop modes sample the
+// expected values, and that removing tracks keeps the other ids valid.
+
+#include "core/log/Logger.h"
+#include "nodes/OscillatingRectangle.h"
+#include "nodes/PulsingTriangle.h"
+#include "nodes/RotatingTriangle.h"
+#include "nodes/TweenSystem.h"
+#include <cmath>
+#include <iostream>
+#include <string>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &message)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << message << std::endl;
+    failures++;
+  }
+}
+
+static bool near(float a, float b, float tolerance) { return std::fabs(a - b) <= tolerance; }
+
+static void testFastSin()
+{
+  float worst = 0.0f;
+  for (int i = -20000; i <= 20000; ++i)
+  {
+    float x = static_cast<float>(i) * 0.001f;
+    worst = std::fmax(worst, std::fabs(fastSin(x) - std::sin(x)));
+    worst = std::fmax(worst, std::fabs(fastCos(x) - std::cos(x)));
+  }
+  check(worst < 1e-5f, "fastSin/fastCos error " + std::to_string(worst));
+}
+
+// Ten seconds at 60 fps next to the script nodes
+static void testMatchesScriptNodes()
+{
+  RotatingTriangle rotating("Rotating", Position2D(5.0f, 5.0f), Scale2D(1.0f, 1.0f), Colors::orange, 90.0f);
+  OscillatingRectangle oscillating("Oscillating", Position2D(10.0f, 20.0f), Scale2D(1.0f, 1.0f), Colors::blue, 0.1f, 2.0f);
+  PulsingTriangle pulsing("Pulsing", Position2D(0.0f, 0.0f), Scale2D(1.0f, 1.0f), Colors::green, 1.0f, 0.2f, 3.0f);
+
+  Transform2D spun, moved(Position2D(10.0f, 20.0f)), pulsed;
+  TweenSystem tweens;
+  tweens.spin(&spun.rotation, 90.0f);
+  tweens.oscillate(&moved.position.x, 1, 10.0f, 0.1f, 2.0f);
+  tweens.oscillate(&pulsed.scale.x, 2, 1.0f, 0.2f, 3.0f);
+
+  for (int step = 0; step < 600; ++step)
+  {
+    rotating.update(1.0f / 60.0f);
+    oscillating.update(1.0f / 60.0f);
+    pulsing.update(1.0f / 60.0f);
+    tweens.update(1.0f / 60.0f);
+
+    if (!near(spun.rotation, rotating.getRotation(), 0.01f) ||
+        !near(moved.position.x, oscillating.getPosition().x, 1e-4f) || moved.position.y != 20.0f ||
+        !near(pulsed.scale.x, pulsing.getScale().x, 1e-4f) || pulsed.scale.x != pulsed.scale.y)
+    {
+      check(false, "step " + std::to_string(step) + ": rotation " + std::to_string(spun.rotation) + " vs " +
+                       std::to_string(rotating.getRotation()) + ", x " + std::to_string(moved.position.x) + " vs " +
+                       std::to_string(oscillating.getPosition().x) + ", scale " + std::to_string(pulsed.scale.x) +
+                       " vs " + std::to_string(pulsing.getScale().x));
+      return;
+    }
+  }
+}
+
+static void testKeyframes()
+{
+  TweenSystem tweens;
+  std::vector<TweenKeyframe> keys = {TweenKeyframe(0.0f, Vector3(0.0f, 10.0f), TweenEase::Linear),
+                                     TweenKeyframe(1.0f, Vector3(10.0f, 20.0f), TweenEase::Step),
+                                     TweenKeyframe(2.0f, Vector3(20.0f, 0.0f), TweenEase::Cubic),
+                                     TweenKeyframe(3.0f, Vector3(30.0f, 30.0f))};
+  TweenCurveHandle once = tweens.addCurve(keys, TweenChannel::Position, TweenLoop::Once);
+  TweenCurveHandle loop = tweens.addCurve(keys, TweenChannel::Position, TweenLoop::Loop);
+  TweenCurveHandle pingPong = tweens.addCurve(keys, TweenChannel::Position, TweenLoop::PingPong);
+  check(tweens.addCurve({TweenKeyframe(1.0f), TweenKeyframe(0.0f)}, 1) == InvalidTween, "unsorted keys are rejected");
+
+  Transform2D a, b, c;
+  TweenId onceId = tweens.play(once, a, TweenChannel::Position);
+  tweens.play(loop, b, TweenChannel::Position);
+  tweens.play(pingPong, c, TweenChannel::Position);
+
+  // Steps of 0.25 s are exact in binary, so the samples are exact too
+  auto advance = [&](float seconds)
+  {
+    for (float t = 0.0f; t < seconds; t += 0.25f)
+      tweens.update(0.25f);
+  };
+
+  advance(0.5f); // t = 0.5: linear half way
+  check(near(a.position.x, 5.0f, 1e-5f) && near(a.position.y, 15.0f, 1e-5f), "linear segment");
+  advance(1.0f); // t = 1.5: step holds the key
+  check(near(a.position.x, 10.0f, 1e-5f) && near(a.position.y, 20.0f, 1e-5f), "step segment");
+  advance(0.75f); // t = 2.25: cubic at u = 0.25 -> 0.15625
+  check(near(a.position.x, 21.5625f, 1e-4f), "cubic segment");
+  check(!tweens.isFinished(onceId), "once is still running");
+
+  advance(1.25f); // t = 3.5
+  check(near(a.position.x, 30.0f, 1e-5f) && tweens.isFinished(onceId), "once holds the last key");
+  check(near(b.position.x, 5.0f, 1e-4f), "loop wraps to 0.5");
+  check(near(c.position.x, 25.0f, 1e-4f), "ping-pong plays back to 2.5");
+}
+
+static void testRemove()
+{
+  TweenSystem tweens;
+  float values[3] = {0.0f, 0.0f, 0.0f};
+  TweenId first = tweens.spin(&values[0], 10.0f);
+  TweenId second = tweens.spin(&values[1], 20.0f);
+  TweenId third = tweens.spin(&values[2], 30.0f);
+  tweens.remove(first);
+  check(!tweens.isValid(first) && tweens.isValid(second) && tweens.isValid(third), "remove keeps the other ids");
+  tweens.update(1.0f);
+  check(values[0] == 0.0f && values[1] == 20.0f && values[2] == 30.0f, "removed track stops writing");
+  tweens.remove(third);
+  tweens.update(1.0f);
+  check(values[1] == 40.0f && values[2] == 30.0f && tweens.size() == 1, "remaining track keeps running");
+}
+
+int main()
+{
+  Logger::getInstance().setLevel(LogLevel::Warning);
+
+  testFastSin();
+  testMatchesScriptNodes();
+  testKeyframes();
+  testRemove();
+
+  Logger::getInstance().stop();
+
+  if (failures > 0)
+  {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "Tween system test passed" << std::endl;
+  return 0;
+}